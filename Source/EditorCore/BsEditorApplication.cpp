@@ -28,6 +28,7 @@
 #include "Scene/BsSceneManager.h"
 #include "Utility/BsSplashScreen.h"
 #include "Utility/BsDynLib.h"
+#include "GUI/BsGUIStatusBar.h"
 #include "Scene/BsSceneManager.h"
 #include "BsEngineConfig.h"
 
@@ -195,6 +196,17 @@ namespace bs
 	{
 		Application::preUpdate();
 
+		gProjectLibrary().update();
+		ScenePicking::instance().update();
+
+		MainEditorWindow* mainWindow = EditorWindowManager::instance().getMainWindow();
+		if (mainWindow != nullptr)
+		{
+			ProjectLibrary& projectLibrary = gProjectLibrary();
+			mainWindow->getStatusBar().setImportStatus(projectLibrary.getImportQueueLength(), 
+				projectLibrary.getCurrentImport().getFilename(), projectLibrary.getImportETA());
+		}
+
 		EditorWidgetManager::instance().update();
 		DropDownWindowManager::instance().update();
 	}
@@ -309,6 +321,7 @@ namespace bs
 		buildDataPath.append(BUILD_DATA_PATH);
 
 		BuildManager::instance().load(buildDataPath);
+		gProjectLibrary().setImportCacheFolder(mEditorSettings->getImportCacheFolder());
 		gProjectLibrary().loadLibrary();
 
 		// Do this before restoring windows to ensure types are loaded
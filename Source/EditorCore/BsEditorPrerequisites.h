@@ -192,6 +192,7 @@ namespace bs
 	static constexpr const char* SCRIPT_EDITOR_ASSEMBLY = "MScriptEditor";
 	static const Path PROJECT_INTERNAL_DIR = u8"Internal/";
 	static const Path INTERNAL_ASSEMBLY_PATH = PROJECT_INTERNAL_DIR + "Assemblies/";
+	static const Path INTERNAL_PACKAGE_CACHE_PATH = PROJECT_INTERNAL_DIR + "PackageCache/";
 
 	/** Types of drag and drop operations. Different types specify different types of dragged data. */
 	enum class DragAndDropType
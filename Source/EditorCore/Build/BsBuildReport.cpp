@@ -0,0 +1,386 @@
+//********************************** Banshee Engine (www.banshee3d.com) **************************************************//
+//**************** Copyright (c) 2016 Marko Pintera (marko.pintera@gmail.com). All rights reserved. **********************//
+#include "Build/BsBuildReport.h"
+#include "Utility/BsContentHash.h"
+#include "FileSystem/BsFileSystem.h"
+#include "FileSystem/BsDataStream.h"
+#include "Reflection/BsIReflectable.h"
+#include "Reflection/BsRTTIType.h"
+#include "ThirdParty/json.hpp"
+
+using json = nlohmann::json;
+
+namespace bs
+{
+	const char* BuildReport::JSON_NAME = "BuildReport.json";
+	const char* BuildReport::TEXT_NAME = "BuildReport.txt";
+
+	/** Formats a size in bytes as a human-readable string, using the largest fitting unit with a single decimal. */
+	static String formatSize(UINT64 bytes)
+	{
+		static const char* UNITS[] = { "B", "KB", "MB", "GB" };
+
+		if (bytes < 1024)
+			return toString(bytes) + " B";
+
+		UINT32 unit = 0;
+		UINT64 size = bytes * 10;
+		while (size >= 1024 * 10 && unit < 3)
+		{
+			size /= 1024;
+			unit++;
+		}
+
+		return toString(size / 10) + "." + toString(size % 10) + " " + UNITS[unit];
+	}
+
+	/** Pads the string with spaces on the right up to the specified width. */
+	static String padRight(const String& value, UINT32 width)
+	{
+		if (value.size() >= width)
+			return value;
+
+		return value + String(width - value.size(), ' ');
+	}
+
+	/** Pads the string with spaces on the left up to the specified width. */
+	static String padLeft(const String& value, UINT32 width)
+	{
+		if (value.size() >= width)
+			return value;
+
+		return String(width - value.size(), ' ') + value;
+	}
+
+	/** Checks do the two files have exactly the same contents. */
+	static bool compareFiles(const Path& pathA, const Path& pathB)
+	{
+		static constexpr UINT32 BUFFER_SIZE = 64 * 1024;
+
+		SPtr<DataStream> streamA = FileSystem::openFile(pathA, true);
+		SPtr<DataStream> streamB = FileSystem::openFile(pathB, true);
+
+		bool equal = streamA != nullptr && streamB != nullptr && streamA->size() == streamB->size();
+		if (equal)
+		{
+			Vector<UINT8> bufferA(BUFFER_SIZE);
+			Vector<UINT8> bufferB(BUFFER_SIZE);
+
+			while (equal && !streamA->eof())
+			{
+				size_t numReadA = streamA->read(bufferA.data(), bufferA.size());
+				size_t numReadB = streamB->read(bufferB.data(), bufferB.size());
+
+				equal = numReadA == numReadB && memcmp(bufferA.data(), bufferB.data(), numReadA) == 0;
+				if (numReadA == 0)
+					break;
+			}
+		}
+
+		if (streamA != nullptr)
+			streamA->close();
+
+		if (streamB != nullptr)
+			streamB->close();
+
+		return equal;
+	}
+
+	/** Writes the provided string into a newly created file, overwriting any existing one. */
+	static bool writeFile(const Path& path, const String& contents)
+	{
+		SPtr<DataStream> stream = FileSystem::createAndOpenFile(path);
+		if (stream == nullptr)
+			return false;
+
+		stream->writeString(contents);
+		stream->close();
+
+		return true;
+	}
+
+	void BuildReport::addRoot(const UUID& uuid, const String& reason)
+	{
+		mRoots[uuid] = reason;
+	}
+
+	void BuildReport::addEntry(const UUID& uuid, const Path& path, UINT32 typeId, const Path& packagedPath)
+	{
+		BuildReportEntry entry;
+		entry.uuid = uuid;
+		entry.path = path;
+
+		RTTITypeBase* rtti = IReflectable::_getRTTIfromTypeId(typeId);
+		if (rtti != nullptr)
+			entry.type = rtti->getRTTIName();
+		else
+			entry.type = "Unknown (" + toString(typeId) + ")";
+
+		mEntries.push_back(entry);
+		mPackagedPaths[uuid] = packagedPath;
+	}
+
+	void BuildReport::generate()
+	{
+		mTotalSize = 0;
+		mTotalStoredSize = 0;
+		for (auto& entry : mEntries)
+		{
+			const Path& packagedPath = mPackagedPaths[entry.uuid];
+			if (FileSystem::isFile(packagedPath))
+				entry.size = FileSystem::getFileSize(packagedPath);
+
+			auto iterFindStored = mStoredSizes.find(entry.uuid);
+			entry.storedSize = iterFindStored != mStoredSizes.end() ? iterFindStored->second : entry.size;
+
+			mTotalSize += entry.size;
+			mTotalStoredSize += entry.storedSize;
+
+			// Walk the references back to the build root. References form a tree as every resource is recorded only
+			// for the first resource it was found from, so this always terminates.
+			entry.chain.clear();
+			entry.chain.push_back(entry.uuid);
+
+			auto iterFind = mReferencedFrom.find(entry.uuid);
+			while (iterFind != mReferencedFrom.end())
+			{
+				entry.chain.push_back(iterFind->second);
+				iterFind = mReferencedFrom.find(iterFind->second);
+			}
+
+			std::reverse(entry.chain.begin(), entry.chain.end());
+		}
+
+		std::sort(mEntries.begin(), mEntries.end(),
+			[](const BuildReportEntry& a, const BuildReportEntry& b)
+		{
+			if (a.size != b.size)
+				return a.size > b.size;
+
+			return a.path.toString() < b.path.toString();
+		});
+
+		mEntryLookup.clear();
+		for (UINT32 i = 0; i < (UINT32)mEntries.size(); i++)
+			mEntryLookup[mEntries[i].uuid] = i;
+
+		// Find duplicates. Only files of equal size can be identical, so only those need to be hashed. Entries are
+		// sorted by size, so files of equal size are next to each other.
+		mDuplicateGroups.clear();
+		mDuplicateSize = 0;
+
+		UINT32 rangeStart = 0;
+		while (rangeStart < (UINT32)mEntries.size())
+		{
+			UINT32 rangeEnd = rangeStart + 1;
+			while (rangeEnd < (UINT32)mEntries.size() && mEntries[rangeEnd].size == mEntries[rangeStart].size)
+				rangeEnd++;
+
+			if ((rangeEnd - rangeStart) > 1 && mEntries[rangeStart].size > 0)
+			{
+				Map<UINT64, Vector<UINT32>> byHash;
+				for (UINT32 i = rangeStart; i < rangeEnd; i++)
+				{
+					UINT64 hash = ContentHash::computeFile(mPackagedPaths[mEntries[i].uuid]);
+					byHash[hash].push_back(i);
+				}
+
+				for (auto& hashEntry : byHash)
+				{
+					if (hashEntry.second.size() < 2)
+						continue;
+
+					// Equal hashes are only likely to mean equal contents, so confirm by comparing the files themselves
+					Vector<Vector<UINT32>> groups;
+					for (auto& idx : hashEntry.second)
+					{
+						const Path& packagedPath = mPackagedPaths[mEntries[idx].uuid];
+
+						auto iterFind = std::find_if(groups.begin(), groups.end(),
+							[&](const Vector<UINT32>& group)
+						{
+							return compareFiles(mPackagedPaths[mEntries[group[0]].uuid], packagedPath);
+						});
+
+						if (iterFind != groups.end())
+							iterFind->push_back(idx);
+						else
+							groups.push_back({ idx });
+					}
+
+					for (auto& group : groups)
+					{
+						if (group.size() < 2)
+							continue;
+
+						for (auto& idx : group)
+							mEntries[idx].duplicateGroup = (INT32)mDuplicateGroups.size();
+
+						mDuplicateSize += mEntries[group[0]].size * (group.size() - 1);
+						mDuplicateGroups.push_back(group);
+					}
+				}
+			}
+
+			rangeStart = rangeEnd;
+		}
+	}
+
+	String BuildReport::getDisplayName(const UUID& uuid) const
+	{
+		auto iterFind = mEntryLookup.find(uuid);
+		if (iterFind != mEntryLookup.end())
+			return mEntries[iterFind->second].path.toString();
+
+		return uuid.toString();
+	}
+
+	const String& BuildReport::getRootReason(const BuildReportEntry& entry) const
+	{
+		static const String UNKNOWN = "Unknown";
+
+		if (entry.chain.empty())
+			return UNKNOWN;
+
+		auto iterFind = mRoots.find(entry.chain[0]);
+		if (iterFind != mRoots.end())
+			return iterFind->second;
+
+		return UNKNOWN;
+	}
+
+	bool BuildReport::writeJSON(const Path& path) const
+	{
+		json resourcesJSON = json::array();
+		for (auto& entry : mEntries)
+		{
+			json chainJSON = json::array();
+			for (auto& uuid : entry.chain)
+				chainJSON.push_back(getDisplayName(uuid).c_str());
+
+			json entryJSON;
+			entryJSON["uuid"] = entry.uuid.toString().c_str();
+			entryJSON["path"] = entry.path.toString().c_str();
+			entryJSON["type"] = entry.type.c_str();
+			entryJSON["size"] = entry.size;
+			entryJSON["storedSize"] = entry.storedSize;
+			entryJSON["includedBy"] = getRootReason(entry).c_str();
+			entryJSON["chain"] = chainJSON;
+
+			if (entry.duplicateGroup != -1)
+				entryJSON["duplicateGroup"] = entry.duplicateGroup;
+
+			resourcesJSON.push_back(entryJSON);
+		}
+
+		json duplicatesJSON = json::array();
+		for (auto& group : mDuplicateGroups)
+		{
+			json pathsJSON = json::array();
+			for (auto& idx : group)
+				pathsJSON.push_back(mEntries[idx].path.toString().c_str());
+
+			json groupJSON;
+			groupJSON["size"] = mEntries[group[0]].size;
+			groupJSON["resources"] = pathsJSON;
+
+			duplicatesJSON.push_back(groupJSON);
+		}
+
+		json reportJSON;
+		reportJSON["totalSize"] = mTotalSize;
+		reportJSON["totalStoredSize"] = mTotalStoredSize;
+		reportJSON["duplicateSize"] = mDuplicateSize;
+		reportJSON["resources"] = resourcesJSON;
+		reportJSON["duplicates"] = duplicatesJSON;
+
+		String jsonString = reportJSON.dump(4).c_str();
+		return writeFile(path, jsonString);
+	}
+
+	bool BuildReport::writeText(const Path& path) const
+	{
+		StringStream output;
+		output << "Build report\n";
+		output << "Resources: " << mEntries.size() << ", total size: " << formatSize(mTotalSize) << ", stored size: " <<
+			formatSize(mTotalStoredSize) << "\n\n";
+
+		// Size by type
+		struct TypeTotal
+		{
+			String type;
+			UINT32 count = 0;
+			UINT64 size = 0;
+			UINT64 storedSize = 0;
+		};
+
+		UnorderedMap<String, TypeTotal> typeTotalsLookup;
+		for (auto& entry : mEntries)
+		{
+			TypeTotal& total = typeTotalsLookup[entry.type];
+			total.type = entry.type;
+			total.count++;
+			total.size += entry.size;
+			total.storedSize += entry.storedSize;
+		}
+
+		Vector<TypeTotal> typeTotals;
+		for (auto& totalEntry : typeTotalsLookup)
+			typeTotals.push_back(totalEntry.second);
+
+		std::sort(typeTotals.begin(), typeTotals.end(),
+			[](const TypeTotal& a, const TypeTotal& b) { return a.size > b.size; });
+
+		output << "Size by type:\n";
+		for (auto& total : typeTotals)
+		{
+			output << "  " << padRight(total.type, 24) << padLeft(formatSize(total.size), 10) <<
+				padLeft(formatSize(total.storedSize), 12) << " stored  (" << total.count <<
+				(total.count == 1 ? " resource)\n" : " resources)\n");
+		}
+
+		// All resources, largest first
+		output << "\nResources by size (size, stored size, type, path):\n";
+		for (auto& entry : mEntries)
+		{
+			output << "  " << padLeft(formatSize(entry.size), 10) << padLeft(formatSize(entry.storedSize), 12) <<
+				"  " << padRight(entry.type, 24) << entry.path.toString() << "\n";
+
+			output << "  " << String(48, ' ') << getRootReason(entry);
+			if (entry.chain.size() > 1)
+			{
+				output << ": ";
+				for (UINT32 i = 0; i < (UINT32)entry.chain.size(); i++)
+				{
+					if (i > 0)
+						output << " > ";
+
+					output << getDisplayName(entry.chain[i]);
+				}
+			}
+
+			output << "\n";
+		}
+
+		// Duplicates
+		output << "\nDuplicates: ";
+		if (mDuplicateGroups.empty())
+			output << "none\n";
+		else
+		{
+			output << mDuplicateGroups.size() << (mDuplicateGroups.size() == 1 ? " group, " : " groups, ") <<
+				formatSize(mDuplicateSize) << " could be saved by keeping a single copy of each\n";
+
+			for (auto& group : mDuplicateGroups)
+			{
+				output << "  " << group.size() << " identical resources of " << formatSize(mEntries[group[0]].size) <<
+					":\n";
+
+				for (auto& idx : group)
+					output << "    " << mEntries[idx].path.toString() << "\n";
+			}
+		}
+
+		return writeFile(path, output.str());
+	}
+}
@@ -0,0 +1,145 @@
+//********************************** Banshee Engine (www.banshee3d.com) **************************************************//
+//**************** Copyright (c) 2016 Marko Pintera (marko.pintera@gmail.com). All rights reserved. **********************//
+#pragma once
+
+#include "BsEditorPrerequisites.h"
+
+namespace bs
+{
+	/** @addtogroup Build
+	 *  @{
+	 */
+
+	/** Information about a single resource packaged into a build, as listed in a BuildReport. */
+	struct BuildReportEntry
+	{
+		UUID uuid; /**< UUID of the resource. */
+		Path path; /**< Path to the resource in the project library, relative to the resources folder. */
+		String type; /**< Name of the resource type. */
+		UINT64 size = 0; /**< Size of the packaged resource file, in bytes. */
+
+		/**
+		 * Size of the resource as stored in the build, in bytes. Smaller than @p size if the resource was compressed
+		 * when packed into the resource archive.
+		 */
+		UINT64 storedSize = 0;
+
+		/**
+		 * UUIDs of resources that cause the resource to be included in the build. Starts with the build root (main
+		 * scene or a resource included in the build) and ends with the resource itself, with every resource referencing
+		 * the next one.
+		 */
+		Vector<UUID> chain;
+
+		/** Index of the group of resources with identical contents this resource belongs to, or -1 if it is unique. */
+		INT32 duplicateGroup = -1;
+	};
+
+	/**
+	 * Lists the resources packaged into a build, along with their sizes, types and the reason they were included, and
+	 * finds resources with byte-identical contents stored under different UUIDs. Resources with matching hashes are
+	 * compared byte by byte before being reported as identical. The report is written both as JSON for
+	 * use by external tools, and as human-readable text sorted by size.
+	 */
+	class BS_ED_EXPORT BuildReport
+	{
+	public:
+		/**
+		 * Registers a resource that was explicitly included in the build, as opposed to being referenced by another
+		 * resource. If the same resource is registered more than once the last provided reason is kept.
+		 *
+		 * @param[in]	uuid	UUID of the resource.
+		 * @param[in]	reason	Why the resource was included, e.g. "Main scene".
+		 */
+		void addRoot(const UUID& uuid, const String& reason);
+
+		/**
+		 * Sets the references through which the resources were found, as output by
+		 * ProjectLibrary::findReferencedResources(). Used for determining why each resource was included.
+		 */
+		void setReferences(UnorderedMap<UUID, UUID> referencedFrom) { mReferencedFrom = std::move(referencedFrom); }
+
+		/**
+		 * Adds a packaged resource to the report.
+		 *
+		 * @param[in]	uuid			UUID of the resource.
+		 * @param[in]	path			Path to the resource in the project library, relative to the resources folder.
+		 * @param[in]	typeId			RTTI type ID of the resource.
+		 * @param[in]	packagedPath	Absolute path to the packaged resource file.
+		 */
+		void addEntry(const UUID& uuid, const Path& path, UINT32 typeId, const Path& packagedPath);
+
+		/**
+		 * Sets the sizes of the resources as stored in the resource archive, if the build packs its resources into one.
+		 * Resources without a provided size are considered to be stored as is.
+		 */
+		void setStoredSizes(UnorderedMap<UUID, UINT64> storedSizes) { mStoredSizes = std::move(storedSizes); }
+
+		/**
+		 * Determines the sizes of all the added resources, the reasons they were included and the duplicates among
+		 * them. Must be called after all the resources have been packaged, and before the report is written.
+		 */
+		void generate();
+
+		/**
+		 * Writes the report as JSON.
+		 *
+		 * @param[in]	path	Absolute path to the file to write.
+		 * @return				True if the file was successfully written.
+		 */
+		bool writeJSON(const Path& path) const;
+
+		/**
+		 * Writes the report as human-readable text.
+		 *
+		 * @param[in]	path	Absolute path to the file to write.
+		 * @return				True if the file was successfully written.
+		 */
+		bool writeText(const Path& path) const;
+
+		/** Returns all the resources in the report, sorted by size from the largest. Valid after generate(). */
+		const Vector<BuildReportEntry>& getEntries() const { return mEntries; }
+
+		/** Returns the total size of all the packaged resources, in bytes. Valid after generate(). */
+		UINT64 getTotalSize() const { return mTotalSize; }
+
+		/** Returns the total size of all the resources as stored in the build, in bytes. Valid after generate(). */
+		UINT64 getTotalStoredSize() const { return mTotalStoredSize; }
+
+		/**
+		 * Returns the number of bytes that could be saved by keeping only a single copy of each group of duplicate
+		 * resources. Valid after generate().
+		 */
+		UINT64 getDuplicateSize() const { return mDuplicateSize; }
+
+		/** Returns the number of groups of resources with identical contents. Valid after generate(). */
+		UINT32 getNumDuplicateGroups() const { return (UINT32)mDuplicateGroups.size(); }
+
+		/** Name of the JSON report file. */
+		static const char* JSON_NAME;
+
+		/** Name of the text report file. */
+		static const char* TEXT_NAME;
+
+	private:
+		/** Returns the library path of the resource with the specified UUID, or the UUID itself if not known. */
+		String getDisplayName(const UUID& uuid) const;
+
+		/** Returns why the build root at the start of the entry's chain was included in the build. */
+		const String& getRootReason(const BuildReportEntry& entry) const;
+
+		Vector<BuildReportEntry> mEntries;
+		UnorderedMap<UUID, Path> mPackagedPaths;
+		UnorderedMap<UUID, UINT64> mStoredSizes;
+		UnorderedMap<UUID, UINT32> mEntryLookup;
+		UnorderedMap<UUID, String> mRoots;
+		UnorderedMap<UUID, UUID> mReferencedFrom;
+		Vector<Vector<UINT32>> mDuplicateGroups; /**< Indices into mEntries of resources with identical contents. */
+
+		UINT64 mTotalSize = 0;
+		UINT64 mTotalStoredSize = 0;
+		UINT64 mDuplicateSize = 0;
+	};
+
+	/** @} */
+}
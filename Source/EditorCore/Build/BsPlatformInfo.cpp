@@ -6,12 +6,27 @@
 namespace bs
 {
 	PlatformInfo::PlatformInfo()
-		:type(PlatformType::Windows), fullscreen(true), windowedWidth(1280), windowedHeight(720)
-	{ }
+		:type(PlatformType::Windows), fullscreen(true), windowedWidth(1280), windowedHeight(720), debug(false)
+		, packResources(false), defaultCompression(ArchiveCompression::Snappy)
+	{
+		// Texture and audio data is usually already compressed in a format the hardware or the decoder reads directly,
+		// and compresses poorly any further
+		typeCompression[TID_Texture] = ArchiveCompression::None;
+		typeCompression[TID_AudioClip] = ArchiveCompression::None;
+	}
 
 	PlatformInfo::~PlatformInfo()
 	{ }
 
+	ArchiveCompression PlatformInfo::getCompression(UINT32 typeId) const
+	{
+		auto iterFind = typeCompression.find(typeId);
+		if (iterFind != typeCompression.end())
+			return iterFind->second;
+
+		return defaultCompression;
+	}
+
 	RTTITypeBase* PlatformInfo::getRTTIStatic()
 	{
 		return PlatformInfoRTTI::instance();
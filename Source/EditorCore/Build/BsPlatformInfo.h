@@ -5,6 +5,7 @@
 #include "BsEditorPrerequisites.h"
 #include "Reflection/BsIReflectable.h"
 #include "RenderAPI/BsVideoModeInfo.h"
+#include "Build/BsResourceArchive.h"
 
 namespace bs
 {
@@ -32,6 +33,18 @@ namespace bs
 		UINT32 windowedWidth; /**< Width of the window if not starting the application in fullscreen. */
 		UINT32 windowedHeight; /**< Height of the window if not starting the application in fullscreen. */
 		bool debug; /**< Determines should the scripts be output in debug mode (worse performance but better error reporting). */
+		bool packResources; /**< If true all resources are packed into a single archive, instead of one file each. */
+
+		/** 
+		 * Compression used for resources packed into an archive, unless overriden for their type by typeCompression.
+		 */
+		ArchiveCompression defaultCompression;
+
+		/** Compression used for resources of specific types packed into an archive, keyed by resource RTTI type ID. */
+		Map<UINT32, ArchiveCompression> typeCompression;
+
+		/** Returns the compression to use for a resource packed into an archive, based on its RTTI type ID. */
+		ArchiveCompression getCompression(UINT32 typeId) const;
 
 		/************************************************************************/
 		/* 								RTTI		                     		*/
@@ -0,0 +1,400 @@
+//********************************** Banshee Engine (www.banshee3d.com) **************************************************//
+//**************** Copyright (c) 2016 Marko Pintera (marko.pintera@gmail.com). All rights reserved. **********************//
+#include "Build/BsResourceArchive.h"
+#include "FileSystem/BsFileSystem.h"
+#include "FileSystem/BsDataStream.h"
+#include "Utility/BsCompression.h"
+#include "Utility/BsTimer.h"
+#include "Debug/BsDebug.h"
+
+namespace bs
+{
+	const char* ResourceArchiveWriter::ARCHIVE_NAME = ARCHIVE_FILE_NAME;
+	const char* ResourceArchiveWriter::LOAD_TRACE_NAME = LOAD_TRACE_FILE_NAME;
+	const char* ResourceArchiveWriter::PREFETCH_LIST_NAME = PREFETCH_LIST_FILE_NAME;
+
+	/** Size of the buffer used for copying uncompressed entries into the archive. */
+	static constexpr UINT32 ARCHIVE_COPY_BUFFER_SIZE = 1024 * 1024;
+
+	/** Writes zeroes to the stream until its size is a multiple of the archive alignment. */
+	static bool writeArchivePadding(const SPtr<DataStream>& stream, UINT64& offset)
+	{
+		static const UINT8 ZEROES[ResourceArchiveWriter::ALIGNMENT] = { };
+
+		UINT64 padding = (ResourceArchiveWriter::ALIGNMENT - offset % ResourceArchiveWriter::ALIGNMENT) %
+			ResourceArchiveWriter::ALIGNMENT;
+
+		if (padding == 0)
+			return true;
+
+		offset += padding;
+		return stream->write(ZEROES, (size_t)padding) == padding;
+	}
+
+	/** Copies the remaining contents of the input stream into the output stream. Returns the number of bytes copied. */
+	static UINT64 copyArchiveEntry(const SPtr<DataStream>& input, const SPtr<DataStream>& output, Vector<UINT8>& buffer)
+	{
+		UINT64 total = 0;
+		while (!input->eof())
+		{
+			size_t numRead = input->read(buffer.data(), buffer.size());
+			if (numRead == 0)
+				break;
+
+			if (output->write(buffer.data(), numRead) != numRead)
+				return 0;
+
+			total += numRead;
+		}
+
+		return total;
+	}
+
+	/** Reads the index of an existing archive. Returns false if the archive is missing or invalid. */
+	static bool readArchiveIndex(const Path& path, Vector<ArchiveIndexEntry>& index)
+	{
+		if (!FileSystem::isFile(path))
+			return false;
+
+		SPtr<DataStream> stream = FileSystem::openFile(path, true);
+		if (stream == nullptr)
+			return false;
+
+		ArchiveHeader header;
+		ArchiveFooter footer;
+		UINT64 size = stream->size();
+
+		bool valid = size >= sizeof(header) + sizeof(footer) &&
+			stream->read(&header, sizeof(header)) == sizeof(header) && header.magic == ARCHIVE_MAGIC &&
+			header.version == ARCHIVE_VERSION;
+
+		if (valid)
+		{
+			stream->seek((size_t)(size - sizeof(footer)));
+			valid = stream->read(&footer, sizeof(footer)) == sizeof(footer) && footer.magic == ARCHIVE_MAGIC &&
+				footer.indexOffset + (UINT64)footer.numEntries * sizeof(ArchiveIndexEntry) + sizeof(footer) == size;
+		}
+
+		if (valid)
+		{
+			size_t indexSize = footer.numEntries * sizeof(ArchiveIndexEntry);
+			index.resize(footer.numEntries);
+
+			stream->seek((size_t)footer.indexOffset);
+			valid = stream->read(index.data(), indexSize) == indexSize;
+		}
+
+		stream->close();
+		return valid;
+	}
+
+	void ResourceArchiveWriter::addEntry(const UUID& uuid, const Path& source, ArchiveCompression compression)
+	{
+		mEntries.push_back({ uuid, source, compression });
+	}
+
+	void ResourceArchiveWriter::setLoadOrder(const Vector<UUID>& order, UINT32 numPrefetched)
+	{
+		mLoadOrder = order;
+		mNumPrefetched = std::min(numPrefetched, (UINT32)order.size());
+	}
+
+	bool ResourceArchiveWriter::isUpToDate(const Path& path)
+	{
+		// Missing resources will never be written, so they shouldn't cause the archive to be written on every build
+		removeMissingEntries();
+
+		Vector<ArchiveIndexEntry> index;
+		if (!readArchiveIndex(path, index) || index.size() != mEntries.size())
+			return false;
+
+		// Check the existing entries are laid out in the same order
+		Vector<const QueuedEntry*> layout = getLayout();
+
+		Vector<ArchiveIndexEntry> entriesByOffset = index;
+		std::sort(entriesByOffset.begin(), entriesByOffset.end(),
+			[](const ArchiveIndexEntry& a, const ArchiveIndexEntry& b) { return a.offset < b.offset; });
+
+		for (UINT32 i = 0; i < (UINT32)layout.size(); i++)
+		{
+			if (layout[i]->uuid != entriesByOffset[i].uuid)
+				return false;
+		}
+
+		std::time_t archiveModifiedTime = FileSystem::getLastModifiedTime(path);
+		for (auto& entry : mEntries)
+		{
+			auto iterFind = std::lower_bound(index.begin(), index.end(), entry.uuid, &compareArchiveEntryUUID);
+
+			if (iterFind == index.end() || iterFind->uuid != entry.uuid)
+				return false;
+
+			if (iterFind->requestedCompression != (UINT32)entry.compression)
+				return false;
+
+			if (FileSystem::getLastModifiedTime(entry.source) > archiveModifiedTime)
+				return false;
+		}
+
+		return true;
+	}
+
+	bool ResourceArchiveWriter::write(const Path& path)
+	{
+		mSummary = ArchiveSummary();
+		removeMissingEntries();
+
+		Path tempPath = path;
+		tempPath.setFilename(path.getFilename() + ".tmp");
+
+		SPtr<DataStream> stream = FileSystem::createAndOpenFile(tempPath);
+		if (stream == nullptr)
+			return false;
+
+		ArchiveHeader header;
+		header.magic = ARCHIVE_MAGIC;
+		header.version = ARCHIVE_VERSION;
+
+		UINT64 offset = sizeof(header);
+		bool written = stream->write(&header, sizeof(header)) == sizeof(header) && writeArchivePadding(stream, offset);
+
+		// Entry data is written in the layout order, only the index is sorted
+		Vector<ArchiveIndexEntry> index;
+		index.reserve(mEntries.size());
+
+		Vector<UINT8> buffer(ARCHIVE_COPY_BUFFER_SIZE);
+		for (auto& entryPtr : getLayout())
+		{
+			const QueuedEntry& entry = *entryPtr;
+
+			if (!written)
+				break;
+
+			// Leaving the entry out would make the archive out of date on every build, so fail the write instead
+			SPtr<DataStream> input = FileSystem::openFile(entry.source, true);
+			if (input == nullptr)
+			{
+				LOGERR("Unable to add resource to archive, cannot open: " + entry.source.toString());
+				written = false;
+				break;
+			}
+
+			ArchiveIndexEntry indexEntry{};
+			indexEntry.uuid = entry.uuid;
+			indexEntry.offset = offset;
+			indexEntry.uncompressedSize = input->size();
+			indexEntry.compression = (UINT32)ArchiveCompression::None;
+			indexEntry.requestedCompression = (UINT32)entry.compression;
+
+			SPtr<MemoryDataStream> compressed;
+			UINT64 decompressionTime = 0;
+			if (entry.compression == ArchiveCompression::Snappy)
+			{
+				Timer compressionTimer;
+				compressed = Compression::compress(input);
+				mSummary.compressionTime += compressionTimer.getMilliseconds();
+
+				// Decompress the entry right away, both to make sure it decompresses to the original data, and to
+				// measure how much the compression will slow down loading
+				if (compressed != nullptr)
+				{
+					SPtr<DataStream> compressedStream = compressed;
+					compressedStream->seek(0);
+
+					Timer decompressionTimer;
+					SPtr<MemoryDataStream> decompressed = Compression::decompress(compressedStream);
+					decompressionTime = decompressionTimer.getMicroseconds();
+
+					if (decompressed == nullptr || (UINT64)decompressed->size() != indexEntry.uncompressedSize)
+					{
+						LOGWRN("Compressed resource doesn't match the original, storing it uncompressed: " +
+							entry.source.toString());
+
+						compressed = nullptr;
+					}
+				}
+			}
+
+			// Only keep the compressed data if it is actually smaller
+			if (compressed != nullptr && (UINT64)compressed->size() < indexEntry.uncompressedSize)
+			{
+				indexEntry.compression = (UINT32)ArchiveCompression::Snappy;
+				indexEntry.size = compressed->size();
+
+				written = stream->write(compressed->getPtr(), compressed->size()) == compressed->size();
+
+				mSummary.numCompressed++;
+				mSummary.decompressionTime += decompressionTime;
+			}
+			else
+			{
+				input->seek(0);
+				indexEntry.size = copyArchiveEntry(input, stream, buffer);
+
+				written = indexEntry.size == indexEntry.uncompressedSize;
+			}
+
+			input->close();
+
+			mSummary.numEntries++;
+			mSummary.uncompressedBytes += indexEntry.uncompressedSize;
+			mSummary.storedBytes += indexEntry.size;
+
+			offset += indexEntry.size;
+			written = written && writeArchivePadding(stream, offset);
+
+			index.push_back(indexEntry);
+		}
+
+		std::sort(index.begin(), index.end(), &compareArchiveEntries);
+
+		ArchiveFooter footer;
+		footer.indexOffset = offset;
+		footer.numEntries = (UINT32)index.size();
+		footer.magic = ARCHIVE_MAGIC;
+
+		size_t indexSize = index.size() * sizeof(ArchiveIndexEntry);
+		written = written && stream->write(index.data(), indexSize) == indexSize &&
+			stream->write(&footer, sizeof(footer)) == sizeof(footer);
+
+		stream->close();
+
+		if (!written)
+		{
+			FileSystem::remove(tempPath);
+			return false;
+		}
+
+		FileSystem::move(tempPath, path, true);
+		return true;
+	}
+
+	bool ResourceArchiveWriter::writePrefetchList(const Path& path) const
+	{
+		UnorderedSet<UUID> prefetched(mLoadOrder.begin(), mLoadOrder.begin() + mNumPrefetched);
+
+		Vector<UUID> uuids;
+		for (auto& entry : getLayout())
+		{
+			if (prefetched.find(entry->uuid) != prefetched.end())
+				uuids.push_back(entry->uuid);
+		}
+
+		PrefetchListHeader header;
+		header.magic = PREFETCH_LIST_MAGIC;
+		header.version = PREFETCH_LIST_VERSION;
+		header.numEntries = (UINT32)uuids.size();
+
+		SPtr<DataStream> stream = FileSystem::createAndOpenFile(path);
+		if (stream == nullptr)
+			return false;
+
+		size_t uuidsSize = uuids.size() * sizeof(UUID);
+		bool written = stream->write(&header, sizeof(header)) == sizeof(header) &&
+			stream->write(uuids.data(), uuidsSize) == uuidsSize;
+		stream->close();
+
+		return written;
+	}
+
+	bool ResourceArchiveWriter::readLoadTrace(const Path& path, Vector<UUID>& order, UINT32& numStartup)
+	{
+		if (!FileSystem::isFile(path))
+			return false;
+
+		SPtr<DataStream> stream = FileSystem::openFile(path, true);
+		if (stream == nullptr)
+			return false;
+
+		LoadTraceHeader header;
+		bool valid = stream->read(&header, sizeof(header)) == sizeof(header) && header.magic == LOAD_TRACE_MAGIC &&
+			header.version == LOAD_TRACE_VERSION && header.numStartupRecords <= header.numRecords &&
+			(UINT64)stream->size() == sizeof(header) + (UINT64)header.numRecords * sizeof(LoadTraceRecord);
+
+		Vector<LoadTraceRecord> records;
+		if (valid)
+		{
+			records.resize(header.numRecords);
+
+			size_t recordsSize = records.size() * sizeof(LoadTraceRecord);
+			valid = stream->read(records.data(), recordsSize) == recordsSize;
+		}
+
+		stream->close();
+
+		if (!valid)
+			return false;
+
+		order.clear();
+		order.reserve(records.size());
+
+		for (auto& record : records)
+			order.push_back(record.uuid);
+
+		numStartup = header.numStartupRecords;
+		return true;
+	}
+
+	void ResourceArchiveWriter::removeMissingEntries()
+	{
+		auto iterRemove = std::remove_if(mEntries.begin(), mEntries.end(),
+			[](const QueuedEntry& entry)
+		{
+			if (FileSystem::isFile(entry.source))
+				return false;
+
+			LOGWRN("Unable to add resource to archive, file is missing: " + entry.source.toString());
+			return true;
+		});
+
+		mEntries.erase(iterRemove, mEntries.end());
+	}
+
+	bool ResourceArchiveWriter::readStoredSizes(const Path& path, UnorderedMap<UUID, UINT64>& sizes)
+	{
+		Vector<ArchiveIndexEntry> index;
+		if (!readArchiveIndex(path, index))
+			return false;
+
+		sizes.clear();
+		for (auto& entry : index)
+			sizes[entry.uuid] = entry.size;
+
+		return true;
+	}
+
+	Vector<const ResourceArchiveWriter::QueuedEntry*> ResourceArchiveWriter::getLayout() const
+	{
+		// Only the first load of a resource matters, later loads are of a resource that was unloaded in the meantime
+		UnorderedMap<UUID, UINT32> loadOrder;
+		for (UINT32 i = 0; i < (UINT32)mLoadOrder.size(); i++)
+			loadOrder.insert(std::make_pair(mLoadOrder[i], i));
+
+		Vector<const QueuedEntry*> layout;
+		layout.reserve(mEntries.size());
+
+		for (auto& entry : mEntries)
+			layout.push_back(&entry);
+
+		// Resources that weren't loaded are sorted by UUID, so the layout doesn't change between builds
+		std::sort(layout.begin(), layout.end(),
+			[&loadOrder](const QueuedEntry* a, const QueuedEntry* b)
+		{
+			auto iterFindA = loadOrder.find(a->uuid);
+			auto iterFindB = loadOrder.find(b->uuid);
+
+			bool loadedA = iterFindA != loadOrder.end();
+			bool loadedB = iterFindB != loadOrder.end();
+
+			if (loadedA != loadedB)
+				return loadedA;
+
+			if (loadedA)
+				return iterFindA->second < iterFindB->second;
+
+			return memcmp(&a->uuid, &b->uuid, sizeof(UUID)) < 0;
+		});
+
+		return layout;
+	}
+}
@@ -0,0 +1,154 @@
+//********************************** Banshee Engine (www.banshee3d.com) **************************************************//
+//**************** Copyright (c) 2016 Marko Pintera (marko.pintera@gmail.com). All rights reserved. **********************//
+#pragma once
+
+#include "BsEditorPrerequisites.h"
+#include "Build/BsResourceArchiveFormat.h"
+
+namespace bs
+{
+	/** @addtogroup Build
+	 *  @{
+	 */
+
+	/** Statistics about a single archive written by the ResourceArchiveWriter. */
+	struct ArchiveSummary
+	{
+		UINT32 numEntries = 0; /**< Number of entries in the archive. */
+		UINT32 numCompressed = 0; /**< Number of entries stored compressed. */
+		UINT64 uncompressedBytes = 0; /**< Total size of all entries before compression, in bytes. */
+		UINT64 storedBytes = 0; /**< Total size of all entries as stored in the archive, in bytes. */
+		UINT64 compressionTime = 0; /**< Time spent compressing the entries, in milliseconds. */
+
+		/**
+		 * Time spent decompressing all the compressed entries, in microseconds. Each compressed entry is decompressed
+		 * once after being compressed, giving an estimate of the time the compression adds when loading the resources.
+		 */
+		UINT64 decompressionTime = 0;
+	};
+
+	/**
+	 * Writes resources of a build into a single archive file, so the game can load them without opening a separate file
+	 * for each resource.
+	 *
+	 * The archive starts with a header, followed by the resource data, followed by an index of fixed size records
+	 * sorted by resource UUID and a footer pointing to the index. The index is stored contiguously so it can be read
+	 * (or mapped) in a single operation and searched in place, and every entry starts at an offset aligned to ALIGNMENT
+	 * bytes. Each entry contains the unmodified contents of a resource file as saved by Resources, optionally
+	 * compressed.
+	 *
+	 * Entries are laid out in the order the game loaded them in, if a load order was recorded, so the resources needed
+	 * on startup are read sequentially. Resources loaded during startup are also written into a prefetch list, which
+	 * the game reads ahead of time.
+	 *
+	 * @note	The format is defined in BsResourceArchiveFormat.h, which the game reads the archive through as well.
+	 */
+	class BS_ED_EXPORT ResourceArchiveWriter
+	{
+	public:
+		/**
+		 * Queues a resource to be written into the archive.
+		 *
+		 * @param[in]	uuid		UUID of the resource.
+		 * @param[in]	source		Absolute path to the resource file, as saved by Resources.
+		 * @param[in]	compression	Method to compress the resource data with.
+		 */
+		void addEntry(const UUID& uuid, const Path& source, ArchiveCompression compression = ArchiveCompression::None);
+
+		/**
+		 * Sets the order to lay out the entries of the archive in. Entries not in the load order are placed after the
+		 * ones that are, sorted by UUID.
+		 *
+		 * @param[in]	order			UUIDs of resources in the order they were loaded in by the game.
+		 * @param[in]	numPrefetched	Number of resources, from the start of @p order, to write into the prefetch
+		 *								list.
+		 */
+		void setLoadOrder(const Vector<UUID>& order, UINT32 numPrefetched);
+
+		/**
+		 * Checks does the archive at the specified path already contain exactly the queued resources, compressed as
+		 * requested and laid out in the requested order, with none of the resource files modified since the archive was
+		 * written. Queued resources whose files are missing are removed from the queue first, as they can't be written.
+		 *
+		 * @param[in]	path	Absolute path to the archive file.
+		 * @return				True if the archive doesn't need to be written again.
+		 */
+		bool isUpToDate(const Path& path);
+
+		/**
+		 * Writes all the queued resources into an archive at the specified path. The archive is first written to a
+		 * temporary location and then moved over the existing one, so a failed write never leaves a partial archive
+		 * behind. Queued resources whose files are missing are skipped, while failing to read an existing file fails
+		 * the write.
+		 *
+		 * @param[in]	path	Absolute path to the archive file.
+		 * @return				True if the archive was successfully written.
+		 */
+		bool write(const Path& path);
+
+		/**
+		 * Writes the list of resources the game should prefetch on startup, as determined by the load order.
+		 *
+		 * @param[in]	path	Absolute path to the prefetch list.
+		 * @return				True if the file was successfully written.
+		 */
+		bool writePrefetchList(const Path& path) const;
+
+		/**
+		 * Reads a load trace recorded by the game.
+		 *
+		 * @param[in]	path		Absolute path to the load trace file.
+		 * @param[out]	order		UUIDs of the loaded resources, in the order they were loaded in.
+		 * @param[out]	numStartup	Number of resources, from the start of @p order, loaded during the game startup.
+		 * @return					True if the trace was read, false if the file is missing or invalid.
+		 */
+		static bool readLoadTrace(const Path& path, Vector<UUID>& order, UINT32& numStartup);
+
+		/**
+		 * Reads the sizes of the entries of an existing archive, as stored in the archive.
+		 *
+		 * @param[in]	path	Absolute path to the archive file.
+		 * @param[out]	sizes	Stored (possibly compressed) size of each entry in bytes, keyed by resource UUID.
+		 * @return				True if the sizes were read, false if the archive is missing or invalid.
+		 */
+		static bool readStoredSizes(const Path& path, UnorderedMap<UUID, UINT64>& sizes);
+
+		/** Returns statistics about the last archive written by write(). */
+		const ArchiveSummary& getSummary() const { return mSummary; }
+
+		/** Name of the archive file in the packaged resources folder. */
+		static const char* ARCHIVE_NAME;
+
+		/** Name of the load trace file the game records into the packaged resources folder. */
+		static const char* LOAD_TRACE_NAME;
+
+		/** Name of the prefetch list in the packaged resources folder. */
+		static const char* PREFETCH_LIST_NAME;
+
+		/** Alignment of the offsets of individual entries in the archive, in bytes. */
+		static constexpr UINT32 ALIGNMENT = ARCHIVE_ALIGNMENT;
+
+	private:
+		/** Single resource queued for writing. */
+		struct QueuedEntry
+		{
+			UUID uuid;
+			Path source;
+			ArchiveCompression compression;
+		};
+
+		/** Removes queued entries whose resource files don't exist, logging a warning for each. */
+		void removeMissingEntries();
+
+		/** Returns the queued entries, in the order they should be laid out in the archive. */
+		Vector<const QueuedEntry*> getLayout() const;
+
+		Vector<QueuedEntry> mEntries;
+		ArchiveSummary mSummary;
+
+		Vector<UUID> mLoadOrder;
+		UINT32 mNumPrefetched = 0;
+	};
+
+	/** @} */
+}
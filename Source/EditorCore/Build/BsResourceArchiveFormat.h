@@ -0,0 +1,124 @@
+//********************************** Banshee Engine (www.banshee3d.com) **************************************************//
+//**************** Copyright (c) 2016 Marko Pintera (marko.pintera@gmail.com). All rights reserved. **********************//
+#pragma once
+
+// Layout of the resource archive and the files that accompany it. Written by ResourceArchiveWriter in the editor and
+// read by ResourceArchive in the game, so only the core framework may be included here.
+#include "BsCorePrerequisites.h"
+
+namespace bs
+{
+	/** @addtogroup Build
+	 *  @{
+	 */
+
+	/** Methods that can be used for compressing individual entries of a resource archive. */
+	enum class ArchiveCompression
+	{
+		None, /**< Entry is stored as is. */
+		Snappy /**< Entry is compressed using the engine's built-in compression (Snappy). */
+	};
+
+	/** Name of the archive file in the packaged resources folder. */
+	static constexpr const char* ARCHIVE_FILE_NAME = "Resources.archive";
+
+	/** Name of the load trace file the game records into the packaged resources folder. */
+	static constexpr const char* LOAD_TRACE_FILE_NAME = "LoadOrder.trace";
+
+	/** Name of the prefetch list in the packaged resources folder. */
+	static constexpr const char* PREFETCH_LIST_FILE_NAME = "Prefetch.list";
+
+	/** Identifier at the start and at the end of every resource archive ("BSRA"). */
+	static constexpr UINT32 ARCHIVE_MAGIC = 0x41525342;
+
+	/** Version of the resource archive format. Archives of a different version are not loaded. */
+	static constexpr UINT32 ARCHIVE_VERSION = 1;
+
+	/** Alignment of the offsets of individual entries in the archive, in bytes. */
+	static constexpr UINT32 ARCHIVE_ALIGNMENT = 16;
+
+	/** Header at the start of the archive. */
+	struct ArchiveHeader
+	{
+		UINT32 magic;
+		UINT32 version;
+	};
+
+	/** Record of a single entry in the archive index. */
+	struct ArchiveIndexEntry
+	{
+		UUID uuid;
+		UINT64 offset; /**< Offset of the entry data from the start of the archive. */
+		UINT64 size; /**< Size of the entry data as stored in the archive. */
+		UINT64 uncompressedSize; /**< Size of the entry data once decompressed. */
+		UINT32 compression; /**< ArchiveCompression the entry data was compressed with. */
+
+		/**
+		 * ArchiveCompression requested for the entry when the archive was written. Differs from the actual compression
+		 * if compressing the entry didn't make it smaller.
+		 */
+		UINT32 requestedCompression;
+	};
+
+	/**
+	 * Footer at the end of the archive. Kept at the end so the archive can be written in a single pass, without knowing
+	 * the sizes of the (compressed) entries up front.
+	 */
+	struct ArchiveFooter
+	{
+		UINT64 indexOffset; /**< Offset of the index from the start of the archive. */
+		UINT32 numEntries;
+		UINT32 magic;
+	};
+
+	/** Identifier at the start of every load trace file ("BSLT"). */
+	static constexpr UINT32 LOAD_TRACE_MAGIC = 0x544C5342;
+
+	/** Version of the load trace format. */
+	static constexpr UINT32 LOAD_TRACE_VERSION = 1;
+
+	/** Header at the start of the load trace file, followed by the load records. */
+	struct LoadTraceHeader
+	{
+		UINT32 magic;
+		UINT32 version;
+		UINT32 numRecords;
+		UINT32 numStartupRecords; /**< Number of records, from the start, loaded before the game startup finished. */
+	};
+
+	/** Single resource load, as recorded by the game. */
+	struct LoadTraceRecord
+	{
+		UUID uuid;
+		UINT64 time; /**< Time the load started at, in microseconds since recording started. */
+		UINT64 duration; /**< Time the load took, including the dependencies, in microseconds. */
+	};
+
+	/** Identifier at the start of every prefetch list ("BSPL"). */
+	static constexpr UINT32 PREFETCH_LIST_MAGIC = 0x4C505342;
+
+	/** Version of the prefetch list format. */
+	static constexpr UINT32 PREFETCH_LIST_VERSION = 1;
+
+	/** Header at the start of the prefetch list, followed by the UUIDs to prefetch. */
+	struct PrefetchListHeader
+	{
+		UINT32 magic;
+		UINT32 version;
+		UINT32 numEntries;
+	};
+
+	/** Compares index entries by UUID, in the order the archive index is sorted in. */
+	inline bool compareArchiveEntries(const ArchiveIndexEntry& a, const ArchiveIndexEntry& b)
+	{
+		return memcmp(&a.uuid, &b.uuid, sizeof(UUID)) < 0;
+	}
+
+	/** Compares an index entry with a UUID, in the order the archive index is sorted in. */
+	inline bool compareArchiveEntryUUID(const ArchiveIndexEntry& entry, const UUID& uuid)
+	{
+		return memcmp(&entry.uuid, &uuid, sizeof(UUID)) < 0;
+	}
+
+	/** @} */
+}
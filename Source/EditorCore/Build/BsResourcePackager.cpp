@@ -0,0 +1,402 @@
+//********************************** Banshee Engine (www.banshee3d.com) **************************************************//
+//**************** Copyright (c) 2016 Marko Pintera (marko.pintera@gmail.com). All rights reserved. **********************//
+#include "Build/BsResourcePackager.h"
+#include "Utility/BsContentHash.h"
+#include "Utility/BsTimer.h"
+#include "Threading/BsTaskScheduler.h"
+#include "FileSystem/BsFileSystem.h"
+#include "FileSystem/BsDataStream.h"
+#include "Debug/BsDebug.h"
+#include <atomic>
+
+namespace bs
+{
+	const char* ResourcePackager::MANIFEST_NAME = "Package.manifest";
+
+	/** Identifier at the start of every package manifest file ("BSPM"). */
+	static constexpr UINT32 PACKAGE_MANIFEST_MAGIC = 0x4D505342;
+
+	/**
+	 * Version of the package manifest. Must be increased whenever the format of the manifest or of the packaged files
+	 * changes, in which case all files are written again.
+	 */
+	static constexpr UINT32 PACKAGE_MANIFEST_VERSION = 1;
+
+	/** Maximum number of worker threads used for hashing and copying files. */
+	static constexpr UINT32 MAX_PACKAGE_WORKERS = 8;
+
+	/** State of a source file as of the last time it was hashed. */
+	struct PackageSource
+	{
+		UINT64 size = 0;
+		UINT64 modifiedTime = 0;
+		UINT64 hash = 0;
+	};
+
+	/** File written into the package. */
+	struct PackageFile
+	{
+		UINT64 key = 0; /**< Hash of all the sources the file was produced from. */
+		UINT64 size = 0;
+	};
+
+	/** Contents of the package manifest file. */
+	struct PackageManifest
+	{
+		UnorderedMap<String, PackageSource> sources;
+		UnorderedMap<String, PackageFile> files;
+	};
+
+	/** Reads values from a block of manifest data, failing once the end of the data is reached. */
+	class PackageManifestReader
+	{
+	public:
+		PackageManifestReader(const UINT8* data, UINT64 size)
+			:mData(data), mSize(size)
+		{ }
+
+		template<class T>
+		bool read(T& value)
+		{
+			if (mSize - mOffset < sizeof(T))
+				return false;
+
+			memcpy(&value, mData + mOffset, sizeof(T));
+			mOffset += sizeof(T);
+			return true;
+		}
+
+		bool readString(String& value)
+		{
+			UINT32 length;
+			if (!read(length) || mSize - mOffset < length)
+				return false;
+
+			value.assign((const char*)mData + mOffset, length);
+			mOffset += length;
+			return true;
+		}
+
+	private:
+		const UINT8* mData;
+		UINT64 mSize;
+		UINT64 mOffset = 0;
+	};
+
+	/** Appends a value to a block of manifest data. */
+	template<class T>
+	static void writeManifestValue(Vector<UINT8>& output, const T& value)
+	{
+		const UINT8* bytes = (const UINT8*)&value;
+		output.insert(output.end(), bytes, bytes + sizeof(T));
+	}
+
+	/** Appends a length prefixed string to a block of manifest data. */
+	static void writeManifestString(Vector<UINT8>& output, const String& value)
+	{
+		writeManifestValue(output, (UINT32)value.size());
+		output.insert(output.end(), value.begin(), value.end());
+	}
+
+	/** Loads the package manifest from the provided file. Returns false if the file is missing or invalid. */
+	static bool loadPackageManifest(const Path& path, PackageManifest& manifest)
+	{
+		if (!FileSystem::isFile(path))
+			return false;
+
+		SPtr<DataStream> stream = FileSystem::openFile(path, true);
+		if (stream == nullptr)
+			return false;
+
+		Vector<UINT8> data(stream->size());
+		bool valid = stream->read(data.data(), data.size()) == data.size();
+		stream->close();
+
+		if (!valid)
+			return false;
+
+		PackageManifestReader reader(data.data(), data.size());
+
+		UINT32 magic, version, numSources, numFiles;
+		if (!reader.read(magic) || !reader.read(version) || !reader.read(numSources) || !reader.read(numFiles))
+			return false;
+
+		if (magic != PACKAGE_MANIFEST_MAGIC || version != PACKAGE_MANIFEST_VERSION)
+			return false;
+
+		for (UINT32 i = 0; i < numSources; i++)
+		{
+			String path;
+			PackageSource source;
+			if (!reader.readString(path) || !reader.read(source.size) || !reader.read(source.modifiedTime) ||
+				!reader.read(source.hash))
+				return false;
+
+			manifest.sources[path] = source;
+		}
+
+		for (UINT32 i = 0; i < numFiles; i++)
+		{
+			String name;
+			PackageFile file;
+			if (!reader.readString(name) || !reader.read(file.key) || !reader.read(file.size))
+				return false;
+
+			manifest.files[name] = file;
+		}
+
+		return true;
+	}
+
+	/** Saves the package manifest to the provided file. */
+	static bool savePackageManifest(const Path& path, const PackageManifest& manifest)
+	{
+		Vector<UINT8> output;
+		writeManifestValue(output, PACKAGE_MANIFEST_MAGIC);
+		writeManifestValue(output, PACKAGE_MANIFEST_VERSION);
+		writeManifestValue(output, (UINT32)manifest.sources.size());
+		writeManifestValue(output, (UINT32)manifest.files.size());
+
+		for (auto& entry : manifest.sources)
+		{
+			writeManifestString(output, entry.first);
+			writeManifestValue(output, entry.second.size);
+			writeManifestValue(output, entry.second.modifiedTime);
+			writeManifestValue(output, entry.second.hash);
+		}
+
+		for (auto& entry : manifest.files)
+		{
+			writeManifestString(output, entry.first);
+			writeManifestValue(output, entry.second.key);
+			writeManifestValue(output, entry.second.size);
+		}
+
+		SPtr<DataStream> stream = FileSystem::createAndOpenFile(path);
+		if (stream == nullptr)
+			return false;
+
+		bool written = stream->write(output.data(), output.size()) == output.size();
+		stream->close();
+
+		return written;
+	}
+
+	/**
+	 * Starts worker tasks that call the provided function once for every index in range [0, count). Returns the started
+	 * tasks, which must be waited on before any data used by the function goes out of scope.
+	 */
+	static Vector<SPtr<Task>> startWorkers(UINT32 count, const std::function<void(UINT32)>& func)
+	{
+		SPtr<std::atomic<UINT32>> next = bs_shared_ptr_new<std::atomic<UINT32>>(0);
+
+		Vector<SPtr<Task>> tasks;
+		UINT32 numWorkers = std::min(count, MAX_PACKAGE_WORKERS);
+		for (UINT32 i = 0; i < numWorkers; i++)
+		{
+			SPtr<Task> task = Task::create("ResourcePackager", [next, count, func]()
+			{
+				for (UINT32 idx = (*next)++; idx < count; idx = (*next)++)
+					func(idx);
+			});
+
+			TaskScheduler::instance().addTask(task);
+			tasks.push_back(task);
+		}
+
+		return tasks;
+	}
+
+	ResourcePackager::ResourcePackager(const Path& folder)
+		:mFolder(folder)
+	{ }
+
+	void ResourcePackager::addFile(const Path& source, const String& name)
+	{
+		mFiles.push_back({ name, { source }, nullptr });
+	}
+
+	void ResourcePackager::addGeneratedFile(const String& name, const Vector<Path>& sources,
+		const GenerateFunc& generate)
+	{
+		mFiles.push_back({ name, sources, generate });
+	}
+
+	PackagingSummary ResourcePackager::package()
+	{
+		Timer timer;
+
+		PackagingSummary summary;
+		summary.numFiles = (UINT32)mFiles.size();
+
+		if (!FileSystem::isDirectory(mFolder))
+			FileSystem::createDir(mFolder);
+
+		Path manifestPath = mFolder;
+		manifestPath.append(MANIFEST_NAME);
+
+		// A missing or invalid manifest just means everything gets written
+		PackageManifest oldManifest;
+		if (!loadPackageManifest(manifestPath, oldManifest))
+			oldManifest = PackageManifest();
+
+		// Find the sources of all the files, each one only needs to be hashed once
+		Vector<Path> sources;
+		Vector<String> sourceKeys;
+		UnorderedMap<String, UINT32> sourceLookup;
+		Vector<Vector<UINT32>> fileSources(mFiles.size());
+
+		for (UINT32 i = 0; i < (UINT32)mFiles.size(); i++)
+		{
+			for (auto& source : mFiles[i].sources)
+			{
+				String key = source.toString();
+
+				auto iterFind = sourceLookup.find(key);
+				if (iterFind == sourceLookup.end())
+				{
+					iterFind = sourceLookup.insert(std::make_pair(key, (UINT32)sources.size())).first;
+
+					sources.push_back(source);
+					sourceKeys.push_back(key);
+				}
+
+				fileSources[i].push_back(iterFind->second);
+			}
+		}
+
+		// Sources with the same size and modification time as during the last build are assumed to be unchanged
+		Vector<PackageSource> sourceStates(sources.size());
+		Vector<SPtr<Task>> tasks = startWorkers((UINT32)sources.size(), [&](UINT32 idx)
+		{
+			PackageSource& state = sourceStates[idx];
+			state.size = FileSystem::getFileSize(sources[idx]);
+			state.modifiedTime = (UINT64)FileSystem::getLastModifiedTime(sources[idx]);
+
+			auto iterFind = oldManifest.sources.find(sourceKeys[idx]);
+			if (iterFind != oldManifest.sources.end() && iterFind->second.size == state.size &&
+				iterFind->second.modifiedTime == state.modifiedTime)
+				state.hash = iterFind->second.hash;
+			else
+				state.hash = ContentHash::computeFile(sources[idx]);
+		});
+
+		for (auto& task : tasks)
+			task->wait();
+
+		// Files are only written if their sources changed, or if they were modified or removed since the last build
+		PackageManifest newManifest;
+		Vector<UINT32> toCopy;
+		Vector<UINT32> toGenerate;
+
+		for (UINT32 i = 0; i < (UINT32)mFiles.size(); i++)
+		{
+			ContentHash hash(PACKAGE_MANIFEST_VERSION);
+			for (auto& sourceIdx : fileSources[i])
+				hash.update(&sourceStates[sourceIdx].hash, sizeof(UINT64));
+
+			UINT64 key = hash.getHash();
+			newManifest.files[mFiles[i].name].key = key;
+
+			Path outputPath = mFolder;
+			outputPath.setFilename(mFiles[i].name);
+
+			auto iterFind = oldManifest.files.find(mFiles[i].name);
+			if (iterFind != oldManifest.files.end() && iterFind->second.key == key && FileSystem::isFile(outputPath) &&
+				FileSystem::getFileSize(outputPath) == iterFind->second.size)
+			{
+				newManifest.files[mFiles[i].name].size = iterFind->second.size;
+
+				summary.numSkipped++;
+				summary.bytesSkipped += iterFind->second.size;
+				continue;
+			}
+
+			if (mFiles[i].generate != nullptr)
+				toGenerate.push_back(i);
+			else
+				toCopy.push_back(i);
+		}
+
+		// Copy on the workers, while the main thread generates the files that need it
+		// Not using Vector<bool> as its elements can't be written from multiple threads
+		Vector<UINT8> written(mFiles.size(), 0);
+		tasks = startWorkers((UINT32)toCopy.size(), [&](UINT32 idx)
+		{
+			const QueuedFile& file = mFiles[toCopy[idx]];
+
+			Path outputPath = mFolder;
+			outputPath.setFilename(file.name);
+
+			if (!FileSystem::isFile(file.sources[0]))
+				return;
+
+			FileSystem::copy(file.sources[0], outputPath, true);
+			written[toCopy[idx]] = FileSystem::isFile(outputPath) ? 1 : 0;
+		});
+
+		for (auto& idx : toGenerate)
+		{
+			Path outputPath = mFolder;
+			outputPath.setFilename(mFiles[idx].name);
+
+			written[idx] = mFiles[idx].generate(outputPath) ? 1 : 0;
+		}
+
+		for (auto& task : tasks)
+			task->wait();
+
+		Vector<UINT32> allWritten = toCopy;
+		allWritten.insert(allWritten.end(), toGenerate.begin(), toGenerate.end());
+
+		for (auto& idx : allWritten)
+		{
+			Path outputPath = mFolder;
+			outputPath.setFilename(mFiles[idx].name);
+
+			if (!written[idx])
+			{
+				LOGWRN("Failed to package \"" + mFiles[idx].name + "\".");
+
+				// Make sure a stale version from a previous build doesn't get used
+				if (FileSystem::isFile(outputPath))
+					FileSystem::remove(outputPath);
+
+				newManifest.files.erase(mFiles[idx].name);
+				summary.numFailed++;
+				continue;
+			}
+
+			UINT64 size = FileSystem::getFileSize(outputPath);
+			newManifest.files[mFiles[idx].name].size = size;
+
+			summary.numWritten++;
+			summary.bytesWritten += size;
+		}
+
+		// Remove files that were part of the last build but not this one
+		for (auto& entry : oldManifest.files)
+		{
+			if (newManifest.files.find(entry.first) != newManifest.files.end())
+				continue;
+
+			Path outputPath = mFolder;
+			outputPath.setFilename(entry.first);
+
+			if (FileSystem::isFile(outputPath))
+			{
+				FileSystem::remove(outputPath);
+				summary.numRemoved++;
+			}
+		}
+
+		for (UINT32 i = 0; i < (UINT32)sources.size(); i++)
+			newManifest.sources[sourceKeys[i]] = sourceStates[i];
+
+		if (!savePackageManifest(manifestPath, newManifest))
+			LOGWRN("Failed to save the package manifest to \"" + manifestPath.toString() + "\".");
+
+		summary.time = timer.getMilliseconds();
+		return summary;
+	}
+}
@@ -0,0 +1,88 @@
+//********************************** Banshee Engine (www.banshee3d.com) **************************************************//
+//**************** Copyright (c) 2016 Marko Pintera (marko.pintera@gmail.com). All rights reserved. **********************//
+#pragma once
+
+#include "BsEditorPrerequisites.h"
+
+namespace bs
+{
+	/** @addtogroup Build
+	 *  @{
+	 */
+
+	/** Statistics about a single run of the ResourcePackager. */
+	struct PackagingSummary
+	{
+		UINT32 numFiles = 0; /**< Number of files in the package. */
+		UINT32 numWritten = 0; /**< Number of files written because they were new or changed since the last build. */
+		UINT32 numSkipped = 0; /**< Number of files left as they were, because they didn't change since last build. */
+		UINT32 numRemoved = 0; /**< Number of files from the last build that are no longer part of the package. */
+		UINT32 numFailed = 0; /**< Number of files that failed to be written. */
+		UINT64 bytesWritten = 0; /**< Total size of the written files, in bytes. */
+		UINT64 bytesSkipped = 0; /**< Total size of the skipped files, in bytes. */
+		UINT64 time = 0; /**< Wall time of the whole packaging process, in milliseconds. */
+	};
+
+	/**
+	 * Writes files into a package folder of a build. Files are either copied from a source file, or generated by a
+	 * callback. Copying and hashing of the source files is done on worker threads.
+	 *
+	 * A manifest of the written files along with hashes of the sources they were produced from is kept in the package
+	 * folder. When packaging into a folder containing a previous build, files whose sources haven't changed are left
+	 * as they are, and files that are no longer part of the package are removed.
+	 */
+	class BS_ED_EXPORT ResourcePackager
+	{
+	public:
+		/** Callback that writes a generated file to the provided absolute path. Returns false if the write failed. */
+		typedef std::function<bool(const Path&)> GenerateFunc;
+
+		/**
+		 * Creates a packager for the specified folder. Nothing is written until package() is called.
+		 *
+		 * @param[in]	folder	Absolute path to the folder to write the files to. Created if it doesn't exist.
+		 */
+		ResourcePackager(const Path& folder);
+
+		/**
+		 * Queues a file to be copied into the package.
+		 *
+		 * @param[in]	source	Absolute path to the file to copy.
+		 * @param[in]	name	Name of the file in the package folder.
+		 */
+		void addFile(const Path& source, const String& name);
+
+		/**
+		 * Queues a file to be generated into the package.
+		 *
+		 * @param[in]	name		Name of the file in the package folder.
+		 * @param[in]	sources		Absolute paths to all the files the contents of the generated file depend on. The
+		 *							file is only generated again if any of them change.
+		 * @param[in]	generate	Callback that writes the file. Always called on the thread calling package().
+		 */
+		void addGeneratedFile(const String& name, const Vector<Path>& sources, const GenerateFunc& generate);
+
+		/**
+		 * Writes all the queued files into the package folder, skipping the ones that didn't change since the last
+		 * build, removes files of the last build that weren't queued, and updates the package manifest.
+		 */
+		PackagingSummary package();
+
+		/** Name of the manifest file kept in the package folder. */
+		static const char* MANIFEST_NAME;
+
+	private:
+		/** Single file queued for packaging. */
+		struct QueuedFile
+		{
+			String name;
+			Vector<Path> sources;
+			GenerateFunc generate;
+		};
+
+		Path mFolder;
+		Vector<QueuedFile> mFiles;
+	};
+
+	/** @} */
+}
@@ -7,6 +7,13 @@ set(BS_BANSHEEEDITOR_INC_SETTINGS
 set(BS_BANSHEEEDITOR_SRC_LIBRARY
 	"Library/BsProjectLibrary.cpp"
 	"Library/BsProjectLibraryEntries.cpp"
+	"Library/BsProjectLibrarySearch.cpp"
+	"Library/BsProjectLibrarySnapshot.cpp"
+	"Library/BsProjectLibraryJournal.cpp"
+	"Library/BsImportCache.cpp"
+	"Library/BsImportDependencyGraph.cpp"
+	"Library/BsResourceLocationMap.cpp"
+	"Library/BsResourceReferenceGraph.cpp"
 	"Library/BsProjectResourceMeta.cpp"
 	"Library/BsEditorShaderIncludeHandler.cpp"
 )
@@ -33,6 +40,7 @@ set(BS_BANSHEEEDITOR_INC_SCENE
 	"Scene/BsScenePicking.h"
 	"Scene/BsSelection.h"
 	"Scene/BsSelectionRenderer.h"
+	"Scene/BsPickingBVH.h"
 )
 
 set(BS_BANSHEEEDITOR_SRC_GUI
@@ -66,6 +74,13 @@ set(BS_BANSHEEEDITOR_SRC_GUI
 set(BS_BANSHEEEDITOR_INC_LIBRARY
 	"Library/BsProjectLibrary.h"
 	"Library/BsProjectLibraryEntries.h"
+	"Library/BsProjectLibrarySearch.h"
+	"Library/BsProjectLibrarySnapshot.h"
+	"Library/BsProjectLibraryJournal.h"
+	"Library/BsImportCache.h"
+	"Library/BsImportDependencyGraph.h"
+	"Library/BsResourceLocationMap.h"
+	"Library/BsResourceReferenceGraph.h"
 	"Library/BsProjectResourceMeta.h"
 	"Library/BsEditorShaderIncludeHandler.h"
 )
@@ -134,6 +149,7 @@ set(BS_BANSHEEEDITOR_SRC_SCENEVIEW
 	"SceneView/BsSelection.cpp"
 	"SceneView/BsScenePicking.cpp"
 	"SceneView/BsSceneGrid.cpp"
+	"SceneView/BsPickingBVH.cpp"
 )
 
 set(BS_BANSHEEEDITOR_INC_NOFILTER
@@ -155,6 +171,7 @@ set(BS_BANSHEEEDITOR_INC_HANDLES
 
 set(BS_BANSHEEEDITOR_SRC_UTILITY
 	"Utility/BsEditorUtility.cpp"
+	"Utility/BsContentHash.cpp"
 	"Utility/BsSplashScreen.cpp"
 )
 
@@ -176,6 +193,7 @@ set(BS_BANSHEEEDITOR_SRC_EDITORWINDOW
 
 set(BS_BANSHEEEDITOR_INC_UTILITY
 	"Utility/BsEditorUtility.h"
+	"Utility/BsContentHash.h"
 	"Utility/BsBuiltinEditorResources.h"
 	"Utility/BsSplashScreen.h"
 )
@@ -205,12 +223,19 @@ set(BS_BANSHEEEDITOR_SRC_UNDOREDO
 set(BS_BANSHEEEDITOR_INC_BUILD
 	"Build/BsBuildManager.h"
 	"Build/BsPlatformInfo.h"
+	"Build/BsResourcePackager.h"
+	"Build/BsResourceArchive.h"
+	"Build/BsResourceArchiveFormat.h"
+	"Build/BsBuildReport.h"
 )
 
 set(BS_BANSHEEEDITOR_SRC_BUILD
 	"Build/BsBuildManager.cpp"
 	"Build/BsBuiltinEditorResources.cpp"
 	"Build/BsPlatformInfo.cpp"
+	"Build/BsResourcePackager.cpp"
+	"Build/BsResourceArchive.cpp"
+	"Build/BsBuildReport.cpp"
 )
 
 set(BS_BANSHEEEDITOR_SRC_HANDLES
@@ -132,9 +132,12 @@ namespace bs
 				continue;
 
 			ProjectLibrary::FileEntry* resEntry = static_cast<ProjectLibrary::FileEntry*>(entry);
-			if (resEntry->meta->hasTypeId(TID_ScriptCode))
+			if (resEntry->hasTypeId(TID_ScriptCode))
 			{
-				SPtr<ScriptCodeImportOptions> scriptIO = std::static_pointer_cast<ScriptCodeImportOptions>(resEntry->meta->getImportOptions());
+				SPtr<ProjectFileMeta> fileMeta = resEntry->getMeta();
+				SPtr<ScriptCodeImportOptions> scriptIO;
+				if (fileMeta != nullptr)
+					scriptIO = std::static_pointer_cast<ScriptCodeImportOptions>(fileMeta->getImportOptions());
 
 				bool isEditorScript = false;
 				if (scriptIO != nullptr)
@@ -39,6 +39,7 @@ namespace bs
 
 		gProjectLibrary().onEntryAdded.connect(std::bind(&GUIResourceTreeView::entryAdded, this, _1));
 		gProjectLibrary().onEntryRemoved.connect(std::bind(&GUIResourceTreeView::entryRemoved, this, _1));
+		gProjectLibrary().onEntriesChanged.connect(std::bind(&GUIResourceTreeView::entriesChanged, this, _1, _2));
 
 		const ProjectLibrary::LibraryEntry* rootEntry = gProjectLibrary().getRootEntry();
 
@@ -268,6 +269,15 @@ namespace bs
 			deleteTreeElement(treeElement);
 	}
 
+	void GUIResourceTreeView::entriesChanged(const Vector<Path>& removed, const Vector<Path>& added)
+	{
+		for (auto& path : removed)
+			entryRemoved(path);
+
+		for (auto& path : added)
+			entryAdded(path);
+	}
+
 	void GUIResourceTreeView::setDropTarget(RenderWindow* parentWindow, INT32 x, INT32 y, UINT32 width, UINT32 height)
 	{
 		if(mDropTarget != nullptr)
@@ -419,6 +429,7 @@ namespace bs
 			if(FileSystem::isFile(destDir))
 				destDir = destDir.getParent();
 
+			gProjectLibrary().beginBatch();
 			for(UINT32 i = 0; i < mDraggedResources->numObjects; i++)
 			{
 				String filename = mDraggedResources->resourcePaths[i].getFilename();
@@ -432,6 +443,7 @@ namespace bs
 					gProjectLibrary().moveEntry(mDraggedResources->resourcePaths[i], findUniquePath(newPath));
 				}
 			}
+			gProjectLibrary().endBatch();
 		}
 	}
 
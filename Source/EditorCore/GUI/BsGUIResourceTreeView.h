@@ -187,6 +187,9 @@ namespace bs
 		/**	Called whenever an entry is removed from the project library. */
 		void entryRemoved(const Path& path);
 
+		/**	Called when a batch of project library operations ends, with all the entries removed and added by it. */
+		void entriesChanged(const Vector<Path>& removed, const Vector<Path>& added);
+
 		/**
 		 * Sets an OS drag and drop target that allows this element to receive OS-specific drag and drop events originating
 		 * from other processes.
@@ -32,6 +32,7 @@ namespace bs
 		mScene = GUILabel::create(HString("Scene: Unnamed"), GUIOptions(GUIOption::fixedWidth(150)));
 		mProject = GUILabel::create(HString("Project: None"), GUIOptions(GUIOption::fixedWidth(200)));
 		mCompiling = GUILabel::create(HString("Compiling..."), GUIOptions(GUIOption::fixedWidth(100)));
+		mImporting = GUILabel::create(HString(""), GUIOptions(GUIOption::fixedWidth(250)));
 
 		GUILayoutY* vertLayout = mPanel->addNewElement<GUILayoutY>();
 		vertLayout->addNewElement<GUIFixedSpace>(3);
@@ -44,11 +45,14 @@ namespace bs
 		horzLayout->addNewElement<GUIFixedSpace>(10);
 		horzLayout->addElement(mProject);
 		horzLayout->addNewElement<GUIFixedSpace>(10);
+		horzLayout->addElement(mImporting);
+		horzLayout->addNewElement<GUIFixedSpace>(10);
 		horzLayout->addElement(mCompiling);
 		horzLayout->addNewElement<GUIFixedSpace>(10);
 
 		mBgPanel->addElement(mBackground);
 		mCompiling->setActive(false);
+		mImporting->setActive(false);
 
 		mLogEntryAddedConn = gDebug().onLogModified.connect(std::bind(&GUIStatusBar::logModified, this));
 		mMessageBtnPressedConn = mMessage->onClick.connect(std::bind(&GUIStatusBar::messageBtnClicked, this));
@@ -114,6 +118,48 @@ namespace bs
 	{
 		mCompiling->setActive(compiling);
 	}
+
+	void GUIStatusBar::setImportStatus(UINT32 queueLength, const String& current, float eta)
+	{
+		// Only rebuild the contents when the displayed values change, as this is called every frame
+		UINT32 etaSeconds = (UINT32)std::ceil(eta);
+		if (queueLength == mImportQueueLength && current == mCurrentImport && etaSeconds == mImportETA)
+			return;
+
+		mImportQueueLength = queueLength;
+		mCurrentImport = current;
+		mImportETA = etaSeconds;
+
+		if (queueLength == 0)
+		{
+			mImporting->setActive(false);
+			return;
+		}
+
+		StringStream content;
+		content << "Importing (" << queueLength << ")";
+
+		if (!current.empty())
+		{
+			content << ": ";
+
+			if (current.size() > 20)
+				content << current.substr(0, 20) << "...";
+			else
+				content << current;
+		}
+
+		if (etaSeconds > 0)
+		{
+			if (etaSeconds >= 60)
+				content << " ~" << (etaSeconds / 60) << "m " << (etaSeconds % 60) << "s";
+			else
+				content << " ~" << etaSeconds << "s";
+		}
+
+		mImporting->setContent(HString(content.str()));
+		mImporting->setActive(true);
+	}
 	
 	void GUIStatusBar::setTint(const Color& color)
 	{
@@ -65,6 +65,17 @@ namespace bs
 		/**	Activates or deactivates the "compilation in progress" visuals on the status bar. */
 		void setIsCompiling(bool compiling);
 
+		/**
+		 * Updates the background import progress displayed on the status bar. Nothing is displayed while no resources
+		 * are waiting to be imported.
+		 *
+		 * @param[in]	queueLength		Number of resources waiting to be imported, including the ones being imported.
+		 * @param[in]	current			Name of a resource currently being imported, or empty if none.
+		 * @param[in]	eta				Estimated time until all the queued resources are imported, in seconds. Zero if
+		 *								unknown.
+		 */
+		void setImportStatus(UINT32 queueLength, const String& current, float eta);
+
 		/** @copydoc GUIElement::setTint */
 		void setTint(const Color& color) override;
 
@@ -98,8 +109,13 @@ namespace bs
 		GUILabel* mScene;
 		GUILabel* mProject;
 		GUILabel* mCompiling;
+		GUILabel* mImporting;
 		GUITexture* mBackground;
 
+		UINT32 mImportQueueLength = 0;
+		String mCurrentImport;
+		UINT32 mImportETA = 0;
+
 		HEvent mLogEntryAddedConn;
 		HEvent mMessageBtnPressedConn;
 	};
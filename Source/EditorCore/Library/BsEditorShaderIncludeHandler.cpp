@@ -28,13 +28,12 @@ namespace bs
 		{
 			ProjectLibrary::FileEntry* fileEntry = static_cast<ProjectLibrary::FileEntry*>(entry);
 
-			if (fileEntry->meta != nullptr)
+			for(auto& resHeader : fileEntry->resources)
 			{
-				auto& resourceMetas = fileEntry->meta->getResourceMetaData();
-				for(auto& resMeta : resourceMetas)
+				if(resHeader.typeId == TID_ShaderInclude)
 				{
-					if(resMeta->getTypeID() == TID_ShaderInclude)
-						return static_resource_cast<ShaderInclude>(Resources::instance().loadFromUUID(resMeta->getUUID(), false, loadFlags));
+					HResource include = Resources::instance().loadFromUUID(resHeader.uuid, false, loadFlags);
+					return static_resource_cast<ShaderInclude>(include);
 				}
 			}
 		}
@@ -0,0 +1,228 @@
+//********************************** Banshee Engine (www.banshee3d.com) **************************************************//
+//**************** Copyright (c) 2016 Marko Pintera (marko.pintera@gmail.com). All rights reserved. **********************//
+#include "Library/BsImportCache.h"
+#include "Utility/BsContentHash.h"
+#include "FileSystem/BsFileSystem.h"
+#include "FileSystem/BsDataStream.h"
+#include "Serialization/BsMemorySerializer.h"
+#include "Resources/BsResource.h"
+#include "Debug/BsDebug.h"
+#include <iomanip>
+
+namespace bs
+{
+	/** Identifier at the start of every cache entry file ("BSIC"). */
+	static constexpr UINT32 IMPORT_CACHE_MAGIC = 0x43495342;
+
+	/**
+	 * Version of the imported data. Importers don't report their own versions, so this must be increased whenever an
+	 * importer or the serialized format of an imported resource changes, invalidating all existing cache entries.
+	 */
+	static constexpr UINT32 IMPORT_CACHE_VERSION = 1;
+
+	ImportCache::ImportCache(const Path& folder)
+		:mFolder(folder), mNumHits(0), mNumMisses(0), mNumWrites(0)
+	{
+		if (!FileSystem::isDirectory(mFolder))
+			FileSystem::createDir(mFolder);
+	}
+
+	UINT64 ImportCache::getKey(const Path& sourcePath, UINT64 sourceHash, UINT64 importOptionsHash,
+		UINT64 dependenciesHash)
+	{
+		// Importers are selected by extension, so it is used to identify the importer
+		String extension = sourcePath.getExtension();
+		StringUtil::toLowerCase(extension);
+
+		ContentHash hash(IMPORT_CACHE_VERSION);
+		hash.update(&sourceHash, sizeof(sourceHash));
+		hash.update(&importOptionsHash, sizeof(importOptionsHash));
+		hash.update(&dependenciesHash, sizeof(dependenciesHash));
+		hash.update(extension.data(), extension.size());
+
+		return hash.getHash();
+	}
+
+	bool ImportCache::read(UINT64 key, Vector<CachedResource>& resources)
+	{
+		Path entryPath = getEntryPath(key);
+		if (!FileSystem::isFile(entryPath))
+		{
+			mNumMisses++;
+			return false;
+		}
+
+		SPtr<DataStream> stream = FileSystem::openFile(entryPath, true);
+		if (stream == nullptr)
+		{
+			mNumMisses++;
+			return false;
+		}
+
+		auto readValue = [&](UINT32& value)
+		{
+			return stream->read(&value, sizeof(value)) == sizeof(value);
+		};
+
+		UINT32 magic = 0;
+		UINT32 version = 0;
+		UINT32 numResources = 0;
+		bool valid = readValue(magic) && readValue(version) && readValue(numResources) &&
+			magic == IMPORT_CACHE_MAGIC && version == IMPORT_CACHE_VERSION;
+
+		Vector<CachedResource> output;
+		for (UINT32 i = 0; valid && i < numResources; i++)
+		{
+			CachedResource entry;
+
+			UINT32 nameLength = 0;
+			if (!readValue(nameLength))
+			{
+				valid = false;
+				break;
+			}
+
+			entry.name = String(nameLength, '\0');
+			if (nameLength > 0 && stream->read(&entry.name[0], nameLength) != nameLength)
+			{
+				valid = false;
+				break;
+			}
+
+			UINT32 dataSize = 0;
+			if (!readValue(dataSize) || dataSize == 0)
+			{
+				valid = false;
+				break;
+			}
+
+			entry.data.resize(dataSize);
+			if (stream->read(entry.data.data(), dataSize) != dataSize)
+			{
+				valid = false;
+				break;
+			}
+
+			output.push_back(std::move(entry));
+		}
+
+		stream->close();
+
+		if (!valid)
+		{
+			LOGWRN("Ignoring corrupt import cache entry \"" + entryPath.toString() + "\".");
+
+			mNumMisses++;
+			return false;
+		}
+
+		resources = std::move(output);
+		return true;
+	}
+
+	bool ImportCache::decode(const Vector<CachedResource>& cached, Vector<SubResourceRaw>& resources)
+	{
+		Vector<SubResourceRaw> output;
+		MemorySerializer serializer;
+		for (auto& entry : cached)
+		{
+			SPtr<IReflectable> resource = serializer.decode((UINT8*)entry.data.data(), (UINT32)entry.data.size());
+			if (resource == nullptr || !resource->isDerivedFrom(Resource::getRTTIStatic()))
+			{
+				LOGWRN("Ignoring import cache entry with an invalid resource \"" + entry.name + "\".");
+
+				mNumMisses++;
+				return false;
+			}
+
+			output.push_back({ entry.name, std::static_pointer_cast<Resource>(resource) });
+		}
+
+		resources = std::move(output);
+
+		mNumHits++;
+		return true;
+	}
+
+	void ImportCache::store(UINT64 key, const Vector<SubResourceRaw>& resources)
+	{
+		Path entryPath = getEntryPath(key);
+		if (FileSystem::isFile(entryPath))
+			return;
+
+		Path entryFolder = entryPath.getParent();
+		if (!FileSystem::isDirectory(entryFolder))
+			FileSystem::createDir(entryFolder);
+
+		// Write to a unique temporary file first, so other editor instances never see a partially written entry
+		Path tempPath = entryPath;
+		tempPath.setFilename(entryPath.getFilename() + "." + UUIDGenerator::generateRandom().toString() + ".tmp");
+
+		SPtr<DataStream> stream = FileSystem::createAndOpenFile(tempPath);
+		if (stream == nullptr)
+			return;
+
+		UINT32 header[3] = { IMPORT_CACHE_MAGIC, IMPORT_CACHE_VERSION, (UINT32)resources.size() };
+		bool valid = stream->write(header, sizeof(header)) == sizeof(header);
+
+		MemorySerializer serializer;
+		for (auto& entry : resources)
+		{
+			if (!valid)
+				break;
+
+			UINT32 dataSize = 0;
+			UINT8* data = serializer.encode(entry.value.get(), dataSize);
+
+			UINT32 nameLength = (UINT32)entry.name.size();
+			valid = stream->write(&nameLength, sizeof(nameLength)) == sizeof(nameLength) &&
+				stream->write(entry.name.data(), nameLength) == nameLength &&
+				stream->write(&dataSize, sizeof(dataSize)) == sizeof(dataSize) &&
+				stream->write(data, dataSize) == dataSize;
+
+			bs_free(data);
+		}
+
+		stream->close();
+
+		if (!valid || FileSystem::isFile(entryPath))
+		{
+			FileSystem::remove(tempPath);
+			return;
+		}
+
+		FileSystem::move(tempPath, entryPath, false);
+		mNumWrites++;
+	}
+
+	ImportCacheStatistics ImportCache::getStatistics() const
+	{
+		ImportCacheStatistics output;
+		output.hits = mNumHits;
+		output.misses = mNumMisses;
+		output.writes = mNumWrites;
+
+		return output;
+	}
+
+	void ImportCache::resetStatistics()
+	{
+		mNumHits = 0;
+		mNumMisses = 0;
+		mNumWrites = 0;
+	}
+
+	Path ImportCache::getEntryPath(UINT64 key) const
+	{
+		StringStream stream;
+		stream << std::hex << std::setw(16) << std::setfill('0') << key;
+		String keyStr = stream.str();
+
+		// Spread the entries over multiple folders so no single folder ends up with a huge number of files
+		Path entryPath = mFolder;
+		entryPath.append(keyStr.substr(0, 2) + "/");
+		entryPath.append(keyStr + ".cache");
+
+		return entryPath;
+	}
+}
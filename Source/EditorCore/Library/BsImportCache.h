@@ -0,0 +1,110 @@
+//********************************** Banshee Engine (www.banshee3d.com) **************************************************//
+//**************** Copyright (c) 2016 Marko Pintera (marko.pintera@gmail.com). All rights reserved. **********************//
+#pragma once
+
+#include "BsEditorPrerequisites.h"
+#include "Importer/BsImporter.h"
+#include <atomic>
+
+namespace bs
+{
+	/** @addtogroup Library
+	 *  @{
+	 */
+
+	/** Contains statistics about the import cache usage. */
+	struct ImportCacheStatistics
+	{
+		UINT32 hits = 0; /**< Number of imports that were restored from the cache. */
+		UINT32 misses = 0; /**< Number of imports that weren't found in the cache. */
+		UINT32 writes = 0; /**< Number of imports that were written to the cache. */
+	};
+
+	/**
+	 * Cache of imported resources that may be shared between multiple projects on the same machine. Results of an
+	 * import are stored under a key calculated from the contents of the source file, the import options, the contents
+	 * of the import dependencies (e.g. shader includes) and the importer version, so copies of the same source asset
+	 * (e.g. in different project copies or branches) only need to be imported once.
+	 *
+	 * @note	Thread safe, except for decode().
+	 */
+	class BS_ED_EXPORT ImportCache
+	{
+	public:
+		/**
+		 * Creates a cache that stores its entries in the provided folder. The folder is created if it doesn't exist.
+		 */
+		ImportCache(const Path& folder);
+
+		/** Returns the folder the cache entries are stored in. */
+		const Path& getFolder() const { return mFolder; }
+
+		/**
+		 * Calculates the key used for looking up an import in the cache.
+		 *
+		 * @param[in]	sourcePath			Path to the source file being imported. Used for determining the importer.
+		 * @param[in]	sourceHash			Hash of the contents of the source file.
+		 * @param[in]	importOptionsHash	Hash of the serialized import options used for the import.
+		 * @param[in]	dependenciesHash	Hash of the names and contents of the files the import depends on, or zero
+		 *									if it has no dependencies.
+		 * @return							Key identifying the import.
+		 */
+		static UINT64 getKey(const Path& sourcePath, UINT64 sourceHash, UINT64 importOptionsHash,
+			UINT64 dependenciesHash);
+
+		/** Serialized data of a single resource stored in the cache. */
+		struct CachedResource
+		{
+			String name; /**< Name of the resource, as assigned by the importer. */
+			Vector<UINT8> data; /**< Resource serialized using the MemorySerializer. */
+		};
+
+		/**
+		 * Reads previously cached import results, without deserializing them. Can be called from any thread.
+		 *
+		 * @param[in]	key			Key of the import, as returned by getKey().
+		 * @param[out]	resources	Serialized resources, in the same order as they were originally imported in.
+		 * @return					True if the import was found in the cache and successfully read.
+		 */
+		bool read(UINT64 key, Vector<CachedResource>& resources);
+
+		/**
+		 * Deserializes the import results returned by read(). Must be called from the main thread, as deserialized
+		 * resources might create core objects.
+		 *
+		 * @param[in]	cached		Serialized resources, as returned by read().
+		 * @param[out]	resources	Restored resources, in the same order as they were originally imported in.
+		 * @return					True if all the resources were successfully restored.
+		 */
+		bool decode(const Vector<CachedResource>& cached, Vector<SubResourceRaw>& resources);
+
+		/**
+		 * Stores import results in the cache. Existing entries with the same key are left untouched.
+		 *
+		 * @param[in]	key			Key of the import, as returned by getKey().
+		 * @param[in]	resources	Resources produced by the import.
+		 */
+		void store(UINT64 key, const Vector<SubResourceRaw>& resources);
+
+		/**
+		 * Returns statistics about cache usage since the cache was created, or since the last call to
+		 * resetStatistics().
+		 */
+		ImportCacheStatistics getStatistics() const;
+
+		/** Resets all cache usage statistics to zero. */
+		void resetStatistics();
+
+	private:
+		/** Returns the path to the file containing the cache entry with the specified key. */
+		Path getEntryPath(UINT64 key) const;
+
+		Path mFolder;
+
+		std::atomic<UINT32> mNumHits;
+		std::atomic<UINT32> mNumMisses;
+		std::atomic<UINT32> mNumWrites;
+	};
+
+	/** @} */
+}
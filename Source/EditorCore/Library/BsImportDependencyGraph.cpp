@@ -0,0 +1,156 @@
+//********************************** Banshee Engine (www.banshee3d.com) **************************************************//
+//**************** Copyright (c) 2016 Marko Pintera (marko.pintera@gmail.com). All rights reserved. **********************//
+#include "Library/BsImportDependencyGraph.h"
+
+namespace bs
+{
+	/** Returned when querying edges of resources that have none. */
+	static const Vector<Path> EMPTY_EDGES;
+
+	void ImportDependencyGraph::setDependencies(const Path& resource, const Vector<Path>& dependencies)
+	{
+		removeDependencies(resource);
+
+		for (auto& dependency : dependencies)
+			addDependency(resource, dependency);
+	}
+
+	void ImportDependencyGraph::addDependency(const Path& resource, const Path& dependency)
+	{
+		Vector<Path>& dependencies = mDependencies[resource];
+		if (std::find(dependencies.begin(), dependencies.end(), dependency) != dependencies.end())
+			return;
+
+		dependencies.push_back(dependency);
+		mDependants[dependency].push_back(resource);
+	}
+
+	void ImportDependencyGraph::removeDependencies(const Path& resource)
+	{
+		auto iterFind = mDependencies.find(resource);
+		if (iterFind == mDependencies.end())
+			return;
+
+		for (auto& dependency : iterFind->second)
+			removeEdge(mDependants, dependency, resource);
+
+		mDependencies.erase(iterFind);
+	}
+
+	const Vector<Path>& ImportDependencyGraph::getDependencies(const Path& resource) const
+	{
+		auto iterFind = mDependencies.find(resource);
+		if (iterFind == mDependencies.end())
+			return EMPTY_EDGES;
+
+		return iterFind->second;
+	}
+
+	const Vector<Path>& ImportDependencyGraph::getDependants(const Path& resource) const
+	{
+		auto iterFind = mDependants.find(resource);
+		if (iterFind == mDependants.end())
+			return EMPTY_EDGES;
+
+		return iterFind->second;
+	}
+
+	Vector<Path> ImportDependencyGraph::getAffectedResources(const Vector<Path>& changed) const
+	{
+		UnorderedSet<Path> changedSet(changed.begin(), changed.end());
+
+		// Find every direct and indirect dependant, in the order they are discovered
+		Vector<Path> affected;
+		UnorderedMap<Path, UINT32> affectedLookup;
+
+		Vector<Path> todo = changed;
+		while (!todo.empty())
+		{
+			Path current = todo.back();
+			todo.pop_back();
+
+			for (auto& dependant : getDependants(current))
+			{
+				if (changedSet.find(dependant) != changedSet.end())
+					continue;
+
+				if (affectedLookup.find(dependant) != affectedLookup.end())
+					continue;
+
+				affectedLookup[dependant] = (UINT32)affected.size();
+				affected.push_back(dependant);
+				todo.push_back(dependant);
+			}
+		}
+
+		// Sort topologically, only considering the edges between the affected resources
+		Vector<UINT32> numPendingDependencies(affected.size(), 0);
+		for (UINT32 i = 0; i < (UINT32)affected.size(); i++)
+		{
+			for (auto& dependency : getDependencies(affected[i]))
+			{
+				if (affectedLookup.find(dependency) != affectedLookup.end())
+					numPendingDependencies[i]++;
+			}
+		}
+
+		Vector<Path> output;
+		output.reserve(affected.size());
+
+		Vector<bool> processed(affected.size(), false);
+		Vector<UINT32> ready;
+		for (UINT32 i = 0; i < (UINT32)affected.size(); i++)
+		{
+			if (numPendingDependencies[i] == 0)
+				ready.push_back(i);
+		}
+
+		for (UINT32 i = 0; i < (UINT32)ready.size(); i++)
+		{
+			UINT32 idx = ready[i];
+
+			processed[idx] = true;
+			output.push_back(affected[idx]);
+
+			for (auto& dependant : getDependants(affected[idx]))
+			{
+				auto iterFind = affectedLookup.find(dependant);
+				if (iterFind == affectedLookup.end())
+					continue;
+
+				if (--numPendingDependencies[iterFind->second] == 0)
+					ready.push_back(iterFind->second);
+			}
+		}
+
+		// Anything left is part of a cycle and has no valid order
+		for (UINT32 i = 0; i < (UINT32)affected.size(); i++)
+		{
+			if (!processed[i])
+				output.push_back(affected[i]);
+		}
+
+		return output;
+	}
+
+	void ImportDependencyGraph::clear()
+	{
+		mDependencies.clear();
+		mDependants.clear();
+	}
+
+	void ImportDependencyGraph::removeEdge(UnorderedMap<Path, Vector<Path>>& edges, const Path& key, const Path& value)
+	{
+		auto iterFind = edges.find(key);
+		if (iterFind == edges.end())
+			return;
+
+		Vector<Path>& values = iterFind->second;
+		auto iterValue = std::find(values.begin(), values.end(), value);
+		if (iterValue != values.end())
+			values.erase(iterValue);
+
+		if (values.empty())
+			edges.erase(iterFind);
+	}
+}
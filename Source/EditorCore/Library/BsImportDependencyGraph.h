@@ -0,0 +1,67 @@
+//********************************** Banshee Engine (www.banshee3d.com) **************************************************//
+//**************** Copyright (c) 2016 Marko Pintera (marko.pintera@gmail.com). All rights reserved. **********************//
+#pragma once
+
+#include "BsEditorPrerequisites.h"
+
+namespace bs
+{
+	/** @addtogroup Library-Internal
+	 *  @{
+	 */
+
+	/**
+	 * Keeps track of import dependencies between project library resources (for example a shader including a shader
+	 * include file). Both the forward (resource to its dependencies) and reverse (dependency to its dependants) edges
+	 * are stored, so either direction can be queried without scanning the entire graph.
+	 */
+	class ImportDependencyGraph
+	{
+	public:
+		/**
+		 * Replaces all the dependencies of the provided resource.
+		 *
+		 * @param[in]	resource		Absolute path to the resource.
+		 * @param[in]	dependencies	Absolute paths to the resources that must be imported before @p resource.
+		 */
+		void setDependencies(const Path& resource, const Vector<Path>& dependencies);
+
+		/** Registers a single dependency of the provided resource, if not already registered. */
+		void addDependency(const Path& resource, const Path& dependency);
+
+		/** Removes all the dependencies of the provided resource. Dependants of the resource are not affected. */
+		void removeDependencies(const Path& resource);
+
+		/** Returns the direct dependencies of the provided resource. */
+		const Vector<Path>& getDependencies(const Path& resource) const;
+
+		/** Returns all the resources directly dependent on the provided resource. */
+		const Vector<Path>& getDependants(const Path& resource) const;
+
+		/** Returns a map of all resources with at least one dependant, and their direct dependants. */
+		const UnorderedMap<Path, Vector<Path>>& getAllDependants() const { return mDependants; }
+
+		/**
+		 * Finds all resources that need to be reimported due to changes in the provided resources. This includes both
+		 * direct and indirect dependants.
+		 *
+		 * @param[in]	changed		Absolute paths of the resources that changed.
+		 * @return					Every affected resource exactly once, not including the changed resources
+		 *							themselves. Resources are sorted so that each resource comes after all of its
+		 *							affected dependencies. Resources with circular dependencies are placed at the end.
+		 */
+		Vector<Path> getAffectedResources(const Vector<Path>& changed) const;
+
+		/** Removes all dependencies. */
+		void clear();
+
+	private:
+		/** Removes the first occurrence of the value from the list under the provided key, and the key if empty. */
+		static void removeEdge(UnorderedMap<Path, Vector<Path>>& edges, const Path& key, const Path& value);
+
+		UnorderedMap<Path, Vector<Path>> mDependencies;
+		UnorderedMap<Path, Vector<Path>> mDependants;
+	};
+
+	/** @} */
+}
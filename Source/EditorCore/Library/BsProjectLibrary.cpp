@@ -17,7 +17,20 @@
 #include "BsEditorApplication.h"
 #include "Material/BsShader.h"
 #include "String/BsUnicode.h"
-#include <regex>
+#include "Threading/BsTaskScheduler.h"
+#include "Utility/BsContentHash.h"
+#include "Library/BsProjectLibrarySearch.h"
+#include "Library/BsProjectLibrarySnapshot.h"
+#include "Library/BsProjectLibraryJournal.h"
+#include "Library/BsImportCache.h"
+#include "Library/BsImportDependencyGraph.h"
+#include "Library/BsEditorShaderIncludeHandler.h"
+#include "Library/BsResourceLocationMap.h"
+#include "Library/BsResourceReferenceGraph.h"
+#include "Utility/BsUtility.h"
+#include "Utility/BsTimer.h"
+#include "Utility/BsTime.h"
+#include "Platform/BsFolderMonitor.h"
 
 using namespace std::placeholders;
 
@@ -26,7 +39,147 @@ namespace bs
 	const Path ProjectLibrary::RESOURCES_DIR = "Resources/";
 	const Path ProjectLibrary::INTERNAL_RESOURCES_DIR = PROJECT_INTERNAL_DIR + GAME_RESOURCES_FOLDER_NAME;
 	const char* ProjectLibrary::LIBRARY_ENTRIES_FILENAME = "ProjectLibrary.asset";
+	const char* ProjectLibrary::LIBRARY_SNAPSHOT_FILENAME = "ProjectLibrary.snapshot";
+	const char* ProjectLibrary::LIBRARY_JOURNAL_FILENAME = "ProjectLibrary.journal";
 	const char* ProjectLibrary::RESOURCE_MANIFEST_FILENAME = "ResourceManifest.asset";
+	const char* ProjectLibrary::RESOURCE_REFERENCES_FILENAME = "ResourceReferences.graph";
+
+	/** 
+	 * Maximum number of separate paths that can be queued for checking. Once exceeded the queue is discarded and the
+	 * entire resources folder is checked instead, as a large number of changes is usually the result of an operation
+	 * on the whole project (e.g. switching version control branches).
+	 */
+	static constexpr UINT32 MAX_QUEUED_MODIFICATIONS = 4096;
+
+	/** Minimum time between two journal flushes triggered by update(), in seconds. */
+	static constexpr float JOURNAL_FLUSH_INTERVAL = 5.0f;
+
+	/** 
+	 * Journal is compacted on save once it grows larger than this size, or larger than the snapshot itself, whichever
+	 * is bigger.
+	 */
+	static constexpr UINT64 JOURNAL_COMPACTION_SIZE = 4 * 1024 * 1024;
+
+	/** Minimum time between two sweeps for unused file meta-data triggered by update(), in seconds. */
+	static constexpr float META_EVICTION_INTERVAL = 30.0f;
+
+	/** Time after which decoded file meta-data that wasn't accessed is released by update(), in seconds. */
+	static constexpr float META_IDLE_TIME = 60.0f;
+
+	/** 
+	 * Maximum number of resources imported by a single background import step. Importers run on the main thread when
+	 * the step is committed, so this is kept low to avoid stalling the frame it is done in.
+	 */
+	static constexpr UINT32 MAX_BACKGROUND_IMPORTS = 2;
+
+	/** 
+	 * Calculates a hash of the names and contents of the files an import depends on, used as part of the import cache
+	 * key. Relative dependency paths are resolved against @p resourcesFolder. Returns false if any of the dependencies
+	 * cannot be read, in which case the import cache must not be used.
+	 */
+	static bool hashImportDependencies(const Vector<Path>& dependencies, const Path& resourcesFolder, UINT64& hash)
+	{
+		hash = 0;
+		if (dependencies.empty())
+			return true;
+
+		ContentHash dependenciesHash;
+		for(auto& dependency : dependencies)
+		{
+			String name = dependency.toString();
+
+			Path dependencyPath = EditorShaderIncludeHandler::toResourcePath(name);
+			if (dependencyPath.isEmpty())
+				return false;
+
+			if (!dependencyPath.isAbsolute())
+				dependencyPath.makeAbsolute(resourcesFolder);
+
+			UINT64 contentHash = ContentHash::computeFile(dependencyPath);
+			if (contentHash == 0)
+				return false;
+
+			dependenciesHash.update(name.data(), name.size());
+			dependenciesHash.update(&contentHash, sizeof(contentHash));
+		}
+
+		hash = dependenciesHash.getHash();
+		return true;
+	}
+
+	/** Input and results of a background check of the library entries against the file system. */
+	struct ProjectLibrary::BackgroundValidation
+	{
+		/** Information about a library entry to check. */
+		struct Entry
+		{
+			Path path;
+			LibraryEntryType type;
+			std::time_t metaModifiedTime;
+		};
+
+		Vector<Entry> entries;
+		Path internalResourcesFolder;
+
+		Vector<Path> missingEntries;
+		Vector<Path> modifiedMetas;
+		Vector<Path> internalFiles;
+	};
+
+	/** Changes recorded during a batch of operations, applied once the outermost batch ends. */
+	struct ProjectLibrary::BatchState
+	{
+		/** Entries removed or added during the batch, keyed by their entry keys. */
+		Map<String, Path> removedEntries;
+		Map<String, Path> addedEntries;
+
+		/** Paths that need to be checked for modifications, keyed by their entry keys. */
+		Map<String, Path> refreshPaths;
+
+		/** Entries that need to be imported, along with optional import options. */
+		Vector<std::pair<Path, SPtr<ImportOptions>>> imports;
+
+		/** Paths whose dependants need to be reimported. */
+		Vector<Path> dependants;
+	};
+
+	/** 
+	 * Adds a path to a map of paths keyed by their entry keys, unless the path or one of its parent folders is already
+	 * present. Any present descendants of the path are removed. 
+	 *
+	 * @return	True if the path was added.
+	 */
+	static bool addCoalescedPath(Map<String, Path>& paths, const String& key, const Path& path)
+	{
+		// Root folder is a parent of every other path
+		if (paths.find("") != paths.end())
+			return false;
+
+		if (key.empty())
+		{
+			paths.clear();
+			paths[key] = path;
+			return true;
+		}
+
+		if (paths.find(key) != paths.end())
+			return false;
+
+		for (size_t separator = key.find('/'); separator != String::npos; separator = key.find('/', separator + 1))
+		{
+			if (paths.find(key.substr(0, separator)) != paths.end())
+				return false;
+		}
+
+		// Keys are sorted so all the descendants immediately follow the folder key with a separator appended
+		String childPrefix = key + "/";
+		auto iter = paths.lower_bound(childPrefix);
+		while (iter != paths.end() && iter->first.compare(0, childPrefix.size(), childPrefix) == 0)
+			iter = paths.erase(iter);
+
+		paths[key] = path;
+		return true;
+	}
 
 	ProjectLibrary::LibraryEntry::LibraryEntry()
 		:type(LibraryEntryType::Directory), parent(nullptr)
@@ -37,13 +190,82 @@ namespace bs
 	{ }
 
 	ProjectLibrary::FileEntry::FileEntry()
-		: lastUpdateTime(0)
+		: hasMeta(false), includeInBuild(false), lastUpdateTime(0), sourceSize(0), sourceModifiedTime(0), sourceHash(0)
+		, metaModifiedTime(0), importOptionsHash(0), mMetaAccessTime(0.0f)
 	{ }
 
 	ProjectLibrary::FileEntry::FileEntry(const Path& path, const String& name, DirectoryEntry* parent)
-		: LibraryEntry(path, name, parent, LibraryEntryType::File), lastUpdateTime(0)
+		: LibraryEntry(path, name, parent, LibraryEntryType::File), hasMeta(false), includeInBuild(false)
+		, lastUpdateTime(0), sourceSize(0), sourceModifiedTime(0), sourceHash(0), metaModifiedTime(0)
+		, importOptionsHash(0), mMetaAccessTime(0.0f)
 	{ }
 
+	SPtr<ProjectFileMeta> ProjectLibrary::FileEntry::getMeta()
+	{
+		mMetaAccessTime = gTime().getTime();
+
+		if (mMeta != nullptr || !hasMeta)
+			return mMeta;
+
+		Path metaPath = path;
+		metaPath.setFilename(metaPath.getFilename() + ".meta");
+
+		if (!FileSystem::isFile(metaPath))
+			return nullptr;
+
+		FileDecoder fs(metaPath);
+		SPtr<IReflectable> loadedMeta = fs.decode();
+
+		if (loadedMeta == nullptr || !loadedMeta->isDerivedFrom(ProjectFileMeta::getRTTIStatic()))
+		{
+			LOGWRN("Unable to load meta-data for \"" + path.toString() + "\".");
+			return nullptr;
+		}
+
+		mMeta = std::static_pointer_cast<ProjectFileMeta>(loadedMeta);
+		return mMeta;
+	}
+
+	void ProjectLibrary::FileEntry::setMeta(const SPtr<ProjectFileMeta>& meta)
+	{
+		mMeta = meta;
+		mMetaAccessTime = gTime().getTime();
+
+		resources.clear();
+		if (meta == nullptr)
+		{
+			hasMeta = false;
+			includeInBuild = false;
+			return;
+		}
+
+		hasMeta = true;
+		includeInBuild = meta->getIncludeInBuild();
+
+		for (auto& resMeta : meta->getResourceMetaData())
+			resources.push_back({ resMeta->getUUID(), resMeta->getTypeID(), resMeta->getUniqueName() });
+	}
+
+	bool ProjectLibrary::FileEntry::evictMeta()
+	{
+		if (mMeta == nullptr || mMeta.use_count() > 1)
+			return false;
+
+		mMeta = nullptr;
+		return true;
+	}
+
+	bool ProjectLibrary::FileEntry::hasTypeId(UINT32 typeId) const
+	{
+		for (auto& resource : resources)
+		{
+			if (resource.typeId == typeId)
+				return true;
+		}
+
+		return false;
+	}
+
 	ProjectLibrary::DirectoryEntry::DirectoryEntry()
 	{ }
 
@@ -52,14 +274,36 @@ namespace bs
 	{ }
 
 	ProjectLibrary::ProjectLibrary()
-		: mRootEntry(nullptr), mIsLoaded(false)
+		: mRootEntry(nullptr), mIsLoaded(false), mDependencyGraph(nullptr), mResourceLocations(nullptr)
+		, mReferenceGraph(nullptr), mSearchIndex(nullptr), mFolderMonitor(nullptr), mFullScanQueued(false)
+		, mJournal(nullptr), mSnapshotSize(0)
+		, mLastJournalFlushTime(0.0f), mLastMetaEvictionTime(0.0f), mBatch(nullptr), mBatchDepth(0)
+		, mImportQueueSequence(0), mImportTimePerResource(0.0f)
 	{
+		mSearchIndex = bs_new<ProjectLibrarySearchIndex>();
+		mDependencyGraph = bs_new<ImportDependencyGraph>();
+		mResourceLocations = bs_new<ResourceLocationMap>();
+		mReferenceGraph = bs_new<ResourceReferenceGraph>();
+
 		mRootEntry = bs_new<DirectoryEntry>(mResourcesFolder, mResourcesFolder.getTail(), nullptr);
+		addToIndex(mRootEntry);
 	}
 
 	ProjectLibrary::~ProjectLibrary()
 	{
+		stopWatching();
 		clearEntries();
+
+		if (mJournal != nullptr)
+			bs_delete(mJournal);
+
+		if (mBatch != nullptr)
+			bs_delete(mBatch);
+
+		bs_delete(mSearchIndex);
+		bs_delete(mDependencyGraph);
+		bs_delete(mResourceLocations);
+		bs_delete(mReferenceGraph);
 	}
 
 	void ProjectLibrary::checkForModifications(const Path& fullPath)
@@ -69,6 +313,30 @@ namespace bs
 	}
 
 	void ProjectLibrary::checkForModifications(const Path& fullPath, bool import, Vector<Path>& dirtyResources)
+	{
+		if(!import)
+		{
+			scanForModifications(fullPath, nullptr, dirtyResources);
+			return;
+		}
+
+		Vector<FileEntry*> toImport;
+		Vector<Path> newResources;
+		scanForModifications(fullPath, &toImport, newResources);
+
+		importResources(toImport);
+
+		// Newly added resources are always reported, while existing ones only if they failed to import
+		UnorderedSet<Path> newResourceSet(newResources.begin(), newResources.end());
+		for(auto& entry : toImport)
+		{
+			if (newResourceSet.find(entry->path) != newResourceSet.end() || !isUpToDate(entry))
+				dirtyResources.push_back(entry->path);
+		}
+	}
+
+	void ProjectLibrary::scanForModifications(const Path& fullPath, Vector<FileEntry*>* toImport,
+		Vector<Path>& dirtyResources)
 	{
 		if (!mResourcesFolder.includes(fullPath))
 			return; // Folder not part of our resources path, so no modifications
@@ -76,6 +344,7 @@ namespace bs
 		if(mRootEntry == nullptr)
 		{
 			mRootEntry = bs_new<DirectoryEntry>(mResourcesFolder, mResourcesFolder.getTail(), nullptr);
+			addToIndex(mRootEntry);
 		}
 
 		Path pathToSearch = fullPath;
@@ -111,8 +380,11 @@ namespace bs
 
 					if (FileSystem::isFile(pathToSearch))
 					{
-						if (import)
-							addResourceInternal(entryParent, pathToSearch);
+						if (toImport != nullptr)
+						{
+							FileEntry* newEntry = addResourceInternal(entryParent, pathToSearch, nullptr, false, false);
+							toImport->push_back(newEntry);
+						}
 
 						dirtyResources.push_back(pathToSearch);
 					}
@@ -120,7 +392,7 @@ namespace bs
 					{
 						addDirectoryInternal(entryParent, pathToSearch);
 
-						checkForModifications(pathToSearch, import, dirtyResources);
+						scanForModifications(pathToSearch, toImport, dirtyResources);
 					}
 				}
 			}
@@ -131,10 +403,9 @@ namespace bs
 			{
 				FileEntry* resEntry = static_cast<FileEntry*>(entry);
 
-				if (import)
-					reimportResourceInternal(resEntry);
-
-				if (!isUpToDate(resEntry))
+				if (toImport != nullptr)
+					toImport->push_back(resEntry);
+				else if (!isUpToDate(resEntry))
 					dirtyResources.push_back(entry->path);
 			}
 			else
@@ -205,16 +476,19 @@ namespace bs
 
 							if(existingEntry != nullptr)
 							{
-								if (import)
-									reimportResourceInternal(existingEntry);
-
-								if (!isUpToDate(existingEntry))
+								if (toImport != nullptr)
+									toImport->push_back(existingEntry);
+								else if (!isUpToDate(existingEntry))
 									dirtyResources.push_back(existingEntry->path);
 							}
 							else
 							{
-								if (import)
-									addResourceInternal(currentDir, filePath);
+								if (toImport != nullptr)
+								{
+									FileEntry* newEntry = addResourceInternal(currentDir, filePath, nullptr, false,
+										false);
+									toImport->push_back(newEntry);
+								}
 
 								dirtyResources.push_back(filePath);
 							}
@@ -272,13 +546,16 @@ namespace bs
 	}
 
 	ProjectLibrary::FileEntry* ProjectLibrary::addResourceInternal(DirectoryEntry* parent, const Path& filePath, 
-		const SPtr<ImportOptions>& importOptions, bool forceReimport)
+		const SPtr<ImportOptions>& importOptions, bool forceReimport, bool import)
 	{
 		FileEntry* newResource = bs_new<FileEntry>(filePath, filePath.getTail(), parent);
 		parent->mChildren.push_back(newResource);
+		addToIndex(newResource);
+
+		if(import)
+			reimportResourceInternal(newResource, importOptions, forceReimport);
 
-		reimportResourceInternal(newResource, importOptions, forceReimport);
-		onEntryAdded(newResource->path);
+		notifyEntryAdded(newResource->path);
 
 		return newResource;
 	}
@@ -287,19 +564,21 @@ namespace bs
 	{
 		DirectoryEntry* newEntry = bs_new<DirectoryEntry>(dirPath, dirPath.getTail(), parent);
 		parent->mChildren.push_back(newEntry);
+		addToIndex(newEntry);
 
-		onEntryAdded(newEntry->path);
+		notifyEntryAdded(newEntry->path);
 		return newEntry;
 	}
 
 	void ProjectLibrary::deleteResourceInternal(FileEntry* resource)
 	{
-		if(resource->meta != nullptr)
+		finishBackgroundImport();
+
+		if(resource->hasMeta)
 		{
-			auto& resourceMetas = resource->meta->getResourceMetaData();
-			for(auto& entry : resourceMetas)
+			for(auto& entry : resource->resources)
 			{
-				const UUID& uuid = entry->getUUID();
+				const UUID& uuid = entry.uuid;
 
 				Path path;
 				if (mResourceManifest->uuidToFilePath(uuid, path))
@@ -308,9 +587,12 @@ namespace bs
 						FileSystem::remove(path);
 
 					mResourceManifest->unregisterResource(uuid);
+					markResourceDirty(uuid);
 				}
 
-				mUUIDToPath.erase(uuid);
+				mResourceLocations->erase(uuid);
+				mReferenceGraph->removeReferences(uuid);
+				mMissingReferences.erase(uuid);
 			}
 		}
 
@@ -323,14 +605,15 @@ namespace bs
 			[&] (const LibraryEntry* entry) { return entry == resource; });
 
 		parent->mChildren.erase(findIter);
+		removeFromIndex(resource);
 
 		Path originalPath = resource->path;
-		onEntryRemoved(originalPath);
+		notifyEntryRemoved(originalPath);
 
 		removeDependencies(resource);
 		bs_delete(resource);
 
-		reimportDependants(originalPath);
+		reimportDependants({ originalPath });
 	}
 
 	void ProjectLibrary::deleteDirectoryInternal(DirectoryEntry* directory)
@@ -356,17 +639,171 @@ namespace bs
 			parent->mChildren.erase(findIter);
 		}
 
-		onEntryRemoved(directory->path);
+		removeFromIndex(directory);
+		notifyEntryRemoved(directory->path);
 		bs_delete(directory);
 	}
 
+	/** Information about a single resource (re)import, shared between the preparation, execution and finalization. */
+	struct ProjectLibrary::QueuedImport
+	{
+		FileEntry* entry = nullptr;
+		Path sourcePath; // Copy of the entry path, so worker threads never need to access the entry
+		Path metaPath;
+		SPtr<ImportOptions> importOptions;
+		bool native = false;
+		bool pruneResourceMetas = false;
+
+		Vector<SubResourceRaw> importedResources;
+		UINT64 sourceSize = 0;
+		std::time_t sourceModifiedTime = 0;
+		UINT64 sourceHash = 0;
+
+		SPtr<ImportCache> importCache;
+		Vector<ImportCache::CachedResource> cachedResources;
+		UINT64 importOptionsHash = 0;
+		Vector<Path> dependencies;
+		Path resourcesFolder;
+		UINT64 cacheKey = 0;
+		bool restoredFromCache = false;
+	};
+
+	/** Resources taken from the background import queue, whose source files are being hashed on worker threads. */
+	struct ProjectLibrary::BackgroundImport
+	{
+		Vector<QueuedImport> imports;
+		Vector<SPtr<Task>> tasks;
+		Timer timer;
+	};
+
 	void ProjectLibrary::reimportResourceInternal(FileEntry* fileEntry, const SPtr<ImportOptions>& importOptions,
 		bool forceReimport, bool pruneResourceMetas)
 	{
+		finishBackgroundImport();
+
+		QueuedImport import;
+		if (!prepareImport(fileEntry, importOptions, forceReimport, pruneResourceMetas, import))
+			return;
+
+		executeImport(import);
+		finalizeImport(import);
+
+		reimportDependants({ fileEntry->path });
+	}
+
+	void ProjectLibrary::importResources(const Vector<FileEntry*>& files, bool forceReimport)
+	{
+		Vector<Path> imported = importBatch(files, forceReimport);
+		if (!imported.empty())
+			reimportDependants(imported);
+	}
+
+	Vector<Path> ProjectLibrary::importBatch(const Vector<FileEntry*>& files, bool forceReimport,
+		const Vector<SPtr<ImportOptions>>& importOptions)
+	{
+		finishBackgroundImport();
+
+		Vector<Path> imported;
+
+		Vector<QueuedImport> imports;
+		imports.reserve(files.size());
+
+		for(UINT32 i = 0; i < (UINT32)files.size(); i++)
+		{
+			SPtr<ImportOptions> entryImportOptions;
+			if (i < (UINT32)importOptions.size())
+				entryImportOptions = importOptions[i];
+
+			QueuedImport import;
+			if (prepareImport(files[i], entryImportOptions, forceReimport, false, import))
+				imports.push_back(std::move(import));
+		}
+
+		if (imports.empty())
+			return imported;
+
+		// Resources that have an import dependency on another resource in the batch (e.g. a shader including a modified
+		// include file) must wait until that resource is imported. Split the imports into waves where all imports
+		// within a wave are independent, and can therefore be processed in parallel.
+		UnorderedSet<Path> pending;
+		for(auto& import : imports)
+			pending.insert(import.entry->path);
+
+		Vector<UINT32> remaining(imports.size());
+		for(UINT32 i = 0; i < (UINT32)imports.size(); i++)
+			remaining[i] = i;
+
+		Vector<UINT32> wave;
+		Vector<UINT32> deferred;
+		Vector<SPtr<Task>> tasks;
+		while(!remaining.empty())
+		{
+			wave.clear();
+			deferred.clear();
+
+			for(auto& idx : remaining)
+			{
+				bool isBlocked = false;
+				const Vector<Path>& dependencies = mDependencyGraph->getDependencies(imports[idx].entry->path);
+				for(auto& dependency : dependencies)
+				{
+					if(dependency != imports[idx].entry->path && pending.find(dependency) != pending.end())
+					{
+						isBlocked = true;
+						break;
+					}
+				}
+
+				if (isBlocked)
+					deferred.push_back(idx);
+				else
+					wave.push_back(idx);
+			}
+
+			// Circular dependencies, nothing we can do but import the rest in any order
+			if(wave.empty())
+				std::swap(wave, deferred);
+
+			// Hash the source files and read the import cache in parallel. Importing itself, and loading of native
+			// resources, is done during finalization since it must happen on the main thread.
+			tasks.clear();
+			for(auto& idx : wave)
+			{
+				QueuedImport* import = &imports[idx];
+				SPtr<Task> task = Task::create("ProjectLibraryImport", [import]() { executeImport(*import); });
+				TaskScheduler::instance().addTask(task);
+
+				tasks.push_back(task);
+			}
+
+			for(auto& task : tasks)
+				task->wait();
+
+			// Commit the results in order
+			for(auto& idx : wave)
+			{
+				finalizeImport(imports[idx]);
+				pending.erase(imports[idx].entry->path);
+				imported.push_back(imports[idx].entry->path);
+			}
+
+			remaining = deferred;
+		}
+
+		return imported;
+	}
+
+	bool ProjectLibrary::prepareImport(FileEntry* fileEntry, const SPtr<ImportOptions>& importOptions, 
+		bool forceReimport, bool pruneResourceMetas, QueuedImport& import)
+	{
+		// Resource is being imported now, so it no longer needs to wait in the background queue
+		if (!mImportQueue.empty())
+			dequeueImport(getEntryKey(fileEntry->path));
+
 		Path metaPath = fileEntry->path;
 		metaPath.setFilename(metaPath.getFilename() + ".meta");
 
-		if(fileEntry->meta == nullptr)
+		if(!fileEntry->hasMeta)
 		{
 			if(FileSystem::isFile(metaPath))
 			{
@@ -376,297 +813,420 @@ namespace bs
 				if(loadedMeta != nullptr && loadedMeta->isDerivedFrom(ProjectFileMeta::getRTTIStatic()))
 				{
 					SPtr<ProjectFileMeta> fileMeta = std::static_pointer_cast<ProjectFileMeta>(loadedMeta);
-					fileEntry->meta = fileMeta;
+					fileEntry->setMeta(fileMeta);
+					mSearchIndex->update(fileEntry);
+					markEntryDirty(fileEntry->path);
+					addDependencies(fileEntry);
+					mResourceLocations->set(fileEntry);
+					queueMissingReferences(fileEntry);
+				}
+			}
+		}
 
-					auto& resourceMetas = fileEntry->meta->getResourceMetaData();
+		if (isUpToDate(fileEntry) && !forceReimport)
+			return false;
 
-					if (resourceMetas.size() > 0)
-					{
-						mUUIDToPath[resourceMetas[0]->getUUID()] = fileEntry->path;
+		// Note: If resource is native we just copy it to the internal folder. We could avoid the copy and 
+		// load the resource directly from the Resources folder but that requires complicating library code.
+		bool isNativeResource = isNative(fileEntry->path);
 
-						for (UINT32 i = 1; i < (UINT32)resourceMetas.size(); i++)
-						{
-							SPtr<ProjectResourceMeta> entry = resourceMetas[i];
-							mUUIDToPath[entry->getUUID()] = fileEntry->path + entry->getUniqueName();
-						}
-					}
-				}
-			}
+		SPtr<ImportOptions> curImportOptions = nullptr;
+		if (importOptions == nullptr && !isNativeResource)
+		{
+			SPtr<ProjectFileMeta> fileMeta = fileEntry->getMeta();
+			if (fileMeta != nullptr)
+				curImportOptions = fileMeta->getImportOptions();
+			else
+				curImportOptions = Importer::instance().createImportOptions(fileEntry->path);
+		}
+		else
+			curImportOptions = importOptions;
+
+		import.entry = fileEntry;
+		import.sourcePath = fileEntry->path;
+		import.metaPath = metaPath;
+		import.importOptions = curImportOptions;
+		import.native = isNativeResource;
+		import.pruneResourceMetas = pruneResourceMetas;
+
+		if (!isNativeResource && mImportCache != nullptr)
+		{
+			import.importCache = mImportCache;
+			import.importOptionsHash = ContentHash::computeObject(curImportOptions.get());
+
+			// Dependencies as of the last import. If the import changes them the key is recalculated before storing.
+			import.dependencies = mDependencyGraph->getDependencies(fileEntry->path);
+			import.resourcesFolder = mResourcesFolder;
+		}
+
+		return true;
+	}
+
+	void ProjectLibrary::executeImport(QueuedImport& import)
+	{
+		// Query the timestamp before hashing, so any modifications made during import are detected on the next check
+		import.sourceModifiedTime = FileSystem::getLastModifiedTime(import.sourcePath);
+		import.sourceSize = FileSystem::getFileSize(import.sourcePath);
+		import.sourceHash = ContentHash::computeFile(import.sourcePath);
+
+		if (import.native)
+			return;
+
+		// Output of an import also depends on the contents of its dependencies (e.g. shader includes), so those are
+		// part of the key as well. Otherwise a reimport triggered by a modified include would restore stale results.
+		UINT64 dependenciesHash;
+		if (import.importCache != nullptr && import.sourceHash != 0 &&
+			hashImportDependencies(import.dependencies, import.resourcesFolder, dependenciesHash))
+		{
+			import.cacheKey = ImportCache::getKey(import.sourcePath, import.sourceHash, import.importOptionsHash,
+				dependenciesHash);
+			import.restoredFromCache = import.importCache->read(import.cacheKey, import.cachedResources);
+		}
+	}
+
+	void ProjectLibrary::finalizeImport(QueuedImport& import)
+	{
+		// Cached resources are only read on the worker thread, since deserializing them might create core objects
+		if (import.restoredFromCache)
+		{
+			import.restoredFromCache = import.importCache->decode(import.cachedResources, import.importedResources);
+			import.cachedResources.clear();
 		}
 
-		if (!isUpToDate(fileEntry) || forceReimport)
+		// Importers create core objects, and some keep state shared between imports, so they run on the main thread
+		if (!import.native && !import.restoredFromCache)
+			import.importedResources = gImporter()._importAll(import.entry->path, import.importOptions);
+
+		FileEntry* fileEntry = import.entry;
+		SPtr<ProjectFileMeta> fileMeta = fileEntry->getMeta();
+
+		// Resources no longer in the file must not keep referencing the entry
+		for (auto& resHeader : fileEntry->resources)
 		{
-			// Note: If resource is native we just copy it to the internal folder. We could avoid the copy and 
-			// load the resource directly from the Resources folder but that requires complicating library code.
-			bool isNativeResource = isNative(fileEntry->path);
+			mResourceLocations->erase(resHeader.uuid);
+			mReferenceGraph->removeReferences(resHeader.uuid);
+		}
 
-			SPtr<ImportOptions> curImportOptions = nullptr;
-			if (importOptions == nullptr && !isNativeResource)
+		Vector<SubResource> importedResources;
+		if (import.native)
+		{
+			// If meta exists make sure it is registered in the manifest before load, otherwise it will get assigned a
+			// new UUID. This can happen if library isn't properly saved before exiting the application.
+			if (fileMeta != nullptr)
 			{
-				if (fileEntry->meta != nullptr)
-					curImportOptions = fileEntry->meta->getImportOptions();
-				else
-					curImportOptions = Importer::instance().createImportOptions(fileEntry->path);
+				auto& resourceMetas = fileMeta->getResourceMetaData();
+				mResourceManifest->registerResource(resourceMetas[0]->getUUID(), fileEntry->path);
+				markResourceDirty(resourceMetas[0]->getUUID());
 			}
-			else
-				curImportOptions = importOptions;
 
-			Vector<SubResource> importedResources;
-			if (isNativeResource)
+			// Don't load dependencies because we don't need them, but also because they might not be in the manifest
+			// which would screw up their UUIDs.
+			HResource resource = gResources().load(fileEntry->path, ResourceLoadFlag::KeepSourceData);
+			importedResources.push_back({ "primary", resource });
+		}
+
+		if(fileMeta == nullptr)
+		{
+			if (!import.native)
 			{
-				// If meta exists make sure it is registered in the manifest before load, otherwise it will get assigned a new UUID.
-				// This can happen if library isn't properly saved before exiting the application.
-				if (fileEntry->meta != nullptr)
+				for(auto& resEntry : import.importedResources)
 				{
-					auto& resourceMetas = fileEntry->meta->getResourceMetaData();
-					mResourceManifest->registerResource(resourceMetas[0]->getUUID(), fileEntry->path);
+					HResource importedResource = gResources()._createResourceHandle(resEntry.value);
+					importedResources.push_back({ resEntry.name, importedResource });
 				}
-
-				// Don't load dependencies because we don't need them, but also because they might not be in the manifest
-				// which would screw up their UUIDs.
-				importedResources.push_back({ "primary", gResources().load(fileEntry->path, ResourceLoadFlag::KeepSourceData) });
 			}
 
-			if(fileEntry->meta == nullptr)
-			{
-				if (!isNativeResource)
-					importedResources = Importer::instance().importAll(fileEntry->path, curImportOptions);
-
-				fileEntry->meta = ProjectFileMeta::create(curImportOptions);
-
-				for(auto& entry : importedResources)
-				{
-					SPtr<ResourceMetaData> subMeta = entry.value->getMetaData();
-					UINT32 typeId = entry.value->getTypeId();
-					const UUID& UUID = entry.value.getUUID();
-					Path::stripInvalid(entry.name);
+			fileMeta = ProjectFileMeta::create(import.importOptions);
 
-					SPtr<ProjectResourceMeta> resMeta = ProjectResourceMeta::create(entry.name, UUID, typeId, subMeta);
-					fileEntry->meta->add(resMeta);
-				}
+			for(auto& entry : importedResources)
+			{
+				SPtr<ResourceMetaData> subMeta = entry.value->getMetaData();
+				UINT32 typeId = entry.value->getTypeId();
+				const UUID& UUID = entry.value.getUUID();
+				Path::stripInvalid(entry.name);
 
-				if(importedResources.size() > 0)
-				{
-					HResource primary = importedResources[0].value;
+				SPtr<ProjectResourceMeta> resMeta = ProjectResourceMeta::create(entry.name, UUID, typeId, subMeta);
+				fileMeta->add(resMeta);
+			}
 
-					mUUIDToPath[primary.getUUID()] = fileEntry->path;
-					for (UINT32 i = 1; i < (UINT32)importedResources.size(); i++)
-					{
-						SubResource& entry = importedResources[i];
+			fileEntry->setMeta(fileMeta);
 
-						const UUID& UUID = entry.value.getUUID();
-						mUUIDToPath[UUID] = fileEntry->path + entry.name;
-					}
-				}
+			FileEncoder fs(import.metaPath);
+			fs.encode(fileMeta.get());
+		}
+		else
+		{
+			removeDependencies(fileEntry);
 
-				FileEncoder fs(metaPath);
-				fs.encode(fileEntry->meta.get());
-			}
-			else
+			if (!import.native)
 			{
-				removeDependencies(fileEntry);
+				Vector<SPtr<ProjectResourceMeta>> existingResourceMetas = fileMeta->getAllResourceMetaData();
+				fileMeta->clearResourceMetaData();
 
-				if (!isNativeResource)
+				for(auto& resEntry : import.importedResources)
 				{
-					Vector<SubResourceRaw> importedResourcesRaw = gImporter()._importAll(fileEntry->path, curImportOptions);
-					Vector<SPtr<ProjectResourceMeta>> existingResourceMetas = fileEntry->meta->getAllResourceMetaData();
-					fileEntry->meta->clearResourceMetaData();
+					Path::stripInvalid(resEntry.name);
 
-					for(auto& resEntry : importedResourcesRaw)
+					bool foundMeta = false;
+					for (auto iter = existingResourceMetas.begin(); iter != existingResourceMetas.end(); ++iter)
 					{
-						Path::stripInvalid(resEntry.name);
+						SPtr<ProjectResourceMeta> metaEntry = *iter;
 
-						bool foundMeta = false;
-						for (auto iter = existingResourceMetas.begin(); iter != existingResourceMetas.end(); ++iter)
+						if(resEntry.name == metaEntry->getUniqueName())
 						{
-							SPtr<ProjectResourceMeta> metaEntry = *iter;
-
-							if(resEntry.name == metaEntry->getUniqueName())
-							{
-								HResource importedResource = gResources()._getResourceHandle(metaEntry->getUUID());
-								gResources().update(importedResource, resEntry.value);
-
-								importedResources.push_back({ resEntry.name, importedResource });
-								fileEntry->meta->add(metaEntry);
-
-								existingResourceMetas.erase(iter);
-								foundMeta = true;
-								break;
-							}
-						}
+							HResource importedResource = gResources()._getResourceHandle(metaEntry->getUUID());
+							gResources().update(importedResource, resEntry.value);
 
-						if(!foundMeta)
-						{
-							HResource importedResource = gResources()._createResourceHandle(resEntry.value);
 							importedResources.push_back({ resEntry.name, importedResource });
+							fileMeta->add(metaEntry);
 
-							SPtr<ResourceMetaData> subMeta = resEntry.value->getMetaData();
-							UINT32 typeId = resEntry.value->getTypeId();
-							const UUID& UUID = importedResource.getUUID();
-
-							SPtr<ProjectResourceMeta> resMeta = ProjectResourceMeta::create(resEntry.name, UUID, typeId, subMeta);
-							fileEntry->meta->add(resMeta);
+							existingResourceMetas.erase(iter);
+							foundMeta = true;
+							break;
 						}
 					}
 
-					// Keep resource metas that we are not currently using, in case they get restored so their references
-					// don't get broken
-					if(!pruneResourceMetas)
+					if(!foundMeta)
 					{
-						for (auto& entry : existingResourceMetas)
-							fileEntry->meta->addInactive(entry);
-					}
+						HResource importedResource = gResources()._createResourceHandle(resEntry.value);
+						importedResources.push_back({ resEntry.name, importedResource });
 
-					// Update UUID to path mapping
-					auto& resourceMetas = fileEntry->meta->getResourceMetaData();
-					if (resourceMetas.size() > 0)
-					{
-						mUUIDToPath[resourceMetas[0]->getUUID()] = fileEntry->path;
+						SPtr<ResourceMetaData> subMeta = resEntry.value->getMetaData();
+						UINT32 typeId = resEntry.value->getTypeId();
+						const UUID& UUID = importedResource.getUUID();
 
-						for (UINT32 i = 1; i < (UINT32)resourceMetas.size(); i++)
-						{
-							SPtr<ProjectResourceMeta> entry = resourceMetas[i];
-							mUUIDToPath[entry->getUUID()] = fileEntry->path + entry->getUniqueName();
-						}
+						SPtr<ProjectResourceMeta> resMeta = ProjectResourceMeta::create(resEntry.name, UUID, typeId,
+							subMeta);
+						fileMeta->add(resMeta);
 					}
 				}
 
-				fileEntry->meta->mImportOptions = curImportOptions;
-
-				FileEncoder fs(metaPath);
-				fs.encode(fileEntry->meta.get());
+				// Keep resource metas that we are not currently using, in case they get restored so their references
+				// don't get broken
+				if(!import.pruneResourceMetas)
+				{
+					for (auto& entry : existingResourceMetas)
+						fileMeta->addInactive(entry);
+				}
 			}
 
-			addDependencies(fileEntry);
-
-			if (importedResources.size() > 0)
-			{
-				Path internalResourcesPath = mProjectFolder;
-				internalResourcesPath.append(INTERNAL_RESOURCES_DIR);
+			fileMeta->mImportOptions = import.importOptions;
 
-				if (!FileSystem::isDirectory(internalResourcesPath))
-					FileSystem::createDir(internalResourcesPath);
+			fileEntry->setMeta(fileMeta);
 
-				for (auto& entry : importedResources)
-				{
-					String uuidStr = entry.value.getUUID().toString();
+			FileEncoder fs(import.metaPath);
+			fs.encode(fileMeta.get());
+		}
 
-					internalResourcesPath.setFilename(uuidStr + ".asset");
-					gResources().save(entry.value, internalResourcesPath, true);
+		mResourceLocations->set(fileEntry);
+		mSearchIndex->update(fileEntry);
+		markEntryDirty(fileEntry->path);
+		addDependencies(fileEntry);
 
-					const UUID& uuid = entry.value.getUUID();
-					mResourceManifest->registerResource(uuid, internalResourcesPath);
+		// Resource serialization might need to read data from the core thread, so cache is populated on the main thread
+		if (import.importCache != nullptr && import.sourceHash != 0 && !import.restoredFromCache &&
+			!import.importedResources.empty())
+		{
+			// Entry must be stored under the dependencies the resource was actually imported with. This also ensures
+			// a first import, whose dependencies aren't known until now, never matches a result that had dependencies.
+			UINT64 cacheKey = import.cacheKey;
+			const Vector<Path>& dependencies = mDependencyGraph->getDependencies(fileEntry->path);
+			if (cacheKey == 0 || dependencies != import.dependencies)
+			{
+				UINT64 dependenciesHash;
+				if (hashImportDependencies(dependencies, mResourcesFolder, dependenciesHash))
+				{
+					cacheKey = ImportCache::getKey(fileEntry->path, import.sourceHash, import.importOptionsHash,
+						dependenciesHash);
 				}
+				else
+					cacheKey = 0;
 			}
 
-			fileEntry->lastUpdateTime = std::time(nullptr);
+			if (cacheKey != 0)
+				import.importCache->store(cacheKey, import.importedResources);
+		}
+
+		// Raw data is no longer needed, release it as soon as possible
+		import.importedResources.clear();
+
+		if (importedResources.size() > 0)
+		{
+			Path internalResourcesPath = mProjectFolder;
+			internalResourcesPath.append(INTERNAL_RESOURCES_DIR);
+
+			if (!FileSystem::isDirectory(internalResourcesPath))
+				FileSystem::createDir(internalResourcesPath);
 
-			onEntryImported(fileEntry->path);
-			reimportDependants(fileEntry->path);
+			for (auto& entry : importedResources)
+			{
+				String uuidStr = entry.value.getUUID().toString();
+
+				internalResourcesPath.setFilename(uuidStr + ".asset");
+				gResources().save(entry.value, internalResourcesPath, true);
+				recordReferences(entry.value);
+
+				const UUID& uuid = entry.value.getUUID();
+				mResourceManifest->registerResource(uuid, internalResourcesPath);
+				markResourceDirty(uuid);
+			}
 		}
+
+		fileEntry->lastUpdateTime = std::time(nullptr);
+		fileEntry->sourceSize = import.sourceSize;
+		fileEntry->sourceModifiedTime = import.sourceModifiedTime;
+		fileEntry->sourceHash = import.sourceHash;
+		fileEntry->metaModifiedTime = FileSystem::getLastModifiedTime(import.metaPath);
+		fileEntry->importOptionsHash = ContentHash::computeObject(fileMeta->getImportOptions().get());
+
+		onEntryImported(fileEntry->path);
 	}
 
-	bool ProjectLibrary::isUpToDate(FileEntry* resource) const
+	bool ProjectLibrary::isUpToDate(FileEntry* resource)
 	{
-		if(resource->meta == nullptr)
+		if(!resource->hasMeta)
 			return false;
 
-		auto& resourceMetas = resource->meta->getResourceMetaData();
-		for (auto& resMeta : resourceMetas)
+		for (auto& resHeader : resource->resources)
 		{
 			Path internalPath;
-			if (!mResourceManifest->uuidToFilePath(resMeta->getUUID(), internalPath))
+			if (!mResourceManifest->uuidToFilePath(resHeader.uuid, internalPath))
 				return false;
 
 			if (!FileSystem::isFile(internalPath))
 				return false;
 		}
 
-		std::time_t lastModifiedTime = FileSystem::getLastModifiedTime(resource->path);
-		return lastModifiedTime <= resource->lastUpdateTime;
-	}
+		// Entry was imported before content hashes were tracked, fall back to comparing timestamps
+		if(resource->sourceHash == 0)
+		{
+			std::time_t lastModifiedTime = FileSystem::getLastModifiedTime(resource->path);
+			return lastModifiedTime <= resource->lastUpdateTime;
+		}
 
-	Vector<ProjectLibrary::LibraryEntry*> ProjectLibrary::search(const String& pattern)
-	{
-		return search(pattern, {});
-	}
+		// Import options might have been modified externally (e.g. by version control). The loaded meta-data doesn't
+		// know about that, so it is replaced with the one on disk. Reloading only records the new modification time if
+		// the import options are unchanged.
+		Path metaPath = getMetaPath(resource->path);
+		std::time_t metaModifiedTime = FileSystem::getLastModifiedTime(metaPath);
+		if(metaModifiedTime != resource->metaModifiedTime)
+		{
+			reloadMeta(resource);
+			if (resource->metaModifiedTime != metaModifiedTime)
+				return false;
+		}
 
-	Vector<ProjectLibrary::LibraryEntry*> ProjectLibrary::search(const String& pattern, const Vector<UINT32>& typeIds)
-	{
-		Vector<LibraryEntry*> foundEntries;
+		UINT64 sourceSize = FileSystem::getFileSize(resource->path);
+		if (sourceSize != resource->sourceSize)
+			return false;
 
-		std::regex escape("[.^$|()\\[\\]{}*+?\\\\]");
-		String replace("\\\\&");
-		String escapedPattern = std::regex_replace(pattern, escape, replace, std::regex_constants::match_default | std::regex_constants::format_sed);
+		std::time_t sourceModifiedTime = FileSystem::getLastModifiedTime(resource->path);
+		if (sourceModifiedTime == resource->sourceModifiedTime)
+			return true;
 
-		// For some reason MSVC stdlib implementation requires a different pattern than stdlib one
-#if BS_PLATFORM == BS_PLATFORM_WIN32
-		std::regex wildcard("\\\\\\*");
-#else
-		std::regex wildcard("\\\\\\\\\\*");
-#endif
-		String wildcardReplace(".*");
-		String searchPattern = std::regex_replace(escapedPattern, wildcard, ".*");
+		// Timestamp changed but the size didn't, only a content comparison can tell if the file was actually modified
+		UINT64 sourceHash = ContentHash::computeFile(resource->path);
+		if (sourceHash != resource->sourceHash)
+			return false;
 
-		std::regex searchRegex(searchPattern, std::regex_constants::ECMAScript | std::regex_constants::icase);
+		resource->sourceModifiedTime = sourceModifiedTime;
+		return true;
+	}
 
-		Stack<DirectoryEntry*> todo;
-		todo.push(mRootEntry);
-		while (!todo.empty())
+	void ProjectLibrary::setImportCacheFolder(const Path& folder)
+	{
+		if (folder.isEmpty())
 		{
-			DirectoryEntry* dirEntry = todo.top();
-			todo.pop();
+			mImportCache = nullptr;
+			return;
+		}
+
+		if (mImportCache != nullptr && mImportCache->getFolder() == folder)
+			return;
+
+		mImportCache = bs_shared_ptr_new<ImportCache>(folder);
+	}
+
+	Path ProjectLibrary::getImportCacheFolder() const
+	{
+		if (mImportCache == nullptr)
+			return Path::BLANK;
+
+		return mImportCache->getFolder();
+	}
+
+	ImportCacheStatistics ProjectLibrary::getImportCacheStatistics() const
+	{
+		if (mImportCache == nullptr)
+			return ImportCacheStatistics();
+
+		return mImportCache->getStatistics();
+	}
+
+	/** Returns an estimate of the heap memory used by the provided path, in bytes. */
+	static UINT64 getPathMemoryUsage(const Path& path)
+	{
+		UINT64 bytes = path.getNumDirectories() * sizeof(String) + path.getFilename().capacity();
+		for (UINT32 i = 0; i < path.getNumDirectories(); i++)
+			bytes += path[i].capacity();
+
+		return bytes;
+	}
+
+	ProjectLibrary::MemoryStatistics ProjectLibrary::getMemoryStatistics() const
+	{
+		MemoryStatistics stats;
+		for (auto& entry : mEntryLookup)
+		{
+			const LibraryEntry* libEntry = entry.second;
+			stats.entryBytes += getPathMemoryUsage(libEntry->path) + libEntry->elementName.capacity();
 
-			for (auto& child : dirEntry->mChildren)
+			if (libEntry->type == LibraryEntryType::File)
 			{
-				if (std::regex_match(child->elementName, searchRegex))
-				{
-					if (typeIds.size() == 0)
-						foundEntries.push_back(child);
-					else
-					{
-						if (child->type == LibraryEntryType::File)
-						{
-							FileEntry* childFileEntry = static_cast<FileEntry*>(child);
-							if (childFileEntry->meta != nullptr)
-							{
-								auto& resourceMetas = childFileEntry->meta->getResourceMetaData();
-								for (auto& typeId : typeIds)
-								{
-									bool found = false;
-									for (auto& resMeta : resourceMetas)
-									{
-										if (resMeta->getTypeID() == typeId)
-										{
-											foundEntries.push_back(child);
-											found = true;
-											break;
-										}
-									}
-
-									if (found)
-										break;
-								}
-							}
-						}
-					}
-				}
+				const FileEntry* fileEntry = static_cast<const FileEntry*>(libEntry);
 
-				if (child->type == LibraryEntryType::Directory)
-				{
-					DirectoryEntry* childDirEntry = static_cast<DirectoryEntry*>(child);
-					todo.push(childDirEntry);
-				}
+				stats.numFiles++;
+				stats.numResources += (UINT32)fileEntry->resources.size();
+				stats.entryBytes += sizeof(FileEntry);
+
+				stats.resourceBytes += fileEntry->resources.capacity() * sizeof(ResourceHeader);
+				for (auto& resource : fileEntry->resources)
+					stats.resourceBytes += resource.uniqueName.capacity();
+
+				// Every resource would hold its own copy of the file path in a separate hash map node
+				UINT64 pathBytes = sizeof(UUID) + sizeof(Path) + getPathMemoryUsage(fileEntry->path) + 
+					2 * sizeof(void*);
+				stats.resourcePathBytes += fileEntry->resources.size() * pathBytes;
+			}
+			else
+			{
+				const DirectoryEntry* dirEntry = static_cast<const DirectoryEntry*>(libEntry);
+
+				stats.numDirectories++;
+				stats.entryBytes += sizeof(DirectoryEntry) + dirEntry->mChildren.capacity() * sizeof(LibraryEntry*);
 			}
+
+			// Key, value and an estimated per-node overhead of the hash map
+			stats.entryLookupBytes += sizeof(String) + entry.first.capacity() + sizeof(LibraryEntry*) + 
+				2 * sizeof(void*);
 		}
 
-		std::sort(foundEntries.begin(), foundEntries.end(), 
-			[&](const LibraryEntry* a, const LibraryEntry* b) 
-		{ 
-			return a->elementName.compare(b->elementName) < 0;
-		});
+		stats.entryLookupBytes += mEntryLookup.bucket_count() * sizeof(void*);
+		stats.resourceLocationBytes = mResourceLocations->getMemoryUsage();
+		stats.resourcePathBytes += stats.numResources * sizeof(void*);
+
+		return stats;
+	}
+
+	Vector<ProjectLibrary::LibraryEntry*> ProjectLibrary::search(const String& pattern)
+	{
+		return search(pattern, {});
+	}
 
-		return foundEntries;
+	Vector<ProjectLibrary::LibraryEntry*> ProjectLibrary::search(const String& pattern, const Vector<UINT32>& typeIds,
+		UINT32 offset, UINT32 count)
+	{
+		return mSearchIndex->find(pattern, typeIds, offset, count);
 	}
 
 	ProjectLibrary::LibraryEntry* ProjectLibrary::findEntry(const Path& path) const
@@ -680,47 +1240,84 @@ namespace bs
 		else
 			fullPath.makeAbsolute(mResourcesFolder);
 
-		Path relPath = fullPath.getRelative(mRootEntry->path);
+		auto iterFind = mEntryLookup.find(getEntryKey(fullPath));
+		if (iterFind != mEntryLookup.end())
+			return iterFind->second;
+
+		// If the path's parent is a file, the last element is assumed to be a sub-resource name, which we ignore
+		UINT32 numElems = fullPath.getNumDirectories() + (fullPath.isFile() ? 1 : 0);
+		if (numElems == 0)
+			return nullptr;
+
+		Path parentPath = fullPath.getParent();
+		if (!mResourcesFolder.includes(parentPath))
+			return nullptr;
+
+		iterFind = mEntryLookup.find(getEntryKey(parentPath));
+		if (iterFind != mEntryLookup.end() && iterFind->second->type == LibraryEntryType::File)
+			return iterFind->second;
+
+		return nullptr;
+	}
+
+	String ProjectLibrary::getEntryKey(const Path& fullPath) const
+	{
+		Path relPath = fullPath.getRelative(mResourcesFolder);
 		UINT32 numElems = relPath.getNumDirectories() + (relPath.isFile() ? 1 : 0);
-		UINT32 idx = 0;
 
-		LibraryEntry* current = mRootEntry;
-		while (current != nullptr)
+		StringStream key;
+		for(UINT32 i = 0; i < numElems; i++)
 		{
-			if (idx == numElems)
-				return current;
+			if (i > 0)
+				key << '/';
 
-			String curElem;
-			if (relPath.isFile() && idx == (numElems - 1))
-				curElem = relPath.getFilename();
+			if (relPath.isFile() && i == (numElems - 1))
+				key << relPath.getFilename();
 			else
-				curElem = relPath[idx];
-
-			if (current->type == LibraryEntryType::Directory)
-			{
-				DirectoryEntry* dirEntry = static_cast<DirectoryEntry*>(current);
-				current = nullptr;
-				for (auto& child : dirEntry->mChildren)
-				{
-					if (Path::comparePathElem(curElem, child->elementName))
-					{
-						idx++;
-						current = child;
-						break;
-					}
-				}
-			}
-			else // Found file
-			{
-				// If this is next to last element, next entry is assumed to be a sub-resource name, which we ignore
-				if (idx == (numElems - 1))
-					return current;
-				else
-					break; // Not a valid path
-			}
+				key << relPath[i];
 		}
 
-		return nullptr;
+		String output = key.str();
+
+		// Keep in sync with Path::comparePathElem()
+#if BS_PLATFORM == BS_PLATFORM_WIN32
+		StringUtil::toLowerCase(output);
+#endif
+
+		return output;
+	}
+
+	void ProjectLibrary::addToIndex(LibraryEntry* entry, bool recursive)
+	{
+		mEntryLookup[getEntryKey(entry->path)] = entry;
+		markEntryDirty(entry->path, recursive);
+
+		if (entry != mRootEntry)
+			mSearchIndex->add(entry);
+
+		if (!recursive || entry->type != LibraryEntryType::Directory)
+			return;
+
+		DirectoryEntry* dirEntry = static_cast<DirectoryEntry*>(entry);
+		for (auto& child : dirEntry->mChildren)
+			addToIndex(child, true);
+	}
+
+	void ProjectLibrary::removeFromIndex(LibraryEntry* entry, bool recursive)
+	{
+		auto iterFind = mEntryLookup.find(getEntryKey(entry->path));
+		if (iterFind != mEntryLookup.end() && iterFind->second == entry)
+			mEntryLookup.erase(iterFind);
+
+		markEntryDirty(entry->path);
+		mSearchIndex->remove(entry);
+
+		if (!recursive || entry->type != LibraryEntryType::Directory)
+			return;
+
+		DirectoryEntry* dirEntry = static_cast<DirectoryEntry*>(entry);
+		for (auto& child : dirEntry->mChildren)
+			removeFromIndex(child, true);
 	}
 
 	bool ProjectLibrary::isSubresource(const Path& path) const
@@ -758,10 +1355,11 @@ namespace bs
 			if (entry->type == LibraryEntryType::File)
 			{
 				FileEntry* fileEntry = static_cast<FileEntry*>(entry);
-				if (fileEntry->meta == nullptr)
+				SPtr<ProjectFileMeta> fileMeta = fileEntry->getMeta();
+				if (fileMeta == nullptr)
 					return nullptr;
 
-				auto& resourceMetas = fileEntry->meta->getResourceMetaData();
+				auto& resourceMetas = fileMeta->getResourceMetaData();
 				for(auto& resMeta : resourceMetas)
 				{
 					if (resMeta->getUniqueName() == path.getTail())
@@ -781,10 +1379,11 @@ namespace bs
 						if (child->type == LibraryEntryType::File)
 						{
 							FileEntry* fileEntry = static_cast<FileEntry*>(child);
-							if (fileEntry->meta == nullptr)
+							SPtr<ProjectFileMeta> fileMeta = fileEntry->getMeta();
+							if (fileMeta == nullptr || fileMeta->getResourceMetaData().empty())
 								return nullptr;
 
-							return fileEntry->meta->getResourceMetaData()[0];
+							return fileMeta->getResourceMetaData()[0];
 						}
 					}
 				}
@@ -800,21 +1399,17 @@ namespace bs
 				return nullptr;
 
 			FileEntry* fileEntry = static_cast<FileEntry*>(entry);
-			if (fileEntry->meta == nullptr)
+			SPtr<ProjectFileMeta> fileMeta = fileEntry->getMeta();
+			if (fileMeta == nullptr || fileMeta->getResourceMetaData().empty())
 				return nullptr;
 
-			return fileEntry->meta->getResourceMetaData()[0];
+			return fileMeta->getResourceMetaData()[0];
 		}
 	}
 
 	Path ProjectLibrary::uuidToPath(const UUID& uuid) const
 	{
-		auto iterFind = mUUIDToPath.find(uuid);
-
-		if (iterFind != mUUIDToPath.end())
-			return iterFind->second;
-
-		return Path::BLANK;
+		return mResourceLocations->getPath(uuid);
 	}
 
 	void ProjectLibrary::createEntry(const HResource& resource, const Path& path)
@@ -837,7 +1432,7 @@ namespace bs
 
 		Path absPath = assetPath.getAbsolute(getResourcesFolder());
 		Resources::instance().save(resource, absPath, false);
-		checkForModifications(absPath);
+		refreshPath(absPath);
 	}
 
 	void ProjectLibrary::saveEntry(const HResource& resource)
@@ -855,7 +1450,7 @@ namespace bs
 		filePath.makeAbsolute(getResourcesFolder());
 
 		Resources::instance().save(resource, filePath, true);
-		checkForModifications(filePath);
+		refreshPath(filePath);
 	}
 
 	void ProjectLibrary::createFolderEntry(const Path& path)
@@ -892,6 +1487,8 @@ namespace bs
 
 	void ProjectLibrary::moveEntry(const Path& oldPath, const Path& newPath, bool overwrite)
 	{
+		finishBackgroundImport();
+
 		Path oldFullPath = oldPath;
 		if (!oldFullPath.isAbsolute())
 			oldFullPath.makeAbsolute(mResourcesFolder);
@@ -926,32 +1523,13 @@ namespace bs
 			}
 			else // Just moving internally
 			{
-				onEntryRemoved(oldEntry->path);
+				notifyEntryRemoved(oldEntry->path);
 
 				FileEntry* fileEntry = nullptr;
 				if (oldEntry->type == LibraryEntryType::File)
 				{
 					fileEntry = static_cast<FileEntry*>(oldEntry);
 					removeDependencies(fileEntry);
-
-					// Update uuid <-> path mapping
-					if(fileEntry->meta != nullptr)
-					{
-						auto& resourceMetas = fileEntry->meta->getResourceMetaData();
-
-						if (resourceMetas.size() > 0)
-						{
-							mUUIDToPath[resourceMetas[0]->getUUID()] = newFullPath;
-
-							for (UINT32 i = 1; i < (UINT32)resourceMetas.size(); i++)
-							{
-								SPtr<ProjectResourceMeta> resMeta = resourceMetas[i];
-
-								const UUID& UUID = resMeta->getUUID();
-								mUUIDToPath[UUID] = newFullPath + resMeta->getUniqueName();
-							}
-						}
-					}
 				}
 
 				if(FileSystem::isFile(oldMetaPath))
@@ -962,6 +1540,9 @@ namespace bs
 				if(findIter != parent->mChildren.end())
 					parent->mChildren.erase(findIter);
 
+				removeFromIndex(oldEntry, true);
+				moveQueuedImports(oldFullPath, newFullPath);
+
 				Path parentPath = newFullPath.getParent();
 
 				DirectoryEntry* newEntryParent = nullptr;
@@ -1003,23 +1584,26 @@ namespace bs
 					}
 				}
 
-				onEntryAdded(oldEntry->path);
+				addToIndex(oldEntry, true);
+				notifyEntryAdded(oldEntry->path);
 
 				if (fileEntry != nullptr)
 				{
-					reimportDependants(oldFullPath);
-					reimportDependants(newFullPath);
+					addDependencies(fileEntry);
+					reimportDependants({ oldFullPath, newFullPath });
 				}
 			}
 		}
 		else // Moving from outside of the Resources folder (likely adding a new resource)
 		{
-			checkForModifications(newFullPath);
+			refreshPath(newFullPath);
 		}
 	}
 
 	void ProjectLibrary::copyEntry(const Path& oldPath, const Path& newPath, bool overwrite)
 	{
+		finishBackgroundImport();
+
 		Path oldFullPath = oldPath;
 		if (!oldFullPath.isAbsolute())
 			oldFullPath.makeAbsolute(mResourcesFolder);
@@ -1051,7 +1635,7 @@ namespace bs
 		LibraryEntry* oldEntry = findEntry(oldFullPath);
 		if (oldEntry == nullptr)
 		{
-			checkForModifications(newFullPath);
+			refreshPath(newFullPath);
 			return;
 		}
 
@@ -1062,10 +1646,17 @@ namespace bs
 			FileEntry* oldResEntry = static_cast<FileEntry*>(oldEntry);
 
 			SPtr<ImportOptions> importOptions;
-			if (oldResEntry->meta != nullptr)
-				importOptions = oldResEntry->meta->getImportOptions();
+			SPtr<ProjectFileMeta> oldMeta = oldResEntry->getMeta();
+			if (oldMeta != nullptr)
+				importOptions = oldMeta->getImportOptions();
 
-			addResourceInternal(newEntryParent, newFullPath, importOptions, true);
+			if (mBatch != nullptr)
+			{
+				addResourceInternal(newEntryParent, newFullPath, importOptions, true, false);
+				mBatch->imports.push_back(std::make_pair(newFullPath, importOptions));
+			}
+			else
+				addResourceInternal(newEntryParent, newFullPath, importOptions, true);
 		}
 		else
 		{
@@ -1095,10 +1686,17 @@ namespace bs
 						FileEntry* childResEntry = static_cast<FileEntry*>(child);
 
 						SPtr<ImportOptions> importOptions;
-						if (childResEntry->meta != nullptr)
-							importOptions = childResEntry->meta->getImportOptions();
+						SPtr<ProjectFileMeta> childMeta = childResEntry->getMeta();
+						if (childMeta != nullptr)
+							importOptions = childMeta->getImportOptions();
 
-						addResourceInternal(destDir, childDestPath, importOptions, true);
+						if (mBatch != nullptr)
+						{
+							addResourceInternal(destDir, childDestPath, importOptions, true, false);
+							mBatch->imports.push_back(std::make_pair(childDestPath, importOptions));
+						}
+						else
+							addResourceInternal(destDir, childDestPath, importOptions, true);
 					}
 					else // Directory
 					{
@@ -1131,6 +1729,133 @@ namespace bs
 		}
 	}
 
+	void ProjectLibrary::beginBatch()
+	{
+		if (mBatchDepth == 0)
+			mBatch = bs_new<BatchState>();
+
+		mBatchDepth++;
+	}
+
+	void ProjectLibrary::endBatch()
+	{
+		if (mBatchDepth == 0)
+		{
+			LOGWRN("ProjectLibrary::endBatch() called without a matching beginBatch().");
+			return;
+		}
+
+		mBatchDepth--;
+		if (mBatchDepth > 0)
+			return;
+
+		// Refresh while the batch state is still active, so any changes made by the refresh are coalesced as well
+		Vector<FileEntry*> toImport;
+		Vector<SPtr<ImportOptions>> importOptions;
+		UnorderedMap<FileEntry*, UINT32> queuedEntries; // Maps the entries to their index in toImport
+
+		for (auto& entry : mBatch->refreshPaths)
+		{
+			Vector<FileEntry*> modifiedEntries;
+			Vector<Path> newResources;
+			scanForModifications(entry.second, &modifiedEntries, newResources);
+
+			for (auto& modifiedEntry : modifiedEntries)
+			{
+				if (queuedEntries.insert(std::make_pair(modifiedEntry, (UINT32)toImport.size())).second)
+					toImport.push_back(modifiedEntry);
+			}
+		}
+
+		importOptions.resize(toImport.size());
+		for (auto& import : mBatch->imports)
+		{
+			LibraryEntry* entry = findEntry(import.first);
+			if (entry == nullptr || entry->type != LibraryEntryType::File)
+				continue;
+
+			FileEntry* fileEntry = static_cast<FileEntry*>(entry);
+			auto result = queuedEntries.insert(std::make_pair(fileEntry, (UINT32)toImport.size()));
+			if (result.second)
+			{
+				toImport.push_back(fileEntry);
+				importOptions.push_back(import.second);
+			}
+			else
+				importOptions[result.first->second] = import.second;
+		}
+
+		Vector<Path> imported = importBatch(toImport, false, importOptions);
+
+		BatchState* batch = mBatch;
+		mBatch = nullptr;
+
+		batch->dependants.insert(batch->dependants.end(), imported.begin(), imported.end());
+		if (!batch->dependants.empty())
+			reimportDependants(batch->dependants);
+
+		Vector<Path> removedEntries;
+		for (auto& entry : batch->removedEntries)
+			removedEntries.push_back(entry.second);
+
+		Vector<Path> addedEntries;
+		for (auto& entry : batch->addedEntries)
+		{
+			if (findEntry(entry.second) != nullptr)
+				addedEntries.push_back(entry.second);
+		}
+
+		bs_delete(batch);
+
+		if (!removedEntries.empty() || !addedEntries.empty())
+			onEntriesChanged(removedEntries, addedEntries);
+
+		if (mIsLoaded)
+			flushJournal();
+	}
+
+	void ProjectLibrary::notifyEntryAdded(const Path& fullPath)
+	{
+		if (mBatch == nullptr)
+		{
+			onEntryAdded(fullPath);
+			return;
+		}
+
+		addCoalescedPath(mBatch->addedEntries, getEntryKey(fullPath), fullPath);
+	}
+
+	void ProjectLibrary::notifyEntryRemoved(const Path& fullPath)
+	{
+		if (mBatch == nullptr)
+		{
+			onEntryRemoved(fullPath);
+			return;
+		}
+
+		// Entry added earlier in the batch no longer needs to be reported as added, along with any of its descendants
+		String key = getEntryKey(fullPath);
+		mBatch->addedEntries.erase(key);
+
+		String childPrefix = key + "/";
+		auto iter = mBatch->addedEntries.lower_bound(childPrefix);
+		while (iter != mBatch->addedEntries.end() && iter->first.compare(0, childPrefix.size(), childPrefix) == 0)
+			iter = mBatch->addedEntries.erase(iter);
+
+		addCoalescedPath(mBatch->removedEntries, key, fullPath);
+	}
+
+	void ProjectLibrary::refreshPath(const Path& fullPath)
+	{
+		if (mBatch == nullptr)
+		{
+			checkForModifications(fullPath);
+			return;
+		}
+
+		addCoalescedPath(mBatch->refreshPaths, getEntryKey(fullPath), fullPath);
+	}
+
 	void ProjectLibrary::reimport(const Path& path, const SPtr<ImportOptions>& importOptions, bool forceReimport)
 	{
 		LibraryEntry* entry = findEntry(path);
@@ -1152,16 +1877,20 @@ namespace bs
 			return;
 
 		FileEntry* resEntry = static_cast<FileEntry*>(entry);
-		if (resEntry->meta == nullptr)
+		SPtr<ProjectFileMeta> fileMeta = resEntry->getMeta();
+		if (fileMeta == nullptr)
 			return;
 
-		resEntry->meta->setIncludeInBuild(include);
+		fileMeta->setIncludeInBuild(include);
+		resEntry->setMeta(fileMeta);
+		mSearchIndex->update(resEntry);
+		markEntryDirty(resEntry->path);
 
 		Path metaPath = resEntry->path;
 		metaPath.setFilename(metaPath.getFilename() + ".meta");
 
 		FileEncoder fs(metaPath);
-		fs.encode(resEntry->meta.get());
+		fs.encode(fileMeta.get());
 	}
 
 	void ProjectLibrary::setUserData(const Path& path, const SPtr<IReflectable>& userData)
@@ -1177,47 +1906,155 @@ namespace bs
 		if (resMeta == nullptr)
 			return;
 
+		// Resource meta is owned by the file meta, which remains loaded for as long as we hold a reference to it
+		SPtr<ProjectFileMeta> fileMeta = fileEntry->getMeta();
+		if (fileMeta == nullptr)
+			return;
+
 		resMeta->mUserData = userData;
+		markEntryDirty(fileEntry->path);
 
 		Path metaPath = fileEntry->path;
 		metaPath.setFilename(metaPath.getFilename() + ".meta");
 
 		FileEncoder fs(metaPath);
-		fs.encode(fileEntry->meta.get());
+		fs.encode(fileMeta.get());
+	}
+
+	/**
+	 * Sorts the entries by their paths. Index order depends on the order entries were modified in, so this is used to
+	 * keep results (and builds) the same between runs.
+	 */
+	static void sortByPath(Vector<ProjectLibrary::FileEntry*>& entries)
+	{
+		typedef std::pair<String, ProjectLibrary::FileEntry*> PathEntry;
+
+		Vector<PathEntry> sorted;
+		sorted.reserve(entries.size());
+
+		for (auto& entry : entries)
+			sorted.push_back(std::make_pair(entry->path.toString(), entry));
+
+		std::sort(sorted.begin(), sorted.end(),
+			[](const PathEntry& a, const PathEntry& b) { return a.first < b.first; });
+
+		for (UINT32 i = 0; i < (UINT32)sorted.size(); i++)
+			entries[i] = sorted[i].second;
 	}
 
 	Vector<ProjectLibrary::FileEntry*> ProjectLibrary::getResourcesForBuild() const
 	{
-		Vector<FileEntry*> output;
+		Vector<FileEntry*> output = mSearchIndex->getBuildEntries();
+		sortByPath(output);
 
-		Stack<DirectoryEntry*> todo;
-		todo.push(mRootEntry);
+		return output;
+	}
 
-		while (!todo.empty())
+	Vector<ProjectLibrary::FileEntry*> ProjectLibrary::findEntriesOfType(const Vector<UINT32>& typeIds) const
+	{
+		Vector<FileEntry*> output = mSearchIndex->findByType(typeIds);
+		sortByPath(output);
+
+		return output;
+	}
+
+	Vector<UUID> ProjectLibrary::findReferencedResources(const Vector<UUID>& resources,
+		UnorderedMap<UUID, UUID>* referencedFrom)
+	{
+		Vector<UUID> output;
+		UnorderedSet<UUID> visited;
+
+		for (auto& resource : resources)
 		{
-			DirectoryEntry* directory = todo.top();
-			todo.pop();
+			if (visited.insert(resource).second)
+				output.push_back(resource);
+		}
 
-			for (auto& child : directory->mChildren)
+		// Output doubles as the list of resources left to process
+		for (UINT32 i = 0; i < (UINT32)output.size(); i++)
+		{
+			UUID current = output[i];
+			for (auto& reference : getResourceReferences(current))
 			{
-				if (child->type == LibraryEntryType::File)
-				{
-					FileEntry* resEntry = static_cast<FileEntry*>(child);
-					if (resEntry->meta != nullptr && resEntry->meta->getIncludeInBuild())
-						output.push_back(resEntry);
-				}
-				else if (child->type == LibraryEntryType::Directory)
-				{
-					todo.push(static_cast<DirectoryEntry*>(child));
-				}
+				if (!visited.insert(reference).second)
+					continue;
+
+				output.push_back(reference);
+
+				if (referencedFrom != nullptr)
+					(*referencedFrom)[reference] = current;
+			}
+		}
+
+		return output;
+	}
+
+	Vector<UUID> ProjectLibrary::findReferencingResources(const UUID& uuid, bool recursive)
+	{
+		recordMissingReferences();
+
+		if (recursive)
+			return mReferenceGraph->findAllReferencedBy({ uuid });
+
+		return mReferenceGraph->getReferencedBy(uuid);
+	}
+
+	Vector<ProjectLibrary::FileEntry*> ProjectLibrary::findReferencingEntries(const Path& path, bool recursive)
+	{
+		Path fullPath = path;
+		if (!fullPath.isAbsolute())
+			fullPath.makeAbsolute(mResourcesFolder);
+
+		LibraryEntry* entry = findEntry(fullPath);
+		if (entry == nullptr || entry->type != LibraryEntryType::File)
+			return Vector<FileEntry*>();
+
+		// Sub-resources are referenced by appending their name to the path of the file containing them
+		FileEntry* fileEntry = static_cast<FileEntry*>(entry);
+		bool isSubresource = fileEntry->path != fullPath;
+
+		Vector<UUID> resources;
+		for (auto& resource : fileEntry->resources)
+		{
+			if (!isSubresource || resource.uniqueName == fullPath.getFilename())
+				resources.push_back(resource.uuid);
+		}
+
+		recordMissingReferences();
+
+		UnorderedSet<UUID> referencing;
+		if (recursive)
+		{
+			Vector<UUID> allReferencing = mReferenceGraph->findAllReferencedBy(resources);
+			referencing.insert(allReferencing.begin(), allReferencing.end());
+		}
+		else
+		{
+			for (auto& resource : resources)
+			{
+				const Vector<UUID>& referencedBy = mReferenceGraph->getReferencedBy(resource);
+				referencing.insert(referencedBy.begin(), referencedBy.end());
 			}
 		}
 
+		// Resources referencing other resources within the same file are not of interest
+		UnorderedSet<FileEntry*> visited = { fileEntry };
+
+		Vector<FileEntry*> output;
+		for (auto& uuid : referencing)
+		{
+			FileEntry* referencingEntry = mResourceLocations->find(uuid);
+			if (referencingEntry != nullptr && visited.insert(referencingEntry).second)
+				output.push_back(referencingEntry);
+		}
+
 		return output;
 	}
 
 	HResource ProjectLibrary::load(const Path& path)
 	{
+		importRequiredResources(path);
+
 		SPtr<ProjectResourceMeta> meta = findResourceMeta(path);
 		if (meta == nullptr)
 			return HResource();
@@ -1297,92 +2134,1072 @@ namespace bs
 		if (!mIsLoaded)
 			return;
 
+		// Results of the background validation are no longer relevant
+		if (mValidationTask != nullptr)
+		{
+			mValidationTask->wait();
+			mValidationTask = nullptr;
+			mValidation = nullptr;
+		}
+
+		// Keep the results of imports that are already running, but don't start any new ones
+		finishBackgroundImport();
+		mImportQueue.clear();
+		mImportQueueLookup.clear();
+		mImportTimePerResource = 0.0f;
+
+		stopWatching();
+
 		mProjectFolder = Path::BLANK;
 		mResourcesFolder = Path::BLANK;
 
 		clearEntries();
 		mRootEntry = bs_new<DirectoryEntry>(mResourcesFolder, mResourcesFolder.getTail(), nullptr);
+		addToIndex(mRootEntry);
 
-		mDependencies.clear();
+		mDependencyGraph->clear();
+		mReferenceGraph->clear();
+		mMissingReferences.clear();
 		gResources().unregisterResourceManifest(mResourceManifest);
 		mResourceManifest = nullptr;
-		mIsLoaded = false;
-	}
 
-	void ProjectLibrary::makeEntriesRelative()
+		bs_delete(mJournal);
+		mJournal = nullptr;
+		mDirtyEntries.clear();
+		mDirtyResources.clear();
+		mSnapshotSize = 0;
+
+		// Changes of an unfinished batch refer to the unloaded library
+		if (mBatch != nullptr)
+		{
+			bs_delete(mBatch);
+			mBatch = nullptr;
+		}
+
+		mBatchDepth = 0;
+
+		mIsLoaded = false;
+	}
+
+	void ProjectLibrary::makeEntriesRelative()
+	{
+		// Make all paths relative before saving
+		std::function<void(LibraryEntry*, const Path&)> makeRelative =
+			[&](LibraryEntry* entry, const Path& root)
+		{
+			entry->path.makeRelative(root);
+
+			if (entry->type == LibraryEntryType::Directory)
+			{
+				DirectoryEntry* dirEntry = static_cast<DirectoryEntry*>(entry);
+				for (auto& child : dirEntry->mChildren)
+					makeRelative(child, root);
+			}
+		};
+
+		Path root = getResourcesFolder();
+		makeRelative(mRootEntry, root);
+	}
+
+	void ProjectLibrary::makeEntriesAbsolute()
+	{
+		std::function<void(LibraryEntry*, const Path&)> makeAbsolute =
+			[&](LibraryEntry* entry, const Path& root)
+		{
+			entry->path.makeAbsolute(root);
+
+			if (entry->type == LibraryEntryType::Directory)
+			{
+				DirectoryEntry* dirEntry = static_cast<DirectoryEntry*>(entry);
+				for (auto& child : dirEntry->mChildren)
+					makeAbsolute(child, root);
+			}
+		};
+
+		Path root = getResourcesFolder();
+		makeAbsolute(mRootEntry, root);
+	}
+
+	void ProjectLibrary::saveLibrary()
+	{
+		if (!mIsLoaded)
+			return;
+
+		// Compact once replaying the journal would be more expensive than loading a new snapshot
+		UINT64 maxJournalSize = std::max(JOURNAL_COMPACTION_SIZE, mSnapshotSize);
+		if (mJournal->isOpen() && mJournal->getSize() <= maxJournalSize)
+		{
+			flushJournal();
+
+			// If the journal couldn't be written fall back to a full save
+			if (mJournal->isOpen() && !mJournal->hasPendingRecords())
+				return;
+		}
+
+		compactLibrary();
+	}
+
+	void ProjectLibrary::compactLibrary()
+	{
+		Path internalFolder = mProjectFolder;
+		internalFolder.append(PROJECT_INTERNAL_DIR);
+
+		// Manifest is saved first. If the snapshot fails to save the old snapshot and journal are still used, and
+		// replaying the journal on top of the newer manifest is harmless as its records describe the latest state of a
+		// mapping rather than a change.
+		saveFallbackFiles();
+		saveReferenceGraph();
+
+		// Save the snapshot used for fast loading. The entries file is still kept as a fallback, so that a snapshot
+		// format change doesn't cause the whole project to be reimported.
+		Path snapshotPath = internalFolder;
+		snapshotPath.append(LIBRARY_SNAPSHOT_FILENAME);
+
+		mDirtyEntries.clear();
+		mDirtyResources.clear();
+		mLastJournalFlushTime = gTime().getTime();
+
+		UUID generation = UUIDGenerator::generateRandom();
+		if (!ProjectLibrarySnapshot::save(snapshotPath, generation, mRootEntry, mResourcesFolder, *mDependencyGraph))
+		{
+			LOGWRN("Failed to save the project library snapshot to \"" + snapshotPath.toString() + "\".");
+
+			// The old snapshot and journal are out of date, make sure the entries file gets used instead
+			if (FileSystem::isFile(snapshotPath))
+				FileSystem::remove(snapshotPath);
+
+			mJournal->discard();
+			return;
+		}
+
+		mSnapshotSize = FileSystem::getFileSize(snapshotPath);
+
+		if (!mJournal->reset(generation))
+			LOGWRN("Failed to create the project library journal. All saves will save the full library.");
+	}
+
+	void ProjectLibrary::flushJournal()
+	{
+		mLastJournalFlushTime = gTime().getTime();
+		saveReferenceGraph();
+
+		if (mDirtyEntries.empty() && mDirtyResources.empty())
+			return;
+
+		// Without a valid journal all changes will be saved by the next compaction
+		if (!mJournal->isOpen())
+		{
+			mDirtyEntries.clear();
+			mDirtyResources.clear();
+			return;
+		}
+
+		// Entries are sorted by path, so parent folders are always recorded before their children
+		for (auto& entry : mDirtyEntries)
+		{
+			LibraryEntry* libEntry = findEntry(entry.second.path);
+			if (libEntry != nullptr)
+				mJournal->writeEntry(libEntry, entry.second.recursive, *mDependencyGraph);
+			else
+				mJournal->writeRemove(entry.second.path);
+		}
+
+		for (auto& uuid : mDirtyResources)
+		{
+			Path path;
+			if (mResourceManifest->uuidToFilePath(uuid, path))
+				mJournal->writeRegisterResource(uuid, path);
+			else
+				mJournal->writeUnregisterResource(uuid);
+		}
+
+		mDirtyEntries.clear();
+		mDirtyResources.clear();
+
+		if (!mJournal->flush())
+			LOGWRN("Failed to write to the project library journal.");
+	}
+
+	void ProjectLibrary::saveFallbackFiles()
+	{
+		Path internalFolder = mProjectFolder;
+		internalFolder.append(PROJECT_INTERNAL_DIR);
+
+		Path resourceManifestPath = internalFolder;
+		resourceManifestPath.append(RESOURCE_MANIFEST_FILENAME);
+
+		ResourceManifest::save(mResourceManifest, resourceManifestPath, mProjectFolder);
+
+		// Make all paths relative before saving
+		makeEntriesRelative();		
+		SPtr<ProjectLibraryEntries> libEntries = ProjectLibraryEntries::create(*mRootEntry);
+
+		Path libraryEntriesPath = internalFolder;
+		libraryEntriesPath.append(LIBRARY_ENTRIES_FILENAME);
+
+		FileEncoder fs(libraryEntriesPath);
+		fs.encode(libEntries.get());
+
+		// Restore absolute entry paths
+		makeEntriesAbsolute();
+	}
+
+	void ProjectLibrary::markEntryDirty(const Path& fullPath, bool recursive)
+	{
+		if (!mIsLoaded)
+			return;
+
+		DirtyEntry& entry = mDirtyEntries[getEntryKey(fullPath)];
+		entry.path = fullPath;
+		entry.recursive |= recursive;
+	}
+
+	void ProjectLibrary::markResourceDirty(const UUID& uuid)
+	{
+		if (!mIsLoaded)
+			return;
+
+		mDirtyResources.insert(uuid);
+	}
+
+	void ProjectLibrary::loadLibrary()
+	{
+		unloadLibrary();
+
+		Timer timer;
+
+		mProjectFolder = gEditorApplication().getProjectPath();
+		mResourcesFolder = mProjectFolder;
+		mResourcesFolder.append(RESOURCES_DIR);
+
+		mRootEntry = bs_new<DirectoryEntry>(mResourcesFolder, mResourcesFolder.getTail(), nullptr);
+
+		// Load resource manifest
+		Path resourceManifestPath = mProjectFolder;
+		resourceManifestPath.append(PROJECT_INTERNAL_DIR);
+		resourceManifestPath.append(RESOURCE_MANIFEST_FILENAME);
+
+		if (FileSystem::exists(resourceManifestPath))
+			mResourceManifest = ResourceManifest::load(resourceManifestPath, mProjectFolder);
+		else
+			mResourceManifest = ResourceManifest::create("ProjectLibrary");
+
+		gResources().registerResourceManifest(mResourceManifest);
+
+		UINT64 manifestTime = timer.getMilliseconds();
+		timer.reset();
+
+		Path snapshotPath = mProjectFolder;
+		snapshotPath.append(PROJECT_INTERNAL_DIR);
+		snapshotPath.append(LIBRARY_SNAPSHOT_FILENAME);
+
+		Path journalPath = mProjectFolder;
+		journalPath.append(PROJECT_INTERNAL_DIR);
+		journalPath.append(LIBRARY_JOURNAL_FILENAME);
+
+		mJournal = bs_new<ProjectLibraryJournal>(journalPath, mProjectFolder, mResourcesFolder);
+
+		bool loadedSnapshot = false;
+		UUID generation;
+		if (FileSystem::exists(snapshotPath))
+		{
+			loadedSnapshot = ProjectLibrarySnapshot::load(snapshotPath, mResourcesFolder, mRootEntry, 
+				*mResourceLocations, *mDependencyGraph, generation);
+
+			if (!loadedSnapshot)
+				LOGWRN("Project library snapshot is invalid or out of date. Loading the library entries instead.");
+		}
+
+		// If the snapshot can't be used the journal is unusable as well, and the next save will be a full one
+		if (loadedSnapshot)
+		{
+			// Apply the changes saved after the snapshot
+			if (!mJournal->replay(generation, mRootEntry, *mResourceLocations, *mDependencyGraph, 
+				*mResourceManifest))
+				mJournal->reset(generation);
+
+			mSnapshotSize = FileSystem::getFileSize(snapshotPath);
+
+			mEntryLookup.clear();
+			mSearchIndex->clear();
+			addToIndex(mRootEntry, true);
+
+			// Files might have changed while the project was closed. Check for that in the background instead of
+			// blocking the load, the results get applied during a later update().
+			startValidation();
+		}
+		else
+			loadEntries();
+
+		loadReferenceGraph();
+
+		UINT64 entriesTime = timer.getMilliseconds();
+
+		LOGDBG("Project library loaded in " + toString(manifestTime + entriesTime) + " ms" + 
+			(loadedSnapshot ? " from snapshot" : "") + ". Manifest: " + toString(manifestTime) + " ms, entries: " + 
+			toString(entriesTime) + " ms.");
+
+		MemoryStatistics memStats = getMemoryStatistics();
+		LOGDBG("Project library contains " + toString(memStats.numFiles) + " files with " + 
+			toString(memStats.numResources) + " resources in " + toString(memStats.numDirectories) + " folders. " +
+			"Memory: entries " + toString(memStats.entryBytes / 1024) + " KB, resources " + 
+			toString(memStats.resourceBytes / 1024) + " KB, lookups " + 
+			toString((memStats.resourceLocationBytes + memStats.entryLookupBytes) / 1024) + " KB, of which resource " +
+			"locations " + toString(memStats.resourceLocationBytes / 1024) + " KB (" +
+			toString(memStats.resourcePathBytes / 1024) + " KB if stored as paths).");
+
+		mIsLoaded = true;
+		mLastJournalFlushTime = gTime().getTime();
+
+		startWatching();
+	}
+
+	void ProjectLibrary::update()
+	{
+		// Triggers the change events, which get recorded in the modification queue
+		if (mFolderMonitor != nullptr)
+			mFolderMonitor->_update();
+
+		// Record changes regularly, so little is lost if the editor doesn't shut down cleanly
+		if (mIsLoaded && (gTime().getTime() - mLastJournalFlushTime) >= JOURNAL_FLUSH_INTERVAL)
+			flushJournal();
+
+		if (mIsLoaded && (gTime().getTime() - mLastMetaEvictionTime) >= META_EVICTION_INTERVAL)
+		{
+			evictMetas(META_IDLE_TIME);
+			mLastMetaEvictionTime = gTime().getTime();
+		}
+
+		if (mBackgroundImport != nullptr)
+		{
+			bool isComplete = true;
+			for (auto& task : mBackgroundImport->tasks)
+			{
+				if (!task->isComplete())
+				{
+					isComplete = false;
+					break;
+				}
+			}
+
+			if (isComplete)
+				finishBackgroundImport();
+		}
+
+		if (mIsLoaded && mBackgroundImport == nullptr && !mImportQueue.empty())
+			startBackgroundImport();
+
+		if (mValidationTask == nullptr || !mValidationTask->isComplete())
+			return;
+
+		SPtr<BackgroundValidation> validation = mValidation;
+		mValidationTask = nullptr;
+		mValidation = nullptr;
+
+		applyValidation(*validation);
+	}
+
+	UINT32 ProjectLibrary::evictMetas(float minIdleTime)
+	{
+		float currentTime = gTime().getTime();
+
+		UINT32 numEvicted = 0;
+		for (auto& entry : mEntryLookup)
+		{
+			if (entry.second->type != LibraryEntryType::File)
+				continue;
+
+			FileEntry* fileEntry = static_cast<FileEntry*>(entry.second);
+			if (!fileEntry->isMetaLoaded() || (currentTime - fileEntry->getMetaAccessTime()) < minIdleTime)
+				continue;
+
+			if (fileEntry->evictMeta())
+				numEvicted++;
+		}
+
+		return numEvicted;
+	}
+
+	void ProjectLibrary::queueImport(const Path& path, ImportPriority priority)
+	{
+		Path fullPath = path;
+		if (!fullPath.isAbsolute())
+			fullPath.makeAbsolute(mResourcesFolder);
+
+		// Queue is ordered by sequence number. High priority imports use negative numbers, so they are processed before
+		// all normal priority ones, and the latest one is processed first.
+		INT64 order;
+		if (priority == ImportPriority::High)
+			order = -(++mImportQueueSequence);
+		else
+			order = ++mImportQueueSequence;
+
+		String key = getEntryKey(fullPath);
+		auto iterFind = mImportQueueLookup.find(key);
+		if (iterFind != mImportQueueLookup.end())
+		{
+			if (priority == ImportPriority::Normal)
+				return;
+
+			mImportQueue.erase(iterFind->second);
+			iterFind->second = order;
+		}
+		else
+			mImportQueueLookup[key] = order;
+
+		mImportQueue[order] = fullPath;
+	}
+
+	void ProjectLibrary::prioritizeImport(const Path& path)
+	{
+		if (mImportQueue.empty())
+			return;
+
+		Path fullPath = path;
+		if (!fullPath.isAbsolute())
+			fullPath.makeAbsolute(mResourcesFolder);
+
+		// Every queued resource is within the root folder, so prioritizing it wouldn't change anything
+		String key = getEntryKey(fullPath);
+		if (key.empty())
+			return;
+
+		Vector<Path> toPrioritize;
+
+		auto iterFind = mImportQueueLookup.find(key);
+		if (iterFind != mImportQueueLookup.end())
+			toPrioritize.push_back(mImportQueue[iterFind->second]);
+
+		// Keys are sorted so all the descendants immediately follow the folder key with a separator appended
+		String childPrefix = key + "/";
+		auto iter = mImportQueueLookup.lower_bound(childPrefix);
+		while (iter != mImportQueueLookup.end() && iter->first.compare(0, childPrefix.size(), childPrefix) == 0)
+		{
+			toPrioritize.push_back(mImportQueue[iter->second]);
+			++iter;
+		}
+
+		// Latest high priority import is processed first, so queue in reverse to keep the folder order
+		for (auto iterPath = toPrioritize.rbegin(); iterPath != toPrioritize.rend(); ++iterPath)
+			queueImport(*iterPath, ImportPriority::High);
+	}
+
+	void ProjectLibrary::importQueued()
+	{
+		finishBackgroundImport();
+
+		Vector<FileEntry*> toImport;
+		for (auto& entry : mImportQueue)
+		{
+			LibraryEntry* libEntry = findEntry(entry.second);
+			if (libEntry != nullptr && libEntry->type == LibraryEntryType::File)
+				toImport.push_back(static_cast<FileEntry*>(libEntry));
+		}
+
+		mImportQueue.clear();
+		mImportQueueLookup.clear();
+
+		importResources(toImport);
+	}
+
+	UINT32 ProjectLibrary::getImportQueueLength() const
+	{
+		UINT32 length = (UINT32)mImportQueue.size();
+		if (mBackgroundImport != nullptr)
+			length += (UINT32)mBackgroundImport->imports.size();
+
+		return length;
+	}
+
+	Path ProjectLibrary::getCurrentImport() const
+	{
+		if (mBackgroundImport == nullptr || mBackgroundImport->imports.empty())
+			return Path::BLANK;
+
+		return mBackgroundImport->imports[0].entry->path;
+	}
+
+	float ProjectLibrary::getImportETA() const
+	{
+		return mImportTimePerResource * getImportQueueLength();
+	}
+
+	void ProjectLibrary::startBackgroundImport()
+	{
+		SPtr<BackgroundImport> backgroundImport = bs_shared_ptr_new<BackgroundImport>();
+		backgroundImport->imports.reserve(MAX_BACKGROUND_IMPORTS);
+
+		auto isBlocked = [&](const Path& path)
+		{
+			// Resources that have an import dependency on another queued resource must wait until it is imported
+			const Vector<Path>& dependencies = mDependencyGraph->getDependencies(path);
+			for (auto& dependency : dependencies)
+			{
+				if (dependency == path)
+					continue;
+
+				if (mImportQueueLookup.find(getEntryKey(dependency)) != mImportQueueLookup.end())
+					return true;
+
+				for (auto& import : backgroundImport->imports)
+				{
+					if (import.entry->path == dependency)
+						return true;
+				}
+			}
+
+			return false;
+		};
+
+		UINT32 numTaken = 0;
+		auto take = [&](Map<INT64, Path>::iterator iter)
+		{
+			Path path = iter->second;
+
+			mImportQueueLookup.erase(getEntryKey(path));
+			auto iterNext = mImportQueue.erase(iter);
+			numTaken++;
+
+			LibraryEntry* entry = findEntry(path);
+			if (entry == nullptr || entry->type != LibraryEntryType::File)
+				return iterNext;
+
+			QueuedImport import;
+			if (prepareImport(static_cast<FileEntry*>(entry), nullptr, false, false, import))
+				backgroundImport->imports.push_back(std::move(import));
+
+			return iterNext;
+		};
+
+		auto iter = mImportQueue.begin();
+		while (iter != mImportQueue.end() && backgroundImport->imports.size() < MAX_BACKGROUND_IMPORTS)
+		{
+			if (isBlocked(iter->second))
+				++iter;
+			else
+				iter = take(iter);
+		}
+
+		// Every queued resource is waiting for another one, so the dependencies are circular and order doesn't matter
+		if (numTaken == 0 && !mImportQueue.empty())
+			take(mImportQueue.begin());
+
+		if (backgroundImport->imports.empty())
+			return;
+
+		// Imports are stored in a vector that no longer changes, so tasks can safely reference them
+		for (auto& entry : backgroundImport->imports)
+		{
+			QueuedImport* import = &entry;
+
+			SPtr<Task> task = Task::create("ProjectLibraryBackgroundImport", [import]() { executeImport(*import); });
+			TaskScheduler::instance().addTask(task);
+
+			backgroundImport->tasks.push_back(task);
+		}
+
+		mBackgroundImport = backgroundImport;
+	}
+
+	void ProjectLibrary::finishBackgroundImport()
+	{
+		if (mBackgroundImport == nullptr)
+			return;
+
+		// Clear first, as finalization triggers events that might call back into the library
+		SPtr<BackgroundImport> backgroundImport = mBackgroundImport;
+		mBackgroundImport = nullptr;
+
+		for (auto& task : backgroundImport->tasks)
+			task->wait();
+
+		Vector<Path> imported;
+		for (auto& import : backgroundImport->imports)
+		{
+			finalizeImport(import);
+			imported.push_back(import.entry->path);
+		}
+
+		// Use a moving average so the estimate adapts as resources of different types and sizes are imported
+		float timePerResource = backgroundImport->timer.getMilliseconds() / 1000.0f / (float)imported.size();
+		if (mImportTimePerResource > 0.0f)
+			mImportTimePerResource = mImportTimePerResource * 0.8f + timePerResource * 0.2f;
+		else
+			mImportTimePerResource = timePerResource;
+
+		reimportDependants(imported);
+	}
+
+	bool ProjectLibrary::dequeueImport(const String& key)
+	{
+		auto iterFind = mImportQueueLookup.find(key);
+		if (iterFind == mImportQueueLookup.end())
+			return false;
+
+		mImportQueue.erase(iterFind->second);
+		mImportQueueLookup.erase(iterFind);
+
+		return true;
+	}
+
+	void ProjectLibrary::moveQueuedImports(const Path& oldFullPath, const Path& newFullPath)
+	{
+		if (mImportQueue.empty())
+			return;
+
+		String oldKey = getEntryKey(oldFullPath);
+		if (oldKey.empty())
+			return;
+
+		Vector<std::pair<String, INT64>> moved;
+
+		auto iterFind = mImportQueueLookup.find(oldKey);
+		if (iterFind != mImportQueueLookup.end())
+			moved.push_back(*iterFind);
+
+		// Keys are sorted so all the descendants immediately follow the folder key with a separator appended
+		String childPrefix = oldKey + "/";
+		auto iter = mImportQueueLookup.lower_bound(childPrefix);
+		while (iter != mImportQueueLookup.end() && iter->first.compare(0, childPrefix.size(), childPrefix) == 0)
+		{
+			moved.push_back(*iter);
+			++iter;
+		}
+
+		for (auto& entry : moved)
+			mImportQueueLookup.erase(entry.first);
+
+		for (auto& entry : moved)
+		{
+			Path& queuedPath = mImportQueue[entry.second];
+			if (entry.first == oldKey)
+				queuedPath = newFullPath;
+			else
+			{
+				Path relativePath = queuedPath;
+				relativePath.makeRelative(oldFullPath);
+
+				queuedPath = newFullPath;
+				queuedPath.append(relativePath);
+			}
+
+			// The entry might have replaced a queued one at the destination, keep only the moved one
+			String newKey = getEntryKey(queuedPath);
+			auto iterExisting = mImportQueueLookup.find(newKey);
+			if (iterExisting != mImportQueueLookup.end())
+				mImportQueue.erase(iterExisting->second);
+
+			mImportQueueLookup[newKey] = entry.second;
+		}
+	}
+
+	void ProjectLibrary::importRequiredResources(const Path& path)
+	{
+		if (!mIsLoaded || (mImportQueue.empty() && mBackgroundImport == nullptr))
+			return;
+
+		Path fullPath = path;
+		if (!fullPath.isAbsolute())
+			fullPath.makeAbsolute(mResourcesFolder);
+
+		// Resource might be one of the ones currently being imported
+		finishBackgroundImport();
+
+		UnorderedSet<FileEntry*> visited;
+		Vector<FileEntry*> toVisit;
+
+		auto visit = [&](const Path& path)
+		{
+			// Sub-resources are referenced by appending their name to the path of the file containing them
+			LibraryEntry* entry = findEntry(path);
+			if (entry == nullptr)
+				entry = findEntry(path.getParent());
+
+			if (entry == nullptr || entry->type != LibraryEntryType::File)
+				return;
+
+			FileEntry* fileEntry = static_cast<FileEntry*>(entry);
+			if (visited.insert(fileEntry).second)
+				toVisit.push_back(fileEntry);
+		};
+
+		visit(fullPath);
+
+		Vector<FileEntry*> toImport;
+		while (!toVisit.empty() && !mImportQueue.empty())
+		{
+			// Import before looking up the dependencies, as importing might change them
+			toImport.clear();
+			for (auto& entry : toVisit)
+			{
+				if (dequeueImport(getEntryKey(entry->path)))
+					toImport.push_back(entry);
+			}
+
+			if (!toImport.empty())
+				importResources(toImport);
+
+			Vector<FileEntry*> entries = std::move(toVisit);
+			toVisit.clear();
+
+			for (auto& entry : entries)
+			{
+				for (auto& resource : entry->resources)
+				{
+					for (auto& reference : getResourceReferences(resource.uuid))
+					{
+						Path referencePath = mResourceLocations->getPath(reference);
+						if (!referencePath.isEmpty())
+							visit(referencePath);
+					}
+				}
+			}
+		}
+	}
+
+	void ProjectLibrary::loadReferenceGraph()
+	{
+		Path referencesPath = mProjectFolder;
+		referencesPath.append(PROJECT_INTERNAL_DIR);
+		referencesPath.append(RESOURCE_REFERENCES_FILENAME);
+
+		// Without a saved graph, references get recorded as they are needed
+		bool loaded = FileSystem::isFile(referencesPath) && mReferenceGraph->load(referencesPath);
+
+		// Resources might have been imported after the graph was last saved, if the editor didn't shut down cleanly
+		std::time_t savedTime = loaded ? FileSystem::getLastModifiedTime(referencesPath) : 0;
+
+		mMissingReferences.clear();
+		for (auto& entry : mEntryLookup)
+		{
+			if (entry.second->type != LibraryEntryType::File)
+				continue;
+
+			FileEntry* fileEntry = static_cast<FileEntry*>(entry.second);
+			if (loaded && fileEntry->lastUpdateTime >= savedTime)
+			{
+				for (auto& resource : fileEntry->resources)
+					mReferenceGraph->removeReferences(resource.uuid);
+			}
+
+			queueMissingReferences(fileEntry);
+		}
+	}
+
+	void ProjectLibrary::saveReferenceGraph()
+	{
+		if (!mReferenceGraph->isDirty())
+			return;
+
+		Path referencesPath = mProjectFolder;
+		referencesPath.append(PROJECT_INTERNAL_DIR);
+		referencesPath.append(RESOURCE_REFERENCES_FILENAME);
+
+		if (!mReferenceGraph->save(referencesPath))
+			LOGWRN("Failed to save the resource reference graph to \"" + referencesPath.toString() + "\".");
+	}
+
+	const Vector<UUID>& ProjectLibrary::getResourceReferences(const UUID& uuid)
+	{
+		if (mReferenceGraph->hasReferences(uuid) || mResourceLocations->find(uuid) == nullptr)
+			return mReferenceGraph->getReferences(uuid);
+
+		// Only happens for resources imported before the graph was saved for the first time, reading the resource
+		// header is enough to find its references
+		Path internalPath;
+		if (mResourceManifest->uuidToFilePath(uuid, internalPath) && FileSystem::isFile(internalPath))
+			mReferenceGraph->setReferences(uuid, gResources().getDependencies(internalPath));
+
+		mMissingReferences.erase(uuid);
+		return mReferenceGraph->getReferences(uuid);
+	}
+
+	void ProjectLibrary::recordMissingReferences()
+	{
+		if (mMissingReferences.empty())
+			return;
+
+		Vector<UUID> missingReferences(mMissingReferences.begin(), mMissingReferences.end());
+		mMissingReferences.clear();
+
+		for (auto& uuid : missingReferences)
+			getResourceReferences(uuid);
+	}
+
+	void ProjectLibrary::queueMissingReferences(const FileEntry* entry)
 	{
-		// Make all paths relative before saving
-		std::function<void(LibraryEntry*, const Path&)> makeRelative =
-			[&](LibraryEntry* entry, const Path& root)
+		for (auto& resource : entry->resources)
 		{
-			entry->path.makeRelative(root);
+			if (!mReferenceGraph->hasReferences(resource.uuid))
+				mMissingReferences.insert(resource.uuid);
+		}
+	}
 
-			if (entry->type == LibraryEntryType::Directory)
+	void ProjectLibrary::recordReferences(const HResource& resource)
+	{
+		Vector<ResourceDependency> dependencies = Utility::findResourceDependencies(*resource.get());
+
+		Vector<UUID> references;
+		for (auto& dependency : dependencies)
+			references.push_back(dependency.resource.getUUID());
+
+		mReferenceGraph->setReferences(resource.getUUID(), references);
+		mMissingReferences.erase(resource.getUUID());
+	}
+
+	void ProjectLibrary::checkForQueuedModifications(bool import, Vector<Path>& dirtyResources)
+	{
+		if (!mIsLoaded)
+			return;
+
+		// Take the queue first, as checking for modifications may itself modify files and queue new changes
+		bool fullScan = mFullScanQueued;
+		Map<String, Path> queuedModifications = std::move(mQueuedModifications);
+
+		mFullScanQueued = false;
+		mQueuedModifications.clear();
+
+		if (fullScan)
+		{
+			checkForModifications(mResourcesFolder, import, dirtyResources);
+			return;
+		}
+
+		for (auto& entry : queuedModifications)
+			checkForModifications(entry.second, import, dirtyResources);
+	}
+
+	void ProjectLibrary::startWatching()
+	{
+		stopWatching();
+
+		FolderChangeBits folderChanges;
+		folderChanges |= FolderChangeBit::FileName;
+		folderChanges |= FolderChangeBit::DirName;
+		folderChanges |= FolderChangeBit::FileWrite;
+
+		// Monitor requires the folder to exist, it will be populated when the user adds the first resource
+		if (!FileSystem::isDirectory(mResourcesFolder))
+			FileSystem::createDir(mResourcesFolder);
+
+		mFolderMonitor = bs_new<FolderMonitor>();
+		mFolderMonitor->startMonitor(mResourcesFolder, true, folderChanges);
+
+		mFolderMonitor->onAdded.connect(std::bind(&ProjectLibrary::queueModification, this, _1));
+		mFolderMonitor->onRemoved.connect(std::bind(&ProjectLibrary::queueModification, this, _1));
+		mFolderMonitor->onModified.connect(std::bind(&ProjectLibrary::queueModification, this, _1));
+		mFolderMonitor->onRenamed.connect(
+			[this](const Path& from, const Path& to)
 			{
-				DirectoryEntry* dirEntry = static_cast<DirectoryEntry*>(entry);
-				for (auto& child : dirEntry->mChildren)
-					makeRelative(child, root);
+				queueModification(from);
+				queueModification(to);
+			});
+	}
+
+	void ProjectLibrary::stopWatching()
+	{
+		if (mFolderMonitor != nullptr)
+		{
+			mFolderMonitor->stopMonitorAll();
+			bs_delete(mFolderMonitor);
+			mFolderMonitor = nullptr;
+		}
+
+		mQueuedModifications.clear();
+		mFullScanQueued = false;
+	}
+
+	void ProjectLibrary::queueModification(const Path& path)
+	{
+		if (mFullScanQueued)
+			return;
+
+		Path fullPath = path;
+		if (!fullPath.isAbsolute())
+			fullPath.makeAbsolute(mResourcesFolder);
+
+		if (!mResourcesFolder.includes(fullPath))
+			return;
+
+		// Changes to .meta files are detected when checking their resources
+		if (isMeta(fullPath))
+			fullPath.setExtension("");
+
+		String key = getEntryKey(fullPath);
+		if (key.empty())
+		{
+			mFullScanQueued = true;
+			mQueuedModifications.clear();
+			return;
+		}
+
+		// Paths whose parent folders are already queued are ignored, and queued children are checked along with it
+		if (!addCoalescedPath(mQueuedModifications, key, fullPath))
+			return;
+
+		if (mQueuedModifications.size() > MAX_QUEUED_MODIFICATIONS)
+		{
+			LOGDBG("Too many changes in the project resources folder, the entire folder will be checked.");
+
+			mFullScanQueued = true;
+			mQueuedModifications.clear();
+		}
+	}
+
+	void ProjectLibrary::startValidation()
+	{
+		SPtr<BackgroundValidation> validation = bs_shared_ptr_new<BackgroundValidation>();
+
+		validation->internalResourcesFolder = mProjectFolder;
+		validation->internalResourcesFolder.append(INTERNAL_RESOURCES_DIR);
+
+		Stack<DirectoryEntry*> todo;
+		todo.push(mRootEntry);
+
+		while (!todo.empty())
+		{
+			DirectoryEntry* curDir = todo.top();
+			todo.pop();
+
+			for (auto& child : curDir->mChildren)
+			{
+				if (child->type == LibraryEntryType::File)
+				{
+					FileEntry* fileEntry = static_cast<FileEntry*>(child);
+					validation->entries.push_back({ child->path, child->type, fileEntry->metaModifiedTime });
+				}
+				else
+				{
+					validation->entries.push_back({ child->path, child->type, 0 });
+					todo.push(static_cast<DirectoryEntry*>(child));
+				}
+			}
+		}
+
+		auto validate = [validation]()
+		{
+			for (auto& entry : validation->entries)
+			{
+				if (entry.type == LibraryEntryType::Directory)
+				{
+					if (!FileSystem::isDirectory(entry.path))
+						validation->missingEntries.push_back(entry.path);
+
+					continue;
+				}
+
+				if (!FileSystem::isFile(entry.path))
+				{
+					validation->missingEntries.push_back(entry.path);
+					continue;
+				}
+
+				Path metaPath = entry.path;
+				metaPath.setFilename(metaPath.getFilename() + ".meta");
+
+				if (!FileSystem::isFile(metaPath))
+					continue;
+
+				// Entries with an unknown meta modification time can't be validated, so their meta is always reloaded
+				if (entry.metaModifiedTime == 0 || FileSystem::getLastModifiedTime(metaPath) != entry.metaModifiedTime)
+					validation->modifiedMetas.push_back(entry.path);
+			}
+
+			if (FileSystem::exists(validation->internalResourcesFolder))
+			{
+				auto processFile = [&](const Path& file)
+				{
+					validation->internalFiles.push_back(file);
+					return true;
+				};
+
+				FileSystem::iterate(validation->internalResourcesFolder, processFile);
 			}
 		};
 
-		Path root = getResourcesFolder();
-		makeRelative(mRootEntry, root);
+		mValidation = validation;
+		mValidationTask = Task::create("ProjectLibraryValidate", validate);
+		TaskScheduler::instance().addTask(mValidationTask);
 	}
 
-	void ProjectLibrary::makeEntriesAbsolute()
+	void ProjectLibrary::applyValidation(const BackgroundValidation& validation)
 	{
-		std::function<void(LibraryEntry*, const Path&)> makeAbsolute =
-			[&](LibraryEntry* entry, const Path& root)
+		// Entries might have changed since the validation started, so only apply results that are still relevant
+		for (auto& path : validation.missingEntries)
 		{
-			entry->path.makeAbsolute(root);
+			LibraryEntry* entry = findEntry(path);
+			if (entry == nullptr)
+				continue;
 
-			if (entry->type == LibraryEntryType::Directory)
+			if (entry->type == LibraryEntryType::File)
 			{
-				DirectoryEntry* dirEntry = static_cast<DirectoryEntry*>(entry);
-				for (auto& child : dirEntry->mChildren)
-					makeAbsolute(child, root);
+				if (!FileSystem::isFile(path))
+					deleteResourceInternal(static_cast<FileEntry*>(entry));
 			}
-		};
+			else
+			{
+				if (!FileSystem::isDirectory(path))
+					deleteDirectoryInternal(static_cast<DirectoryEntry*>(entry));
+			}
+		}
 
-		Path root = getResourcesFolder();
-		makeAbsolute(mRootEntry, root);
+		for (auto& path : validation.modifiedMetas)
+		{
+			LibraryEntry* entry = findEntry(path);
+			if (entry != nullptr && entry->type == LibraryEntryType::File)
+				reloadMeta(static_cast<FileEntry*>(entry));
+		}
+
+		// Clean up internal library folder from obsolete files
+		for (auto& file : validation.internalFiles)
+		{
+			UUID uuid = UUID(file.getFilename(false));
+			if (mResourceLocations->find(uuid) == nullptr)
+			{
+				mResourceManifest->unregisterResource(uuid);
+				markResourceDirty(uuid);
+				FileSystem::remove(file);
+			}
+		}
 	}
 
-	void ProjectLibrary::saveLibrary()
+	void ProjectLibrary::reloadMeta(FileEntry* fileEntry)
 	{
-		if (!mIsLoaded)
+		Path metaPath = getMetaPath(fileEntry->path);
+		if (!FileSystem::isFile(metaPath))
 			return;
 
-		// Make all paths relative before saving
-		makeEntriesRelative();		
-		SPtr<ProjectLibraryEntries> libEntries = ProjectLibraryEntries::create(*mRootEntry);
+		FileDecoder fs(metaPath);
+		SPtr<IReflectable> loadedMeta = fs.decode();
 
-		Path libraryEntriesPath = mProjectFolder;
-		libraryEntriesPath.append(PROJECT_INTERNAL_DIR);
-		libraryEntriesPath.append(LIBRARY_ENTRIES_FILENAME);
+		if (loadedMeta == nullptr || !loadedMeta->isDerivedFrom(ProjectFileMeta::getRTTIStatic()))
+			return;
 
-		FileEncoder fs(libraryEntriesPath);
-		fs.encode(libEntries.get());
+		removeDependencies(fileEntry);
 
-		// Restore absolute entry paths
-		makeEntriesAbsolute();
+		for (auto& resHeader : fileEntry->resources)
+			mResourceLocations->erase(resHeader.uuid);
 
-		Path resourceManifestPath = mProjectFolder;
-		resourceManifestPath.append(PROJECT_INTERNAL_DIR);
-		resourceManifestPath.append(RESOURCE_MANIFEST_FILENAME);
+		SPtr<ProjectFileMeta> fileMeta = std::static_pointer_cast<ProjectFileMeta>(loadedMeta);
+		fileEntry->setMeta(fileMeta);
+		mResourceLocations->set(fileEntry);
+		queueMissingReferences(fileEntry);
 
-		ResourceManifest::save(mResourceManifest, resourceManifestPath, mProjectFolder);
+		// Only record the meta as seen if the import options are unchanged, otherwise isUpToDate() must still detect
+		// that the resource needs to be reimported
+		UINT64 importOptionsHash = ContentHash::computeObject(fileMeta->getImportOptions().get());
+		if (fileEntry->importOptionsHash != 0 && importOptionsHash == fileEntry->importOptionsHash)
+			fileEntry->metaModifiedTime = FileSystem::getLastModifiedTime(metaPath);
+
+		addDependencies(fileEntry);
+		mSearchIndex->update(fileEntry);
+		markEntryDirty(fileEntry->path);
 	}
 
-	void ProjectLibrary::loadLibrary()
+	void ProjectLibrary::loadEntries()
 	{
-		unloadLibrary();
-
-		mProjectFolder = gEditorApplication().getProjectPath();
-		mResourcesFolder = mProjectFolder;
-		mResourcesFolder.append(RESOURCES_DIR);
-
-		mRootEntry = bs_new<DirectoryEntry>(mResourcesFolder, mResourcesFolder.getTail(), nullptr);
+		Timer timer;
+		UINT64 entriesTime, metaDecodeTime, metaMergeTime, cleanupTime;
 
 		Path libraryEntriesPath = mProjectFolder;
 		libraryEntriesPath.append(PROJECT_INTERNAL_DIR);
@@ -1403,24 +3220,27 @@ namespace bs
 		// Entries are stored relative to project folder, but we want their absolute paths now
 		makeEntriesAbsolute();
 
-		// Load resource manifest
-		Path resourceManifestPath = mProjectFolder;
-		resourceManifestPath.append(PROJECT_INTERNAL_DIR);
-		resourceManifestPath.append(RESOURCE_MANIFEST_FILENAME);
+		mEntryLookup.clear();
+		mSearchIndex->clear();
+		addToIndex(mRootEntry, true);
 
-		if (FileSystem::exists(resourceManifestPath))
-			mResourceManifest = ResourceManifest::load(resourceManifestPath, mProjectFolder);
-		else
-			mResourceManifest = ResourceManifest::create("ProjectLibrary");
+		entriesTime = timer.getMilliseconds();
+		timer.reset();
 
-		gResources().registerResourceManifest(mResourceManifest);
+		// Find all file entries, and directories that no longer exist
+		struct MetaLoadInfo
+		{
+			FileEntry* entry;
+			bool exists;
+			SPtr<ProjectFileMeta> meta;
+		};
+
+		Vector<MetaLoadInfo> fileEntries;
+		Vector<LibraryEntry*> deletedEntries;
 
-		// Load all meta files
 		Stack<DirectoryEntry*> todo;
 		todo.push(mRootEntry);
 
-		Vector<LibraryEntry*> deletedEntries;
-
 		while(!todo.empty())
 		{
 			DirectoryEntry* curDir = todo.top();
@@ -1429,50 +3249,7 @@ namespace bs
 			for(auto& child : curDir->mChildren)
 			{
 				if(child->type == LibraryEntryType::File)
-				{
-					FileEntry* resEntry = static_cast<FileEntry*>(child);
-					
-					if (FileSystem::isFile(resEntry->path))
-					{
-						if (resEntry->meta == nullptr)
-						{
-							Path metaPath = resEntry->path;
-							metaPath.setFilename(metaPath.getFilename() + ".meta");
-
-							if (FileSystem::isFile(metaPath))
-							{
-								FileDecoder fs(metaPath);
-								SPtr<IReflectable> loadedMeta = fs.decode();
-
-								if (loadedMeta != nullptr && loadedMeta->isDerivedFrom(ProjectFileMeta::getRTTIStatic()))
-								{
-									SPtr<ProjectFileMeta> fileMeta = std::static_pointer_cast<ProjectFileMeta>(loadedMeta);
-									resEntry->meta = fileMeta;
-								}
-							}
-						}
-
-						if (resEntry->meta != nullptr)
-						{
-							auto& resourceMetas = resEntry->meta->getResourceMetaData();
-
-							if (resourceMetas.size() > 0)
-							{
-								mUUIDToPath[resourceMetas[0]->getUUID()] = resEntry->path;
-
-								for (UINT32 i = 1; i < (UINT32)resourceMetas.size(); i++)
-								{
-									SPtr<ProjectResourceMeta> entry = resourceMetas[i];
-									mUUIDToPath[entry->getUUID()] = resEntry->path + entry->getUniqueName();
-								}
-							}
-						}
-
-						addDependencies(resEntry);
-					}
-					else
-						deletedEntries.push_back(resEntry);
-				}
+					fileEntries.push_back({ static_cast<FileEntry*>(child), false, nullptr });
 				else if(child->type == LibraryEntryType::Directory)
 				{
 					if (FileSystem::isDirectory(child->path))
@@ -1483,6 +3260,77 @@ namespace bs
 			}
 		}
 
+		// Check file existence and decode the meta files in parallel, in batches to keep the task overhead low
+		auto loadMetas = [](MetaLoadInfo* start, MetaLoadInfo* end)
+		{
+			for(MetaLoadInfo* info = start; info != end; ++info)
+			{
+				info->exists = FileSystem::isFile(info->entry->path);
+				if (!info->exists || info->entry->hasMeta)
+					continue;
+
+				Path metaPath = info->entry->path;
+				metaPath.setFilename(metaPath.getFilename() + ".meta");
+
+				if (!FileSystem::isFile(metaPath))
+					continue;
+
+				FileDecoder fs(metaPath);
+				SPtr<IReflectable> loadedMeta = fs.decode();
+
+				if (loadedMeta != nullptr && loadedMeta->isDerivedFrom(ProjectFileMeta::getRTTIStatic()))
+					info->meta = std::static_pointer_cast<ProjectFileMeta>(loadedMeta);
+			}
+		};
+
+		static constexpr UINT32 META_LOAD_BATCH_SIZE = 32;
+
+		Vector<SPtr<Task>> tasks;
+		for(UINT32 i = 0; i < (UINT32)fileEntries.size(); i += META_LOAD_BATCH_SIZE)
+		{
+			MetaLoadInfo* start = fileEntries.data() + i;
+			MetaLoadInfo* end = fileEntries.data() + std::min(i + META_LOAD_BATCH_SIZE, (UINT32)fileEntries.size());
+
+			SPtr<Task> task = Task::create("ProjectLibraryLoadMeta", std::bind(loadMetas, start, end));
+			TaskScheduler::instance().addTask(task);
+
+			tasks.push_back(task);
+		}
+
+		for(auto& task : tasks)
+			task->wait();
+
+		metaDecodeTime = timer.getMilliseconds();
+		timer.reset();
+
+		// Register the loaded meta-data
+		for(auto& info : fileEntries)
+		{
+			FileEntry* resEntry = info.entry;
+			if(!info.exists)
+			{
+				deletedEntries.push_back(resEntry);
+				continue;
+			}
+
+			// Only the header is kept, the full meta-data is decoded again when needed
+			if (info.meta != nullptr)
+			{
+				resEntry->setMeta(info.meta);
+				addDependencies(resEntry);
+				mSearchIndex->update(resEntry);
+				resEntry->evictMeta();
+			}
+			else
+				addDependencies(resEntry);
+
+			if (resEntry->hasMeta)
+				mResourceLocations->set(resEntry);
+		}
+
+		metaMergeTime = timer.getMilliseconds();
+		timer.reset();
+
 		// Remove entries that no longer have corresponding files
 		for (auto& deletedEntry : deletedEntries)
 		{
@@ -1508,7 +3356,7 @@ namespace bs
 			auto processFile = [&](const Path& file)
 			{
 				UUID uuid = UUID(file.getFilename(false));
-				if (mUUIDToPath.find(uuid) == mUUIDToPath.end())
+				if (mResourceLocations->find(uuid) == nullptr)
 				{
 					mResourceManifest->unregisterResource(uuid);
 					toDelete.push_back(file);
@@ -1523,11 +3371,24 @@ namespace bs
 				FileSystem::remove(entry);
 		}
 
-		mIsLoaded = true;
+		cleanupTime = timer.getMilliseconds();
+
+		LOGDBG("Project library entries loaded (" + toString((UINT32)fileEntries.size()) + " files). Entries: " + 
+			toString(entriesTime) + " ms, meta decode: " + toString(metaDecodeTime) + " ms, meta merge: " + 
+			toString(metaMergeTime) + " ms, cleanup: " + toString(cleanupTime) + " ms.");
 	}
 
 	void ProjectLibrary::clearEntries()
 	{
+		// Imports reference the entries, wait until they're done but discard the results
+		if (mBackgroundImport != nullptr)
+		{
+			for (auto& task : mBackgroundImport->tasks)
+				task->wait();
+
+			mBackgroundImport = nullptr;
+		}
+
 		if (mRootEntry == nullptr)
 			return;
 
@@ -1547,16 +3408,24 @@ namespace bs
 
 		deleteRecursive(mRootEntry);
 		mRootEntry = nullptr;
+		mEntryLookup.clear();
+		mSearchIndex->clear();
+		mResourceLocations->clear();
 	}
 
-	Vector<Path> ProjectLibrary::getImportDependencies(const FileEntry* entry)
+	Vector<Path> ProjectLibrary::getImportDependencies(FileEntry* entry)
 	{
 		Vector<Path> output;
 
-		if (entry->meta == nullptr)
+		// Avoid decoding the meta-data for files that cannot have any dependencies
+		if (!entry->hasTypeId(TID_Shader))
 			return output;
 
-		auto& resourceMetas = entry->meta->getResourceMetaData();
+		SPtr<ProjectFileMeta> fileMeta = entry->getMeta();
+		if (fileMeta == nullptr)
+			return output;
+
+		auto& resourceMetas = fileMeta->getResourceMetaData();
 		for(auto& resMeta : resourceMetas)
 		{
 			if (resMeta->getTypeID() == TID_Shader)
@@ -1571,51 +3440,36 @@ namespace bs
 		return output;
 	}
 
-	void ProjectLibrary::addDependencies(const FileEntry* entry)
+	void ProjectLibrary::addDependencies(FileEntry* entry)
 	{
-		Vector<Path> dependencies = getImportDependencies(entry);
-		for (auto& dependency : dependencies)
-			mDependencies[dependency].push_back(entry->path);
+		mDependencyGraph->setDependencies(entry->path, getImportDependencies(entry));
 	}
 
 	void ProjectLibrary::removeDependencies(const FileEntry* entry)
 	{
-		Vector<Path> dependencies = getImportDependencies(entry);
-		for (auto& dependency : dependencies)
-		{
-			Vector<Path>& curDependencies = mDependencies[dependency];
-			auto iterRemove = std::remove_if(curDependencies.begin(), curDependencies.end(),
-				[&](const Path& x)
-			{
-				return x == entry->path;
-			});
-
-			curDependencies.erase(iterRemove, curDependencies.end());
-		}
+		mDependencyGraph->removeDependencies(entry->path);
 	}
 
-	void ProjectLibrary::reimportDependants(const Path& entryPath)
+	void ProjectLibrary::reimportDependants(const Vector<Path>& paths)
 	{
-		auto iterFind = mDependencies.find(entryPath);
-		if (iterFind == mDependencies.end())
+		if (mBatch != nullptr)
+		{
+			mBatch->dependants.insert(mBatch->dependants.end(), paths.begin(), paths.end());
 			return;
+		}
 
-		// Make a copy since we might modify this list during reimport
-		Vector<Path> dependencies = iterFind->second;
-		for (auto& dependency : dependencies)
+		Vector<Path> affected = mDependencyGraph->getAffectedResources(paths);
+
+		Vector<FileEntry*> dependants;
+		for (auto& path : affected)
 		{
-			LibraryEntry* entry = findEntry(dependency);
+			LibraryEntry* entry = findEntry(path);
 			if (entry != nullptr && entry->type == LibraryEntryType::File)
-			{
-				FileEntry* resEntry = static_cast<FileEntry*>(entry);
-
-				SPtr<ImportOptions> importOptions;
-				if (resEntry->meta != nullptr)
-					importOptions = resEntry->meta->getImportOptions();
-
-				reimportResourceInternal(resEntry, importOptions, true);
-			}
+				dependants.push_back(static_cast<FileEntry*>(entry));
 		}
+
+		// All indirect dependants are already included, so their dependants don't need to be looked up again
+		importBatch(dependants, true);
 	}
 
 	BS_ED_EXPORT ProjectLibrary& gProjectLibrary()
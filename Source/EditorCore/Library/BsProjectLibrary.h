@@ -7,6 +7,15 @@
 
 namespace bs
 {
+	class ProjectLibrarySearchIndex;
+	class ProjectLibraryJournal;
+	class FolderMonitor;
+	class ImportDependencyGraph;
+	class ResourceLocationMap;
+	class ResourceReferenceGraph;
+	class ImportCache;
+	struct ImportCacheStatistics;
+
 	/** @addtogroup Library
 	 *  @{
 	 */
@@ -30,6 +39,13 @@ namespace bs
 			Directory
 		};
 
+		/** Determines how soon a resource queued for a background import gets imported. */
+		enum class ImportPriority
+		{
+			Normal, /**< Imported in the order the resources were queued in. */
+			High /**< Imported before any normal priority resources. */
+		};
+
 		/**	A generic library entry that may be a file or a folder depending on its type. */
 		struct LibraryEntry
 		{
@@ -43,14 +59,72 @@ namespace bs
 			DirectoryEntry* parent; /**< Folder this entry is located in. */
 		};
 
-		/**	A library entry representing a file. Each file can have one or multiple resources. */
+		/** Information about a single resource in a file, kept in memory even when the file meta-data isn't loaded. */
+		struct ResourceHeader
+		{
+			UUID uuid; /**< Unique identifier of the resource. */
+			UINT32 typeId; /**< RTTI type ID of the resource. */
+			String uniqueName; /**< Name of the resource, unique within the file. */
+		};
+
+		/**	
+		 * A library entry representing a file. Each file can have one or multiple resources. 
+		 *
+		 * Only a compact header of the file's meta-data is always kept in memory. The full meta-data is decoded from
+		 * the .meta file on first use, and can be evicted again once no longer used.
+		 */
 		struct FileEntry : public LibraryEntry
 		{
 			FileEntry();
 			FileEntry(const Path& path, const String& name, DirectoryEntry* parent);
 
-			SPtr<ProjectFileMeta> meta; /**< Meta file containing various information about the resource(s). */
+			/** 
+			 * Returns the meta file containing various information about the resource(s), decoding it from the .meta
+			 * file if not already loaded. Returns null if the file has no meta-data, or it cannot be read.
+			 *
+			 * @note	Main thread only, as decoding modifies the entry.
+			 */
+			SPtr<ProjectFileMeta> getMeta();
+
+			/** 
+			 * Assigns new meta-data to the file and updates the header. Must also be called after modifying the
+			 * meta-data returned by getMeta(). Provide null to clear the meta-data.
+			 */
+			void setMeta(const SPtr<ProjectFileMeta>& meta);
+
+			/** Checks is the full meta-data currently decoded in memory. */
+			bool isMetaLoaded() const { return mMeta != nullptr; }
+
+			/** 
+			 * Releases the decoded meta-data, if nobody outside of this entry references it. Header information remains
+			 * available. Returns true if the meta-data was released.
+			 */
+			bool evictMeta();
+
+			/** Returns the time the decoded meta-data was last accessed through getMeta() or setMeta(), in seconds. */
+			float getMetaAccessTime() const { return mMetaAccessTime; }
+
+			/** Checks does the file contain a resource of the specified type. */
+			bool hasTypeId(UINT32 typeId) const;
+
+			bool hasMeta; /**< True if the file has meta-data, whether currently loaded or not. */
+			bool includeInBuild; /**< Should the file's resources always be included in the build. */
+			/** Headers of all the active resources in the file, primary one first. */
+			Vector<ResourceHeader> resources;
+
 			std::time_t lastUpdateTime; /**< Timestamp of when we last imported the resource. */
+
+			UINT64 sourceSize; /**< Size of the source file, as of the last import. */
+			std::time_t sourceModifiedTime; /**< Modification time of the source file, as of the last import. */
+			UINT64 sourceHash; /**< Hash of the source file contents, as of the last import. Zero if unknown. */
+			std::time_t metaModifiedTime; /**< Modification time of the .meta file, as of the last import. */
+			UINT64 importOptionsHash; /**< Hash of the import options used for the last import. */
+
+		private:
+			friend class ProjectLibrary;
+
+			SPtr<ProjectFileMeta> mMeta; /**< Decoded meta-data, or null if not loaded. */
+			float mMetaAccessTime; /**< Time the decoded meta-data was last accessed, in seconds. */
 		};
 
 		/**	A library entry representing a folder that contains other entries. */
@@ -62,13 +136,32 @@ namespace bs
 			Vector<LibraryEntry*> mChildren; /**< Child files or folders. */
 		};
 
+		/** Estimate of the memory used for keeping the library hierarchy and its lookup structures in memory. */
+		struct MemoryStatistics
+		{
+			UINT32 numDirectories = 0; /**< Number of directory entries in the library. */
+			UINT32 numFiles = 0; /**< Number of file entries in the library. */
+			UINT32 numResources = 0; /**< Number of resources within all the file entries. */
+			UINT64 entryBytes = 0; /**< Bytes used by the entries themselves, including their paths and names. */
+			UINT64 resourceBytes = 0; /**< Bytes used by the resource headers of the file entries. */
+			UINT64 resourceLocationBytes = 0; /**< Bytes used by the map of resource UUIDs to their entries. */
+
+			/** 
+			 * Estimated bytes a map of resource UUIDs to full resource paths would use instead of the resource location
+			 * map. Only reported for comparison, no such map exists.
+			 */
+			UINT64 resourcePathBytes = 0;
+			UINT64 entryLookupBytes = 0; /**< Bytes used by the map of paths to their entries. */
+		};
+
 	public:
 		ProjectLibrary();
 		~ProjectLibrary();
 
 		/**
 		 * Checks if any resources at the specified path have been modified, added or deleted, and updates the internal
-		 * hierarchy accordingly. Automatically imports dirty resources.
+		 * hierarchy accordingly. Automatically imports dirty resources. Source files are hashed and the import cache is
+		 * read in parallel on the task scheduler, while the importers run on the calling thread.
 		 *
 		 * @param[in]	path	Absolute path of the file or folder to check. If a folder is provided all its children will
 		 *						be checked recursively.
@@ -81,7 +174,8 @@ namespace bs
 		 *
 		 * @param[in]	path			Absolute path of the file or folder to check. If a folder is provided all its 
 		 *								children will be checked recursively.
-		 * @param[in]	import			Should the dirty resources be automatically reimported.
+		 * @param[in]	import			Should the dirty resources be automatically reimported. Source files of
+		 *								independent resources are hashed in parallel.
 		 * @param[in]	dirtyResources	A list of resources that should be reimported.
 		 */
 		void checkForModifications(const Path& path, bool import, Vector<Path>& dirtyResources);
@@ -95,6 +189,8 @@ namespace bs
 		 * @param[in]	path	Path to the entry, either absolute or relative to resources folder.
 		 * @return				Found entry, or null if not found. Value returned by this method is transient, it may be
 		 *						destroyed on any following ProjectLibrary call.
+		 *
+		 * @note	Entries are looked up through a hashed path index, so the cost doesn't depend on library size.
 		 */
 		LibraryEntry* findEntry(const Path& path) const;
 
@@ -117,21 +213,28 @@ namespace bs
 		/**
 		 * Searches the library for a pattern and returns all entries matching it.
 		 *
-		 * @param[in]	pattern	Pattern to search for. Use wildcard * to match any character(s).
+		 * @param[in]	pattern	Pattern to search for, case insensitive. Use wildcard * to match any character(s).
 		 * @return		A list of entries matching the pattern. Values returned by this method are transient, they may be
 		 *				destroyed on any following ProjectLibrary call.
 		 */
 		Vector<LibraryEntry*> search(const String& pattern);
 
 		/**
-		 * Searches the library for a pattern, but only among specific resource types.
+		 * Searches the library for a pattern, but only among specific resource types. Searches are performed using an
+		 * index that is kept up to date as entries are added, removed or imported, so they don't need to visit every
+		 * entry in the library.
 		 *
-		 * @param[in]	pattern	Pattern to search for. Use wildcard * to match any character(s).
-		 * @param[in]	typeIds	RTTI type IDs of the resource types we're interested in searching.
-		 * @return		A list of entries matching the pattern. Values returned by this method are transient, they may be
-		 *				destroyed on any following ProjectLibrary call.
+		 * @param[in]	pattern		Pattern to search for, case insensitive. Use wildcard * to match any character(s).
+		 * @param[in]	typeIds		RTTI type IDs of the resource types we're interested in searching. If empty all
+		 *							entries are searched.
+		 * @param[in]	offset		Number of best ranked results to skip, for retrieving results in pages.
+		 * @param[in]	count		Maximum number of results to return. Zero means no limit.
+		 * @return		A list of entries matching the pattern. Exact name matches are returned first, followed by
+		 *				entries whose name starts with the pattern and then all other matches. Values returned by this
+		 *				method are transient, they may be destroyed on any following ProjectLibrary call.
 		 */
-		Vector<LibraryEntry*> search(const String& pattern, const Vector<UINT32>& typeIds);
+		Vector<LibraryEntry*> search(const String& pattern, const Vector<UINT32>& typeIds, UINT32 offset = 0, 
+			UINT32 count = 0);
 
 		/**
 		 * Returns resource path based on its UUID.
@@ -185,6 +288,25 @@ namespace bs
 		 */
 		void deleteEntry(const Path& path);
 
+		/**
+		 * Starts a batch of library operations. Until the matching endBatch() call, moveEntry(), copyEntry(),
+		 * deleteEntry() and other operations modifying the library only update the entry hierarchy. Refreshing and
+		 * importing of the affected entries, reimporting their dependants, reporting the changes and persisting the
+		 * library is deferred and done once for the entire batch. Batches can be nested, in which case only the
+		 * outermost batch is applied.
+		 */
+		void beginBatch();
+
+		/**
+		 * Ends a batch started with beginBatch(). If this is the outermost batch all the affected entries are refreshed
+		 * and imported at once, and onEntriesChanged is triggered with all the entries added or removed during the
+		 * batch.
+		 */
+		void endBatch();
+
+		/** Checks is a batch of operations started by beginBatch() currently active. */
+		bool isBatchActive() const { return mBatchDepth > 0; }
+
 		/**
 		 * Triggers a reimport of a resource using the provided import options, if needed.
 		 *
@@ -215,13 +337,65 @@ namespace bs
 		void setUserData(const Path& path, const SPtr<IReflectable>& userData);
 
 		/**
-		 * Finds all top-level resource entries that should be included in a build. Values returned by this method are
-		 * transient, they may be destroyed on any following ProjectLibrary call.
+		 * Finds all top-level resource entries that should be included in a build, sorted by path. Values returned by
+		 * this method are transient, they may be destroyed on any following ProjectLibrary call.
+		 *
+		 * @note	Entries are retrieved from an index kept up to date as entries are imported, removed or flagged for
+		 *			inclusion, so the cost only depends on the number of returned entries.
 		 */
 		Vector<FileEntry*> getResourcesForBuild() const;
 
 		/**
-		 * Loads a resource at the specified path, synchronously.
+		 * Finds all file entries containing a resource of one of the provided types. Unlike search() the results are
+		 * not ranked, and the cost only depends on the number of returned entries.
+		 *
+		 * @param[in]	typeIds		RTTI type IDs of the resource types to look for.
+		 * @return					Matching entries, sorted by path. Values returned by this method are transient,
+		 *							they may be destroyed on any following ProjectLibrary call.
+		 */
+		Vector<FileEntry*> findEntriesOfType(const Vector<UINT32>& typeIds) const;
+
+		/**
+		 * Finds all resources referenced by the provided resources, either directly or indirectly. References are
+		 * recorded whenever a resource is imported or saved, so no resources need to be loaded or read from disk.
+		 *
+		 * @param[in]	resources		UUIDs of the resources to start the search from.
+		 * @param[out]	referencedFrom	Optional map that receives, for every found resource except the provided ones,
+		 *								the resource it was first found to be referenced from. Following the map back to
+		 *								one of the provided resources yields the shortest chain of references that
+		 *								reaches the resource.
+		 * @return						UUIDs of every found resource exactly once, including the provided resources.
+		 *								Resources that aren't part of the library (e.g. built-in resources) are included
+		 *								but their references are not followed.
+		 */
+		Vector<UUID> findReferencedResources(const Vector<UUID>& resources,
+			UnorderedMap<UUID, UUID>* referencedFrom = nullptr);
+
+		/**
+		 * Finds all resources referencing the provided resource.
+		 *
+		 * @param[in]	uuid		UUID of the referenced resource.
+		 * @param[in]	recursive	If true, resources referencing the provided resource indirectly are returned as
+		 *							well.
+		 * @return					UUIDs of the referencing resources, in no particular order.
+		 */
+		Vector<UUID> findReferencingResources(const UUID& uuid, bool recursive = false);
+
+		/**
+		 * Finds all file entries containing resources that reference the resources at the provided path.
+		 *
+		 * @param[in]	path		Path to the file, absolute or relative to resources folder. If a sub-resource within
+		 *							a file is needed, append the name of the subresource to the path. Otherwise
+		 *							references to any of the resources within the file are considered.
+		 * @param[in]	recursive	If true, entries referencing the resources indirectly are returned as well.
+		 * @return					Referencing entries in no particular order. Values returned by this method are 
+		 *							transient, they may be destroyed on any following ProjectLibrary call.
+		 */
+		Vector<FileEntry*> findReferencingEntries(const Path& path, bool recursive = false);
+
+		/**
+		 * Loads a resource at the specified path, synchronously. If the resource or any of the resources it depends on
+		 * are waiting in the background import queue, they are imported first.
 		 *
 		 * @param[in]	path	Path of the resource, absolute or relative to resources folder. If a sub-resource within
 		 *						a file is needed, append the name of the subresource to the path 
@@ -236,15 +410,131 @@ namespace bs
 		/**
 		 * Saves all the project library data so it may be restored later, at the default save location in the project
 		 * folder. Project must be loaded when calling this.
+		 *
+		 * Normally only the entries and resource manifest mappings changed since the last save are appended to the
+		 * library journal, so the cost of a save is proportional to the number of changes. Changes are also appended to
+		 * the journal periodically by update(), limiting the amount of data lost on a crash. Once the journal grows
+		 * large enough it is compacted, by saving the full library snapshot and resource manifest and starting a new
+		 * journal.
 		 */
 		void saveLibrary();
 
 		/**
 		 * Loads previously saved project library data from the default save location in the project folder. Nothing is
-		 * loaded if it doesn't exist.Project must be loaded when calling this.
+		 * loaded if it doesn't exist.Project must be loaded when calling this. 
+		 *
+		 * If a valid library snapshot exists the library is restored from it directly, without reading individual .meta
+		 * files. Entries are then checked against the file system in the background, and any changes made while the
+		 * project was closed are applied by a later call to update(). Otherwise the library entries are loaded and the
+		 * resource meta files are decoded in parallel.
 		 */
 		void loadLibrary();
 
+		/** 
+		 * Applies the results of any finished background work and collects file system changes reported since the last
+		 * call. Should be called once per frame. 
+		 */
+		void update();
+
+		/**
+		 * Checks the parts of the library that changed on disk since the last call, and updates the internal hierarchy
+		 * accordingly. While a library is loaded its resources folder is watched for changes, and every changed path is
+		 * recorded in a queue. Nested and repeated changes are coalesced, so each changed subtree is scanned only once.
+		 * If the queue overflows the entire resources folder is scanned instead.
+		 *
+		 * @param[in]	import			Should the dirty resources be automatically reimported. Source files of
+		 *								independent resources are hashed in parallel.
+		 * @param[in]	dirtyResources	A list of resources that should be reimported.
+		 */
+		void checkForQueuedModifications(bool import, Vector<Path>& dirtyResources);
+
+		/** Checks are there any file system changes waiting to be processed by checkForQueuedModifications(). */
+		bool hasQueuedModifications() const { return mFullScanQueued || !mQueuedModifications.empty(); }
+
+		/**
+		 * Releases the decoded meta-data of file entries that haven't been accessed recently. Only the meta-data
+		 * headers remain in memory, and the full meta-data is decoded again from the .meta files when next accessed.
+		 * Meta-data referenced outside of the library is never released. This is also done periodically by update().
+		 *
+		 * @param[in]	minIdleTime		Only meta-data that hasn't been accessed for at least this many seconds is
+		 *								released. Provide zero to release all unreferenced meta-data.
+		 * @return						Number of entries whose meta-data was released.
+		 */
+		UINT32 evictMetas(float minIdleTime = 0.0f);
+
+		/**
+		 * Queues a resource for importing in the background, allowing the editor to be used while the import is in
+		 * progress. Queued resources are processed a few at a time by update(). Their source files are hashed and the
+		 * import cache is read on worker threads, after which a later update() imports them and commits the results on
+		 * the main thread. Resources that are up to date by the time they are processed are skipped. Queued resources
+		 * required by load() are imported immediately.
+		 *
+		 * @param[in]	path		Path to the resource, absolute or relative to resources folder.
+		 * @param[in]	priority	Determines how soon the resource gets imported. High priority resources are imported
+		 *							before all the normal priority ones, most recently queued first. Queuing a resource
+		 *							that is already queued can only raise its priority.
+		 */
+		void queueImport(const Path& path, ImportPriority priority = ImportPriority::Normal);
+
+		/**
+		 * Moves the resource at the specified path to the front of the background import queue. If the path is a folder
+		 * all the queued resources within it are moved to the front instead. Does nothing for resources that aren't
+		 * queued.
+		 *
+		 * @param[in]	path	Path to the resource or folder, absolute or relative to resources folder.
+		 */
+		void prioritizeImport(const Path& path);
+
+		/** Imports all the resources queued for a background import, blocking until done. */
+		void importQueued();
+
+		/**
+		 * Returns the number of resources waiting in the background import queue, including the ones being imported.
+		 */
+		UINT32 getImportQueueLength() const;
+
+		/**
+		 * Returns the absolute path to a resource currently being imported in the background, or an empty path if none.
+		 */
+		Path getCurrentImport() const;
+
+		/** 
+		 * Returns an estimate of the time remaining until all resources in the background import queue are imported, in
+		 * seconds. The estimate is based on the duration of recent background imports, and is zero until one finishes.
+		 */
+		float getImportETA() const;
+
+		/**
+		 * Immediately imports the resource at the specified path and any resources it depends on, if they are still
+		 * waiting in the background import queue. Should be called before loading a resource from outside the library,
+		 * as load() already does this.
+		 *
+		 * @param[in]	path	Path to the resource, absolute or relative to resources folder. If a sub-resource within
+		 *						a file is needed, append the name of the subresource to the path.
+		 */
+		void importRequiredResources(const Path& path);
+
+		/**
+		 * Sets a folder in which the results of resource imports are cached. The folder can be shared between all
+		 * projects on the machine. Before importing a resource the cache is checked for results of an import of an
+		 * identical source file with identical import options, in which case they are used instead of importing the
+		 * resource again.
+		 *
+		 * @param[in]	folder	Absolute path to the cache folder. Provide an empty path to disable the cache.
+		 */
+		void setImportCacheFolder(const Path& folder);
+
+		/** Returns the folder used for caching import results, or an empty path if the import cache is disabled. */
+		Path getImportCacheFolder() const;
+
+		/** Returns hit and miss statistics of the import cache. All values are zero if the import cache is disabled. */
+		ImportCacheStatistics getImportCacheStatistics() const;
+
+		/**
+		 * Returns an estimate of the memory used by the library entries and the structures used for looking them up.
+		 */
+		MemoryStatistics getMemoryStatistics() const;
+
 		/**	Clears all library data. */
 		void unloadLibrary();
 
@@ -257,6 +547,14 @@ namespace bs
 		/** Triggered when a resource is being (re)imported. Path provided is absolute. */
 		Event<void(const Path&)> onEntryImported; 
 
+		/**
+		 * Triggered once a batch of operations ends, instead of triggering onEntryRemoved and onEntryAdded for each
+		 * entry changed during the batch. Provides absolute paths of the removed entries, followed by those of the
+		 * added entries. Paths are coalesced, so descendants of a reported entry are not reported separately. An entry
+		 * that was replaced during the batch is reported in both lists.
+		 */
+		Event<void(const Vector<Path>&, const Vector<Path>&)> onEntriesChanged;
+
 		/** @name Internal 
 		 *  @{
 		 */
@@ -269,6 +567,31 @@ namespace bs
 		static const Path RESOURCES_DIR;
 		static const Path INTERNAL_RESOURCES_DIR;
 	private:
+		struct QueuedImport;
+		struct BackgroundValidation;
+		struct BatchState;
+		struct BackgroundImport;
+
+		/** Library entry whose state needs to be recorded in the journal. */
+		struct DirtyEntry
+		{
+			Path path;
+			bool recursive = false;
+		};
+
+		/**
+		 * Scans the file system at the specified path for added, modified or deleted resources, and updates the
+		 * internal hierarchy accordingly. Resources that need importing are not imported, but are instead appended to
+		 * the @p toImport list.
+		 *
+		 * @param[in]	path			Absolute path of the file or folder to check. If a folder is provided all its 
+		 *								children will be checked recursively.
+		 * @param[out]	toImport		Optional list that will be populated with entries that require importing. If
+		 *								null the entries will not be imported.
+		 * @param[out]	dirtyResources	List of resources that are not up to date.
+		 */
+		void scanForModifications(const Path& path, Vector<FileEntry*>* toImport, Vector<Path>& dirtyResources);
+
 		/**
 		 * Common code for adding a new resource entry to the library.
 		 *
@@ -279,10 +602,12 @@ namespace bs
 		 *								provided default import options are used.
 		 * @param[in]	forceReimport	Should the resource be reimported even if we detect no changes. This should be true
 		 *								if import options changed since last import.
+		 * @param[in]	import			If false the entry will be added but not imported. Caller is then responsible
+		 *								for importing it.
 		 * @return						Newly added resource entry.
 		 */
 		FileEntry* addResourceInternal(DirectoryEntry* parent, const Path& filePath, 
-			const SPtr<ImportOptions>& importOptions = nullptr, bool forceReimport = false);
+			const SPtr<ImportOptions>& importOptions = nullptr, bool forceReimport = false, bool import = true);
 
 		/**
 		 * Common code for adding a new folder entry to the library.
@@ -309,8 +634,21 @@ namespace bs
 		 */
 		void deleteDirectoryInternal(DirectoryEntry* directory);
 
+		/** Triggers onEntryAdded for the entry, or records the change if a batch is active. */
+		void notifyEntryAdded(const Path& fullPath);
+
+		/** Triggers onEntryRemoved for the entry, or records the change if a batch is active. */
+		void notifyEntryRemoved(const Path& fullPath);
+
+		/** 
+		 * Checks for modifications at the specified path and imports any modified resources, or defers the check until
+		 * the end of the batch if one is active.
+		 */
+		void refreshPath(const Path& fullPath);
+
 		/**
-		 * Triggers a reimport of a resource using the provided import options, if needed. Doesn't import dependencies.
+		 * Triggers a reimport of a resource using the provided import options, if needed. Doesn't import dependencies,
+		 * but reimports any resources depending on the resource.
 		 *
 		 * @param[in]	file				File entry of the resource to reimport.
 		 * @param[in]	importOptions		Optional import options to use when importing the resource. Caller must ensure 
@@ -327,6 +665,59 @@ namespace bs
 		void reimportResourceInternal(FileEntry* file, const SPtr<ImportOptions>& importOptions = nullptr, 
 			bool forceReimport = false, bool pruneResourceMetas = false);
 
+		/**
+		 * Imports multiple resources at once, followed by all the resources that depend on them. Each resource is
+		 * imported at most once. See importBatch().
+		 *
+		 * @param[in]	files			Entries of the resources to import.
+		 * @param[in]	forceReimport	If false, entries that are up to date will be skipped.
+		 */
+		void importResources(const Vector<FileEntry*>& files, bool forceReimport = false);
+
+		/**
+		 * Imports multiple resources at once. Source files of resources that don't depend on each other are hashed and
+		 * looked up in the import cache in parallel, after which the resources are imported and committed to the
+		 * library in the order the entries were provided in.
+		 * Resources whose import dependencies are part of the same batch are imported only after their dependencies.
+		 * Resources depending on the imported resources are not reimported.
+		 *
+		 * @param[in]	files			Entries of the resources to import.
+		 * @param[in]	forceReimport	If false, entries that are up to date will be skipped.
+		 * @param[in]	importOptions	Optional import options for each of the entries, in the same order. Entries
+		 *								without import options use the options from their meta-data.
+		 * @return						Absolute paths of all the resources that were imported.
+		 */
+		Vector<Path> importBatch(const Vector<FileEntry*>& files, bool forceReimport, 
+			const Vector<SPtr<ImportOptions>>& importOptions = Vector<SPtr<ImportOptions>>());
+
+		/**
+		 * Loads the meta-data for the provided file and determines if the file requires importing. If it does the
+		 * provided import structure is populated with all the information needed for the import.
+		 *
+		 * @param[in]	file				File entry of the resource to import.
+		 * @param[in]	importOptions		Optional import options, as per reimportResourceInternal().
+		 * @param[in]	forceReimport		Should the resource be reimported even if we detect no changes.
+		 * @param[in]	pruneResourceMetas	Should resource meta-data of resources no longer in the file be deleted.
+		 * @param[out]	import				Information required for performing the import.
+		 * @return							True if the resource requires importing, false otherwise.
+		 */
+		bool prepareImport(FileEntry* file, const SPtr<ImportOptions>& importOptions, bool forceReimport, 
+			bool pruneResourceMetas, QueuedImport& import);
+
+		/**
+		 * Hashes the source file of a previously prepared import, and reads the import results from the import cache if
+		 * available. Only uses data copied into @p import by prepareImport() and doesn't run any importers, so it is
+		 * safe to call from worker threads while the main thread modifies the library.
+		 */
+		static void executeImport(QueuedImport& import);
+
+		/**
+		 * Imports the resource unless it was found in the import cache, and commits the results of the import to the
+		 * library. Updates meta-data, the resource manifest and saves the imported resources into the internal library
+		 * folder. Must be called on the main thread.
+		 */
+		void finalizeImport(QueuedImport& import);
+
 		/**
 		 * Creates a full hierarchy of directory entries up to the provided directory, if any are needed.
 		 *
@@ -336,8 +727,14 @@ namespace bs
 		 */
 		void createInternalParentHierarchy(const Path& fullPath, DirectoryEntry** newHierarchyRoot, DirectoryEntry** newHierarchyLeaf);
 
-		/**	Checks has a file been modified since the last import. */
-		bool isUpToDate(FileEntry* file) const;
+		/**	
+		 * Checks has a file been modified since the last import. File size and modification time are used as a quick
+		 * check, and the file contents are hashed only if they differ. This ensures operations that only touch the
+		 * file (e.g. switching version control branches) don't trigger a reimport. If the .meta file was modified, the
+		 * meta-data of the file is reloaded from it and its import options are compared with the ones used for the last
+		 * import.
+		 */
+		bool isUpToDate(FileEntry* file);
 
 		/**	Checks is the resource a native engine resource that doesn't require importing. */
 		bool isNative(const Path& path) const;
@@ -357,16 +754,52 @@ namespace bs
 		 * Returns a set of resource paths that are dependent on the provided resource entry. (for example a shader file
 		 * might be dependent on shader include file).
 		 */
-		Vector<Path> getImportDependencies(const FileEntry* entry);
+		Vector<Path> getImportDependencies(FileEntry* entry);
 
-		/**	Registers any import dependencies for the specified resource. */
-		void addDependencies(const FileEntry* entry);
+		/**	Registers any import dependencies for the specified resource, replacing existing ones. */
+		void addDependencies(FileEntry* entry);
 
 		/**	Removes any import dependencies for the specified resource. */
 		void removeDependencies(const FileEntry* entry);
 
-		/**	Finds dependants resource for the specified resource entry and reimports them. */
-		void reimportDependants(const Path& entryPath);
+		/**
+		 * Finds all resources that directly or indirectly depend on the provided resources and reimports them. Each
+		 * dependant is reimported exactly once, after all of its own dependencies.
+		 *
+		 * @param[in]	paths	Absolute paths of resources that were changed, moved or deleted.
+		 */
+		void reimportDependants(const Vector<Path>& paths);
+
+		/**
+		 * Takes the next resources from the background import queue and starts hashing them and reading them from the
+		 * import cache on worker threads. Resources whose import dependencies are still queued are left in the queue
+		 * until the dependencies are imported.
+		 */
+		void startBackgroundImport();
+
+		/**
+		 * Waits until the active background import finishes, if any, and commits its results to the library. Must be
+		 * called before any operation that could remove, move or import the entries being imported.
+		 */
+		void finishBackgroundImport();
+
+		/** 
+		 * Removes the resource from the background import queue.
+		 *
+		 * @param[in]	key		Key of the resource entry, as returned by getEntryKey().
+		 * @return				True if the resource was queued.
+		 */
+		bool dequeueImport(const String& key);
+
+		/**
+		 * Updates the paths of queued imports after an entry was moved, so they aren't lost when the queue is
+		 * processed. If the entry is a directory, all queued imports of its descendants are updated as well. Queue
+		 * order is kept.
+		 *
+		 * @param[in]	oldFullPath		Absolute path of the entry before the move.
+		 * @param[in]	newFullPath		Absolute path of the entry after the move.
+		 */
+		void moveQueuedImports(const Path& oldFullPath, const Path& newFullPath);
 
 		/**	Makes all library entry paths relative to the current resources folder. */
 		void makeEntriesRelative();
@@ -377,11 +810,134 @@ namespace bs
 		 */
 		void makeEntriesAbsolute();
 
+		/**
+		 * Loads the library entries from the library entries file and decodes the resource meta files of all entries.
+		 * Entries whose files no longer exist are removed. Used when no valid library snapshot exists.
+		 */
+		void loadEntries();
+
+		/**
+		 * Starts a background task that checks the library entries against the file system, looking for deleted files,
+		 * externally modified .meta files and obsolete files in the internal resources folder. Results are applied by
+		 * update() once the task finishes.
+		 */
+		void startValidation();
+
+		/**
+		 * Applies the results of a finished background validation to the library. Must be called on the main thread.
+		 */
+		void applyValidation(const BackgroundValidation& validation);
+
+		/** 
+		 * Reloads the meta-data of the provided file entry from its .meta file. The .meta file modification time is
+		 * only recorded if the import options didn't change since the last import.
+		 */
+		void reloadMeta(FileEntry* file);
+
 		/** Deletes all library entries. */
 		void clearEntries();
 
+		/**
+		 * Saves the complete library snapshot, the resource manifest and the library entries file, and starts a new
+		 * empty journal.
+		 */
+		void compactLibrary();
+
+		/** Appends the state of all entries and resources changed since the last flush to the library journal. */
+		void flushJournal();
+
+		/**
+		 * Saves the resource manifest and the library entries file. Both are only written on compaction, since manifest
+		 * changes made after it are replayed from the journal, and the entries file is only used if the snapshot can't
+		 * be loaded, in which case all entries are checked against the file system anyway.
+		 */
+		void saveFallbackFiles();
+
+		/**
+		 * Loads the resource reference graph saved with the library. References of resources imported after the graph
+		 * was saved are discarded, to be recorded again when needed.
+		 */
+		void loadReferenceGraph();
+
+		/** Saves the resource reference graph, if it changed since it was last saved. */
+		void saveReferenceGraph();
+
+		/**
+		 * Returns the resources directly referenced by the provided resource. If the references weren't recorded yet
+		 * and the resource is part of the library, they are read from the imported resource file and recorded.
+		 */
+		const Vector<UUID>& getResourceReferences(const UUID& uuid);
+
+		/** Records the references of all library resources whose references weren't recorded yet. */
+		void recordMissingReferences();
+
+		/**
+		 * Notes the resources of the entry whose references weren't recorded yet, so they are recorded by the next call
+		 * to recordMissingReferences().
+		 */
+		void queueMissingReferences(const FileEntry* entry);
+
+		/** Records the references of the provided imported resource, replacing any existing ones. */
+		void recordReferences(const HResource& resource);
+
+		/**
+		 * Notes that the entry at the specified path was added, removed or modified, so it is recorded by the next
+		 * journal flush. Does nothing while the library is being loaded.
+		 *
+		 * @param[in]	fullPath	Absolute path to the entry.
+		 * @param[in]	recursive	If true, all the descendants of the entry are recorded as well.
+		 */
+		void markEntryDirty(const Path& fullPath, bool recursive = false);
+
+		/** Notes that the resource manifest mapping of the resource was changed. See markEntryDirty(). */
+		void markResourceDirty(const UUID& uuid);
+
+		/** Starts watching the resources folder for changes. */
+		void startWatching();
+
+		/** Stops watching the resources folder for changes and clears any queued changes. */
+		void stopWatching();
+
+		/**
+		 * Records a path that was changed on disk, to be checked by the next call to checkForQueuedModifications().
+		 * Paths that are already covered by a queued parent folder are ignored, and queued paths within a newly queued
+		 * folder are removed.
+		 *
+		 * @param[in]	path	Absolute path to the changed file or folder.
+		 */
+		void queueModification(const Path& path);
+
+		/** 
+		 * Converts an absolute path to a key used for looking up entries in the path index. Keys are normalized so that
+		 * two paths that refer to the same entry always map to the same key.
+		 */
+		String getEntryKey(const Path& fullPath) const;
+
+		/**
+		 * Registers the entry in the path and search indices, allowing it to be found by findEntry() and search(). Must
+		 * be called whenever an entry is added or its path changes.
+		 *
+		 * @param[in]	entry		Entry to register. Its path must be absolute.
+		 * @param[in]	recursive	If true and the entry is a directory, all of its descendants will be registered as
+		 *							well.
+		 */
+		void addToIndex(LibraryEntry* entry, bool recursive = false);
+
+		/**
+		 * Unregisters the entry from the path and search indices. Must be called whenever an entry is removed or before
+		 * its path changes.
+		 *
+		 * @param[in]	entry		Entry to unregister. Its path must be absolute.
+		 * @param[in]	recursive	If true and the entry is a directory, all of its descendants will be unregistered as
+		 *							well.
+		 */
+		void removeFromIndex(LibraryEntry* entry, bool recursive = false);
+
 		static const char* LIBRARY_ENTRIES_FILENAME;
+		static const char* LIBRARY_SNAPSHOT_FILENAME;
+		static const char* LIBRARY_JOURNAL_FILENAME;
 		static const char* RESOURCE_MANIFEST_FILENAME;
+		static const char* RESOURCE_REFERENCES_FILENAME;
 
 		SPtr<ResourceManifest> mResourceManifest;
 		DirectoryEntry* mRootEntry;
@@ -389,8 +945,37 @@ namespace bs
 		Path mResourcesFolder;
 		bool mIsLoaded;
 
-		UnorderedMap<Path, Vector<Path>> mDependencies;
-		UnorderedMap<UUID, Path> mUUIDToPath;
+		ImportDependencyGraph* mDependencyGraph;
+		ResourceLocationMap* mResourceLocations;
+		ResourceReferenceGraph* mReferenceGraph;
+		UnorderedSet<UUID> mMissingReferences;
+		UnorderedMap<String, LibraryEntry*> mEntryLookup;
+		ProjectLibrarySearchIndex* mSearchIndex;
+
+		SPtr<Task> mValidationTask;
+		SPtr<BackgroundValidation> mValidation;
+
+		SPtr<ImportCache> mImportCache;
+
+		FolderMonitor* mFolderMonitor;
+		Map<String, Path> mQueuedModifications;
+		bool mFullScanQueued;
+
+		ProjectLibraryJournal* mJournal;
+		Map<String, DirtyEntry> mDirtyEntries;
+		UnorderedSet<UUID> mDirtyResources;
+		UINT64 mSnapshotSize;
+		float mLastJournalFlushTime;
+		float mLastMetaEvictionTime;
+
+		BatchState* mBatch;
+		UINT32 mBatchDepth;
+
+		Map<INT64, Path> mImportQueue;
+		Map<String, INT64> mImportQueueLookup;
+		INT64 mImportQueueSequence;
+		SPtr<BackgroundImport> mBackgroundImport;
+		float mImportTimePerResource;
 	};
 
 	/**	Provides easy access to ProjectLibrary. */
@@ -0,0 +1,685 @@
+//********************************** Banshee Engine (www.banshee3d.com) **************************************************//
+//**************** Copyright (c) 2016 Marko Pintera (marko.pintera@gmail.com). All rights reserved. **********************//
+#include "Library/BsProjectLibraryJournal.h"
+#include "Library/BsProjectResourceMeta.h"
+#include "Library/BsImportDependencyGraph.h"
+#include "Library/BsResourceLocationMap.h"
+#include "Resources/BsResourceManifest.h"
+#include "FileSystem/BsFileSystem.h"
+#include "FileSystem/BsDataStream.h"
+#include "Utility/BsContentHash.h"
+#include "Debug/BsDebug.h"
+
+namespace bs
+{
+	/** Identifier at the start of every journal file ("BSPJ"). */
+	static constexpr UINT32 JOURNAL_MAGIC = 0x4A505342;
+
+	/** Version of the journal format. Journals of a different version are ignored. */
+	static constexpr UINT32 JOURNAL_VERSION = 2;
+
+	/** Set on file records of entries that have meta-data. */
+	static constexpr UINT32 JOURNAL_FILE_HAS_META = 1 << 0;
+
+	/** Set on file records of entries whose resources should always be included in the build. */
+	static constexpr UINT32 JOURNAL_FILE_INCLUDE_IN_BUILD = 1 << 1;
+
+	/** Types of records stored in the journal. */
+	enum class JournalRecordType : UINT32
+	{
+		File, /**< Current state of a file entry, including its meta-data header and import dependencies. */
+		Directory, /**< Directory entry exists. */
+		Remove, /**< Entry and all of its descendants no longer exist. */
+		RegisterResource, /**< Resource manifest maps a UUID to a path. */
+		UnregisterResource /**< Resource manifest no longer contains a UUID. */
+	};
+
+	/** Header at the start of the journal file. */
+	struct JournalHeader
+	{
+		UINT32 magic;
+		UINT32 version;
+		UUID generation;
+	};
+
+	/** Header preceding every record. Checksum is calculated from the record data following the header. */
+	struct JournalRecordHeader
+	{
+		UINT32 size;
+		UINT32 checksum;
+	};
+
+	/** Appends primitive values and strings to a record. */
+	class JournalWriter
+	{
+	public:
+		JournalWriter(Vector<UINT8>& output)
+			:mOutput(output)
+		{ }
+
+		template<class T>
+		void write(const T& value)
+		{
+			writeBytes(&value, sizeof(value));
+		}
+
+		void writeString(const String& value)
+		{
+			write((UINT32)value.size());
+			writeBytes(value.data(), (UINT32)value.size());
+		}
+
+		void writeBytes(const void* data, UINT32 size)
+		{
+			mOutput.insert(mOutput.end(), (const UINT8*)data, (const UINT8*)data + size);
+		}
+
+	private:
+		Vector<UINT8>& mOutput;
+	};
+
+	/** Reads primitive values and strings from a record, with bounds checking. */
+	class JournalReader
+	{
+	public:
+		JournalReader(const UINT8* data, UINT32 size)
+			:mData(data), mSize(size)
+		{ }
+
+		template<class T>
+		bool read(T& value)
+		{
+			const UINT8* bytes = readBytes(sizeof(T));
+			if (bytes == nullptr)
+				return false;
+
+			memcpy(&value, bytes, sizeof(T));
+			return true;
+		}
+
+		bool readString(String& value)
+		{
+			UINT32 length = 0;
+			if (!read(length))
+				return false;
+
+			const UINT8* bytes = readBytes(length);
+			if (bytes == nullptr)
+				return false;
+
+			value.assign((const char*)bytes, length);
+			return true;
+		}
+
+		const UINT8* readBytes(UINT32 size)
+		{
+			if (size > mSize - mOffset)
+				return nullptr;
+
+			const UINT8* output = mData + mOffset;
+			mOffset += size;
+
+			return output;
+		}
+
+		bool isAtEnd() const { return mOffset == mSize; }
+
+	private:
+		const UINT8* mData;
+		UINT32 mSize;
+		UINT32 mOffset = 0;
+	};
+
+	/** Appends the record data to the output, preceded by a record header. */
+	static void appendJournalRecord(Vector<UINT8>& output, const Vector<UINT8>& record)
+	{
+		JournalRecordHeader header;
+		header.size = (UINT32)record.size();
+		header.checksum = (UINT32)ContentHash::compute(record.data(), record.size(), JOURNAL_VERSION);
+
+		JournalWriter writer(output);
+		writer.write(header);
+		writer.writeBytes(record.data(), header.size);
+	}
+
+	/** Splits a path relative to the resources folder into its elements. */
+	static Vector<String> getJournalPathElements(const Path& relativePath)
+	{
+		UINT32 numElems = relativePath.getNumDirectories() + (relativePath.isFile() ? 1 : 0);
+
+		Vector<String> output;
+		for (UINT32 i = 0; i < numElems; i++)
+		{
+			if (relativePath.isFile() && i == (numElems - 1))
+				output.push_back(relativePath.getFilename());
+			else
+				output.push_back(relativePath[i]);
+		}
+
+		return output;
+	}
+
+	/** Finds a direct child of the directory with the provided name, using the same case rules as path comparison. */
+	static ProjectLibrary::LibraryEntry* findJournalChild(ProjectLibrary::DirectoryEntry* parent, const String& name)
+	{
+		for (auto& child : parent->mChildren)
+		{
+			if (Path::comparePathElem(child->elementName, name))
+				return child;
+		}
+
+		return nullptr;
+	}
+
+	/** Deletes the entry and all of its descendants, along with their UUID mappings and import dependencies. */
+	static void destroyJournalEntry(ProjectLibrary::LibraryEntry* entry, ResourceLocationMap& resourceLocations,
+		ImportDependencyGraph& dependencies)
+	{
+		if (entry->type == ProjectLibrary::LibraryEntryType::File)
+		{
+			ProjectLibrary::FileEntry* fileEntry = static_cast<ProjectLibrary::FileEntry*>(entry);
+			for (auto& resource : fileEntry->resources)
+				resourceLocations.erase(resource.uuid);
+
+			dependencies.removeDependencies(fileEntry->path);
+			bs_delete(fileEntry);
+		}
+		else
+		{
+			ProjectLibrary::DirectoryEntry* dirEntry = static_cast<ProjectLibrary::DirectoryEntry*>(entry);
+			for (auto& child : dirEntry->mChildren)
+				destroyJournalEntry(child, resourceLocations, dependencies);
+
+			bs_delete(dirEntry);
+		}
+	}
+
+	/** Removes the entry from its parent and deletes it. See destroyJournalEntry(). */
+	static void removeJournalEntry(ProjectLibrary::LibraryEntry* entry, ResourceLocationMap& resourceLocations,
+		ImportDependencyGraph& dependencies)
+	{
+		Vector<ProjectLibrary::LibraryEntry*>& siblings = entry->parent->mChildren;
+		siblings.erase(std::find(siblings.begin(), siblings.end(), entry));
+
+		destroyJournalEntry(entry, resourceLocations, dependencies);
+	}
+
+	/**
+	 * Returns the directory entry described by the first @p count path elements, creating any directory entries that
+	 * don't exist. File entries in the way are replaced.
+	 */
+	static ProjectLibrary::DirectoryEntry* createJournalDirectory(ProjectLibrary::DirectoryEntry* root,
+		const Vector<String>& elements, UINT32 count, ResourceLocationMap& resourceLocations,
+		ImportDependencyGraph& dependencies)
+	{
+		ProjectLibrary::DirectoryEntry* current = root;
+		for (UINT32 i = 0; i < count; i++)
+		{
+			ProjectLibrary::LibraryEntry* child = findJournalChild(current, elements[i]);
+			if (child != nullptr && child->type == ProjectLibrary::LibraryEntryType::File)
+			{
+				removeJournalEntry(child, resourceLocations, dependencies);
+				child = nullptr;
+			}
+
+			if (child == nullptr)
+			{
+				Path childPath = current->path;
+				childPath.append(elements[i]);
+
+				child = bs_new<ProjectLibrary::DirectoryEntry>(childPath, elements[i], current);
+				current->mChildren.push_back(child);
+			}
+
+			current = static_cast<ProjectLibrary::DirectoryEntry*>(child);
+		}
+
+		return current;
+	}
+
+	ProjectLibraryJournal::ProjectLibraryJournal(const Path& path, const Path& projectFolder,
+		const Path& resourcesFolder)
+		:mPath(path), mProjectFolder(projectFolder), mResourcesFolder(resourcesFolder)
+	{ }
+
+	bool ProjectLibraryJournal::replay(const UUID& generation, ProjectLibrary::DirectoryEntry* root,
+		ResourceLocationMap& resourceLocations, ImportDependencyGraph& dependencies, ResourceManifest& manifest)
+	{
+		mIsOpen = false;
+		mPendingRecords.clear();
+
+		if (!FileSystem::isFile(mPath))
+			return false;
+
+		SPtr<DataStream> stream = FileSystem::openFile(mPath, true);
+		if (stream == nullptr)
+			return false;
+
+		UINT64 size = (UINT64)stream->size();
+		if (size < sizeof(JournalHeader))
+		{
+			stream->close();
+			return false;
+		}
+
+		Vector<UINT8> data((size_t)size);
+		UINT64 numRead = (UINT64)stream->read(data.data(), (size_t)size);
+		stream->close();
+
+		if (numRead != size)
+			return false;
+
+		const JournalHeader& header = *(const JournalHeader*)data.data();
+		if (header.magic != JOURNAL_MAGIC || header.version != JOURNAL_VERSION || header.generation != generation)
+			return false;
+
+		// Apply records until the end of the file, or the first record that wasn't completely written
+		UINT64 offset = sizeof(JournalHeader);
+		while (size - offset >= sizeof(JournalRecordHeader))
+		{
+			JournalRecordHeader recordHeader;
+			memcpy(&recordHeader, data.data() + offset, sizeof(recordHeader));
+
+			UINT64 recordOffset = offset + sizeof(JournalRecordHeader);
+			if (recordHeader.size > size - recordOffset)
+				break;
+
+			const UINT8* recordData = data.data() + recordOffset;
+			if ((UINT32)ContentHash::compute(recordData, recordHeader.size, JOURNAL_VERSION) != recordHeader.checksum)
+				break;
+
+			if (!applyRecord(recordData, recordHeader.size, root, resourceLocations, dependencies, manifest))
+				break;
+
+			offset = recordOffset + recordHeader.size;
+		}
+
+		if (offset != size)
+		{
+			LOGWRN("Project library journal \"" + mPath.toString() + "\" ends with an incomplete record. Changes made "
+				"after it were lost.");
+		}
+
+		mValidSize = offset;
+		mSize = size;
+		mIsOpen = true;
+
+		return true;
+	}
+
+	bool ProjectLibraryJournal::reset(const UUID& generation)
+	{
+		mIsOpen = false;
+		mPendingRecords.clear();
+
+		JournalHeader header{};
+		header.magic = JOURNAL_MAGIC;
+		header.version = JOURNAL_VERSION;
+		header.generation = generation;
+
+		SPtr<DataStream> stream = FileSystem::createAndOpenFile(mPath);
+		if (stream == nullptr)
+			return false;
+
+		bool written = stream->write(&header, sizeof(header)) == sizeof(header);
+		stream->close();
+
+		if (!written)
+			return false;
+
+		mSize = sizeof(header);
+		mValidSize = mSize;
+		mIsOpen = true;
+
+		return true;
+	}
+
+	void ProjectLibraryJournal::discard()
+	{
+		mIsOpen = false;
+		mPendingRecords.clear();
+		mSize = 0;
+		mValidSize = 0;
+
+		if (FileSystem::isFile(mPath))
+			FileSystem::remove(mPath);
+	}
+
+	void ProjectLibraryJournal::writeEntry(const ProjectLibrary::LibraryEntry* entry, bool recursive,
+		const ImportDependencyGraph& dependencies)
+	{
+		Stack<const ProjectLibrary::LibraryEntry*> todo;
+		todo.push(entry);
+
+		while (!todo.empty())
+		{
+			const ProjectLibrary::LibraryEntry* current = todo.top();
+			todo.pop();
+
+			Vector<UINT8> record;
+			JournalWriter writer(record);
+			if (current->type == ProjectLibrary::LibraryEntryType::File)
+			{
+				const ProjectLibrary::FileEntry* fileEntry = static_cast<const ProjectLibrary::FileEntry*>(current);
+
+				writer.write(JournalRecordType::File);
+				writer.writeString(toJournalPath(fileEntry->path, mResourcesFolder));
+				writer.write((INT64)fileEntry->lastUpdateTime);
+				writer.write(fileEntry->sourceSize);
+				writer.write((INT64)fileEntry->sourceModifiedTime);
+				writer.write(fileEntry->sourceHash);
+				writer.write((INT64)fileEntry->metaModifiedTime);
+				writer.write(fileEntry->importOptionsHash);
+
+				UINT32 flags = 0;
+				if (fileEntry->hasMeta)
+					flags |= JOURNAL_FILE_HAS_META;
+
+				if (fileEntry->includeInBuild)
+					flags |= JOURNAL_FILE_INCLUDE_IN_BUILD;
+
+				writer.write(flags);
+				writer.write((UINT32)fileEntry->resources.size());
+				for (auto& resource : fileEntry->resources)
+				{
+					writer.write(resource.uuid);
+					writer.write(resource.typeId);
+					writer.writeString(resource.uniqueName);
+				}
+
+				const Vector<Path>& entryDependencies = dependencies.getDependencies(fileEntry->path);
+				writer.write((UINT32)entryDependencies.size());
+				for (auto& dependency : entryDependencies)
+					writer.writeString(toJournalPath(dependency, mResourcesFolder));
+			}
+			else
+			{
+				writer.write(JournalRecordType::Directory);
+				writer.writeString(toJournalPath(current->path, mResourcesFolder));
+
+				if (recursive)
+				{
+					const ProjectLibrary::DirectoryEntry* dirEntry =
+						static_cast<const ProjectLibrary::DirectoryEntry*>(current);
+
+					for (auto iter = dirEntry->mChildren.rbegin(); iter != dirEntry->mChildren.rend(); ++iter)
+						todo.push(*iter);
+				}
+			}
+
+			appendJournalRecord(mPendingRecords, record);
+		}
+	}
+
+	void ProjectLibraryJournal::writeRemove(const Path& path)
+	{
+		Vector<UINT8> record;
+		JournalWriter writer(record);
+		writer.write(JournalRecordType::Remove);
+		writer.writeString(toJournalPath(path, mResourcesFolder));
+
+		appendJournalRecord(mPendingRecords, record);
+	}
+
+	void ProjectLibraryJournal::writeRegisterResource(const UUID& uuid, const Path& path)
+	{
+		Vector<UINT8> record;
+		JournalWriter writer(record);
+		writer.write(JournalRecordType::RegisterResource);
+		writer.write(uuid);
+		writer.writeString(toJournalPath(path, mProjectFolder));
+
+		appendJournalRecord(mPendingRecords, record);
+	}
+
+	void ProjectLibraryJournal::writeUnregisterResource(const UUID& uuid)
+	{
+		Vector<UINT8> record;
+		JournalWriter writer(record);
+		writer.write(JournalRecordType::UnregisterResource);
+		writer.write(uuid);
+
+		appendJournalRecord(mPendingRecords, record);
+	}
+
+	bool ProjectLibraryJournal::flush()
+	{
+		if (!mIsOpen || mPendingRecords.empty())
+			return mIsOpen;
+
+		SPtr<DataStream> stream;
+		if (mValidSize == mSize)
+		{
+			stream = FileSystem::openFile(mPath, false);
+			if (stream == nullptr)
+				return false;
+
+			stream->seek((size_t)mValidSize);
+		}
+		else
+		{
+			// The journal ends with a partially written record, which must be dropped before anything is appended.
+			// This requires rewriting the journal, but only happens once after a crash.
+			SPtr<DataStream> oldStream = FileSystem::openFile(mPath, true);
+			if (oldStream == nullptr)
+				return false;
+
+			Vector<UINT8> validData((size_t)mValidSize);
+			size_t numRead = oldStream->read(validData.data(), validData.size());
+			oldStream->close();
+
+			if (numRead != validData.size())
+				return false;
+
+			stream = FileSystem::createAndOpenFile(mPath);
+			if (stream == nullptr)
+				return false;
+
+			if (stream->write(validData.data(), validData.size()) != validData.size())
+			{
+				stream->close();
+				return false;
+			}
+		}
+
+		size_t numWritten = stream->write(mPendingRecords.data(), mPendingRecords.size());
+		stream->close();
+
+		if (numWritten != mPendingRecords.size())
+		{
+			// Partially written record will be ignored on replay, and dropped by the next flush
+			mSize = mValidSize + numWritten;
+			return false;
+		}
+
+		mValidSize += mPendingRecords.size();
+		mSize = mValidSize;
+		mPendingRecords.clear();
+
+		return true;
+	}
+
+	bool ProjectLibraryJournal::applyRecord(const UINT8* data, UINT32 size, ProjectLibrary::DirectoryEntry* root,
+		ResourceLocationMap& resourceLocations, ImportDependencyGraph& dependencies, ResourceManifest& manifest)
+	{
+		JournalReader reader(data, size);
+
+		JournalRecordType type;
+		if (!reader.read(type))
+			return false;
+
+		switch (type)
+		{
+		case JournalRecordType::File:
+		{
+			String pathStr;
+			INT64 lastUpdateTime, sourceModifiedTime, metaModifiedTime;
+			UINT64 sourceSize, sourceHash, importOptionsHash;
+			UINT32 flags, numResources;
+
+			if (!reader.readString(pathStr) || !reader.read(lastUpdateTime) || !reader.read(sourceSize) ||
+				!reader.read(sourceModifiedTime) || !reader.read(sourceHash) || !reader.read(metaModifiedTime) ||
+				!reader.read(importOptionsHash) || !reader.read(flags) || !reader.read(numResources))
+				return false;
+
+			if ((flags & JOURNAL_FILE_HAS_META) == 0 && numResources > 0)
+				return false;
+
+			Vector<ProjectLibrary::ResourceHeader> resources;
+			for (UINT32 i = 0; i < numResources; i++)
+			{
+				ProjectLibrary::ResourceHeader resource;
+				if (!reader.read(resource.uuid) || !reader.read(resource.typeId) ||
+					!reader.readString(resource.uniqueName))
+					return false;
+
+				resources.push_back(resource);
+			}
+
+			UINT32 numDependencies;
+			if (!reader.read(numDependencies))
+				return false;
+
+			Vector<Path> entryDependencies;
+			for (UINT32 i = 0; i < numDependencies; i++)
+			{
+				String dependency;
+				if (!reader.readString(dependency))
+					return false;
+
+				entryDependencies.push_back(fromJournalPath(dependency, mResourcesFolder));
+			}
+
+			Path relativePath = pathStr;
+			Vector<String> elements = getJournalPathElements(relativePath);
+			if (elements.empty() || relativePath.isAbsolute())
+				return false;
+
+			ProjectLibrary::DirectoryEntry* parent = createJournalDirectory(root, elements,
+				(UINT32)elements.size() - 1, resourceLocations, dependencies);
+
+			ProjectLibrary::LibraryEntry* existing = findJournalChild(parent, elements.back());
+			if (existing != nullptr && existing->type == ProjectLibrary::LibraryEntryType::Directory)
+			{
+				removeJournalEntry(existing, resourceLocations, dependencies);
+				existing = nullptr;
+			}
+
+			ProjectLibrary::FileEntry* fileEntry;
+			if (existing != nullptr)
+			{
+				fileEntry = static_cast<ProjectLibrary::FileEntry*>(existing);
+				for (auto& resource : fileEntry->resources)
+					resourceLocations.erase(resource.uuid);
+			}
+			else
+			{
+				Path entryPath = parent->path;
+				entryPath.append(elements.back());
+
+				fileEntry = bs_new<ProjectLibrary::FileEntry>(entryPath, elements.back(), parent);
+				parent->mChildren.push_back(fileEntry);
+			}
+
+			fileEntry->lastUpdateTime = (std::time_t)lastUpdateTime;
+			fileEntry->sourceSize = sourceSize;
+			fileEntry->sourceModifiedTime = (std::time_t)sourceModifiedTime;
+			fileEntry->sourceHash = sourceHash;
+			fileEntry->metaModifiedTime = (std::time_t)metaModifiedTime;
+			fileEntry->importOptionsHash = importOptionsHash;
+
+			// Full meta-data is decoded from the .meta file when first needed
+			fileEntry->setMeta(nullptr);
+			fileEntry->hasMeta = (flags & JOURNAL_FILE_HAS_META) != 0;
+			fileEntry->includeInBuild = (flags & JOURNAL_FILE_INCLUDE_IN_BUILD) != 0;
+			fileEntry->resources = std::move(resources);
+
+			resourceLocations.set(fileEntry);
+
+			dependencies.setDependencies(fileEntry->path, entryDependencies);
+		}
+			break;
+		case JournalRecordType::Directory:
+		case JournalRecordType::Remove:
+		{
+			String pathStr;
+			if (!reader.readString(pathStr))
+				return false;
+
+			Path relativePath = pathStr;
+			if (relativePath.isAbsolute())
+				return false;
+
+			Vector<String> elements = getJournalPathElements(relativePath);
+			if (type == JournalRecordType::Directory)
+			{
+				createJournalDirectory(root, elements, (UINT32)elements.size(), resourceLocations, dependencies);
+				break;
+			}
+
+			// Root is never removed
+			if (elements.empty())
+				break;
+
+			ProjectLibrary::LibraryEntry* entry = root;
+			for (auto& element : elements)
+			{
+				if (entry->type != ProjectLibrary::LibraryEntryType::Directory)
+				{
+					entry = nullptr;
+					break;
+				}
+
+				entry = findJournalChild(static_cast<ProjectLibrary::DirectoryEntry*>(entry), element);
+				if (entry == nullptr)
+					break;
+			}
+
+			if (entry != nullptr)
+				removeJournalEntry(entry, resourceLocations, dependencies);
+		}
+			break;
+		case JournalRecordType::RegisterResource:
+		{
+			UUID uuid;
+			String pathStr;
+			if (!reader.read(uuid) || !reader.readString(pathStr))
+				return false;
+
+			manifest.registerResource(uuid, fromJournalPath(pathStr, mProjectFolder));
+		}
+			break;
+		case JournalRecordType::UnregisterResource:
+		{
+			UUID uuid;
+			if (!reader.read(uuid))
+				return false;
+
+			manifest.unregisterResource(uuid);
+		}
+			break;
+		default:
+			return false;
+		}
+
+		return reader.isAtEnd();
+	}
+
+	String ProjectLibraryJournal::toJournalPath(const Path& path, const Path& folder) const
+	{
+		Path output = path;
+		if (folder.includes(output))
+			output.makeRelative(folder);
+
+		return output.toString();
+	}
+
+	Path ProjectLibraryJournal::fromJournalPath(const String& path, const Path& folder) const
+	{
+		Path output = path;
+		if (!output.isAbsolute())
+			output.makeAbsolute(folder);
+
+		return output;
+	}
+}
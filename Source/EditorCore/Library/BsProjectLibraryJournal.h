@@ -0,0 +1,124 @@
+//********************************** Banshee Engine (www.banshee3d.com) **************************************************//
+//**************** Copyright (c) 2016 Marko Pintera (marko.pintera@gmail.com). All rights reserved. **********************//
+#pragma once
+
+#include "BsEditorPrerequisites.h"
+#include "Library/BsProjectLibrary.h"
+
+namespace bs
+{
+	class ImportDependencyGraph;
+	class ResourceLocationMap;
+
+	/** @addtogroup Library-Internal
+	 *  @{
+	 */
+
+	/**
+	 * Append-only log of changes made to the project library since the last library snapshot was saved. Each record
+	 * describes the latest state of a single library entry or resource manifest mapping, so replaying the records on
+	 * top of the snapshot restores the library as of the last journal flush. Saving only requires appending the records
+	 * of entries that changed, and the journal is periodically compacted by saving a new snapshot and starting a new,
+	 * empty journal.
+	 *
+	 * Every journal is tied to a specific snapshot through a generation identifier, and a journal of a different
+	 * generation is never replayed. Records are checksummed, so a record that was only partially written (e.g. due to a
+	 * crash) is discarded along with everything following it.
+	 */
+	class ProjectLibraryJournal
+	{
+	public:
+		/**
+		 * Creates a journal stored in the specified file. Nothing is read or written until replay() or reset() is
+		 * called.
+		 *
+		 * @param[in]	path				Absolute path to the journal file.
+		 * @param[in]	projectFolder		Folder of the project the library belongs to. Resource manifest paths are
+		 *									stored relative to it.
+		 * @param[in]	resourcesFolder		Folder the library entries are located in. Entry paths are stored relative
+		 *									to it.
+		 */
+		ProjectLibraryJournal(const Path& path, const Path& projectFolder, const Path& resourcesFolder);
+
+		/**
+		 * Applies all the valid records in the journal to a library hierarchy restored from a snapshot. Only done if
+		 * the journal belongs to the snapshot, as determined by the generation. Afterwards new records can be appended
+		 * to the journal.
+		 *
+		 * @param[in]	generation			Generation of the snapshot the hierarchy was loaded from.
+		 * @param[in]	root				Root of the library hierarchy.
+		 * @param[in]	resourceLocations	Map of resource UUIDs to their file entries, updated with any changes.
+		 * @param[in]	dependencies		Graph of import dependencies, updated with any changes.
+		 * @param[in]	manifest			Resource manifest, updated with any changes.
+		 * @return							False if the journal is missing or belongs to a different snapshot. In that
+		 *									case nothing is applied and reset() must be called before appending new
+		 *									records.
+		 */
+		bool replay(const UUID& generation, ProjectLibrary::DirectoryEntry* root,
+			ResourceLocationMap& resourceLocations, ImportDependencyGraph& dependencies, ResourceManifest& manifest);
+
+		/**
+		 * Discards all records and starts a new empty journal for the snapshot with the provided generation. Any
+		 * pending records are discarded as well.
+		 */
+		bool reset(const UUID& generation);
+
+		/** Deletes the journal file along with any pending records. Nothing can be appended until reset() is called. */
+		void discard();
+
+		/**
+		 * Queues a record describing the current state of a library entry.
+		 *
+		 * @param[in]	entry			Entry to record.
+		 * @param[in]	recursive		If true and the entry is a directory, the state of all its descendants is
+		 *								recorded as well.
+		 * @param[in]	dependencies	Graph to retrieve the import dependencies of file entries from.
+		 */
+		void writeEntry(const ProjectLibrary::LibraryEntry* entry, bool recursive,
+			const ImportDependencyGraph& dependencies);
+
+		/** Queues a record noting that the entry at the provided absolute path and all its descendants were removed. */
+		void writeRemove(const Path& path);
+
+		/** Queues a record noting that the resource with the provided UUID is stored at the provided absolute path. */
+		void writeRegisterResource(const UUID& uuid, const Path& path);
+
+		/** Queues a record noting that the resource with the provided UUID was removed from the resource manifest. */
+		void writeUnregisterResource(const UUID& uuid);
+
+		/** Appends all queued records to the journal file. Returns false if the records could not be written. */
+		bool flush();
+
+		/** Checks are there any records queued by the write methods that haven't been flushed yet. */
+		bool hasPendingRecords() const { return !mPendingRecords.empty(); }
+
+		/** Returns the size of the journal file in bytes, as of the last flush. */
+		UINT64 getSize() const { return mSize; }
+
+		/** Checks has the journal been replayed or reset, meaning new records can be appended to it. */
+		bool isOpen() const { return mIsOpen; }
+
+	private:
+		/** Applies a single decoded record to the library. Returns false if the record is malformed. */
+		bool applyRecord(const UINT8* data, UINT32 size, ProjectLibrary::DirectoryEntry* root,
+			ResourceLocationMap& resourceLocations, ImportDependencyGraph& dependencies, ResourceManifest& manifest);
+
+		/** Converts an absolute entry path into the form stored in the journal. */
+		String toJournalPath(const Path& path, const Path& folder) const;
+
+		/** Converts a path stored in the journal back into an absolute path. */
+		Path fromJournalPath(const String& path, const Path& folder) const;
+
+		Path mPath;
+		Path mProjectFolder;
+		Path mResourcesFolder;
+
+		UINT64 mSize = 0;
+		UINT64 mValidSize = 0;
+		bool mIsOpen = false;
+
+		Vector<UINT8> mPendingRecords;
+	};
+
+	/** @} */
+}
@@ -0,0 +1,357 @@
+//********************************** Banshee Engine (www.banshee3d.com) **************************************************//
+//**************** Copyright (c) 2016 Marko Pintera (marko.pintera@gmail.com). All rights reserved. **********************//
+#include "Library/BsProjectLibrarySearch.h"
+#include "Library/BsProjectResourceMeta.h"
+
+namespace bs
+{
+	/** Minimum number of removed slots before the index is considered for compaction. */
+	static constexpr UINT32 MIN_REMOVED_FOR_COMPACTION = 1024;
+
+	void ProjectLibrarySearchIndex::add(ProjectLibrary::LibraryEntry* entry)
+	{
+		remove(entry);
+		addInternal(entry);
+	}
+
+	void ProjectLibrarySearchIndex::remove(ProjectLibrary::LibraryEntry* entry)
+	{
+		auto iterFind = mEntryToSlot.find(entry);
+		if (iterFind == mEntryToSlot.end())
+			return;
+
+		// Posting lists still reference the slot, but dead slots are skipped when reading them
+		Slot& slot = mSlots[iterFind->second];
+		slot.alive = false;
+		slot.entry = nullptr;
+		slot.name.clear();
+
+		mEntryToSlot.erase(iterFind);
+		mNumRemoved++;
+
+		compactIfNeeded();
+	}
+
+	void ProjectLibrarySearchIndex::update(ProjectLibrary::LibraryEntry* entry)
+	{
+		// Slots are append-only, so an update is just a removal followed by an addition
+		add(entry);
+	}
+
+	void ProjectLibrarySearchIndex::clear()
+	{
+		mSlots.clear();
+		mEntryToSlot.clear();
+		mTrigrams.clear();
+		mFilesByType.clear();
+		mBuildSlots.clear();
+		mNumRemoved = 0;
+	}
+
+	void ProjectLibrarySearchIndex::addInternal(ProjectLibrary::LibraryEntry* entry)
+	{
+		UINT32 slotIdx = (UINT32)mSlots.size();
+
+		String name = entry->elementName;
+		StringUtil::toLowerCase(name);
+
+		UnorderedSet<UINT32> trigramKeys;
+		for (UINT32 i = 0; i + 3 <= (UINT32)name.size(); i++)
+			trigramKeys.insert(getTrigramKey(&name[i]));
+
+		for (auto& key : trigramKeys)
+			mTrigrams[key].push_back(slotIdx);
+
+		if (entry->type == ProjectLibrary::LibraryEntryType::File)
+			addFile(static_cast<ProjectLibrary::FileEntry*>(entry), slotIdx);
+
+		mSlots.push_back({ entry, name, true });
+		mEntryToSlot[entry] = slotIdx;
+	}
+
+	void ProjectLibrarySearchIndex::addFile(ProjectLibrary::FileEntry* entry, UINT32 slotIdx)
+	{
+		if (!entry->hasMeta)
+			return;
+
+		// Slots are only ever appended, so the posting lists stay sorted
+		for (UINT32 i = 0; i < (UINT32)entry->resources.size(); i++)
+		{
+			UINT32 typeId = entry->resources[i].typeId;
+
+			bool isDuplicate = false;
+			for (UINT32 j = 0; j < i; j++)
+			{
+				if (entry->resources[j].typeId == typeId)
+				{
+					isDuplicate = true;
+					break;
+				}
+			}
+
+			if (!isDuplicate)
+				mFilesByType[typeId].push_back(slotIdx);
+		}
+
+		if (entry->includeInBuild)
+			mBuildSlots.push_back(slotIdx);
+	}
+
+	void ProjectLibrarySearchIndex::compactIfNeeded()
+	{
+		if (mNumRemoved < MIN_REMOVED_FOR_COMPACTION || mNumRemoved < (UINT32)mEntryToSlot.size())
+			return;
+
+		Vector<Slot> oldSlots = std::move(mSlots);
+		mSlots.clear();
+		mEntryToSlot.clear();
+		mTrigrams.clear();
+		mFilesByType.clear();
+		mBuildSlots.clear();
+		mNumRemoved = 0;
+
+		for (auto& slot : oldSlots)
+		{
+			if (slot.alive)
+				addInternal(slot.entry);
+		}
+	}
+
+	Vector<ProjectLibrary::LibraryEntry*> ProjectLibrarySearchIndex::find(const String& pattern,
+		const Vector<UINT32>& typeIds, UINT32 offset, UINT32 count) const
+	{
+		Vector<ProjectLibrary::LibraryEntry*> output;
+
+		String lowerPattern = pattern;
+		StringUtil::toLowerCase(lowerPattern);
+
+		// Split the pattern into literal segments separated by wildcards
+		Vector<String> segments;
+		String segment;
+		for (auto& entry : lowerPattern)
+		{
+			if (entry == '*')
+			{
+				if (!segment.empty())
+					segments.push_back(segment);
+
+				segment.clear();
+			}
+			else
+				segment += entry;
+		}
+
+		if (!segment.empty())
+			segments.push_back(segment);
+
+		// Every trigram of every literal segment must be present in a matching name
+		Vector<const Vector<UINT32>*> postingLists;
+		for (auto& entry : segments)
+		{
+			for (UINT32 i = 0; i + 3 <= (UINT32)entry.size(); i++)
+			{
+				auto iterFind = mTrigrams.find(getTrigramKey(&entry[i]));
+				if (iterFind == mTrigrams.end())
+					return output;
+
+				postingLists.push_back(&iterFind->second);
+			}
+		}
+
+		// Matching entries must also contain at least one of the requested types
+		Vector<UINT32> typeSlots;
+		if (!typeIds.empty())
+		{
+			getTypeSlots(typeIds, typeSlots);
+			if (typeSlots.empty())
+				return output;
+
+			postingLists.push_back(&typeSlots);
+		}
+
+		// Intersect the lists, starting with the shortest one to keep the intermediate results small
+		Vector<UINT32> candidates;
+		bool allSlots = postingLists.empty();
+		if (!allSlots)
+		{
+			std::sort(postingLists.begin(), postingLists.end(),
+				[](const Vector<UINT32>* a, const Vector<UINT32>* b) { return a->size() < b->size(); });
+
+			candidates = *postingLists[0];
+
+			Vector<UINT32> intersection;
+			for (UINT32 i = 1; i < (UINT32)postingLists.size() && !candidates.empty(); i++)
+			{
+				intersection.clear();
+				std::set_intersection(candidates.begin(), candidates.end(), postingLists[i]->begin(),
+					postingLists[i]->end(), std::back_inserter(intersection));
+
+				std::swap(candidates, intersection);
+			}
+		}
+
+		// Verify the candidates against the full pattern, and rank them
+		String literal;
+		for (auto& entry : segments)
+			literal += entry;
+
+		struct RankedEntry
+		{
+			UINT32 slot;
+			UINT32 rank;
+		};
+
+		Vector<RankedEntry> results;
+		auto processSlot = [&](UINT32 slotIdx)
+		{
+			const Slot& slot = mSlots[slotIdx];
+			if (!slot.alive || !matches(slot.name, lowerPattern))
+				return;
+
+			UINT32 rank = 2;
+			if (slot.name == literal)
+				rank = 0;
+			else if (!segments.empty() && slot.name.compare(0, segments[0].size(), segments[0]) == 0)
+				rank = 1;
+
+			results.push_back({ slotIdx, rank });
+		};
+
+		if (allSlots)
+		{
+			for (UINT32 i = 0; i < (UINT32)mSlots.size(); i++)
+				processSlot(i);
+		}
+		else
+		{
+			for (auto& slotIdx : candidates)
+				processSlot(slotIdx);
+		}
+
+		auto compare = [&](const RankedEntry& a, const RankedEntry& b)
+		{
+			if (a.rank != b.rank)
+				return a.rank < b.rank;
+
+			const String& nameA = mSlots[a.slot].name;
+			const String& nameB = mSlots[b.slot].name;
+			if (nameA.size() != nameB.size())
+				return nameA.size() < nameB.size();
+
+			int nameCmp = nameA.compare(nameB);
+			if (nameCmp != 0)
+				return nameCmp < 0;
+
+			return a.slot < b.slot;
+		};
+
+		if (offset >= (UINT32)results.size())
+			return output;
+
+		UINT32 end = (UINT32)results.size();
+		if (count > 0)
+			end = std::min(end, offset + count);
+
+		std::partial_sort(results.begin(), results.begin() + end, results.end(), compare);
+
+		output.reserve(end - offset);
+		for (UINT32 i = offset; i < end; i++)
+			output.push_back(mSlots[results[i].slot].entry);
+
+		return output;
+	}
+
+	Vector<ProjectLibrary::FileEntry*> ProjectLibrarySearchIndex::findByType(const Vector<UINT32>& typeIds) const
+	{
+		Vector<UINT32> typeSlots;
+		getTypeSlots(typeIds, typeSlots);
+
+		Vector<ProjectLibrary::FileEntry*> output;
+		for (auto& slotIdx : typeSlots)
+		{
+			const Slot& slot = mSlots[slotIdx];
+			if (slot.alive)
+				output.push_back(static_cast<ProjectLibrary::FileEntry*>(slot.entry));
+		}
+
+		return output;
+	}
+
+	Vector<ProjectLibrary::FileEntry*> ProjectLibrarySearchIndex::getBuildEntries() const
+	{
+		Vector<ProjectLibrary::FileEntry*> output;
+		for (auto& slotIdx : mBuildSlots)
+		{
+			const Slot& slot = mSlots[slotIdx];
+			if (slot.alive)
+				output.push_back(static_cast<ProjectLibrary::FileEntry*>(slot.entry));
+		}
+
+		return output;
+	}
+
+	void ProjectLibrarySearchIndex::getTypeSlots(const Vector<UINT32>& typeIds, Vector<UINT32>& output) const
+	{
+		output.clear();
+
+		Vector<UINT32> merged;
+		for (auto& typeId : typeIds)
+		{
+			auto iterFind = mFilesByType.find(typeId);
+			if (iterFind == mFilesByType.end())
+				continue;
+
+			const Vector<UINT32>& slots = iterFind->second;
+			if (output.empty())
+			{
+				output = slots;
+				continue;
+			}
+
+			// A file containing multiple of the requested types is present in multiple lists, but is only kept once
+			merged.clear();
+			std::set_union(output.begin(), output.end(), slots.begin(), slots.end(), std::back_inserter(merged));
+			std::swap(output, merged);
+		}
+	}
+
+	bool ProjectLibrarySearchIndex::matches(const String& name, const String& pattern)
+	{
+		UINT32 nameIdx = 0;
+		UINT32 patternIdx = 0;
+		UINT32 starPatternIdx = (UINT32)-1;
+		UINT32 starNameIdx = 0;
+
+		while (nameIdx < (UINT32)name.size())
+		{
+			if (patternIdx < (UINT32)pattern.size() && pattern[patternIdx] == '*')
+			{
+				starPatternIdx = patternIdx++;
+				starNameIdx = nameIdx;
+			}
+			else if (patternIdx < (UINT32)pattern.size() && pattern[patternIdx] == name[nameIdx])
+			{
+				patternIdx++;
+				nameIdx++;
+			}
+			else if (starPatternIdx != (UINT32)-1)
+			{
+				// Backtrack, letting the last wildcard consume one more character
+				patternIdx = starPatternIdx + 1;
+				nameIdx = ++starNameIdx;
+			}
+			else
+				return false;
+		}
+
+		while (patternIdx < (UINT32)pattern.size() && pattern[patternIdx] == '*')
+			patternIdx++;
+
+		return patternIdx == (UINT32)pattern.size();
+	}
+
+	UINT32 ProjectLibrarySearchIndex::getTrigramKey(const char* chars)
+	{
+		return (UINT32)(UINT8)chars[0] | ((UINT32)(UINT8)chars[1] << 8) | ((UINT32)(UINT8)chars[2] << 16);
+	}
+}
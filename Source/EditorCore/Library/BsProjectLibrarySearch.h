@@ -0,0 +1,104 @@
+//********************************** Banshee Engine (www.banshee3d.com) **************************************************//
+//**************** Copyright (c) 2016 Marko Pintera (marko.pintera@gmail.com). All rights reserved. **********************//
+#pragma once
+
+#include "BsEditorPrerequisites.h"
+#include "Library/BsProjectLibrary.h"
+
+namespace bs
+{
+	/** @addtogroup Library-Internal
+	 *  @{
+	 */
+
+	/**
+	 * Incrementally maintained index over the names and resource types of ProjectLibrary entries, allowing wildcard
+	 * searches without visiting every entry in the library. Names are indexed by their trigrams (sequences of three
+	 * consecutive characters). File entries are additionally indexed by the RTTI type IDs of the resources they
+	 * contain, and by their inclusion in the build, allowing those to be queried at a cost proportional to the number
+	 * of results rather than the size of the library.
+	 *
+	 * Entries are stored in slots that are never reused, which keeps all the posting lists sorted so they can be
+	 * intersected in linear time. Posting lists may reference removed slots, which are skipped when reading results.
+	 * Removed slots are reclaimed by periodically rebuilding the index.
+	 */
+	class ProjectLibrarySearchIndex
+	{
+	public:
+		/** Adds a new entry to the index. */
+		void add(ProjectLibrary::LibraryEntry* entry);
+
+		/** Removes an entry from the index. Does nothing if the entry isn't indexed. */
+		void remove(ProjectLibrary::LibraryEntry* entry);
+
+		/** Updates the indexed data for an entry, to be called when the entry's name or resource types change. */
+		void update(ProjectLibrary::LibraryEntry* entry);
+
+		/** Removes all entries from the index. */
+		void clear();
+
+		/**
+		 * Finds all entries whose names match the provided pattern.
+		 *
+		 * @param[in]	pattern		Pattern to match, case insensitive. Use wildcard * to match any character(s).
+		 * @param[in]	typeIds		If not empty, only file entries containing a resource of one of these types will be
+		 *							returned.
+		 * @param[in]	offset		Number of best ranked results to skip.
+		 * @param[in]	count		Maximum number of results to return. Zero means no limit.
+		 * @return					Matching entries, ranked so that exact matches come first, followed by entries
+		 *							starting with the pattern, and then all other matches. Entries with the same rank
+		 *							are sorted by length, then alphabetically.
+		 */
+		Vector<ProjectLibrary::LibraryEntry*> find(const String& pattern, const Vector<UINT32>& typeIds,
+			UINT32 offset = 0, UINT32 count = 0) const;
+
+		/**
+		 * Finds all file entries containing a resource of one of the provided types.
+		 *
+		 * @param[in]	typeIds		RTTI type IDs of the resources to look for.
+		 * @return					Matching entries, each entry returned only once, in the order they were indexed in.
+		 */
+		Vector<ProjectLibrary::FileEntry*> findByType(const Vector<UINT32>& typeIds) const;
+
+		/** Returns all the file entries flagged to be included in the build, in the order they were indexed in. */
+		Vector<ProjectLibrary::FileEntry*> getBuildEntries() const;
+
+	private:
+		/** Information about a single indexed entry. */
+		struct Slot
+		{
+			ProjectLibrary::LibraryEntry* entry;
+			String name;
+			bool alive;
+		};
+
+		/** Adds the entry into a new slot. */
+		void addInternal(ProjectLibrary::LibraryEntry* entry);
+
+		/** Adds the file entry stored in the provided slot to the type and build posting lists. */
+		void addFile(ProjectLibrary::FileEntry* entry, UINT32 slotIdx);
+
+		/** Merges the type posting lists of all the provided types into a single sorted list without duplicates. */
+		void getTypeSlots(const Vector<UINT32>& typeIds, Vector<UINT32>& output) const;
+
+		/** Rebuilds the index from scratch if enough slots were removed. */
+		void compactIfNeeded();
+
+		/** Checks does the lower-case name match the lower-case wildcard pattern. */
+		static bool matches(const String& name, const String& pattern);
+
+		/** Generates a key for the three characters starting at the provided location. */
+		static UINT32 getTrigramKey(const char* chars);
+
+		Vector<Slot> mSlots;
+		UINT32 mNumRemoved = 0;
+
+		UnorderedMap<ProjectLibrary::LibraryEntry*, UINT32> mEntryToSlot;
+		UnorderedMap<UINT32, Vector<UINT32>> mTrigrams;
+
+		UnorderedMap<UINT32, Vector<UINT32>> mFilesByType;
+		Vector<UINT32> mBuildSlots;
+	};
+
+	/** @} */
+}
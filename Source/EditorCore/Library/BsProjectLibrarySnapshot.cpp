@@ -0,0 +1,451 @@
+//********************************** Banshee Engine (www.banshee3d.com) **************************************************//
+//**************** Copyright (c) 2016 Marko Pintera (marko.pintera@gmail.com). All rights reserved. **********************//
+#include "Library/BsProjectLibrarySnapshot.h"
+#include "Library/BsProjectResourceMeta.h"
+#include "Library/BsImportDependencyGraph.h"
+#include "Library/BsResourceLocationMap.h"
+#include "FileSystem/BsFileSystem.h"
+#include "FileSystem/BsDataStream.h"
+
+namespace bs
+{
+	/** Identifier at the start of every snapshot file ("BSPL"). */
+	static constexpr UINT32 SNAPSHOT_MAGIC = 0x4C505342;
+
+	/** Version of the snapshot format. Snapshots of a different version are ignored. */
+	static constexpr UINT32 SNAPSHOT_VERSION = 3;
+
+	/** Index used for references to entries or strings that don't exist. */
+	static constexpr UINT32 SNAPSHOT_INVALID_INDEX = (UINT32)-1;
+
+	/** Alignment of all the sections in the snapshot file. */
+	static constexpr UINT64 SNAPSHOT_ALIGNMENT = 8;
+
+	/** Set on file entries that have meta-data. */
+	static constexpr UINT32 SNAPSHOT_ENTRY_HAS_META = 1 << 0;
+
+	/** Set on file entries whose resources should always be included in the build. */
+	static constexpr UINT32 SNAPSHOT_ENTRY_INCLUDE_IN_BUILD = 1 << 1;
+
+	/** Header at the start of the snapshot file. All offsets are relative to the start of the file. */
+	struct SnapshotHeader
+	{
+		UINT32 magic;
+		UINT32 version;
+		UINT64 fileSize;
+		UUID generation;
+
+		UINT32 numEntries;
+		UINT32 numUUIDs;
+		UINT32 numDependencies;
+		UINT32 numDependants;
+
+		UINT64 entriesOffset;
+		UINT64 uuidsOffset;
+		UINT64 dependenciesOffset;
+		UINT64 dependantsOffset;
+		UINT64 stringsOffset;
+		UINT64 stringsSize;
+	};
+
+	/** Reference to a string in the string section. Strings are stored as UTF-8 and are not null terminated. */
+	struct SnapshotString
+	{
+		UINT32 offset;
+		UINT32 length;
+	};
+
+	/**
+	 * Single library entry. Entries are stored in depth-first order, so the parent of an entry always precedes it. The
+	 * first entry is the root.
+	 */
+	struct SnapshotEntry
+	{
+		UINT32 parent;
+		UINT32 type;
+		SnapshotString name;
+
+		UINT32 flags; /**< Combination of SNAPSHOT_ENTRY_* flags. */
+		UINT32 padding;
+
+		INT64 lastUpdateTime;
+		UINT64 sourceSize;
+		INT64 sourceModifiedTime;
+		UINT64 sourceHash;
+		INT64 metaModifiedTime;
+		UINT64 importOptionsHash;
+	};
+
+	/** 
+	 * Header of a single resource in a file entry. Resources of the same file are stored in their original order, the
+	 * first one being the primary resource.
+	 */
+	struct SnapshotUUID
+	{
+		UUID uuid;
+		UINT32 entry;
+		UINT32 typeId;
+		SnapshotString uniqueName;
+	};
+
+	/** Maps a dependency path to a range of entries in the dependants section. */
+	struct SnapshotDependency
+	{
+		SnapshotString path; /**< Relative to the resources folder, unless located outside of it. */
+		UINT32 firstDependant;
+		UINT32 numDependants;
+	};
+
+	static_assert(sizeof(UUID) == 16, "Snapshot format assumes UUIDs are stored as 16 bytes.");
+	static_assert(sizeof(SnapshotEntry) % SNAPSHOT_ALIGNMENT == 0, "Snapshot records must be aligned.");
+	static_assert(sizeof(SnapshotUUID) % SNAPSHOT_ALIGNMENT == 0, "Snapshot records must be aligned.");
+	static_assert(sizeof(SnapshotDependency) % SNAPSHOT_ALIGNMENT == 0, "Snapshot records must be aligned.");
+
+	static UINT64 alignSnapshotOffset(UINT64 offset)
+	{
+		return (offset + SNAPSHOT_ALIGNMENT - 1) & ~(SNAPSHOT_ALIGNMENT - 1);
+	}
+
+	bool ProjectLibrarySnapshot::save(const Path& path, const UUID& generation,
+		const ProjectLibrary::DirectoryEntry* root, const Path& resourcesFolder,
+		const ImportDependencyGraph& dependencies)
+	{
+		Vector<SnapshotEntry> entries;
+		Vector<SnapshotUUID> uuids;
+		Vector<SnapshotDependency> dependencyRecords;
+		Vector<UINT32> dependants;
+		Vector<char> strings;
+
+		UnorderedMap<Path, UINT32> pathToEntry;
+
+		auto addString = [&](const String& value)
+		{
+			SnapshotString output;
+			output.offset = (UINT32)strings.size();
+			output.length = (UINT32)value.size();
+
+			strings.insert(strings.end(), value.begin(), value.end());
+			return output;
+		};
+
+		// Entries are written depth-first, ensuring parents are always written before their children
+		Stack<std::pair<const ProjectLibrary::LibraryEntry*, UINT32>> todo;
+		todo.push({ root, SNAPSHOT_INVALID_INDEX });
+
+		while (!todo.empty())
+		{
+			const ProjectLibrary::LibraryEntry* entry = todo.top().first;
+			UINT32 parentIdx = todo.top().second;
+			todo.pop();
+
+			UINT32 entryIdx = (UINT32)entries.size();
+
+			SnapshotEntry record{};
+			record.parent = parentIdx;
+			record.type = (UINT32)entry->type;
+			record.name = addString(entry->elementName);
+
+			if (entry->type == ProjectLibrary::LibraryEntryType::File)
+			{
+				const ProjectLibrary::FileEntry* fileEntry = static_cast<const ProjectLibrary::FileEntry*>(entry);
+
+				record.lastUpdateTime = (INT64)fileEntry->lastUpdateTime;
+				record.sourceSize = fileEntry->sourceSize;
+				record.sourceModifiedTime = (INT64)fileEntry->sourceModifiedTime;
+				record.sourceHash = fileEntry->sourceHash;
+				record.metaModifiedTime = (INT64)fileEntry->metaModifiedTime;
+				record.importOptionsHash = fileEntry->importOptionsHash;
+
+				if (fileEntry->hasMeta)
+				{
+					record.flags |= SNAPSHOT_ENTRY_HAS_META;
+
+					if (fileEntry->includeInBuild)
+						record.flags |= SNAPSHOT_ENTRY_INCLUDE_IN_BUILD;
+
+					for (auto& resource : fileEntry->resources)
+					{
+						SnapshotUUID uuidRecord{};
+						uuidRecord.uuid = resource.uuid;
+						uuidRecord.entry = entryIdx;
+						uuidRecord.typeId = resource.typeId;
+						uuidRecord.uniqueName = addString(resource.uniqueName);
+
+						uuids.push_back(uuidRecord);
+					}
+				}
+			}
+			else
+			{
+				const ProjectLibrary::DirectoryEntry* dirEntry =
+					static_cast<const ProjectLibrary::DirectoryEntry*>(entry);
+
+				// Push in reverse so children are written in their original order
+				for (auto iter = dirEntry->mChildren.rbegin(); iter != dirEntry->mChildren.rend(); ++iter)
+					todo.push({ *iter, entryIdx });
+			}
+
+			pathToEntry[entry->path] = entryIdx;
+			entries.push_back(record);
+		}
+
+		for (auto& entry : dependencies.getAllDependants())
+		{
+			UINT32 firstDependant = (UINT32)dependants.size();
+			for (auto& dependant : entry.second)
+			{
+				auto iterFind = pathToEntry.find(dependant);
+				if (iterFind != pathToEntry.end())
+					dependants.push_back(iterFind->second);
+			}
+
+			UINT32 numDependants = (UINT32)dependants.size() - firstDependant;
+			if (numDependants == 0)
+				continue;
+
+			// Keep dependencies within the project relative, so the snapshot remains valid if the project is moved
+			Path dependencyPath = entry.first;
+			if (resourcesFolder.includes(dependencyPath))
+				dependencyPath.makeRelative(resourcesFolder);
+
+			SnapshotDependency record;
+			record.path = addString(dependencyPath.toString());
+			record.firstDependant = firstDependant;
+			record.numDependants = numDependants;
+
+			dependencyRecords.push_back(record);
+		}
+
+		// Lay out the sections
+		SnapshotHeader header{};
+		header.magic = SNAPSHOT_MAGIC;
+		header.version = SNAPSHOT_VERSION;
+		header.generation = generation;
+		header.numEntries = (UINT32)entries.size();
+		header.numUUIDs = (UINT32)uuids.size();
+		header.numDependencies = (UINT32)dependencyRecords.size();
+		header.numDependants = (UINT32)dependants.size();
+		header.stringsSize = strings.size();
+
+		UINT64 offset = alignSnapshotOffset(sizeof(SnapshotHeader));
+		auto allocateSection = [&](UINT64 size)
+		{
+			UINT64 sectionOffset = offset;
+			offset = alignSnapshotOffset(offset + size);
+
+			return sectionOffset;
+		};
+
+		header.entriesOffset = allocateSection(entries.size() * sizeof(SnapshotEntry));
+		header.uuidsOffset = allocateSection(uuids.size() * sizeof(SnapshotUUID));
+		header.dependenciesOffset = allocateSection(dependencyRecords.size() * sizeof(SnapshotDependency));
+		header.dependantsOffset = allocateSection(dependants.size() * sizeof(UINT32));
+		header.stringsOffset = allocateSection(strings.size());
+		header.fileSize = offset;
+
+		Vector<UINT8> output((size_t)header.fileSize, 0);
+		auto writeSection = [&](UINT64 sectionOffset, const void* data, UINT64 size)
+		{
+			if (size > 0)
+				memcpy(output.data() + sectionOffset, data, (size_t)size);
+		};
+
+		writeSection(0, &header, sizeof(header));
+		writeSection(header.entriesOffset, entries.data(), entries.size() * sizeof(SnapshotEntry));
+		writeSection(header.uuidsOffset, uuids.data(), uuids.size() * sizeof(SnapshotUUID));
+		writeSection(header.dependenciesOffset, dependencyRecords.data(),
+			dependencyRecords.size() * sizeof(SnapshotDependency));
+		writeSection(header.dependantsOffset, dependants.data(), dependants.size() * sizeof(UINT32));
+		writeSection(header.stringsOffset, strings.data(), strings.size());
+
+		Path tempPath = path;
+		tempPath.setFilename(path.getFilename() + ".tmp");
+
+		SPtr<DataStream> stream = FileSystem::createAndOpenFile(tempPath);
+		if (stream == nullptr)
+			return false;
+
+		size_t numWritten = stream->write(output.data(), output.size());
+		stream->close();
+
+		if (numWritten != output.size())
+		{
+			FileSystem::remove(tempPath);
+			return false;
+		}
+
+		FileSystem::move(tempPath, path, true);
+		return true;
+	}
+
+	bool ProjectLibrarySnapshot::load(const Path& path, const Path& resourcesFolder,
+		ProjectLibrary::DirectoryEntry* root, ResourceLocationMap& resourceLocations,
+		ImportDependencyGraph& dependencies, UUID& generation)
+	{
+		SPtr<DataStream> stream = FileSystem::openFile(path, true);
+		if (stream == nullptr)
+			return false;
+
+		UINT64 size = (UINT64)stream->size();
+		if (size < sizeof(SnapshotHeader))
+		{
+			stream->close();
+			return false;
+		}
+
+		// Read everything at once, after which the data is used in-place
+		UINT8* data = (UINT8*)bs_alloc((UINT32)size);
+		UINT64 numRead = (UINT64)stream->read(data, (size_t)size);
+		stream->close();
+
+		bool loaded = false;
+		if (numRead == size)
+			loaded = loadFromMemory(data, size, resourcesFolder, root, resourceLocations, dependencies, generation);
+
+		bs_free(data);
+		return loaded;
+	}
+
+	bool ProjectLibrarySnapshot::loadFromMemory(UINT8* data, UINT64 size, const Path& resourcesFolder,
+		ProjectLibrary::DirectoryEntry* root, ResourceLocationMap& resourceLocations,
+		ImportDependencyGraph& dependencies, UUID& generation)
+	{
+		const SnapshotHeader& header = *(const SnapshotHeader*)data;
+		if (header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION || header.fileSize != size)
+			return false;
+
+		auto isValidSection = [&](UINT64 offset, UINT64 count, UINT64 elementSize)
+		{
+			return offset <= size && (offset % SNAPSHOT_ALIGNMENT) == 0 && count <= (size - offset) / elementSize;
+		};
+
+		if (!isValidSection(header.entriesOffset, header.numEntries, sizeof(SnapshotEntry)) ||
+			!isValidSection(header.uuidsOffset, header.numUUIDs, sizeof(SnapshotUUID)) ||
+			!isValidSection(header.dependenciesOffset, header.numDependencies, sizeof(SnapshotDependency)) ||
+			!isValidSection(header.dependantsOffset, header.numDependants, sizeof(UINT32)) ||
+			!isValidSection(header.stringsOffset, header.stringsSize, 1))
+		{
+			return false;
+		}
+
+		const SnapshotEntry* entryRecords = (const SnapshotEntry*)(data + header.entriesOffset);
+		const SnapshotUUID* uuidRecords = (const SnapshotUUID*)(data + header.uuidsOffset);
+		const SnapshotDependency* dependencyRecords = (const SnapshotDependency*)(data + header.dependenciesOffset);
+		const UINT32* dependantRecords = (const UINT32*)(data + header.dependantsOffset);
+		const char* strings = (const char*)(data + header.stringsOffset);
+
+		auto isValidString = [&](const SnapshotString& value)
+		{
+			return (UINT64)value.offset + value.length <= header.stringsSize;
+		};
+
+		auto getString = [&](const SnapshotString& value)
+		{
+			return String(strings + value.offset, value.length);
+		};
+
+		// Validate everything before touching the library, so a corrupt snapshot has no side effects
+		if (header.numEntries == 0 || entryRecords[0].type != (UINT32)ProjectLibrary::LibraryEntryType::Directory)
+			return false;
+
+		for (UINT32 i = 0; i < header.numEntries; i++)
+		{
+			const SnapshotEntry& record = entryRecords[i];
+
+			if (record.type != (UINT32)ProjectLibrary::LibraryEntryType::File &&
+				record.type != (UINT32)ProjectLibrary::LibraryEntryType::Directory)
+				return false;
+
+			if (!isValidString(record.name))
+				return false;
+
+			if (i > 0 && (record.parent >= i ||
+				entryRecords[record.parent].type != (UINT32)ProjectLibrary::LibraryEntryType::Directory))
+				return false;
+		}
+
+		for (UINT32 i = 0; i < header.numUUIDs; i++)
+		{
+			const SnapshotUUID& record = uuidRecords[i];
+			if (record.entry >= header.numEntries ||
+				entryRecords[record.entry].type != (UINT32)ProjectLibrary::LibraryEntryType::File ||
+				(entryRecords[record.entry].flags & SNAPSHOT_ENTRY_HAS_META) == 0)
+				return false;
+
+			if (!isValidString(record.uniqueName))
+				return false;
+		}
+
+		for (UINT32 i = 0; i < header.numDependencies; i++)
+		{
+			const SnapshotDependency& record = dependencyRecords[i];
+			if (!isValidString(record.path) || record.firstDependant > header.numDependants ||
+				record.numDependants > header.numDependants - record.firstDependant)
+				return false;
+		}
+
+		for (UINT32 i = 0; i < header.numDependants; i++)
+		{
+			if (dependantRecords[i] >= header.numEntries)
+				return false;
+		}
+
+		// Build the hierarchy
+		Vector<ProjectLibrary::LibraryEntry*> entries(header.numEntries);
+		entries[0] = root;
+
+		for (UINT32 i = 1; i < header.numEntries; i++)
+		{
+			const SnapshotEntry& record = entryRecords[i];
+			ProjectLibrary::DirectoryEntry* parent =
+				static_cast<ProjectLibrary::DirectoryEntry*>(entries[record.parent]);
+
+			String name = getString(record.name);
+			Path entryPath = parent->path;
+			entryPath.append(name);
+
+			if (record.type == (UINT32)ProjectLibrary::LibraryEntryType::File)
+			{
+				ProjectLibrary::FileEntry* fileEntry = bs_new<ProjectLibrary::FileEntry>(entryPath, name, parent);
+				fileEntry->hasMeta = (record.flags & SNAPSHOT_ENTRY_HAS_META) != 0;
+				fileEntry->includeInBuild = (record.flags & SNAPSHOT_ENTRY_INCLUDE_IN_BUILD) != 0;
+				fileEntry->lastUpdateTime = (std::time_t)record.lastUpdateTime;
+				fileEntry->sourceSize = record.sourceSize;
+				fileEntry->sourceModifiedTime = (std::time_t)record.sourceModifiedTime;
+				fileEntry->sourceHash = record.sourceHash;
+				fileEntry->metaModifiedTime = (std::time_t)record.metaModifiedTime;
+				fileEntry->importOptionsHash = record.importOptionsHash;
+
+				entries[i] = fileEntry;
+			}
+			else
+				entries[i] = bs_new<ProjectLibrary::DirectoryEntry>(entryPath, name, parent);
+
+			parent->mChildren.push_back(entries[i]);
+		}
+
+		for (UINT32 i = 0; i < header.numUUIDs; i++)
+		{
+			const SnapshotUUID& record = uuidRecords[i];
+			ProjectLibrary::FileEntry* fileEntry = static_cast<ProjectLibrary::FileEntry*>(entries[record.entry]);
+
+			fileEntry->resources.push_back({ record.uuid, record.typeId, getString(record.uniqueName) });
+			resourceLocations.set(record.uuid, fileEntry);
+		}
+
+		for (UINT32 i = 0; i < header.numDependencies; i++)
+		{
+			const SnapshotDependency& record = dependencyRecords[i];
+
+			Path dependencyPath = getString(record.path);
+			if (!dependencyPath.isAbsolute())
+				dependencyPath.makeAbsolute(resourcesFolder);
+
+			for (UINT32 j = 0; j < record.numDependants; j++)
+				dependencies.addDependency(entries[dependantRecords[record.firstDependant + j]]->path, dependencyPath);
+		}
+
+		generation = header.generation;
+		return true;
+	}
+}
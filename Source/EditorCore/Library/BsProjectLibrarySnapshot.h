@@ -0,0 +1,70 @@
+//********************************** Banshee Engine (www.banshee3d.com) **************************************************//
+//**************** Copyright (c) 2016 Marko Pintera (marko.pintera@gmail.com). All rights reserved. **********************//
+#pragma once
+
+#include "BsEditorPrerequisites.h"
+#include "Library/BsProjectLibrary.h"
+
+namespace bs
+{
+	class ImportDependencyGraph;
+	class ResourceLocationMap;
+
+	/** @addtogroup Library-Internal
+	 *  @{
+	 */
+
+	/**
+	 * Saves and loads a snapshot of the entire project library into a single binary file. The snapshot contains the
+	 * entry hierarchy, the meta-data headers of all file entries, the UUID to path map and the import dependency map,
+	 * allowing the library to be restored without touching any individual .meta files. Full meta-data is not stored, as
+	 * file entries decode it from their .meta files on demand.
+	 *
+	 * The file consists of a fixed size header followed by tables of fixed size records and a blob of string data, all
+	 * referenced through offsets. This allows the contents to be used in-place after reading the file in a
+	 * single operation, with no parsing beyond validation. Any snapshot that fails validation is rejected as a whole.
+	 */
+	class ProjectLibrarySnapshot
+	{
+	public:
+		/**
+		 * Writes the snapshot of the provided library hierarchy to the specified file. The file is first written to
+		 * a temporary location and then moved over the existing snapshot, so an interrupted save never leaves a
+		 * corrupted snapshot behind.
+		 *
+		 * @param[in]	path				Absolute path to the snapshot file.
+		 * @param[in]	generation			Unique identifier of this snapshot, used for pairing it with the library
+		 *									journal.
+		 * @param[in]	root				Root of the library hierarchy to save.
+		 * @param[in]	resourcesFolder		Folder the library entries are located in. Paths are stored relative to it.
+		 * @param[in]	dependencies		Import dependencies between the library resources.
+		 * @return							True if the snapshot was successfully written.
+		 */
+		static bool save(const Path& path, const UUID& generation, const ProjectLibrary::DirectoryEntry* root, 
+			const Path& resourcesFolder, const ImportDependencyGraph& dependencies);
+
+		/**
+		 * Restores the library hierarchy from a previously saved snapshot. Nothing is modified if the snapshot cannot
+		 * be read or is invalid.
+		 *
+		 * @param[in]	path				Absolute path to the snapshot file.
+		 * @param[in]	resourcesFolder		Folder the library entries are located in.
+		 * @param[in]	root				Empty root directory entry to populate with the loaded hierarchy.
+		 * @param[out]	resourceLocations	Map that will be populated with resource UUIDs and their file entries.
+		 * @param[out]	dependencies		Graph that will be populated with import dependencies.
+		 * @param[out]	generation			Unique identifier the snapshot was saved with.
+		 * @return							True if the snapshot was loaded, false if it is missing, of a different
+		 *									version, or corrupt.
+		 */
+		static bool load(const Path& path, const Path& resourcesFolder, ProjectLibrary::DirectoryEntry* root,
+			ResourceLocationMap& resourceLocations, ImportDependencyGraph& dependencies, UUID& generation);
+
+	private:
+		/** Restores the library hierarchy from snapshot data in memory. See load(). */
+		static bool loadFromMemory(UINT8* data, UINT64 size, const Path& resourcesFolder,
+			ProjectLibrary::DirectoryEntry* root, ResourceLocationMap& resourceLocations,
+			ImportDependencyGraph& dependencies, UUID& generation);
+	};
+
+	/** @} */
+}
@@ -0,0 +1,136 @@
+//********************************** Banshee Engine (www.banshee3d.com) **************************************************//
+//**************** Copyright (c) 2016 Marko Pintera (marko.pintera@gmail.com). All rights reserved. **********************//
+#include "Library/BsResourceLocationMap.h"
+
+namespace bs
+{
+	/** Number of slots allocated when the first resource is registered. */
+	static constexpr UINT32 MIN_SLOTS = 64;
+
+	ProjectLibrary::FileEntry* ResourceLocationMap::find(const UUID& uuid) const
+	{
+		if (mSize == 0)
+			return nullptr;
+
+		return mSlots[findSlot(uuid)].entry;
+	}
+
+	void ResourceLocationMap::set(const UUID& uuid, ProjectLibrary::FileEntry* entry)
+	{
+		// Keep the load factor below 3/4, as linear probing degrades quickly beyond that
+		if ((mSize + 1) * 4 > (UINT32)mSlots.size() * 3)
+			resize(std::max(MIN_SLOTS, (UINT32)mSlots.size() * 2));
+
+		Slot& slot = mSlots[findSlot(uuid)];
+		if (slot.entry == nullptr)
+		{
+			slot.uuid = uuid;
+			mSize++;
+		}
+
+		slot.entry = entry;
+	}
+
+	void ResourceLocationMap::set(ProjectLibrary::FileEntry* entry)
+	{
+		for (auto& resource : entry->resources)
+			set(resource.uuid, entry);
+	}
+
+	void ResourceLocationMap::erase(const UUID& uuid)
+	{
+		if (mSize == 0)
+			return;
+
+		UINT32 idx = findSlot(uuid);
+		if (mSlots[idx].entry == nullptr)
+			return;
+
+		mSlots[idx].entry = nullptr;
+		mSize--;
+
+		// Move back any following slots that can no longer be reached from their home slot, because of the hole
+		UINT32 mask = (UINT32)mSlots.size() - 1;
+		UINT32 hole = idx;
+		for (UINT32 i = (idx + 1) & mask; mSlots[i].entry != nullptr; i = (i + 1) & mask)
+		{
+			UINT32 home = getHomeSlot(mSlots[i].uuid);
+
+			// Slot can be moved if its home isn't cyclically within (hole, i]
+			bool canMove;
+			if (hole <= i)
+				canMove = home <= hole || home > i;
+			else
+				canMove = home <= hole && home > i;
+
+			if (canMove)
+			{
+				mSlots[hole] = mSlots[i];
+				mSlots[i].entry = nullptr;
+				hole = i;
+			}
+		}
+	}
+
+	void ResourceLocationMap::clear()
+	{
+		mSlots.clear();
+		mSlots.shrink_to_fit();
+		mSize = 0;
+	}
+
+	Path ResourceLocationMap::getPath(const UUID& uuid) const
+	{
+		ProjectLibrary::FileEntry* entry = find(uuid);
+		if (entry == nullptr)
+			return Path::BLANK;
+
+		// Primary resource is referenced by the file path, and sub-resources by their name appended to it
+		const Vector<ProjectLibrary::ResourceHeader>& resources = entry->resources;
+		for (UINT32 i = 0; i < (UINT32)resources.size(); i++)
+		{
+			if (resources[i].uuid != uuid)
+				continue;
+
+			if (i == 0)
+				return entry->path;
+
+			return entry->path + resources[i].uniqueName;
+		}
+
+		return Path::BLANK;
+	}
+
+	UINT32 ResourceLocationMap::getHomeSlot(const UUID& uuid) const
+	{
+		// Mix the hash, as the slot is selected using only the low bits
+		UINT64 hash = (UINT64)std::hash<UUID>()(uuid) * 0x9E3779B97F4A7C15ULL;
+		return (UINT32)(hash >> 32) & ((UINT32)mSlots.size() - 1);
+	}
+
+	UINT32 ResourceLocationMap::findSlot(const UUID& uuid) const
+	{
+		UINT32 mask = (UINT32)mSlots.size() - 1;
+
+		UINT32 idx = getHomeSlot(uuid);
+		while (mSlots[idx].entry != nullptr && mSlots[idx].uuid != uuid)
+			idx = (idx + 1) & mask;
+
+		return idx;
+	}
+
+	void ResourceLocationMap::resize(UINT32 numSlots)
+	{
+		Vector<Slot> oldSlots = std::move(mSlots);
+
+		mSlots.clear();
+		mSlots.resize(numSlots);
+		mSize = 0;
+
+		for (auto& slot : oldSlots)
+		{
+			if (slot.entry != nullptr)
+				set(slot.uuid, slot.entry);
+		}
+	}
+}
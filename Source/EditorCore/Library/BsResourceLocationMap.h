@@ -0,0 +1,76 @@
+//********************************** Banshee Engine (www.banshee3d.com) **************************************************//
+//**************** Copyright (c) 2016 Marko Pintera (marko.pintera@gmail.com). All rights reserved. **********************//
+#pragma once
+
+#include "BsEditorPrerequisites.h"
+#include "Library/BsProjectLibrary.h"
+
+namespace bs
+{
+	/** @addtogroup Library-Internal
+	 *  @{
+	 */
+
+	/**
+	 * Maps resource UUIDs to the library file entries containing the resources. Paths are not stored, and are instead
+	 * retrieved from the entries when needed, so a single slot only holds a UUID and a pointer. This also means entries
+	 * can be moved or renamed without updating the map.
+	 *
+	 * The map uses open addressing with linear probing over a single contiguous array, and removals shift the following
+	 * slots back instead of leaving tombstones, so lookups never slow down as resources are added and removed.
+	 */
+	class ResourceLocationMap
+	{
+	public:
+		/** Returns the entry containing the resource with the provided UUID, or null if the UUID isn't registered. */
+		ProjectLibrary::FileEntry* find(const UUID& uuid) const;
+
+		/**
+		 * Registers the entry as the one containing the resource with the provided UUID, replacing any existing one.
+		 */
+		void set(const UUID& uuid, ProjectLibrary::FileEntry* entry);
+
+		/** Registers the entry as the one containing all of its resources. */
+		void set(ProjectLibrary::FileEntry* entry);
+
+		/** Unregisters the resource with the provided UUID. Does nothing if the UUID isn't registered. */
+		void erase(const UUID& uuid);
+
+		/** Unregisters all resources. */
+		void clear();
+
+		/** Returns the number of registered resources. */
+		UINT32 size() const { return mSize; }
+
+		/** Returns the number of bytes allocated by the map. */
+		UINT64 getMemoryUsage() const { return (UINT64)mSlots.capacity() * sizeof(Slot); }
+
+		/**
+		 * Returns the absolute path of the resource with the provided UUID. Sub-resources have their name appended to
+		 * the path of the file containing them. Returns an empty path if the UUID isn't registered.
+		 */
+		Path getPath(const UUID& uuid) const;
+
+	private:
+		/** Single slot of the table. Slot is empty if it has no entry. */
+		struct Slot
+		{
+			UUID uuid;
+			ProjectLibrary::FileEntry* entry = nullptr;
+		};
+
+		/** Returns the slot the UUID would ideally be stored in. */
+		UINT32 getHomeSlot(const UUID& uuid) const;
+
+		/** Returns the index of the slot containing the UUID, or the empty slot where it would be inserted. */
+		UINT32 findSlot(const UUID& uuid) const;
+
+		/** Resizes the table to the provided number of slots, which must be a power of two. */
+		void resize(UINT32 numSlots);
+
+		Vector<Slot> mSlots;
+		UINT32 mSize = 0;
+	};
+
+	/** @} */
+}
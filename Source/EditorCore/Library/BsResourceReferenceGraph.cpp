@@ -0,0 +1,243 @@
+//********************************** Banshee Engine (www.banshee3d.com) **************************************************//
+//**************** Copyright (c) 2016 Marko Pintera (marko.pintera@gmail.com). All rights reserved. **********************//
+#include "Library/BsResourceReferenceGraph.h"
+#include "FileSystem/BsFileSystem.h"
+#include "FileSystem/BsDataStream.h"
+
+namespace bs
+{
+	/** Identifier at the start of every reference graph file ("BSRR"). */
+	static constexpr UINT32 REFERENCES_MAGIC = 0x52525342;
+
+	/** Version of the reference graph format. Files of a different version are ignored. */
+	static constexpr UINT32 REFERENCES_VERSION = 1;
+
+	/** Header at the start of the reference graph file. */
+	struct ReferencesHeader
+	{
+		UINT32 magic;
+		UINT32 version;
+		UINT32 numResources;
+		UINT32 numReferences;
+	};
+
+	/**
+	 * Record of a single resource. Followed by the records of all other resources, and then by the referenced UUIDs of
+	 * all the resources, in the same order as the resource records.
+	 */
+	struct ReferencesRecord
+	{
+		UUID uuid;
+		UINT32 numReferences;
+	};
+
+	/** Returned when querying edges of resources that have none. */
+	static const Vector<UUID> EMPTY_EDGES;
+
+	void ResourceReferenceGraph::setReferences(const UUID& resource, const Vector<UUID>& references)
+	{
+		removeReferences(resource);
+
+		Vector<UUID>& output = mReferences[resource];
+		for (auto& reference : references)
+		{
+			if (reference == resource || std::find(output.begin(), output.end(), reference) != output.end())
+				continue;
+
+			output.push_back(reference);
+			mReferencedBy[reference].push_back(resource);
+		}
+
+		mIsDirty = true;
+	}
+
+	void ResourceReferenceGraph::removeReferences(const UUID& resource)
+	{
+		auto iterFind = mReferences.find(resource);
+		if (iterFind == mReferences.end())
+			return;
+
+		for (auto& reference : iterFind->second)
+			removeEdge(mReferencedBy, reference, resource);
+
+		mReferences.erase(iterFind);
+		mIsDirty = true;
+	}
+
+	bool ResourceReferenceGraph::hasReferences(const UUID& resource) const
+	{
+		return mReferences.find(resource) != mReferences.end();
+	}
+
+	const Vector<UUID>& ResourceReferenceGraph::getReferences(const UUID& resource) const
+	{
+		auto iterFind = mReferences.find(resource);
+		if (iterFind == mReferences.end())
+			return EMPTY_EDGES;
+
+		return iterFind->second;
+	}
+
+	const Vector<UUID>& ResourceReferenceGraph::getReferencedBy(const UUID& resource) const
+	{
+		auto iterFind = mReferencedBy.find(resource);
+		if (iterFind == mReferencedBy.end())
+			return EMPTY_EDGES;
+
+		return iterFind->second;
+	}
+
+	Vector<UUID> ResourceReferenceGraph::findAllReferencedBy(const Vector<UUID>& resources) const
+	{
+		Vector<UUID> output;
+		UnorderedSet<UUID> visited(resources.begin(), resources.end());
+
+		Vector<UUID> todo = resources;
+		while (!todo.empty())
+		{
+			UUID current = todo.back();
+			todo.pop_back();
+
+			for (auto& referencedBy : getReferencedBy(current))
+			{
+				if (!visited.insert(referencedBy).second)
+					continue;
+
+				output.push_back(referencedBy);
+				todo.push_back(referencedBy);
+			}
+		}
+
+		return output;
+	}
+
+	void ResourceReferenceGraph::clear()
+	{
+		mReferences.clear();
+		mReferencedBy.clear();
+		mIsDirty = false;
+	}
+
+	bool ResourceReferenceGraph::save(const Path& path)
+	{
+		ReferencesHeader header;
+		header.magic = REFERENCES_MAGIC;
+		header.version = REFERENCES_VERSION;
+		header.numResources = (UINT32)mReferences.size();
+		header.numReferences = 0;
+
+		Vector<ReferencesRecord> records;
+		records.reserve(mReferences.size());
+
+		Vector<UUID> references;
+		for (auto& entry : mReferences)
+		{
+			ReferencesRecord record{};
+			record.uuid = entry.first;
+			record.numReferences = (UINT32)entry.second.size();
+
+			records.push_back(record);
+			references.insert(references.end(), entry.second.begin(), entry.second.end());
+		}
+
+		header.numReferences = (UINT32)references.size();
+
+		Path tempPath = path;
+		tempPath.setFilename(path.getFilename() + ".tmp");
+
+		SPtr<DataStream> stream = FileSystem::createAndOpenFile(tempPath);
+		if (stream == nullptr)
+			return false;
+
+		size_t recordsSize = records.size() * sizeof(ReferencesRecord);
+		size_t referencesSize = references.size() * sizeof(UUID);
+
+		bool written = stream->write(&header, sizeof(header)) == sizeof(header) &&
+			stream->write(records.data(), recordsSize) == recordsSize &&
+			stream->write(references.data(), referencesSize) == referencesSize;
+		stream->close();
+
+		if (!written)
+		{
+			FileSystem::remove(tempPath);
+			return false;
+		}
+
+		FileSystem::move(tempPath, path, true);
+		mIsDirty = false;
+
+		return true;
+	}
+
+	bool ResourceReferenceGraph::load(const Path& path)
+	{
+		clear();
+
+		SPtr<DataStream> stream = FileSystem::openFile(path, true);
+		if (stream == nullptr)
+			return false;
+
+		ReferencesHeader header;
+		bool valid = stream->read(&header, sizeof(header)) == sizeof(header) && header.magic == REFERENCES_MAGIC &&
+			header.version == REFERENCES_VERSION;
+
+		Vector<ReferencesRecord> records;
+		Vector<UUID> references;
+		if (valid)
+		{
+			UINT64 recordsSize = (UINT64)header.numResources * sizeof(ReferencesRecord);
+			UINT64 referencesSize = (UINT64)header.numReferences * sizeof(UUID);
+
+			valid = (UINT64)stream->size() == sizeof(header) + recordsSize + referencesSize;
+			if (valid)
+			{
+				records.resize(header.numResources);
+				references.resize(header.numReferences);
+
+				valid = stream->read(records.data(), (size_t)recordsSize) == recordsSize &&
+					stream->read(references.data(), (size_t)referencesSize) == referencesSize;
+			}
+		}
+
+		stream->close();
+
+		if (!valid)
+			return false;
+
+		UINT32 referenceIdx = 0;
+		for (auto& record : records)
+		{
+			if (record.numReferences > header.numReferences - referenceIdx)
+			{
+				clear();
+				return false;
+			}
+
+			Vector<UUID>& output = mReferences[record.uuid];
+			output.assign(references.begin() + referenceIdx, references.begin() + referenceIdx + record.numReferences);
+
+			for (auto& reference : output)
+				mReferencedBy[reference].push_back(record.uuid);
+
+			referenceIdx += record.numReferences;
+		}
+
+		mIsDirty = false;
+		return true;
+	}
+
+	void ResourceReferenceGraph::removeEdge(UnorderedMap<UUID, Vector<UUID>>& edges, const UUID& key, const UUID& value)
+	{
+		auto iterFind = edges.find(key);
+		if (iterFind == edges.end())
+			return;
+
+		Vector<UUID>& values = iterFind->second;
+		auto iterValue = std::find(values.begin(), values.end(), value);
+		if (iterValue != values.end())
+			values.erase(iterValue);
+
+		if (values.empty())
+			edges.erase(iterFind);
+	}
+}
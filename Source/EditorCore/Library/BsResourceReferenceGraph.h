@@ -0,0 +1,90 @@
+//********************************** Banshee Engine (www.banshee3d.com) **************************************************//
+//**************** Copyright (c) 2016 Marko Pintera (marko.pintera@gmail.com). All rights reserved. **********************//
+#pragma once
+
+#include "BsEditorPrerequisites.h"
+
+namespace bs
+{
+	/** @addtogroup Library-Internal
+	 *  @{
+	 */
+
+	/**
+	 * Keeps track of references between resources (for example a material referencing a texture), as stored in the
+	 * imported resource data. Both the forward (resource to the resources it references) and reverse (resource to the
+	 * resources referencing it) edges are stored, so either direction can be queried without loading any resources.
+	 *
+	 * References of a resource are only known once they have been recorded with setReferences(). A resource with a
+	 * record but no references is distinct from a resource that was never recorded, see hasReferences().
+	 */
+	class ResourceReferenceGraph
+	{
+	public:
+		/**
+		 * Replaces all the references of the provided resource.
+		 *
+		 * @param[in]	resource	UUID of the resource.
+		 * @param[in]	references	UUIDs of the resources referenced by @p resource.
+		 */
+		void setReferences(const UUID& resource, const Vector<UUID>& references);
+
+		/**
+		 * Removes the record of the provided resource, along with all of its references. Resources referencing the
+		 * resource are not affected.
+		 */
+		void removeReferences(const UUID& resource);
+
+		/** Checks have the references of the provided resource been recorded. */
+		bool hasReferences(const UUID& resource) const;
+
+		/** Returns the resources directly referenced by the provided resource. */
+		const Vector<UUID>& getReferences(const UUID& resource) const;
+
+		/** Returns the resources directly referencing the provided resource. */
+		const Vector<UUID>& getReferencedBy(const UUID& resource) const;
+
+		/**
+		 * Finds all resources referencing the provided resources, either directly or indirectly.
+		 *
+		 * @param[in]	resources	Resources to start the search from.
+		 * @return					Every found resource exactly once, not including the provided resources.
+		 */
+		Vector<UUID> findAllReferencedBy(const Vector<UUID>& resources) const;
+
+		/** Removes all references. */
+		void clear();
+
+		/** Checks have there been any changes since the graph was last saved or loaded. */
+		bool isDirty() const { return mIsDirty; }
+
+		/**
+		 * Writes the graph to the specified file. The file is first written to a temporary location and then moved over
+		 * the existing one, so an interrupted save never leaves a corrupted file behind.
+		 *
+		 * @param[in]	path	Absolute path to the file.
+		 * @return				True if the file was successfully written.
+		 */
+		bool save(const Path& path);
+
+		/**
+		 * Replaces the contents of the graph with the contents of the specified file. The graph is left empty if the
+		 * file cannot be read or is invalid.
+		 *
+		 * @param[in]	path	Absolute path to the file.
+		 * @return				True if the graph was loaded, false if the file is missing, of a different version, or
+		 *						corrupt.
+		 */
+		bool load(const Path& path);
+
+	private:
+		/** Removes the first occurrence of the value from the list under the provided key, and the key if empty. */
+		static void removeEdge(UnorderedMap<UUID, Vector<UUID>>& edges, const UUID& key, const UUID& value);
+
+		UnorderedMap<UUID, Vector<UUID>> mReferences;
+		UnorderedMap<UUID, Vector<UUID>> mReferencedBy;
+		bool mIsDirty = false;
+	};
+
+	/** @} */
+}
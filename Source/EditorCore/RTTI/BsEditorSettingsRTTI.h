@@ -38,6 +38,7 @@ namespace bs
 
 			BS_RTTI_MEMBER_PLAIN(mFPSLimit, 13)
 			BS_RTTI_MEMBER_PLAIN(mMouseSensitivity, 14)
+			BS_RTTI_MEMBER_PLAIN(mImportCacheFolder, 15)
 		BS_END_RTTI_MEMBERS
 	public:
 		EditorSettingsRTTI()
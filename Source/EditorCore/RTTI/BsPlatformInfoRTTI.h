@@ -24,6 +24,9 @@ namespace bs
 			BS_RTTI_MEMBER_PLAIN(windowedWidth, 4)
 			BS_RTTI_MEMBER_PLAIN(windowedHeight, 5)
 			BS_RTTI_MEMBER_PLAIN(debug, 6)
+			BS_RTTI_MEMBER_PLAIN(packResources, 7)
+			BS_RTTI_MEMBER_PLAIN(defaultCompression, 8)
+			BS_RTTI_MEMBER_PLAIN(typeCompression, 11)
 		BS_END_RTTI_MEMBERS
 
 	public:
@@ -62,6 +62,11 @@ namespace bs
 			memory = rttiWriteElem(data.path, memory, size);
 			memory = rttiWriteElem(elemName, memory, size);
 			memory = rttiWriteElem(data.lastUpdateTime, memory, size);
+			memory = rttiWriteElem(data.sourceSize, memory, size);
+			memory = rttiWriteElem(data.sourceModifiedTime, memory, size);
+			memory = rttiWriteElem(data.sourceHash, memory, size);
+			memory = rttiWriteElem(data.metaModifiedTime, memory, size);
+			memory = rttiWriteElem(data.importOptionsHash, memory, size);
 
 			memcpy(memoryStart, &size, sizeof(UINT32));
 		}
@@ -69,6 +74,7 @@ namespace bs
 		static UINT32 fromMemory(bs::ProjectLibrary::FileEntry& data, char* memory)
 		{ 
 			UINT32 size = 0;
+			char* memoryStart = memory;
 			memcpy(&size, memory, sizeof(UINT32));
 			memory += sizeof(UINT32);
 
@@ -84,6 +90,16 @@ namespace bs
 
 			memory = rttiReadElem(data.lastUpdateTime, memory);
 
+			// Entries saved by older versions don't contain the content hash information
+			if((UINT32)(memory - memoryStart) < size)
+			{
+				memory = rttiReadElem(data.sourceSize, memory);
+				memory = rttiReadElem(data.sourceModifiedTime, memory);
+				memory = rttiReadElem(data.sourceHash, memory);
+				memory = rttiReadElem(data.metaModifiedTime, memory);
+				memory = rttiReadElem(data.importOptionsHash, memory);
+			}
+
 			return size;
 		}
 
@@ -92,7 +108,9 @@ namespace bs
 			WString elemName = UTF8::toWide(data.elementName);
 
 			UINT64 dataSize = sizeof(UINT32) + rttiGetElemSize(data.type) + rttiGetElemSize(data.path) + 
-				rttiGetElemSize(elemName) + rttiGetElemSize(data.lastUpdateTime);
+				rttiGetElemSize(elemName) + rttiGetElemSize(data.lastUpdateTime) + rttiGetElemSize(data.sourceSize) + 
+				rttiGetElemSize(data.sourceModifiedTime) + rttiGetElemSize(data.sourceHash) + 
+				rttiGetElemSize(data.metaModifiedTime) + rttiGetElemSize(data.importOptionsHash);
 
 #if BS_DEBUG_MODE
 			if(dataSize > std::numeric_limits<UINT32>::max())
@@ -262,6 +262,27 @@ namespace bs
 		 */
 		void renderForPicking(const SPtr<Camera>& camera, std::function<Color(UINT32)> idxToColorCallback);
 
+		/**
+		 * Checks could any of the pickable gizmos end up under the provided position when rendered for picking. The
+		 * check is conservative and can report a gizmo that wouldn't actually be picked, but never misses one that
+		 * would.
+		 *
+		 * @param[in]	camera		Camera the gizmos would be rendered to.
+		 * @param[in]	position	Position to check, in pixels relative to the camera viewport.
+		 *
+		 * @note	Internal method.
+		 */
+		bool isPickableGizmoAt(const SPtr<Camera>& camera, const Vector2I& position);
+
+		/**
+		 * Returns the world space bounds of all pickable gizmos, merged for each scene object the gizmos belong to.
+		 * Icons and text are represented only by their position, as their size depends on the camera they're viewed
+		 * from.
+		 *
+		 * @note	Internal method.
+		 */
+		Vector<std::pair<HSceneObject, AABox>> getPickableBounds() const;
+
 		/** @} */
 
 	private:
@@ -443,6 +464,12 @@ namespace bs
 		void calculateIconColors(const Color& tint, const SPtr<Camera>& camera, UINT32 iconHeight, bool fixedScale,
 			Color& normalColor, Color& fadedColor);
 
+		/**
+		 * Calculates a world space bounding sphere for each pickable gizmo with a fixed size, meaning all gizmos except
+		 * icons and text, and triggers the callback for it. Iteration stops once the callback returns true.
+		 */
+		void forEachPickableShape(const std::function<bool(const CommonData&, const Sphere&)>& callback) const;
+
 		static const UINT32 VERTEX_BUFFER_GROWTH;
 		static const UINT32 INDEX_BUFFER_GROWTH;
 		static const UINT32 SPHERE_QUALITY;
@@ -450,6 +477,7 @@ namespace bs
 		static const float MAX_ICON_RANGE;
 		static const UINT32 OPTIMAL_ICON_SIZE;
 		static const float ICON_TEXEL_WORLD_SIZE;
+		static const float PICKING_MARGIN;
 
 		typedef Set<IconData, std::function<bool(const IconData&, const IconData&)>> IconSet;
 
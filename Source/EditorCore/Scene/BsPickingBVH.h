@@ -0,0 +1,242 @@
+//********************************** Banshee Engine (www.banshee3d.com) **************************************************//
+//**************** Copyright (c) 2016 Marko Pintera (marko.pintera@gmail.com). All rights reserved. **********************//
+#pragma once
+
+#include "BsEditorPrerequisites.h"
+#include "Math/BsAABox.h"
+#include "Math/BsConvexVolume.h"
+#include "Math/BsVector3.h"
+
+namespace bs
+{
+	/** @addtogroup Scene-Editor-Internal
+	 *  @{
+	 */
+
+	/**
+	 * Bounding volume hierarchy over the triangles of a mesh, used for ray casting against the mesh on the CPU.
+	 * Triangles are stored in groups of four in leaf nodes, laid out so the four ray-triangle tests can be performed at
+	 * once using SIMD instructions.
+	 */
+	class BS_ED_EXPORT MeshBVH
+	{
+	public:
+		/** Information about the closest triangle hit by a ray. */
+		struct Hit
+		{
+			float distance; /**< Distance along the ray, in multiples of the ray direction length. */
+			UINT32 triangle; /**< Index of the triangle, counted from the start of the sub-mesh. */
+			UINT32 subMesh; /**< Index of the sub-mesh the triangle belongs to. */
+			Vector3 normal; /**< Normalized geometric normal of the triangle, facing towards the ray origin. */
+		};
+
+		/**
+		 * Builds a hierarchy from the provided mesh data. Only sub-meshes containing triangle lists are included.
+		 *
+		 * @param[in]	meshData	Mesh data containing the vertex positions and indices.
+		 * @param[in]	subMeshes	Sub-meshes of the mesh the data belongs to.
+		 * @return					Built hierarchy, or null if the mesh data doesn't contain positions.
+		 */
+		static SPtr<MeshBVH> create(const SPtr<MeshData>& meshData, const Vector<SubMesh>& subMeshes);
+
+		/**
+		 * Finds the closest triangle intersected by the ray.
+		 *
+		 * @param[in]	origin			Origin of the ray, in the mesh's local space.
+		 * @param[in]	direction		Direction of the ray, in the mesh's local space. Doesn't need to be normalized.
+		 * @param[in]	cullModes		Culling mode for each of the mesh's sub-meshes. Triangles facing away from the
+		 *								ray are ignored for CULL_CLOCKWISE, triangles facing the ray are ignored for
+		 *								CULL_COUNTERCLOCKWISE.
+		 * @param[in]	maxDistance		Hits further along the ray than this are ignored.
+		 * @param[out]	hit				Information about the closest hit, if any.
+		 * @return						True if a triangle was hit closer than @p maxDistance.
+		 */
+		bool intersect(const Vector3& origin, const Vector3& direction, const Vector<CullingMode>& cullModes,
+			float maxDistance, Hit& hit) const;
+
+		/** Returns the number of sub-meshes in the mesh the hierarchy was built for. */
+		UINT32 getNumSubMeshes() const { return mNumSubMeshes; }
+
+		/** Number of triangles stored together in a single leaf and tested at once. */
+		static constexpr UINT32 TRIANGLES_PER_LEAF = 4;
+
+	private:
+		/** Node of the hierarchy. Children of a node are always stored next to each other. */
+		struct Node
+		{
+			Vector3 min;
+			Vector3 max;
+			/** Index of the first child for interior nodes, or index of the triangle group for leaves. */
+			UINT32 offset;
+			bool leaf;
+		};
+
+		/**
+		 * Up to TRIANGLES_PER_LEAF triangles stored as a structure of arrays. Each triangle is stored as its first
+		 * vertex and the two edges from it. Unused slots contain degenerate triangles that can never be hit.
+		 */
+		struct TriangleGroup
+		{
+			float v0[3][TRIANGLES_PER_LEAF];
+			float edge1[3][TRIANGLES_PER_LEAF];
+			float edge2[3][TRIANGLES_PER_LEAF];
+			UINT32 triangle[TRIANGLES_PER_LEAF];
+			UINT32 subMesh[TRIANGLES_PER_LEAF];
+		};
+
+		/** Information about a triangle used during the build. */
+		struct BuildTriangle
+		{
+			Vector3 vertices[3];
+			Vector3 centroid;
+			UINT32 triangle;
+			UINT32 subMesh;
+		};
+
+		/** Builds a node containing the specified range of triangles, and all of its children. */
+		void buildNode(UINT32 nodeIdx, Vector<BuildTriangle>& triangles, UINT32 start, UINT32 end);
+
+		/**
+		 * Intersects the ray with the triangle group and returns a mask of the triangles hit closer than
+		 * @p maxDistance, along with their distances and barycentric coordinates.
+		 */
+		static UINT32 intersectGroup(const TriangleGroup& group, const Vector3& origin, const Vector3& direction,
+			float maxDistance, float (&distances)[TRIANGLES_PER_LEAF], float (&determinants)[TRIANGLES_PER_LEAF]);
+
+		Vector<Node> mNodes;
+		Vector<TriangleGroup> mGroups;
+		UINT32 mNumSubMeshes = 0;
+	};
+
+	/**
+	 * Bounding volume hierarchy over a set of axis aligned boxes that can be added, moved and removed without
+	 * rebuilding the hierarchy. Boxes are stored enlarged by a margin proportional to their size, so small movements
+	 * don't require the hierarchy to be updated, and the tree is kept balanced using rotations as it is modified.
+	 * Queries report all boxes whose enlarged bounds match, callers should test the exact bounds themselves where it
+	 * matters.
+	 */
+	class BS_ED_EXPORT DynamicAABBTree
+	{
+	public:
+		/**
+		 * Callback triggered for each box intersected by a ray. Receives the proxy of the box and the distance at which
+		 * the ray enters it. Returns the new maximum distance to search up to.
+		 */
+		typedef std::function<float(UINT32, float)> RayCallback;
+
+		/** Callback triggered for each box found by an overlap query. Receives the proxy of the box. */
+		typedef std::function<void(UINT32)> QueryCallback;
+
+		/**
+		 * Adds a new box to the tree.
+		 *
+		 * @param[in]	bounds		Bounds of the box.
+		 * @param[in]	userData	Data to associate with the box, returned by getUserData().
+		 * @return					Proxy identifying the box, valid until destroyProxy() is called.
+		 */
+		UINT32 createProxy(const AABox& bounds, void* userData);
+
+		/** Removes a box previously added with createProxy(). */
+		void destroyProxy(UINT32 proxy);
+
+		/**
+		 * Updates the bounds of a box. The tree is only modified if the new bounds don't fit within the enlarged bounds
+		 * the box is currently stored with.
+		 *
+		 * @param[in]	proxy		Proxy of the box, as returned by createProxy().
+		 * @param[in]	bounds		New bounds of the box.
+		 * @return					True if the box had to be re-inserted.
+		 */
+		bool moveProxy(UINT32 proxy, const AABox& bounds);
+
+		/** Returns the data associated with the box when it was created. */
+		void* getUserData(UINT32 proxy) const { return mNodes[proxy].userData; }
+
+		/** Returns the enlarged bounds the box is stored with. */
+		const AABox& getFatBounds(UINT32 proxy) const { return mNodes[proxy].bounds; }
+
+		/** Finds all boxes overlapping the provided box. */
+		void query(const AABox& bounds, const QueryCallback& callback) const;
+
+		/** Finds all boxes intersecting the provided convex volume. */
+		void query(const ConvexVolume& volume, const QueryCallback& callback) const;
+
+		/**
+		 * Finds all boxes intersected by the ray, visiting them in approximately front to back order.
+		 *
+		 * @param[in]	origin		Origin of the ray.
+		 * @param[in]	direction	Direction of the ray.
+		 * @param[in]	maxDistance	Maximum distance along the ray to search up to.
+		 * @param[in]	callback	Callback to trigger for each intersected box. Boxes further along the ray than the
+		 *							distance returned by the callback are not reported.
+		 */
+		void rayCast(const Vector3& origin, const Vector3& direction, float maxDistance,
+			const RayCallback& callback) const;
+
+		/** Returns the height of the tree, with an empty tree having height zero. */
+		UINT32 getHeight() const { return mRoot == NULL_NODE ? 0 : (UINT32)mNodes[mRoot].height + 1; }
+
+		/**
+		 * Tests does the ray intersect the box, and returns the distance at which the ray enters the box.
+		 *
+		 * @param[in]	min				Minimum corner of the box.
+		 * @param[in]	max				Maximum corner of the box.
+		 * @param[in]	origin			Origin of the ray.
+		 * @param[in]	invDirection	Reciprocal of each component of the ray direction.
+		 * @param[in]	maxDistance		Intersections further along the ray than this are ignored.
+		 * @param[out]	distance		Distance at which the ray enters the box, or zero if the origin is inside the
+		 *								box.
+		 * @return						True if the ray intersects the box.
+		 */
+		static bool intersectBox(const Vector3& min, const Vector3& max, const Vector3& origin,
+			const Vector3& invDirection, float maxDistance, float& distance);
+
+		/** Value of a proxy or node index that doesn't reference anything. */
+		static constexpr UINT32 NULL_NODE = (UINT32)-1;
+
+		/** Fraction of the box size by which the stored bounds are enlarged in each direction. */
+		static const float BOUNDS_MARGIN;
+
+		/** Minimum distance by which the stored bounds are enlarged, so flat or point-sized boxes can still move. */
+		static const float MIN_BOUNDS_MARGIN;
+
+	private:
+		/** Node of the tree. Leaves contain the boxes, and are referenced by their proxies. */
+		struct Node
+		{
+			AABox bounds;
+			void* userData = nullptr;
+			UINT32 parent = NULL_NODE; /**< Parent of the node, or the next free node if the node is unused. */
+			UINT32 children[2] = { NULL_NODE, NULL_NODE };
+			INT32 height = 0; /**< Height of the sub-tree starting at this node. Leaves have zero, unused nodes -1. */
+
+			bool isLeaf() const { return children[0] == NULL_NODE; }
+		};
+
+		/** Returns an unused node, growing the node pool if needed. */
+		UINT32 allocateNode();
+
+		/** Returns the node to the pool of unused nodes. */
+		void freeNode(UINT32 node);
+
+		/** Inserts the leaf into the tree, next to the sibling that increases the total surface area the least. */
+		void insertLeaf(UINT32 leaf);
+
+		/** Removes the leaf from the tree, replacing its parent with its sibling. */
+		void removeLeaf(UINT32 leaf);
+
+		/** Rotates the node's children if they are unbalanced. Returns the node that took its place. */
+		UINT32 balance(UINT32 node);
+
+		/**
+		 * Recalculates the height and bounds of all nodes from the provided one up to the root, balancing on the way.
+		 */
+		void refit(UINT32 node);
+
+		Vector<Node> mNodes;
+		UINT32 mRoot = NULL_NODE;
+		UINT32 mFreeList = NULL_NODE;
+	};
+
+	/** @} */
+}
@@ -5,6 +5,12 @@
 #include "BsEditorPrerequisites.h"
 #include "Utility/BsModule.h"
 #include "Math/BsMatrix4.h"
+#include "Math/BsAABox.h"
+#include "Math/BsBounds.h"
+#include "Math/BsConvexVolume.h"
+#include "Math/BsRay.h"
+#include "Threading/BsAsyncOp.h"
+#include "Scene/BsPickingBVH.h"
 #include "RenderAPI/BsGpuParam.h"
 #include "Renderer/BsParamBlocks.h"
 
@@ -31,20 +37,120 @@ namespace bs
 
 	namespace ct { class ScenePicking; }
 
-	/**	Handles picking of scene objects with a pointer in scene view. */
+	/**
+	 * Handle to a picking operation started by ScenePicking::pickObjectsAsync() or
+	 * ScenePicking::pickClosestObjectAsync(). Results become available once hasCompleted() returns true, which can take
+	 * a few frames as the picking results are read back from the GPU only once it is done rendering them.
+	 */
+	class BS_ED_EXPORT ScenePickingOp
+	{
+	public:
+		/** Checks has the picking operation completed and are its results available. */
+		bool hasCompleted() const { return mCompleted; }
+
+		/**
+		 * Returns all the scene objects found by the operation, sorted so that the objects covering most of the picked
+		 * area come first. Only valid once the operation has completed.
+		 */
+		const Vector<HSceneObject>& getObjects() const { return mObjects; }
+
+		/** Returns the nearest scene object found by the operation, or an empty handle if no object was found. */
+		HSceneObject getClosestObject() const { return mObjects.empty() ? HSceneObject() : mObjects[0]; }
+
+		/**
+		 * Returns the position and normal of the surface under the picked position. Only valid once the operation has
+		 * completed, and only if it was started with snap data gathering enabled.
+		 */
+		const SnapData& getSnapData() const { return mSnapData; }
+
+	private:
+		friend class ScenePicking;
+
+		SPtr<Camera> mCamera;
+		Vector2I mPosition;
+		Vector2I mArea;
+		bool mGatherSnapData = false;
+		Vector<HSceneObject> mIgnoreRenderables;
+
+		bool mStarted = false;
+		bool mReadbackQueued = false;
+		UINT32 mBufferIdx = 0;
+		UINT64 mFrameIdx = 0;
+		AsyncOp mAsyncOp;
+		UINT32 mFirstGizmoIdx = 0;
+		Map<UINT32, HSceneObject> mGizmoObjects; /**< Objects of gizmos rendered by the operation, by picking index. */
+
+		bool mCompleted = false;
+		Vector<HSceneObject> mObjects;
+		SnapData mSnapData;
+	};
+
+	/**
+	 * Handles picking of scene objects with a pointer in scene view.
+	 *
+	 * Picking of the single closest object is performed on the CPU when possible, by casting a ray against a tree of
+	 * renderable bounds and the triangles of their meshes. Other picks, and picks whose result depends on alpha-tested
+	 * materials, gizmos or meshes whose data isn't yet available on the CPU, render the scene into an off-screen target
+	 * and read back the result instead.
+	 *
+	 * Both paths use a persistent draw list of pickable renderables. It is synchronized with the scene at most once per
+	 * frame, and only when a pick is made, and only renderables that were added, removed, moved or had their mesh or
+	 * materials changed since are updated. The rendering copy of the list lives on the core thread and is updated with
+	 * only the changes.
+	 *
+	 * The bounds of the renderables and the pickable gizmos are kept in a dynamic tree updated during the same
+	 * synchronization, which is also used for answering ray, box and frustum queries against the scene.
+	 */
 	class BS_ED_EXPORT ScenePicking : public Module<ScenePicking>
 	{
-		/**	Contains information about a single pickable item (mesh). */
+		/**	Contains information about a single pickable item (sub-mesh), as required for rendering it. */
 		struct RenderablePickData
 		{
 			SPtr<ct::Mesh> mesh;
+			UINT32 subMesh;
 			UINT32 index;
-			Matrix4 wvpTransform;
+			Matrix4 worldTransform;
+			Bounds worldBounds;
 			bool alpha;
 			CullingMode cullMode;
 			HTexture mainTexture;
 		};
 
+		/** Data required for picking a single mesh on the CPU. */
+		struct MeshPickData
+		{
+			SPtr<MeshBVH> bvh;
+			SPtr<MeshData> readbackData;
+			AsyncOp readbackOp;
+			bool readbackPending = false;
+			bool unsupported = false; /**< True if the mesh data can't be used for picking, e.g. has no positions. */
+		};
+
+		/** Object registered in the scene query tree. */
+		struct QueryEntry
+		{
+			HSceneObject sceneObject;
+			AABox bounds; /**< World space bounds. The tree stores them enlarged, so queries need to check these. */
+			UINT32 proxy = DynamicAABBTree::NULL_NODE;
+			bool gizmo = false;
+			UINT64 lastSynced = 0; /**< Frame during which the object was last found in the scene. */
+		};
+
+		/** Renderable registered in the picking draw list. */
+		struct PickEntry : QueryEntry
+		{
+			HMesh mesh;
+			Matrix4 worldTransform;
+			Bounds worldBounds;
+			Vector<HMaterial> materials; /**< Material of each sub-mesh, as of the last synchronization. */
+			Vector<HShader> shaders; /**< Shader of each sub-mesh material, as of the last synchronization. */
+			/** Texture used for alpha testing each sub-mesh, if any, as of the last sync. */
+			Vector<HTexture> textures;
+			Vector<CullingMode> cullModes; /**< Culling mode of each sub-mesh. */
+			Vector<bool> alpha; /**< Whether each sub-mesh uses an alpha-tested material. */
+			Vector<UINT32> indices; /**< Picking index of each sub-mesh. */
+		};
+
 	public:
 		ScenePicking();
 		~ScenePicking();
@@ -79,10 +185,122 @@ namespace bs
 		Vector<HSceneObject> pickObjects(const SPtr<Camera>& cam, const Vector2I& position, const Vector2I& area, 
 			Vector<HSceneObject>& ignoreRenderables, SnapData* data = nullptr);
 
+		/**
+		 * Finds all scene objects whose renderable or pickable gizmo bounds are intersected by the ray. Unlike picking
+		 * this only tests the bounds and doesn't account for occlusion.
+		 *
+		 * @param[in]	ray			Ray to test, in world space.
+		 * @param[in]	maxDistance	Maximum distance along the ray to search up to.
+		 * @return					Found scene objects, sorted by the distance along the ray at which their bounds are
+		 *							entered.
+		 */
+		Vector<HSceneObject> queryRay(const Ray& ray, float maxDistance = std::numeric_limits<float>::infinity());
+
+		/**
+		 * Finds all scene objects whose renderable or pickable gizmo bounds overlap the provided box.
+		 *
+		 * @param[in]	bounds		Box to test, in world space.
+		 * @return					Found scene objects, in no particular order.
+		 */
+		Vector<HSceneObject> queryBox(const AABox& bounds);
+
+		/**
+		 * Finds all scene objects whose renderable or pickable gizmo bounds intersect the provided volume, such as the
+		 * frustum of a camera.
+		 *
+		 * @param[in]	volume		Volume to test, in world space.
+		 * @return					Found scene objects, in no particular order.
+		 */
+		Vector<HSceneObject> queryFrustum(const ConvexVolume& volume);
+
+		/**
+		 * Finds all scene objects whose renderable or pickable gizmo bounds are within the frustum going through the
+		 * provided area of the camera's viewport. Useful for marquee selection that also needs to find occluded
+		 * objects.
+		 *
+		 * @param[in]	cam			Camera whose viewport the area is relative to.
+		 * @param[in]	position	Top left corner of the area relative to the camera viewport, in pixels.
+		 * @param[in]	area		Width/height of the area, in pixels.
+		 * @return					Found scene objects, in no particular order.
+		 */
+		Vector<HSceneObject> queryArea(const SPtr<Camera>& cam, const Vector2I& position, const Vector2I& area);
+
+		/**
+		 * Starts a search for all scene objects under the provided position and area, without waiting for the GPU to
+		 * finish rendering the picking data. Use this instead of pickObjects() for picks performed every frame, as the
+		 * blocking version stalls the CPU until the GPU catches up.
+		 *
+		 * @param[in]	cam					Camera to perform the picking from.
+		 * @param[in]	position			Pointer position relative to the camera viewport, in pixels.
+		 * @param[in]	area				Width/height of the checked area in pixels. Use (1, 1) if you want the exact
+		 *									 position under the pointer.
+		 * @param[in]	ignoreRenderables	A list of objects that should be ignored during scene picking.
+		 * @param[in]	gatherSnapData		Determines whether the position and normal under the pointer are recorded.
+		 * @return							Handle to the operation that will contain the results once complete.
+		 */
+		SPtr<ScenePickingOp> pickObjectsAsync(const SPtr<Camera>& cam, const Vector2I& position, const Vector2I& area,
+			const Vector<HSceneObject>& ignoreRenderables, bool gatherSnapData = false);
+
+		/**
+		 * Starts a search for the single nearest scene object under the provided position, without waiting for the GPU.
+		 * If the pick can be resolved on the CPU the returned operation is already complete.
+		 *
+		 * @param[in]	cam					Camera to perform the picking from.
+		 * @param[in]	position			Pointer position relative to the camera viewport, in pixels.
+		 * @param[in]	ignoreRenderables	A list of objects that should be ignored during scene picking.
+		 * @param[in]	gatherSnapData		Determines whether the position and normal under the pointer are recorded.
+		 * @return							Handle to the operation that will contain the results once complete.
+		 */
+		SPtr<ScenePickingOp> pickClosestObjectAsync(const SPtr<Camera>& cam, const Vector2I& position,
+			const Vector<HSceneObject>& ignoreRenderables, bool gatherSnapData = false);
+
+		/** @name Internal
+		 *  @{
+		 */
+
+		/** Progresses the asynchronous picking operations. Must be called once per frame. */
+		void update();
+
+		/** @} */
+
 	private:
 		friend class ct::ScenePicking;
 
-		typedef Set<RenderablePickData, std::function<bool(const RenderablePickData&, const RenderablePickData&)>> RenderableSet;
+		/**
+		 * Number of off-screen buffers available to asynchronous picks. Limits the number of picks in flight at once.
+		 */
+		static constexpr UINT32 NUM_ASYNC_BUFFERS = 2;
+
+		/**
+		 * Updates the draw list with renderables that were added, removed or modified since the last call. Queues the
+		 * changes for the core thread, and updates the bounds of renderables and gizmos in the scene query tree. Does 
+		 * nothing if already called during the current frame.
+		 */
+		void syncDrawList();
+
+		/** Updates the scene query tree with the current bounds of the pickable gizmos. */
+		void syncGizmos(UINT64 frameIdx);
+
+		/** Inserts the entry into the scene query tree, or updates its bounds if it is already in it. */
+		void updateQueryEntry(QueryEntry& entry);
+
+		/** Returns the entry a proxy in the scene query tree belongs to. */
+		const QueryEntry& getQueryEntry(UINT32 proxy) const 
+		{ 
+			return *static_cast<const QueryEntry*>(mSceneTree.getUserData(proxy)); 
+		}
+
+		/** Returns a picking index that isn't used by any renderable in the draw list. */
+		UINT32 allocatePickIndex();
+
+		/** Returns the sorted picking indices of all sub-meshes belonging to the provided scene objects. */
+		Vector<UINT32> getIgnoredIndices(const Vector<HSceneObject>& ignoreRenderables) const;
+
+		/** Queues rendering of the picking data for the operation, into the specified asynchronous picking buffer. */
+		void startAsyncPick(ScenePickingOp& op, UINT32 bufferIdx);
+
+		/** Maps the read back picking results to scene objects and marks the operation as complete. */
+		void resolveAsyncPick(ScenePickingOp& op, const PickResults& results);
 
 		/**	Encodes a pickable object identifier to a unique color. */
 		static Color encodeIndex(UINT32 index);
@@ -90,7 +308,52 @@ namespace bs
 		/** Decodes a color into a unique object identifier. Color should have initially been encoded with encodeIndex(). */
 		static UINT32 decodeIndex(Color color);
 
+		/**
+		 * Determines how a sub-mesh using the provided material is picked.
+		 *
+		 * @param[in]	material	Material used by the sub-mesh. Can be null.
+		 * @param[out]	alpha		True if the material uses alpha and picking must take its texture into account.
+		 * @param[out]	cullMode	Culling mode used by the material.
+		 */
+		static void getPickingMaterialInfo(const HMaterial& material, bool& alpha, CullingMode& cullMode);
+
+		/**
+		 * Attempts to find the single nearest scene object under the provided position by casting a ray against the
+		 * scene on the CPU.
+		 *
+		 * @param[in]	cam					Camera to perform the picking from.
+		 * @param[in]	position			Pointer position relative to the camera viewport, in pixels.
+		 * @param[in]	ignoreRenderables	A list of objects that should be ignored during scene picking.
+		 * @param[out]	object				Nearest scene object under the position, or an empty handle if there is
+		 *									none.
+		 * @param[out]	data				Picking data regarding position and normal, with the normal in the local
+		 *									space of the picked object.
+		 * @return							True if the pick was resolved, false if it needs to be performed on the GPU.
+		 */
+		bool pickClosestObjectCPU(const SPtr<Camera>& cam, const Vector2I& position, 
+			const Vector<HSceneObject>& ignoreRenderables, HSceneObject& object, SnapData* data);
+
+		/**
+		 * Returns the triangle hierarchy used for picking the provided mesh on the CPU. If the mesh doesn't keep a CPU
+		 * copy of its data, the data is read back from the GPU first, in which case null is returned until the read
+		 * completes.
+		 */
+		SPtr<MeshBVH> getMeshBVH(const HMesh& mesh);
+
 		ct::ScenePicking* mCore;
+
+		UnorderedMap<UINT64, MeshPickData> mMeshPickData;
+		DynamicAABBTree mSceneTree;
+
+		UnorderedMap<UINT64, PickEntry> mPickEntries; /**< Draw list entries, keyed by renderable instance ID. */
+		UnorderedMap<UINT64, QueryEntry> mGizmoEntries; /**< Gizmo bounds, keyed by scene object instance ID. */
+		Vector<HSceneObject> mIndexObjects; /**< Scene object each picking index belongs to. */
+		Vector<UINT32> mFreeIndices;
+		Vector<std::pair<UINT32, UINT64>> mPendingFreeIndices; /**< Freed indices, and the frame they were freed in. */
+		UINT64 mDrawListFrameIdx = (UINT64)-1;
+
+		Vector<SPtr<ScenePickingOp>> mAsyncOps;
+		bool mBufferInUse[NUM_ASYNC_BUFFERS] = { };
 	};
 
 	/** @} */
@@ -120,18 +383,28 @@ namespace bs
 		void destroy();
 
 		/**
-		 * Sets up the viewport, materials and their parameters as needed for picking. Also renders all the provided
-		 * renderable objects. Must be followed by corePickingEnd(). You may call other methods after this one, but you must
-		 * ensure they render proper unique pickable colors that can be resolved to SceneObject%s later.
+		 * Updates the persistent list of renderables drawn during picking.
+		 *
+		 * @param[in]	updated		Sub-meshes that were added or modified, identified by their picking index.
+		 * @param[in]	removed		Picking indices of sub-meshes that were removed.
+		 */
+		void updateDrawList(const Vector<bs::ScenePicking::RenderablePickData>& updated, const Vector<UINT32>& removed);
+
+		/**
+		 * Sets up the viewport, materials and their parameters as needed for picking. Also renders all the renderables
+		 * in the draw list. Must be followed by corePickingEnd(). You may call other methods after this one, but you
+		 * must ensure they render proper unique pickable colors that can be resolved to SceneObject%s later.
 		 *
 		 * @param[in]	target			Render target to render to.
 		 * @param[in]	viewportArea	Normalized area of the render target to render in.
-		 * @param[in]	renderables		A set of pickable Renderable objects to render.
+		 * @param[in]	viewProj		View-projection matrix of the camera to render from.
+		 * @param[in]	frustum			World space frustum of the camera. Renderables outside of it are skipped.
+		 * @param[in]	ignored			Sorted picking indices of sub-meshes that shouldn't be rendered.
 		 * @param[in]	position		Position of the pointer where to pick objects, in pixels relative to viewport.
 		 * @param[in]	area			Width/height of the area to pick objects, in pixels.
 		 */
-		void corePickingBegin(const SPtr<RenderTarget>& target, const Rect2& viewportArea, 
-			const bs::ScenePicking::RenderableSet& renderables, const Vector2I& position, const Vector2I& area);
+		void corePickingBegin(const SPtr<RenderTarget>& target, const Rect2& viewportArea, const Matrix4& viewProj,
+			const ConvexVolume& frustum, const Vector<UINT32>& ignored, const Vector2I& position, const Vector2I& area);
 		
 		/**
 		 * Ends picking operation started by corePickingBegin(). Render target is resolved and objects in the picked area
@@ -148,12 +421,69 @@ namespace bs
 		void corePickingEnd(const SPtr<RenderTarget>& target, const Rect2& viewportArea, const Vector2I& position,
 			const Vector2I& area, bool gatherSnapData, AsyncOp& asyncOp);
 
+		/**
+		 * Version of corePickingBegin() that renders into one of the off-screen picking buffers instead of the camera's
+		 * render target, so the results can be read at a later time. Must be followed by corePickingEndAsync().
+		 *
+		 * @param[in]	bufferIdx		Index of the picking buffer to render to.
+		 * @param[in]	target			Render target of the camera. Picking buffer is sized to match it.
+		 * @param[in]	viewportArea	Normalized area of the render target to render in.
+		 * @param[in]	viewProj		View-projection matrix of the camera to render from.
+		 * @param[in]	frustum			World space frustum of the camera. Renderables outside of it are skipped.
+		 * @param[in]	ignored			Sorted picking indices of sub-meshes that shouldn't be rendered.
+		 * @param[in]	position		Position of the pointer where to pick objects, in pixels relative to viewport.
+		 * @param[in]	area			Width/height of the area to pick objects, in pixels.
+		 */
+		void corePickingBeginAsync(UINT32 bufferIdx, const SPtr<RenderTarget>& target, const Rect2& viewportArea,
+			const Matrix4& viewProj, const ConvexVolume& frustum, const Vector<UINT32>& ignored,
+			const Vector2I& position, const Vector2I& area);
+
+		/**
+		 * Ends rendering started by corePickingBeginAsync(), without waiting for it to finish or reading the results.
+		 */
+		void corePickingEndAsync();
+
+		/**
+		 * Reads the results of picking rendered by corePickingBeginAsync(). Should be called a frame or more after the
+		 * rendering was submitted, so the GPU is done with it and the read doesn't stall.
+		 *
+		 * @param[in]	bufferIdx		Index of the picking buffer to read from.
+		 * @param[in]	position		Position of the pointer where to pick objects, in pixels relative to viewport.
+		 * @param[in]	area			Width/height of the area to pick objects, in pixels.
+		 * @param[in]	gatherSnapData	Determines whather normal & depth information will be read.
+		 * @param[out]	asyncOp			Async operation handle that when complete will contain the PickResults.
+		 */
+		void coreReadPickingResults(UINT32 bufferIdx, const Vector2I& position, const Vector2I& area, 
+			bool gatherSnapData, AsyncOp& asyncOp);
+
 	private:
 		friend class bs::ScenePicking;
 
+		/** Renders the draw list into the picking texture, limited to the picked area. */
+		void renderPickingData(const SPtr<RenderTexture>& pickingTexture, const Rect2& viewportArea,
+			const Matrix4& viewProj, const ConvexVolume& frustum, const Vector<UINT32>& ignored,
+			const Vector2I& position, const Vector2I& area);
+
+		/** Removes the sub-mesh with the specified picking index from the draw list, if present. */
+		void removeFromDrawList(UINT32 index);
+
+		/** Number of material variations used for picking: opaque and alpha-tested, for each culling mode. */
+		static constexpr UINT32 NUM_MATERIALS = 6;
+
+		/** Reads back the objects in the picked area, and optionally the depth and normal, from the picking texture. */
+		PickResults readPickingResults(const SPtr<RenderTexture>& pickingTexture, const Vector2I& position, 
+			const Vector2I& area, bool gatherSnapData);
+
 		static const float ALPHA_CUTOFF;
 
 		SPtr<RenderTexture> mPickingTexture;
+		SPtr<RenderTexture> mAsyncBuffers[bs::ScenePicking::NUM_ASYNC_BUFFERS];
+
+		/** Pickable sub-meshes, grouped by the material variation used for rendering them. */
+		Vector<bs::ScenePicking::RenderablePickData> mDrawList[NUM_MATERIALS];
+
+		/** Maps picking indices to the material variation and position of the sub-mesh in mDrawList. */
+		UnorderedMap<UINT32, std::pair<UINT32, UINT32>> mDrawListLookup;
 
 		SPtr<Material> mMaterials[6];
 		Vector<SPtr<GpuParamsSet>> mParamSets[6];
@@ -4,6 +4,7 @@
 #include "Mesh/BsMesh.h"
 #include "Math/BsAABox.h"
 #include "Math/BsSphere.h"
+#include "Math/BsRay.h"
 #include "RenderAPI/BsVertexDataDesc.h"
 #include "Utility/BsShapeMeshes3D.h"
 #include "Components/BsCCamera.h"
@@ -28,6 +29,17 @@ namespace bs
 	const float GizmoManager::MAX_ICON_RANGE = 500.0f;
 	const UINT32 GizmoManager::OPTIMAL_ICON_SIZE = 64;
 	const float GizmoManager::ICON_TEXEL_WORLD_SIZE = 0.05f;
+	const float GizmoManager::PICKING_MARGIN = 3.0f;
+
+	/** Returns the number of pixels a unit long object covers when one unit away from the camera. */
+	static float getCameraScale(const SPtr<Camera>& camera)
+	{
+		if (camera->getProjectionType() == PT_ORTHOGRAPHIC)
+			return camera->getViewport()->getPixelArea().height / camera->getOrthoWindowHeight();
+
+		Radian vertFOV(Math::tan(camera->getHorzFOV() * 0.5f));
+		return (camera->getViewport()->getPixelArea().height * 0.5f) / vertFOV.valueRadians();
+	}
 
 	GizmoManager::GizmoManager()
 		: mPickable(false), mCurrentIdx(0), mTransformDirty(false), mColorDirty(false), mDrawHelper(nullptr)
@@ -750,14 +762,7 @@ namespace bs
 
 		UINT32* indices = meshData->getIndices32();
 
-		float cameraScale = 1.0f;
-		if (camera->getProjectionType() == PT_ORTHOGRAPHIC)
-			cameraScale = camera->getViewport()->getPixelArea().height / camera->getOrthoWindowHeight();
-		else
-		{
-			Radian vertFOV(Math::tan(camera->getHorzFOV() * 0.5f));
-			cameraScale = (camera->getViewport()->getPixelArea().height * 0.5f) / vertFOV.valueRadians();
-		}
+		float cameraScale = getCameraScale(camera);
 
 		iconRenderData = bs_shared_ptr_new<IconRenderDataVec>();
 		UINT32 lastTextureIdx = std::numeric_limits<UINT32>::max();
@@ -907,6 +912,249 @@ namespace bs
 		return HSceneObject();
 	}
 
+	bool GizmoManager::isPickableGizmoAt(const SPtr<Camera>& camera, const Vector2I& position)
+	{
+		Ray ray = camera->screenPointToRay(position);
+		float cameraScale = getCameraScale(camera);
+		bool orthographic = camera->getProjectionType() == PT_ORTHOGRAPHIC;
+
+		// Checks is the ray close enough to the sphere, accounting for the width of lines drawn by wireframe gizmos
+		bool found = false;
+		forEachPickableShape([&](const CommonData& data, const Sphere& sphere)
+		{
+			Vector3 toCenter = sphere.getCenter() - ray.getOrigin();
+			float distanceAlong = toCenter.dot(ray.getDirection());
+			if ((distanceAlong + sphere.getRadius()) < 0.0f)
+				return false;
+
+			float worldPerPixel = 1.0f / cameraScale;
+			if (!orthographic)
+				worldPerPixel *= std::max(distanceAlong, 0.0f);
+
+			float radius = sphere.getRadius() + PICKING_MARGIN * worldPerPixel;
+			float distanceSqrd = toCenter.squaredLength() - distanceAlong * distanceAlong;
+
+			found = distanceSqrd <= (radius * radius);
+			return found;
+		});
+
+		if (found)
+			return true;
+
+		// Text layout isn't known until the text mesh is built, so assume any pickable text could be under the position
+		for (auto& entry : mTextData)
+		{
+			if (entry.pickable)
+				return true;
+		}
+
+		// Icons are drawn in screen space, with the same size and culling as in buildIconMesh()
+		for (auto& entry : mIconData)
+		{
+			if (!entry.pickable || !entry.texture.isLoaded())
+				continue;
+
+			Vector3 viewPoint = camera->worldToViewPoint(entry.position);
+
+			float distance = -viewPoint.z;
+			if (distance < camera->getNearClipDistance() || distance > MAX_ICON_RANGE)
+				continue;
+
+			UINT32 iconWidth = entry.texture->getWidth();
+			UINT32 iconHeight = entry.texture->getHeight();
+			limitIconSize(iconWidth, iconHeight);
+
+			float halfWidth = iconWidth * 0.5f;
+			float halfHeight = iconHeight * 0.5f;
+
+			if (!entry.fixedScale)
+			{
+				float iconScale = cameraScale * ICON_TEXEL_WORLD_SIZE;
+				if (!orthographic)
+					iconScale /= distance;
+
+				halfWidth *= iconScale;
+				halfHeight *= iconScale;
+			}
+
+			Vector2I screenPosition = camera->viewToScreenPoint(viewPoint);
+			if (Math::abs((float)(position.x - screenPosition.x)) <= (halfWidth + PICKING_MARGIN) &&
+				Math::abs((float)(position.y - screenPosition.y)) <= (halfHeight + PICKING_MARGIN))
+				return true;
+		}
+
+		return false;
+	}
+
+	Vector<std::pair<HSceneObject, AABox>> GizmoManager::getPickableBounds() const
+	{
+		UnorderedMap<UINT64, UINT32> lookup;
+		Vector<std::pair<HSceneObject, AABox>> output;
+
+		auto addBounds = [&](const HSceneObject& so, const AABox& bounds)
+		{
+			if (!so)
+				return;
+
+			auto iterFind = lookup.find(so.getInstanceId());
+			if (iterFind != lookup.end())
+			{
+				output[iterFind->second].second.merge(bounds);
+				return;
+			}
+
+			lookup[so.getInstanceId()] = (UINT32)output.size();
+			output.push_back(std::make_pair(so, bounds));
+		};
+
+		forEachPickableShape([&](const CommonData& data, const Sphere& sphere)
+		{
+			Vector3 radius(sphere.getRadius(), sphere.getRadius(), sphere.getRadius());
+			addBounds(data.sceneObject, AABox(sphere.getCenter() - radius, sphere.getCenter() + radius));
+
+			return false;
+		});
+
+		// Size of icons and text depends on the camera, so only their position is included
+		for (auto& entry : mIconData)
+		{
+			if (entry.pickable && entry.texture.isLoaded())
+				addBounds(entry.sceneObject, AABox(entry.position, entry.position));
+		}
+
+		for (auto& entry : mTextData)
+		{
+			if (!entry.pickable)
+				continue;
+
+			Vector3 position = entry.transform.multiplyAffine(entry.position);
+			addBounds(entry.sceneObject, AABox(position, position));
+		}
+
+		return output;
+	}
+
+	void GizmoManager::forEachPickableShape(const std::function<bool(const CommonData&, const Sphere&)>& callback) const
+	{
+		auto visit = [&](const CommonData& data, const Vector3& center, float radius)
+		{
+			if (!data.pickable)
+				return false;
+
+			Sphere bounds(center, radius);
+			bounds.transform(data.transform);
+
+			return callback(data, bounds);
+		};
+
+		for (auto& entry : mSolidCubeData)
+		{
+			if (visit(entry, entry.position, entry.extents.length()))
+				return;
+		}
+
+		for (auto& entry : mWireCubeData)
+		{
+			if (visit(entry, entry.position, entry.extents.length()))
+				return;
+		}
+
+		for (auto& entry : mSolidSphereData)
+		{
+			if (visit(entry, entry.position, entry.radius))
+				return;
+		}
+
+		for (auto& entry : mWireSphereData)
+		{
+			if (visit(entry, entry.position, entry.radius))
+				return;
+		}
+
+		// Cones are drawn with their height equal to their radius (see renderForPicking())
+		for (auto& entry : mSolidConeData)
+		{
+			float radius = entry.radius * std::max(1.0f, std::max(entry.scale.x, entry.scale.y));
+			if (visit(entry, entry.base, radius))
+				return;
+		}
+
+		for (auto& entry : mWireConeData)
+		{
+			float radius = entry.radius * std::max(1.0f, std::max(entry.scale.x, entry.scale.y));
+			if (visit(entry, entry.base, radius))
+				return;
+		}
+
+		for (auto& entry : mLineData)
+		{
+			Vector3 center = (entry.start + entry.end) * 0.5f;
+			if (visit(entry, center, (entry.end - entry.start).length() * 0.5f))
+				return;
+		}
+
+		for (auto& entry : mLineListData)
+		{
+			if (!entry.pickable || entry.linePoints.empty())
+				continue;
+
+			AABox bounds(entry.linePoints[0], entry.linePoints[0]);
+			for (auto& point : entry.linePoints)
+				bounds.merge(point);
+
+			if (visit(entry, bounds.getCenter(), bounds.getHalfSize().length()))
+				return;
+		}
+
+		for (auto& entry : mSolidDiscData)
+		{
+			if (visit(entry, entry.position, entry.radius))
+				return;
+		}
+
+		for (auto& entry : mWireDiscData)
+		{
+			if (visit(entry, entry.position, entry.radius))
+				return;
+		}
+
+		for (auto& entry : mWireArcData)
+		{
+			if (visit(entry, entry.position, entry.radius))
+				return;
+		}
+
+		for (auto& entry : mWireMeshData)
+		{
+			if (!entry.pickable || entry.meshData == nullptr || entry.meshData->getNumVertices() == 0)
+				continue;
+
+			UINT32 numVertices = entry.meshData->getNumVertices();
+			auto positionIter = entry.meshData->getVec3DataIter(VES_POSITION);
+
+			AABox bounds(positionIter.getValue(), positionIter.getValue());
+			for (UINT32 i = 0; i < numVertices; i++)
+			{
+				bounds.merge(positionIter.getValue());
+				positionIter.moveNext();
+			}
+
+			if (visit(entry, bounds.getCenter(), bounds.getHalfSize().length()))
+				return;
+		}
+
+		for (auto& entry : mFrustumData)
+		{
+			float farHalfHeight = entry.far * Math::tan(Radian(entry.FOV) * 0.5f);
+			float farHalfWidth = farHalfHeight * entry.aspect;
+
+			float radius = Math::sqrt(entry.far * entry.far + farHalfHeight * farHalfHeight + 
+				farHalfWidth * farHalfWidth);
+			if (visit(entry, entry.position, radius))
+				return;
+		}
+	}
+
 	namespace ct
 	{
 	GizmoParamBlockDef gGizmoParamBlockDef;
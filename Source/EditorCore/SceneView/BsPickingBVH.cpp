@@ -0,0 +1,832 @@
+//********************************** Banshee Engine (www.banshee3d.com) **************************************************//
+//**************** Copyright (c) 2016 Marko Pintera (marko.pintera@gmail.com). All rights reserved. **********************//
+#include "Scene/BsPickingBVH.h"
+#include "Mesh/BsMeshData.h"
+#include "RenderAPI/BsSubMesh.h"
+#include "RenderAPI/BsVertexDataDesc.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+	#include <xmmintrin.h>
+	#define BS_PICKING_BVH_SSE 1
+#else
+	#define BS_PICKING_BVH_SSE 0
+#endif
+
+namespace bs
+{
+	/** 
+	 * Maximum depth of the traversal stack for static hierarchies. They are built balanced, so this is never reached in
+	 * practice. Dynamic hierarchies use it as the initial stack size.
+	 */
+	static constexpr UINT32 MAX_STACK_DEPTH = 64;
+
+	/** Entry on the traversal stack, containing the node index and the distance at which the ray enters the node. */
+	struct StackEntry
+	{
+		UINT32 node;
+		float distance;
+	};
+
+	SPtr<MeshBVH> MeshBVH::create(const SPtr<MeshData>& meshData, const Vector<SubMesh>& subMeshes)
+	{
+		if (meshData == nullptr || !meshData->getVertexDesc()->hasElement(VES_POSITION))
+			return nullptr;
+
+		UINT32 numVertices = meshData->getNumVertices();
+		Vector<Vector3> positions(numVertices);
+
+		VertexElemIter<Vector3> positionIter = meshData->getVec3DataIter(VES_POSITION);
+		for (UINT32 i = 0; i < numVertices; i++)
+		{
+			positions[i] = positionIter.getValue();
+			positionIter.moveNext();
+		}
+
+		bool use32BitIndices = meshData->getIndexType() == IT_32BIT;
+		UINT32* indices32 = use32BitIndices ? meshData->getIndices32() : nullptr;
+		UINT16* indices16 = use32BitIndices ? nullptr : meshData->getIndices16();
+		UINT32 numIndices = meshData->getNumIndices();
+
+		Vector<BuildTriangle> triangles;
+		for (UINT32 i = 0; i < (UINT32)subMeshes.size(); i++)
+		{
+			const SubMesh& subMesh = subMeshes[i];
+			if (subMesh.drawOp != DOT_TRIANGLE_LIST)
+				continue;
+
+			UINT32 numTriangles = subMesh.indexCount / 3;
+			for (UINT32 j = 0; j < numTriangles; j++)
+			{
+				BuildTriangle triangle;
+				triangle.triangle = j;
+				triangle.subMesh = i;
+
+				bool valid = true;
+				for (UINT32 k = 0; k < 3; k++)
+				{
+					UINT32 indexIdx = subMesh.indexOffset + j * 3 + k;
+					if (indexIdx >= numIndices)
+					{
+						valid = false;
+						break;
+					}
+
+					UINT32 vertexIdx = use32BitIndices ? indices32[indexIdx] : indices16[indexIdx];
+					if (vertexIdx >= numVertices)
+					{
+						valid = false;
+						break;
+					}
+
+					triangle.vertices[k] = positions[vertexIdx];
+				}
+
+				if (!valid)
+					continue;
+
+				triangle.centroid = (triangle.vertices[0] + triangle.vertices[1] + triangle.vertices[2]) / 3.0f;
+				triangles.push_back(triangle);
+			}
+		}
+
+		SPtr<MeshBVH> bvh = bs_shared_ptr_new<MeshBVH>();
+		bvh->mNumSubMeshes = (UINT32)subMeshes.size();
+
+		if (!triangles.empty())
+		{
+			UINT32 numLeaves = ((UINT32)triangles.size() + TRIANGLES_PER_LEAF - 1) / TRIANGLES_PER_LEAF;
+			bvh->mNodes.reserve(numLeaves * 2);
+			bvh->mGroups.reserve(numLeaves);
+
+			bvh->mNodes.push_back(Node());
+			bvh->buildNode(0, triangles, 0, (UINT32)triangles.size());
+		}
+
+		return bvh;
+	}
+
+	void MeshBVH::buildNode(UINT32 nodeIdx, Vector<BuildTriangle>& triangles, UINT32 start, UINT32 end)
+	{
+		AABox bounds(triangles[start].vertices[0], triangles[start].vertices[0]);
+		AABox centroidBounds(triangles[start].centroid, triangles[start].centroid);
+		for (UINT32 i = start; i < end; i++)
+		{
+			for (UINT32 j = 0; j < 3; j++)
+				bounds.merge(triangles[i].vertices[j]);
+
+			centroidBounds.merge(triangles[i].centroid);
+		}
+
+		mNodes[nodeIdx].min = bounds.getMin();
+		mNodes[nodeIdx].max = bounds.getMax();
+
+		UINT32 count = end - start;
+		if (count <= TRIANGLES_PER_LEAF)
+		{
+			TriangleGroup group;
+			bs_zero_out(group);
+
+			for (UINT32 i = 0; i < count; i++)
+			{
+				const BuildTriangle& triangle = triangles[start + i];
+				Vector3 edge1 = triangle.vertices[1] - triangle.vertices[0];
+				Vector3 edge2 = triangle.vertices[2] - triangle.vertices[0];
+
+				for (UINT32 j = 0; j < 3; j++)
+				{
+					group.v0[j][i] = triangle.vertices[0][j];
+					group.edge1[j][i] = edge1[j];
+					group.edge2[j][i] = edge2[j];
+				}
+
+				group.triangle[i] = triangle.triangle;
+				group.subMesh[i] = triangle.subMesh;
+			}
+
+			mNodes[nodeIdx].offset = (UINT32)mGroups.size();
+			mNodes[nodeIdx].leaf = true;
+
+			mGroups.push_back(group);
+			return;
+		}
+
+		// Split at the median of the longest axis of the triangle centroids
+		Vector3 extents = centroidBounds.getSize();
+
+		UINT32 axis = 0;
+		if (extents.y > extents[axis])
+			axis = 1;
+
+		if (extents.z > extents[axis])
+			axis = 2;
+
+		UINT32 mid = start + count / 2;
+		std::nth_element(triangles.begin() + start, triangles.begin() + mid, triangles.begin() + end,
+			[axis](const BuildTriangle& a, const BuildTriangle& b) { return a.centroid[axis] < b.centroid[axis]; });
+
+		UINT32 firstChild = (UINT32)mNodes.size();
+		mNodes.push_back(Node());
+		mNodes.push_back(Node());
+
+		mNodes[nodeIdx].offset = firstChild;
+		mNodes[nodeIdx].leaf = false;
+
+		buildNode(firstChild, triangles, start, mid);
+		buildNode(firstChild + 1, triangles, mid, end);
+	}
+
+	bool MeshBVH::intersect(const Vector3& origin, const Vector3& direction, const Vector<CullingMode>& cullModes,
+		float maxDistance, Hit& hit) const
+	{
+		if (mNodes.empty())
+			return false;
+
+		Vector3 invDirection(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+
+		StackEntry stack[MAX_STACK_DEPTH];
+		UINT32 stackSize = 0;
+
+		float rootDistance;
+		if (!DynamicAABBTree::intersectBox(mNodes[0].min, mNodes[0].max, origin, invDirection, maxDistance,
+			rootDistance))
+			return false;
+
+		stack[stackSize++] = { 0, rootDistance };
+
+		float closest = maxDistance;
+		const TriangleGroup* hitGroup = nullptr;
+		UINT32 hitLane = 0;
+
+		while (stackSize > 0)
+		{
+			StackEntry entry = stack[--stackSize];
+			if (entry.distance > closest)
+				continue;
+
+			const Node& node = mNodes[entry.node];
+			if (node.leaf)
+			{
+				const TriangleGroup& group = mGroups[node.offset];
+
+				float distances[TRIANGLES_PER_LEAF];
+				float determinants[TRIANGLES_PER_LEAF];
+				UINT32 mask = intersectGroup(group, origin, direction, closest, distances, determinants);
+
+				for (UINT32 i = 0; i < TRIANGLES_PER_LEAF; i++)
+				{
+					if ((mask & (1 << i)) == 0)
+						continue;
+
+					// Positive determinant means the triangle is facing the ray (counter-clockwise as seen from origin)
+					CullingMode cullMode = CULL_NONE;
+					if (group.subMesh[i] < (UINT32)cullModes.size())
+						cullMode = cullModes[group.subMesh[i]];
+
+					if (cullMode == CULL_CLOCKWISE && determinants[i] < 0.0f)
+						continue;
+
+					if (cullMode == CULL_COUNTERCLOCKWISE && determinants[i] > 0.0f)
+						continue;
+
+					if (distances[i] < closest)
+					{
+						closest = distances[i];
+						hitGroup = &group;
+						hitLane = i;
+					}
+				}
+			}
+			else
+			{
+				// Push the further child first, so the closer one is visited first and can cull the other one
+				float distances[2];
+				bool hits[2];
+				for (UINT32 i = 0; i < 2; i++)
+				{
+					const Node& child = mNodes[node.offset + i];
+					hits[i] = DynamicAABBTree::intersectBox(child.min, child.max, origin, invDirection, closest,
+						distances[i]);
+				}
+
+				UINT32 first = distances[0] <= distances[1] ? 1 : 0;
+				for (UINT32 i = 0; i < 2; i++)
+				{
+					UINT32 childIdx = i == 0 ? first : 1 - first;
+					if (hits[childIdx] && stackSize < MAX_STACK_DEPTH)
+						stack[stackSize++] = { node.offset + childIdx, distances[childIdx] };
+				}
+			}
+		}
+
+		if (hitGroup == nullptr)
+			return false;
+
+		Vector3 edge1(hitGroup->edge1[0][hitLane], hitGroup->edge1[1][hitLane], hitGroup->edge1[2][hitLane]);
+		Vector3 edge2(hitGroup->edge2[0][hitLane], hitGroup->edge2[1][hitLane], hitGroup->edge2[2][hitLane]);
+
+		Vector3 normal = Vector3::normalize(edge1.cross(edge2));
+		if (normal.dot(direction) > 0.0f)
+			normal = -normal;
+
+		hit.distance = closest;
+		hit.triangle = hitGroup->triangle[hitLane];
+		hit.subMesh = hitGroup->subMesh[hitLane];
+		hit.normal = normal;
+
+		return true;
+	}
+
+	UINT32 MeshBVH::intersectGroup(const TriangleGroup& group, const Vector3& origin, const Vector3& direction,
+		float maxDistance, float (&distances)[TRIANGLES_PER_LEAF], float (&determinants)[TRIANGLES_PER_LEAF])
+	{
+		// Moller-Trumbore, performed for all triangles in the group at once. Degenerate triangles (including the unused
+		// slots) have a zero determinant and are rejected.
+#if BS_PICKING_BVH_SSE
+		static_assert(TRIANGLES_PER_LEAF == 4, "SSE path assumes four triangles per leaf.");
+
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 signMask = _mm_set1_ps(-0.0f);
+
+		__m128 dirX = _mm_set1_ps(direction.x);
+		__m128 dirY = _mm_set1_ps(direction.y);
+		__m128 dirZ = _mm_set1_ps(direction.z);
+
+		__m128 edge1X = _mm_loadu_ps(group.edge1[0]);
+		__m128 edge1Y = _mm_loadu_ps(group.edge1[1]);
+		__m128 edge1Z = _mm_loadu_ps(group.edge1[2]);
+
+		__m128 edge2X = _mm_loadu_ps(group.edge2[0]);
+		__m128 edge2Y = _mm_loadu_ps(group.edge2[1]);
+		__m128 edge2Z = _mm_loadu_ps(group.edge2[2]);
+
+		// p = direction x edge2
+		__m128 pX = _mm_sub_ps(_mm_mul_ps(dirY, edge2Z), _mm_mul_ps(dirZ, edge2Y));
+		__m128 pY = _mm_sub_ps(_mm_mul_ps(dirZ, edge2X), _mm_mul_ps(dirX, edge2Z));
+		__m128 pZ = _mm_sub_ps(_mm_mul_ps(dirX, edge2Y), _mm_mul_ps(dirY, edge2X));
+
+		__m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(edge1X, pX), _mm_mul_ps(edge1Y, pY)), _mm_mul_ps(edge1Z, pZ));
+		__m128 invDet = _mm_div_ps(one, det);
+
+		// t = origin - v0
+		__m128 tX = _mm_sub_ps(_mm_set1_ps(origin.x), _mm_loadu_ps(group.v0[0]));
+		__m128 tY = _mm_sub_ps(_mm_set1_ps(origin.y), _mm_loadu_ps(group.v0[1]));
+		__m128 tZ = _mm_sub_ps(_mm_set1_ps(origin.z), _mm_loadu_ps(group.v0[2]));
+
+		__m128 tDotP = _mm_add_ps(_mm_add_ps(_mm_mul_ps(tX, pX), _mm_mul_ps(tY, pY)), _mm_mul_ps(tZ, pZ));
+		__m128 u = _mm_mul_ps(tDotP, invDet);
+
+		// q = t x edge1
+		__m128 qX = _mm_sub_ps(_mm_mul_ps(tY, edge1Z), _mm_mul_ps(tZ, edge1Y));
+		__m128 qY = _mm_sub_ps(_mm_mul_ps(tZ, edge1X), _mm_mul_ps(tX, edge1Z));
+		__m128 qZ = _mm_sub_ps(_mm_mul_ps(tX, edge1Y), _mm_mul_ps(tY, edge1X));
+
+		__m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dirX, qX), _mm_mul_ps(dirY, qY)), _mm_mul_ps(dirZ, qZ)),
+			invDet);
+		__m128 distance = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(edge2X, qX), _mm_mul_ps(edge2Y, qY)),
+			_mm_mul_ps(edge2Z, qZ)), invDet);
+
+		__m128 mask = _mm_cmpgt_ps(_mm_andnot_ps(signMask, det), zero);
+		mask = _mm_and_ps(mask, _mm_cmpge_ps(u, zero));
+		mask = _mm_and_ps(mask, _mm_cmpge_ps(v, zero));
+		mask = _mm_and_ps(mask, _mm_cmple_ps(_mm_add_ps(u, v), one));
+		mask = _mm_and_ps(mask, _mm_cmpgt_ps(distance, zero));
+		mask = _mm_and_ps(mask, _mm_cmplt_ps(distance, _mm_set1_ps(maxDistance)));
+
+		_mm_storeu_ps(distances, distance);
+		_mm_storeu_ps(determinants, det);
+
+		return (UINT32)_mm_movemask_ps(mask);
+#else
+		UINT32 mask = 0;
+		for (UINT32 i = 0; i < TRIANGLES_PER_LEAF; i++)
+		{
+			Vector3 edge1(group.edge1[0][i], group.edge1[1][i], group.edge1[2][i]);
+			Vector3 edge2(group.edge2[0][i], group.edge2[1][i], group.edge2[2][i]);
+			Vector3 v0(group.v0[0][i], group.v0[1][i], group.v0[2][i]);
+
+			Vector3 p = direction.cross(edge2);
+			float det = edge1.dot(p);
+
+			determinants[i] = det;
+			distances[i] = 0.0f;
+
+			if (det == 0.0f)
+				continue;
+
+			float invDet = 1.0f / det;
+
+			Vector3 t = origin - v0;
+			float u = t.dot(p) * invDet;
+			if (u < 0.0f || u > 1.0f)
+				continue;
+
+			Vector3 q = t.cross(edge1);
+			float v = direction.dot(q) * invDet;
+			if (v < 0.0f || (u + v) > 1.0f)
+				continue;
+
+			float distance = edge2.dot(q) * invDet;
+			if (distance <= 0.0f || distance >= maxDistance)
+				continue;
+
+			distances[i] = distance;
+			mask |= 1 << i;
+		}
+
+		return mask;
+#endif
+	}
+
+	const float DynamicAABBTree::BOUNDS_MARGIN = 0.1f;
+	const float DynamicAABBTree::MIN_BOUNDS_MARGIN = 0.01f;
+
+	/** Returns the box enlarged by a margin proportional to its size, as stored in the tree. */
+	static AABox getEnlargedBounds(const AABox& bounds)
+	{
+		Vector3 size = bounds.getSize();
+		Vector3 margin(
+			std::max(size.x * DynamicAABBTree::BOUNDS_MARGIN, DynamicAABBTree::MIN_BOUNDS_MARGIN),
+			std::max(size.y * DynamicAABBTree::BOUNDS_MARGIN, DynamicAABBTree::MIN_BOUNDS_MARGIN),
+			std::max(size.z * DynamicAABBTree::BOUNDS_MARGIN, DynamicAABBTree::MIN_BOUNDS_MARGIN));
+
+		return AABox(bounds.getMin() - margin, bounds.getMax() + margin);
+	}
+
+	/** Returns half of the surface area of the box, used as the cost of the box when building the tree. */
+	static float getHalfArea(const AABox& bounds)
+	{
+		Vector3 size = bounds.getSize();
+		return size.x * size.y + size.y * size.z + size.z * size.x;
+	}
+
+	/** Returns the smallest box containing both of the provided boxes. */
+	static AABox mergeBounds(const AABox& a, const AABox& b)
+	{
+		AABox output = a;
+		output.merge(b);
+
+		return output;
+	}
+
+	/** Checks is the inner box fully contained within the outer box. */
+	static bool containsBounds(const AABox& outer, const AABox& inner)
+	{
+		const Vector3& outerMin = outer.getMin();
+		const Vector3& outerMax = outer.getMax();
+		const Vector3& innerMin = inner.getMin();
+		const Vector3& innerMax = inner.getMax();
+
+		return outerMin.x <= innerMin.x && outerMin.y <= innerMin.y && outerMin.z <= innerMin.z &&
+			innerMax.x <= outerMax.x && innerMax.y <= outerMax.y && innerMax.z <= outerMax.z;
+	}
+
+	UINT32 DynamicAABBTree::createProxy(const AABox& bounds, void* userData)
+	{
+		UINT32 proxy = allocateNode();
+
+		mNodes[proxy].bounds = getEnlargedBounds(bounds);
+		mNodes[proxy].userData = userData;
+		mNodes[proxy].height = 0;
+
+		insertLeaf(proxy);
+		return proxy;
+	}
+
+	void DynamicAABBTree::destroyProxy(UINT32 proxy)
+	{
+		assert(proxy < (UINT32)mNodes.size() && mNodes[proxy].isLeaf());
+
+		removeLeaf(proxy);
+		freeNode(proxy);
+	}
+
+	bool DynamicAABBTree::moveProxy(UINT32 proxy, const AABox& bounds)
+	{
+		assert(proxy < (UINT32)mNodes.size() && mNodes[proxy].isLeaf());
+
+		if (containsBounds(mNodes[proxy].bounds, bounds))
+			return false;
+
+		removeLeaf(proxy);
+
+		mNodes[proxy].bounds = getEnlargedBounds(bounds);
+
+		insertLeaf(proxy);
+		return true;
+	}
+
+	void DynamicAABBTree::query(const AABox& bounds, const QueryCallback& callback) const
+	{
+		if (mRoot == NULL_NODE)
+			return;
+
+		Vector<UINT32> stack;
+		stack.reserve(MAX_STACK_DEPTH);
+		stack.push_back(mRoot);
+
+		while (!stack.empty())
+		{
+			const Node& node = mNodes[stack.back()];
+			UINT32 nodeIdx = stack.back();
+			stack.pop_back();
+
+			if (!node.bounds.intersects(bounds))
+				continue;
+
+			if (node.isLeaf())
+				callback(nodeIdx);
+			else
+			{
+				stack.push_back(node.children[0]);
+				stack.push_back(node.children[1]);
+			}
+		}
+	}
+
+	void DynamicAABBTree::query(const ConvexVolume& volume, const QueryCallback& callback) const
+	{
+		if (mRoot == NULL_NODE)
+			return;
+
+		Vector<UINT32> stack;
+		stack.reserve(MAX_STACK_DEPTH);
+		stack.push_back(mRoot);
+
+		while (!stack.empty())
+		{
+			const Node& node = mNodes[stack.back()];
+			UINT32 nodeIdx = stack.back();
+			stack.pop_back();
+
+			if (!volume.intersects(node.bounds))
+				continue;
+
+			if (node.isLeaf())
+				callback(nodeIdx);
+			else
+			{
+				stack.push_back(node.children[0]);
+				stack.push_back(node.children[1]);
+			}
+		}
+	}
+
+	void DynamicAABBTree::rayCast(const Vector3& origin, const Vector3& direction, float maxDistance,
+		const RayCallback& callback) const
+	{
+		if (mRoot == NULL_NODE)
+			return;
+
+		Vector3 invDirection(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+
+		float rootDistance;
+		const AABox& rootBounds = mNodes[mRoot].bounds;
+		if (!intersectBox(rootBounds.getMin(), rootBounds.getMax(), origin, invDirection, maxDistance, rootDistance))
+			return;
+
+		// Tree isn't perfectly balanced, so unlike the static hierarchy the stack can't have a fixed size
+		Vector<StackEntry> stack;
+		stack.reserve(MAX_STACK_DEPTH);
+		stack.push_back({ mRoot, rootDistance });
+
+		float closest = maxDistance;
+		while (!stack.empty())
+		{
+			StackEntry entry = stack.back();
+			stack.pop_back();
+
+			if (entry.distance > closest)
+				continue;
+
+			const Node& node = mNodes[entry.node];
+			if (node.isLeaf())
+			{
+				closest = std::min(closest, callback(entry.node, entry.distance));
+				continue;
+			}
+
+			// Push the further child first, so the closer one is visited first and can cull the other one
+			float distances[2];
+			bool hits[2];
+			for (UINT32 i = 0; i < 2; i++)
+			{
+				const AABox& childBounds = mNodes[node.children[i]].bounds;
+				hits[i] = intersectBox(childBounds.getMin(), childBounds.getMax(), origin, invDirection, closest,
+					distances[i]);
+			}
+
+			UINT32 first = distances[0] <= distances[1] ? 1 : 0;
+			for (UINT32 i = 0; i < 2; i++)
+			{
+				UINT32 childIdx = i == 0 ? first : 1 - first;
+				if (hits[childIdx])
+					stack.push_back({ node.children[childIdx], distances[childIdx] });
+			}
+		}
+	}
+
+	UINT32 DynamicAABBTree::allocateNode()
+	{
+		if (mFreeList == NULL_NODE)
+		{
+			mNodes.push_back(Node());
+			return (UINT32)mNodes.size() - 1;
+		}
+
+		UINT32 node = mFreeList;
+		mFreeList = mNodes[node].parent;
+
+		mNodes[node] = Node();
+		return node;
+	}
+
+	void DynamicAABBTree::freeNode(UINT32 node)
+	{
+		mNodes[node].userData = nullptr;
+		mNodes[node].children[0] = NULL_NODE;
+		mNodes[node].children[1] = NULL_NODE;
+		mNodes[node].height = -1;
+		mNodes[node].parent = mFreeList;
+
+		mFreeList = node;
+	}
+
+	void DynamicAABBTree::insertLeaf(UINT32 leaf)
+	{
+		if (mRoot == NULL_NODE)
+		{
+			mRoot = leaf;
+			mNodes[leaf].parent = NULL_NODE;
+
+			return;
+		}
+
+		// Descend towards the sibling that results in the smallest increase of the total surface area
+		AABox leafBounds = mNodes[leaf].bounds;
+		UINT32 sibling = mRoot;
+		while (!mNodes[sibling].isLeaf())
+		{
+			const Node& node = mNodes[sibling];
+
+			float area = getHalfArea(node.bounds);
+			float combinedArea = getHalfArea(mergeBounds(node.bounds, leafBounds));
+
+			// Cost of creating a new parent for this node and the leaf
+			float cost = 2.0f * combinedArea;
+
+			// Minimum cost of pushing the leaf further down, as all the parents grow by this much
+			float inheritanceCost = 2.0f * (combinedArea - area);
+
+			float childCosts[2];
+			for (UINT32 i = 0; i < 2; i++)
+			{
+				const Node& child = mNodes[node.children[i]];
+				float newArea = getHalfArea(mergeBounds(child.bounds, leafBounds));
+
+				if (child.isLeaf())
+					childCosts[i] = newArea + inheritanceCost;
+				else
+					childCosts[i] = (newArea - getHalfArea(child.bounds)) + inheritanceCost;
+			}
+
+			if (cost < childCosts[0] && cost < childCosts[1])
+				break;
+
+			sibling = childCosts[0] < childCosts[1] ? node.children[0] : node.children[1];
+		}
+
+		// Note: Allocation can resize the node array, so nodes must not be referenced across it
+		UINT32 oldParent = mNodes[sibling].parent;
+		UINT32 newParent = allocateNode();
+
+		mNodes[newParent].parent = oldParent;
+		mNodes[newParent].bounds = mergeBounds(leafBounds, mNodes[sibling].bounds);
+		mNodes[newParent].height = mNodes[sibling].height + 1;
+		mNodes[newParent].children[0] = sibling;
+		mNodes[newParent].children[1] = leaf;
+
+		mNodes[sibling].parent = newParent;
+		mNodes[leaf].parent = newParent;
+
+		if (oldParent == NULL_NODE)
+			mRoot = newParent;
+		else
+		{
+			Node& parent = mNodes[oldParent];
+			if (parent.children[0] == sibling)
+				parent.children[0] = newParent;
+			else
+				parent.children[1] = newParent;
+		}
+
+		refit(mNodes[leaf].parent);
+	}
+
+	void DynamicAABBTree::removeLeaf(UINT32 leaf)
+	{
+		if (leaf == mRoot)
+		{
+			mRoot = NULL_NODE;
+			return;
+		}
+
+		UINT32 parent = mNodes[leaf].parent;
+		UINT32 grandParent = mNodes[parent].parent;
+		UINT32 sibling = mNodes[parent].children[0] == leaf ? mNodes[parent].children[1] : mNodes[parent].children[0];
+
+		freeNode(parent);
+
+		if (grandParent == NULL_NODE)
+		{
+			mRoot = sibling;
+			mNodes[sibling].parent = NULL_NODE;
+
+			return;
+		}
+
+		Node& grandParentNode = mNodes[grandParent];
+		if (grandParentNode.children[0] == parent)
+			grandParentNode.children[0] = sibling;
+		else
+			grandParentNode.children[1] = sibling;
+
+		mNodes[sibling].parent = grandParent;
+
+		refit(grandParent);
+	}
+
+	void DynamicAABBTree::refit(UINT32 node)
+	{
+		while (node != NULL_NODE)
+		{
+			node = balance(node);
+
+			Node& current = mNodes[node];
+			const Node& child0 = mNodes[current.children[0]];
+			const Node& child1 = mNodes[current.children[1]];
+
+			current.height = 1 + std::max(child0.height, child1.height);
+			current.bounds = mergeBounds(child0.bounds, child1.bounds);
+
+			node = current.parent;
+		}
+	}
+
+	UINT32 DynamicAABBTree::balance(UINT32 a)
+	{
+		Node& nodeA = mNodes[a];
+		if (nodeA.isLeaf() || nodeA.height < 2)
+			return a;
+
+		UINT32 b = nodeA.children[0];
+		UINT32 c = nodeA.children[1];
+		INT32 heightDiff = mNodes[c].height - mNodes[b].height;
+
+		if (heightDiff > 1)
+		{
+			// C is too deep, rotate it up
+			UINT32 f = mNodes[c].children[0];
+			UINT32 g = mNodes[c].children[1];
+
+			Node& nodeC = mNodes[c];
+			nodeC.children[0] = a;
+			nodeC.parent = nodeA.parent;
+			nodeA.parent = c;
+
+			if (nodeC.parent == NULL_NODE)
+				mRoot = c;
+			else
+			{
+				Node& parent = mNodes[nodeC.parent];
+				if (parent.children[0] == a)
+					parent.children[0] = c;
+				else
+					parent.children[1] = c;
+			}
+
+			// Keep the deeper of C's children under C, and move the other one to A
+			UINT32 kept = mNodes[f].height > mNodes[g].height ? f : g;
+			UINT32 moved = kept == f ? g : f;
+
+			nodeC.children[1] = kept;
+			nodeA.children[1] = moved;
+			mNodes[moved].parent = a;
+
+			nodeA.bounds = mergeBounds(mNodes[b].bounds, mNodes[moved].bounds);
+			nodeA.height = 1 + std::max(mNodes[b].height, mNodes[moved].height);
+
+			nodeC.bounds = mergeBounds(nodeA.bounds, mNodes[kept].bounds);
+			nodeC.height = 1 + std::max(nodeA.height, mNodes[kept].height);
+
+			return c;
+		}
+
+		if (heightDiff < -1)
+		{
+			// B is too deep, rotate it up
+			UINT32 d = mNodes[b].children[0];
+			UINT32 e = mNodes[b].children[1];
+
+			Node& nodeB = mNodes[b];
+			nodeB.children[0] = a;
+			nodeB.parent = nodeA.parent;
+			nodeA.parent = b;
+
+			if (nodeB.parent == NULL_NODE)
+				mRoot = b;
+			else
+			{
+				Node& parent = mNodes[nodeB.parent];
+				if (parent.children[0] == a)
+					parent.children[0] = b;
+				else
+					parent.children[1] = b;
+			}
+
+			// Keep the deeper of B's children under B, and move the other one to A
+			UINT32 kept = mNodes[d].height > mNodes[e].height ? d : e;
+			UINT32 moved = kept == d ? e : d;
+
+			nodeB.children[1] = kept;
+			nodeA.children[0] = moved;
+			mNodes[moved].parent = a;
+
+			nodeA.bounds = mergeBounds(mNodes[c].bounds, mNodes[moved].bounds);
+			nodeA.height = 1 + std::max(mNodes[c].height, mNodes[moved].height);
+
+			nodeB.bounds = mergeBounds(nodeA.bounds, mNodes[kept].bounds);
+			nodeB.height = 1 + std::max(nodeA.height, mNodes[kept].height);
+
+			return b;
+		}
+
+		return a;
+	}
+
+	bool DynamicAABBTree::intersectBox(const Vector3& min, const Vector3& max, const Vector3& origin,
+		const Vector3& invDirection, float maxDistance, float& distance)
+	{
+		float entry = -std::numeric_limits<float>::infinity();
+		float exit = std::numeric_limits<float>::infinity();
+
+		for (UINT32 i = 0; i < 3; i++)
+		{
+			float t0 = (min[i] - origin[i]) * invDirection[i];
+			float t1 = (max[i] - origin[i]) * invDirection[i];
+
+			entry = std::max(entry, std::min(t0, t1));
+			exit = std::min(exit, std::max(t0, t1));
+		}
+
+		entry = std::max(entry, 0.0f);
+		if (exit < entry || entry > maxDistance)
+		{
+			distance = 0.0f;
+			return false;
+		}
+
+		distance = entry;
+		return true;
+	}
+}
@@ -25,6 +25,9 @@
 #include "Renderer/BsRenderer.h"
 #include "Scene/BsGizmoManager.h"
 #include "Renderer/BsRendererUtility.h"
+#include "Math/BsRay.h"
+#include "Math/BsPlane.h"
+#include "Utility/BsTime.h"
 
 using namespace std::placeholders;
 
@@ -54,117 +57,195 @@ namespace bs
 	HSceneObject ScenePicking::pickClosestObject(const SPtr<Camera>& cam, const Vector2I& position, const Vector2I& area, 
 		Vector<HSceneObject>& ignoreRenderables, SnapData* data)
 	{
-		Vector<HSceneObject> selectedObjects = pickObjects(cam, position, area, ignoreRenderables, data);
-		if (selectedObjects.size() == 0)
+		HSceneObject closestObject;
+
+		// Picks of the exact position under the pointer can usually be resolved without rendering, or waiting for
+		// the GPU
+		bool resolved = false;
+		if (area.x == 1 && area.y == 1)
+			resolved = pickClosestObjectCPU(cam, position, ignoreRenderables, closestObject, data);
+
+		if (!resolved)
+		{
+			Vector<HSceneObject> selectedObjects = pickObjects(cam, position, area, ignoreRenderables, data);
+			if (selectedObjects.size() > 0)
+				closestObject = selectedObjects[0];
+		}
+
+		if (!closestObject)
 			return HSceneObject();
 			
 		if (data != nullptr)
 		{
 			Matrix3 rotation;
-			selectedObjects[0]->getTransform().getRotation().toRotationMatrix(rotation);
+			closestObject->getTransform().getRotation().toRotationMatrix(rotation);
 			data->normal = rotation.inverse().transpose().multiply(data->normal);
 		}
 		
-		return selectedObjects[0];
+		return closestObject;
 	}
 
-	Vector<HSceneObject> ScenePicking::pickObjects(const SPtr<Camera>& cam, const Vector2I& position, const Vector2I& area, 
-		Vector<HSceneObject>& ignoreRenderables, SnapData* data)
+	bool ScenePicking::pickClosestObjectCPU(const SPtr<Camera>& cam, const Vector2I& position, 
+		const Vector<HSceneObject>& ignoreRenderables, HSceneObject& object, SnapData* data)
 	{
-		auto comparePickElement = [&] (const ScenePicking::RenderablePickData& a, const ScenePicking::RenderablePickData& b)
+		// Gizmos can only be resolved by rendering them
+		if (GizmoManager::instance().isPickableGizmoAt(cam, position))
+			return false;
+
+		syncDrawList();
+
+		Ray ray = cam->screenPointToRay(position);
+
+		// Ray starts at the near plane and is limited to the far plane, so everything it hits is in the frustum. Rays
+		// away from the view center travel further than the distance between the planes before reaching the far plane.
+		float clipRange = cam->getFarClipDistance() - cam->getNearClipDistance();
+		float closest = clipRange / ray.getDirection().dot(cam->getTransform().getForward());
+		MeshBVH::Hit closestHit;
+
+		// Nearest distance at which something was hit that can't be resolved on the CPU
+		float unresolved = std::numeric_limits<float>::infinity();
+
+		const PickEntry* closestEntry = nullptr;
+		mSceneTree.rayCast(ray.getOrigin(), ray.getDirection(), closest, [&](UINT32 proxy, float distance)
 		{
-			// Sort by alpha setting first, then by cull mode, then by index
-			if (a.alpha == b.alpha)
+			// Gizmos were already checked above
+			const QueryEntry& entry = getQueryEntry(proxy);
+			if (entry.gizmo)
+				return closest;
+
+			auto iterFind = std::find(ignoreRenderables.begin(), ignoreRenderables.end(), entry.sceneObject);
+			if (iterFind != ignoreRenderables.end())
+				return closest;
+
+			const PickEntry& candidate = static_cast<const PickEntry&>(entry);
+
+			SPtr<MeshBVH> bvh = getMeshBVH(candidate.mesh);
+			if (bvh == nullptr)
 			{
-				if (a.cullMode == b.cullMode)
-					return a.index > b.index;
-				else
-					return (UINT32)a.cullMode > (UINT32)b.cullMode;
+				unresolved = std::min(unresolved, distance);
+				return closest;
 			}
-			else
-				return (UINT32)a.alpha > (UINT32)b.alpha;
-		};
 
-		Matrix4 viewProjMatrix = cam->getProjectionMatrixRS() * cam->getViewMatrix();
+			// Direction isn't normalized after the transform, so distances remain in world space
+			Matrix4 invWorldTransform = candidate.worldTransform.inverseAffine();
+			Vector3 localOrigin = invWorldTransform.multiplyAffine(ray.getOrigin());
+			Vector3 localDirection = invWorldTransform.multiplyDirection(ray.getDirection());
 
-		Vector<HRenderable> renderables = gSceneManager().findComponents<CRenderable>(true);
-		RenderableSet pickData(comparePickElement);
-		Map<UINT32, HSceneObject> idxToRenderable;
+			MeshBVH::Hit hit;
+			if (!bvh->intersect(localOrigin, localDirection, candidate.cullModes, closest, hit))
+				return closest;
 
-		for (auto& renderable : renderables)
+			// Whether an alpha-tested surface is hit depends on its texture, which is only known to the GPU
+			if (hit.subMesh < (UINT32)candidate.alpha.size() && candidate.alpha[hit.subMesh])
+			{
+				unresolved = std::min(unresolved, hit.distance);
+				return closest;
+			}
+
+			closest = hit.distance;
+			closestEntry = &candidate;
+			closestHit = hit;
+
+			return closest;
+		});
+
+		if (unresolved < closest)
+			return false;
+
+		if (closestEntry == nullptr)
 		{
-			HSceneObject so = renderable->SO();
+			object = HSceneObject();
+			return true;
+		}
 
-			HMesh mesh = renderable->getMesh();
-			if (!mesh.isLoaded())
-				continue;
+		object = closestEntry->sceneObject;
+
+		if (data != nullptr)
+		{
+			data->pickPosition = ray.getPoint(closest);
+			data->normal = closestHit.normal;
+		}
+
+		return true;
+	}
+
+	SPtr<MeshBVH> ScenePicking::getMeshBVH(const HMesh& mesh)
+	{
+		MeshPickData& pickData = mMeshPickData[mesh->getInternalID()];
+
+		if (pickData.bvh != nullptr || pickData.unsupported)
+			return pickData.bvh;
 
-			bool found = false;
-			for (UINT32 i = 0; i < (UINT32)ignoreRenderables.size(); i++)
+		// Meshes that keep a CPU copy of their data can be used immediately, others need to be read from the GPU once
+		SPtr<MeshData> meshData = mesh->getCachedData();
+		if (meshData == nullptr)
+		{
+			if (!pickData.readbackPending)
 			{
-				if (ignoreRenderables[i] == so)
-				{
-					found = true;
-					break;
-				}
+				pickData.readbackData = mesh->allocBuffer();
+				pickData.readbackOp = mesh->readData(pickData.readbackData);
+				pickData.readbackPending = true;
+
+				return nullptr;
 			}
-			
-			if (found)
-				continue;
 
-			Bounds worldBounds = mesh->getProperties().getBounds();
-			Matrix4 worldTransform = so->getWorldMatrix();
-			worldBounds.transformAffine(worldTransform);
+			if (!pickData.readbackOp.hasCompleted())
+				return nullptr;
+
+			meshData = pickData.readbackData;
+
+			pickData.readbackData = nullptr;
+			pickData.readbackPending = false;
+		}
+
+		const MeshProperties& meshProps = mesh->getProperties();
+
+		Vector<SubMesh> subMeshes;
+		for (UINT32 i = 0; i < meshProps.getNumSubMeshes(); i++)
+			subMeshes.push_back(meshProps.getSubMesh(i));
+
+		pickData.bvh = MeshBVH::create(meshData, subMeshes);
+		pickData.unsupported = pickData.bvh == nullptr;
 
-			const ConvexVolume& frustum = cam->getWorldFrustum();
-			if (frustum.intersects(worldBounds.getSphere()))
+		return pickData.bvh;
+	}
+
+	void ScenePicking::getPickingMaterialInfo(const HMaterial& material, bool& alpha, CullingMode& cullMode)
+	{
+		alpha = false;
+		SPtr<RasterizerState> rasterizerState = RasterizerState::getDefault();
+
+		if (material != nullptr && material->getNumPasses() > 0)
+		{
+			SPtr<Pass> firstPass = material->getPass(0); // Note: We only ever check the first pass, problem?
+			const auto& pipelineState = firstPass->getGraphicsPipelineState();
+			if(pipelineState)
 			{
-				// More precise with the box
-				if (frustum.intersects(worldBounds.getBox()))
-				{
-					for (UINT32 i = 0; i < mesh->getProperties().getNumSubMeshes(); i++)
-					{
-						UINT32 idx = (UINT32)pickData.size();
-
-						bool useAlphaShader = false;
-						SPtr<RasterizerState> rasterizerState = RasterizerState::getDefault();
-
-						HMaterial originalMat = renderable->getMaterial(i);
-						if (originalMat != nullptr && originalMat->getNumPasses() > 0)
-						{
-							SPtr<Pass> firstPass = originalMat->getPass(0); // Note: We only ever check the first pass, problem?
-							const auto& pipelineState = firstPass->getGraphicsPipelineState();
-							if(pipelineState)
-							{
-								useAlphaShader = firstPass->hasBlending();
-
-								if (pipelineState->getRasterizerState() == nullptr)
-									rasterizerState = RasterizerState::getDefault();
-								else
-									rasterizerState = pipelineState->getRasterizerState();
-							}
-						}
-
-						CullingMode cullMode = rasterizerState->getProperties().getCullMode();
-
-						HTexture mainTexture;
-						if (useAlphaShader)
-							mainTexture = originalMat->getTexture("gAlbedoTex");
-
-						idxToRenderable[idx] = so;
-
-						Matrix4 wvpTransform = viewProjMatrix * worldTransform;
-						pickData.insert({ mesh->getCore(), idx, wvpTransform, useAlphaShader, cullMode, mainTexture });
-					}
-				}
+				alpha = firstPass->hasBlending();
+
+				if (pipelineState->getRasterizerState() == nullptr)
+					rasterizerState = RasterizerState::getDefault();
+				else
+					rasterizerState = pipelineState->getRasterizerState();
 			}
 		}
 
-		UINT32 firstGizmoIdx = (UINT32)pickData.size();
+		cullMode = rasterizerState->getProperties().getCullMode();
+	}
+
+	Vector<HSceneObject> ScenePicking::pickObjects(const SPtr<Camera>& cam, const Vector2I& position,
+		const Vector2I& area, Vector<HSceneObject>& ignoreRenderables, SnapData* data)
+	{
+		syncDrawList();
+
+		Matrix4 viewProjMatrix = cam->getProjectionMatrixRS() * cam->getViewMatrix();
+		Vector<UINT32> ignoredIndices = getIgnoredIndices(ignoreRenderables);
+
+		UINT32 firstGizmoIdx = (UINT32)mIndexObjects.size();
 
 		SPtr<ct::RenderTarget> target = cam->getViewport()->getTarget()->getCore();
 		gCoreThread().queueCommand(std::bind(&ct::ScenePicking::corePickingBegin, mCore, target,
-			cam->getViewport()->getArea(), std::cref(pickData), position, area));
+			cam->getViewport()->getArea(), viewProjMatrix, cam->getWorldFrustum(), ignoredIndices, position, area));
 
 		GizmoManager::instance().renderForPicking(cam, [&](UINT32 inputIdx) { return encodeIndex(firstGizmoIdx + inputIdx); });
 
@@ -188,10 +269,9 @@ namespace bs
 		{
 			if (selectedObjectIdx < firstGizmoIdx)
 			{
-				auto iterFind = idxToRenderable.find(selectedObjectIdx);
-
-				if (iterFind != idxToRenderable.end())
-					results.push_back(iterFind->second);
+				HSceneObject so = mIndexObjects[selectedObjectIdx];
+				if (so)
+					results.push_back(so);
 			}
 			else
 			{
@@ -206,6 +286,572 @@ namespace bs
 		return results;
 	}
 
+	SPtr<ScenePickingOp> ScenePicking::pickObjectsAsync(const SPtr<Camera>& cam, const Vector2I& position, 
+		const Vector2I& area, const Vector<HSceneObject>& ignoreRenderables, bool gatherSnapData)
+	{
+		SPtr<ScenePickingOp> op = bs_shared_ptr_new<ScenePickingOp>();
+		op->mCamera = cam;
+		op->mPosition = position;
+		op->mArea = area;
+		op->mGatherSnapData = gatherSnapData;
+		op->mIgnoreRenderables = ignoreRenderables;
+
+		// If all the buffers are busy the operation is started by update(), once one of them frees up
+		for (UINT32 i = 0; i < NUM_ASYNC_BUFFERS; i++)
+		{
+			if (!mBufferInUse[i])
+			{
+				startAsyncPick(*op, i);
+				break;
+			}
+		}
+
+		mAsyncOps.push_back(op);
+		return op;
+	}
+
+	SPtr<ScenePickingOp> ScenePicking::pickClosestObjectAsync(const SPtr<Camera>& cam, const Vector2I& position, 
+		const Vector<HSceneObject>& ignoreRenderables, bool gatherSnapData)
+	{
+		HSceneObject closestObject;
+		SnapData snapData;
+
+		if (pickClosestObjectCPU(cam, position, ignoreRenderables, closestObject, gatherSnapData ? &snapData : nullptr))
+		{
+			SPtr<ScenePickingOp> op = bs_shared_ptr_new<ScenePickingOp>();
+			op->mCamera = cam;
+			op->mPosition = position;
+			op->mArea = Vector2I(1, 1);
+			op->mGatherSnapData = gatherSnapData;
+
+			if (closestObject)
+			{
+				op->mObjects.push_back(closestObject);
+
+				if (gatherSnapData)
+				{
+					Matrix3 rotation;
+					closestObject->getTransform().getRotation().toRotationMatrix(rotation);
+					snapData.normal = rotation.inverse().transpose().multiply(snapData.normal);
+
+					op->mSnapData = snapData;
+				}
+			}
+
+			op->mCompleted = true;
+			return op;
+		}
+
+		return pickObjectsAsync(cam, position, Vector2I(1, 1), ignoreRenderables, gatherSnapData);
+	}
+
+	void ScenePicking::update()
+	{
+		UINT64 frameIdx = gTime().getFrameIdx();
+
+		for (auto iter = mAsyncOps.begin(); iter != mAsyncOps.end();)
+		{
+			ScenePickingOp& op = **iter;
+
+			if (!op.mStarted)
+			{
+				++iter;
+				continue;
+			}
+
+			if (!op.mReadbackQueued)
+			{
+				// Give the GPU a frame to finish rendering before reading back the results, so the read doesn't stall
+				if (frameIdx > op.mFrameIdx)
+				{
+					op.mAsyncOp = gCoreThread().queueReturnCommand(std::bind(&ct::ScenePicking::coreReadPickingResults,
+						mCore, op.mBufferIdx, op.mPosition, op.mArea, op.mGatherSnapData, _1));
+
+					op.mReadbackQueued = true;
+				}
+
+				++iter;
+				continue;
+			}
+
+			if (!op.mAsyncOp.hasCompleted())
+			{
+				++iter;
+				continue;
+			}
+
+			resolveAsyncPick(op, op.mAsyncOp.getReturnValue<PickResults>());
+			mBufferInUse[op.mBufferIdx] = false;
+
+			iter = mAsyncOps.erase(iter);
+		}
+
+		// Start the operations that were waiting for a free buffer, in the order they were requested in
+		for (auto& op : mAsyncOps)
+		{
+			if (op->mStarted)
+				continue;
+
+			UINT32 bufferIdx = NUM_ASYNC_BUFFERS;
+			for (UINT32 i = 0; i < NUM_ASYNC_BUFFERS; i++)
+			{
+				if (!mBufferInUse[i])
+				{
+					bufferIdx = i;
+					break;
+				}
+			}
+
+			if (bufferIdx == NUM_ASYNC_BUFFERS)
+				break;
+
+			startAsyncPick(*op, bufferIdx);
+		}
+	}
+
+	void ScenePicking::startAsyncPick(ScenePickingOp& op, UINT32 bufferIdx)
+	{
+		const SPtr<Camera>& cam = op.mCamera;
+
+		syncDrawList();
+
+		Matrix4 viewProjMatrix = cam->getProjectionMatrixRS() * cam->getViewMatrix();
+		Vector<UINT32> ignoredIndices = getIgnoredIndices(op.mIgnoreRenderables);
+
+		UINT32 firstGizmoIdx = (UINT32)mIndexObjects.size();
+
+		SPtr<ct::RenderTarget> target = cam->getViewport()->getTarget()->getCore();
+		gCoreThread().queueCommand(std::bind(&ct::ScenePicking::corePickingBeginAsync, mCore, bufferIdx, target,
+			cam->getViewport()->getArea(), viewProjMatrix, cam->getWorldFrustum(), ignoredIndices, op.mPosition, 
+			op.mArea));
+
+		// Gizmos are rebuilt every frame, so their objects must be recorded now rather than once the results arrive
+		GizmoManager& gizmoManager = GizmoManager::instance();
+		GizmoManager::instance().renderForPicking(cam, [&](UINT32 inputIdx)
+		{
+			op.mGizmoObjects[firstGizmoIdx + inputIdx] = gizmoManager.getSceneObject(inputIdx);
+			return encodeIndex(firstGizmoIdx + inputIdx);
+		});
+
+		gCoreThread().queueCommand(std::bind(&ct::ScenePicking::corePickingEndAsync, mCore));
+
+		op.mIgnoreRenderables.clear();
+		op.mFirstGizmoIdx = firstGizmoIdx;
+		op.mBufferIdx = bufferIdx;
+		op.mFrameIdx = gTime().getFrameIdx();
+		op.mStarted = true;
+
+		mBufferInUse[bufferIdx] = true;
+	}
+
+	void ScenePicking::resolveAsyncPick(ScenePickingOp& op, const PickResults& results)
+	{
+		// Indices of renderables removed since the operation started aren't reused until all async operations complete,
+		// so they still map to the same objects
+		for (auto& selectedObjectIdx : results.objects)
+		{
+			if (selectedObjectIdx < op.mFirstGizmoIdx)
+			{
+				HSceneObject so = mIndexObjects[selectedObjectIdx];
+				if (so)
+					op.mObjects.push_back(so);
+			}
+			else
+			{
+				auto iterFind = op.mGizmoObjects.find(selectedObjectIdx);
+				if (iterFind != op.mGizmoObjects.end() && iterFind->second)
+					op.mObjects.push_back(iterFind->second);
+			}
+		}
+
+		if (op.mGatherSnapData)
+		{
+			// Note: The position is reconstructed using the current camera transform, which might have changed since
+			// the operation started
+			op.mSnapData.pickPosition = op.mCamera->screenToWorldPointDeviceDepth(op.mPosition, results.depth);
+			op.mSnapData.normal = results.normal;
+
+			if (!op.mObjects.empty())
+			{
+				Matrix3 rotation;
+				op.mObjects[0]->getTransform().getRotation().toRotationMatrix(rotation);
+				op.mSnapData.normal = rotation.inverse().transpose().multiply(op.mSnapData.normal);
+			}
+		}
+
+		op.mGizmoObjects.clear();
+		op.mCamera = nullptr;
+		op.mCompleted = true;
+	}
+
+	void ScenePicking::syncDrawList()
+	{
+		UINT64 frameIdx = gTime().getFrameIdx();
+		if (mDrawListFrameIdx == frameIdx)
+			return;
+
+		mDrawListFrameIdx = frameIdx;
+
+		// Freed indices can be reused once no async operation rendered before they were freed is still in flight
+		UINT64 oldestStartedFrame = frameIdx;
+		for (auto& op : mAsyncOps)
+		{
+			if (op->mStarted)
+				oldestStartedFrame = std::min(oldestStartedFrame, op->mFrameIdx);
+		}
+
+		for (auto iter = mPendingFreeIndices.begin(); iter != mPendingFreeIndices.end();)
+		{
+			if (iter->second > oldestStartedFrame)
+			{
+				++iter;
+				continue;
+			}
+
+			mIndexObjects[iter->first] = HSceneObject();
+			mFreeIndices.push_back(iter->first);
+
+			iter = mPendingFreeIndices.erase(iter);
+		}
+
+		Vector<RenderablePickData> updated;
+		Vector<UINT32> removed;
+		bool meshesChanged = false;
+
+		Vector<HRenderable> renderables = gSceneManager().findComponents<CRenderable>(true);
+		for (auto& renderable : renderables)
+		{
+			HMesh mesh = renderable->getMesh();
+			if (!mesh.isLoaded())
+				continue;
+
+			auto iterFind = mPickEntries.find(renderable.getInstanceId());
+			bool isNew = iterFind == mPickEntries.end();
+
+			PickEntry& entry = isNew ? mPickEntries[renderable.getInstanceId()] : iterFind->second;
+			entry.lastSynced = frameIdx;
+
+			HSceneObject so = renderable->SO();
+			const Matrix4& worldTransform = so->getWorldMatrix();
+			UINT32 numSubMeshes = mesh->getProperties().getNumSubMeshes();
+
+			bool meshChanged = isNew || !(entry.mesh == mesh) || (UINT32)entry.indices.size() != numSubMeshes;
+			bool materialsChanged = meshChanged;
+			for (UINT32 i = 0; !materialsChanged && i < numSubMeshes; i++)
+			{
+				HMaterial material = renderable->getMaterial(i);
+				HShader shader = material.isLoaded() ? material->getShader() : HShader();
+
+				materialsChanged = !(entry.materials[i] == material) || !(entry.shaders[i] == shader);
+
+				// Alpha tested sub-meshes are picked using their texture, so they also change along with it
+				if (!materialsChanged && entry.alpha[i])
+					materialsChanged = !(entry.textures[i] == material->getTexture("gAlbedoTex"));
+			}
+
+			if (!materialsChanged && entry.worldTransform == worldTransform)
+				continue;
+
+			meshesChanged |= meshChanged;
+
+			entry.sceneObject = so;
+			entry.mesh = mesh;
+			entry.worldTransform = worldTransform;
+			entry.worldBounds = mesh->getProperties().getBounds();
+			entry.worldBounds.transformAffine(worldTransform);
+			entry.bounds = entry.worldBounds.getBox();
+
+			updateQueryEntry(entry);
+
+			if (materialsChanged)
+			{
+				while ((UINT32)entry.indices.size() > numSubMeshes)
+				{
+					removed.push_back(entry.indices.back());
+					mPendingFreeIndices.push_back(std::make_pair(entry.indices.back(), frameIdx));
+					entry.indices.pop_back();
+				}
+
+				while ((UINT32)entry.indices.size() < numSubMeshes)
+				{
+					UINT32 index = allocatePickIndex();
+					mIndexObjects[index] = so;
+
+					entry.indices.push_back(index);
+				}
+
+				entry.materials.resize(numSubMeshes);
+				entry.shaders.resize(numSubMeshes);
+				entry.textures.resize(numSubMeshes);
+				entry.cullModes.resize(numSubMeshes);
+				entry.alpha.resize(numSubMeshes);
+
+				for (UINT32 i = 0; i < numSubMeshes; i++)
+				{
+					HMaterial material = renderable->getMaterial(i);
+
+					bool alpha;
+					getPickingMaterialInfo(material, alpha, entry.cullModes[i]);
+
+					entry.materials[i] = material;
+					entry.shaders[i] = material.isLoaded() ? material->getShader() : HShader();
+					entry.textures[i] = alpha ? material->getTexture("gAlbedoTex") : HTexture();
+					entry.alpha[i] = alpha;
+				}
+			}
+
+			for (UINT32 i = 0; i < numSubMeshes; i++)
+			{
+				updated.push_back({ mesh->getCore(), i, entry.indices[i], worldTransform, entry.worldBounds, 
+					entry.alpha[i], entry.cullModes[i], entry.textures[i] });
+			}
+		}
+
+		// Renderables not found in the scene, or whose mesh got unloaded, were removed
+		for (auto iter = mPickEntries.begin(); iter != mPickEntries.end();)
+		{
+			if (iter->second.lastSynced == frameIdx)
+			{
+				++iter;
+				continue;
+			}
+
+			for (auto& index : iter->second.indices)
+			{
+				removed.push_back(index);
+				mPendingFreeIndices.push_back(std::make_pair(index, frameIdx));
+			}
+
+			mSceneTree.destroyProxy(iter->second.proxy);
+
+			iter = mPickEntries.erase(iter);
+			meshesChanged = true;
+		}
+
+		// Release the CPU picking data of meshes no longer in the scene
+		if (meshesChanged)
+		{
+			UnorderedSet<UINT64> usedMeshes;
+			for (auto& entry : mPickEntries)
+				usedMeshes.insert(entry.second.mesh->getInternalID());
+
+			for (auto iter = mMeshPickData.begin(); iter != mMeshPickData.end();)
+			{
+				if (usedMeshes.find(iter->first) == usedMeshes.end())
+					iter = mMeshPickData.erase(iter);
+				else
+					++iter;
+			}
+		}
+
+		syncGizmos(frameIdx);
+
+		if (updated.empty() && removed.empty())
+			return;
+
+		gCoreThread().queueCommand(std::bind(&ct::ScenePicking::updateDrawList, mCore, updated, removed));
+	}
+
+	void ScenePicking::syncGizmos(UINT64 frameIdx)
+	{
+		Vector<std::pair<HSceneObject, AABox>> gizmoBounds = GizmoManager::instance().getPickableBounds();
+		for (auto& gizmo : gizmoBounds)
+		{
+			QueryEntry& entry = mGizmoEntries[gizmo.first.getInstanceId()];
+			entry.sceneObject = gizmo.first;
+			entry.bounds = gizmo.second;
+			entry.gizmo = true;
+			entry.lastSynced = frameIdx;
+
+			updateQueryEntry(entry);
+		}
+
+		for (auto iter = mGizmoEntries.begin(); iter != mGizmoEntries.end();)
+		{
+			if (iter->second.lastSynced == frameIdx)
+			{
+				++iter;
+				continue;
+			}
+
+			mSceneTree.destroyProxy(iter->second.proxy);
+			iter = mGizmoEntries.erase(iter);
+		}
+	}
+
+	void ScenePicking::updateQueryEntry(QueryEntry& entry)
+	{
+		if (entry.proxy == DynamicAABBTree::NULL_NODE)
+			entry.proxy = mSceneTree.createProxy(entry.bounds, &entry);
+		else
+			mSceneTree.moveProxy(entry.proxy, entry.bounds);
+	}
+
+	Vector<HSceneObject> ScenePicking::queryRay(const Ray& ray, float maxDistance)
+	{
+		syncDrawList();
+
+		Vector3 invDirection(1.0f / ray.getDirection().x, 1.0f / ray.getDirection().y, 1.0f / ray.getDirection().z);
+
+		Vector<std::pair<float, HSceneObject>> hits;
+		mSceneTree.rayCast(ray.getOrigin(), ray.getDirection(), maxDistance, [&](UINT32 proxy, float distance)
+		{
+			const QueryEntry& entry = getQueryEntry(proxy);
+
+			float exactDistance;
+			if (DynamicAABBTree::intersectBox(entry.bounds.getMin(), entry.bounds.getMax(), ray.getOrigin(),
+				invDirection, maxDistance, exactDistance))
+			{
+				hits.push_back(std::make_pair(exactDistance, entry.sceneObject));
+			}
+
+			return maxDistance;
+		});
+
+		std::sort(hits.begin(), hits.end(), 
+			[](const std::pair<float, HSceneObject>& a, const std::pair<float, HSceneObject>& b)
+		{
+			return a.first < b.first;
+		});
+
+		// Objects can have both renderables and gizmos, only report them once, at the closest distance
+		UnorderedSet<UINT64> found;
+		Vector<HSceneObject> output;
+		for (auto& hit : hits)
+		{
+			if (found.insert(hit.second.getInstanceId()).second)
+				output.push_back(hit.second);
+		}
+
+		return output;
+	}
+
+	Vector<HSceneObject> ScenePicking::queryBox(const AABox& bounds)
+	{
+		syncDrawList();
+
+		UnorderedSet<UINT64> found;
+		Vector<HSceneObject> output;
+		mSceneTree.query(bounds, [&](UINT32 proxy)
+		{
+			const QueryEntry& entry = getQueryEntry(proxy);
+			if (!entry.bounds.intersects(bounds))
+				return;
+
+			if (found.insert(entry.sceneObject.getInstanceId()).second)
+				output.push_back(entry.sceneObject);
+		});
+
+		return output;
+	}
+
+	Vector<HSceneObject> ScenePicking::queryFrustum(const ConvexVolume& volume)
+	{
+		syncDrawList();
+
+		UnorderedSet<UINT64> found;
+		Vector<HSceneObject> output;
+		mSceneTree.query(volume, [&](UINT32 proxy)
+		{
+			const QueryEntry& entry = getQueryEntry(proxy);
+			if (!volume.intersects(entry.bounds))
+				return;
+
+			if (found.insert(entry.sceneObject.getInstanceId()).second)
+				output.push_back(entry.sceneObject);
+		});
+
+		return output;
+	}
+
+	Vector<HSceneObject> ScenePicking::queryArea(const SPtr<Camera>& cam, const Vector2I& position,
+		const Vector2I& area)
+	{
+		// Areas narrower than a pixel would produce degenerate side planes
+		INT32 width = std::max(area.x, 1);
+		INT32 height = std::max(area.y, 1);
+
+		// Rays through the corners of the area, in clockwise order
+		Ray corners[4] =
+		{
+			cam->screenPointToRay(position),
+			cam->screenPointToRay(Vector2I(position.x + width, position.y)),
+			cam->screenPointToRay(Vector2I(position.x + width, position.y + height)),
+			cam->screenPointToRay(Vector2I(position.x, position.y + height))
+		};
+
+		Vector3 forward = cam->getTransform().getForward();
+		Vector3 farPoint = cam->getTransform().getPosition() + forward * cam->getFarClipDistance();
+
+		// Point half way between the near and far planes, along the ray through the center of the area. Unlike the view
+		// center, it is within the volume wherever the area is on the viewport.
+		Ray centerRay = cam->screenPointToRay(Vector2I(position.x + width / 2, position.y + height / 2));
+		Vector3 nearPoint = centerRay.getOrigin();
+
+		float clipRange = cam->getFarClipDistance() - cam->getNearClipDistance();
+		float farDistance = clipRange / centerRay.getDirection().dot(forward);
+		Vector3 insidePoint = centerRay.getPoint(farDistance * 0.5f);
+
+		Vector<Plane> planes;
+		for (UINT32 i = 0; i < 4; i++)
+		{
+			const Ray& current = corners[i];
+			const Ray& next = corners[(i + 1) % 4];
+
+			planes.push_back(Plane(current.getOrigin(), current.getOrigin() + current.getDirection(), 
+				next.getOrigin() + next.getDirection()));
+		}
+
+		planes.push_back(Plane(forward, nearPoint));
+		planes.push_back(Plane(-forward, farPoint));
+
+		// Volume expects the planes to face inwards
+		for (auto& plane : planes)
+		{
+			if (plane.getDistance(insidePoint) < 0.0f)
+				plane = Plane(-plane.normal, -plane.d);
+		}
+
+		return queryFrustum(ConvexVolume(planes));
+	}
+
+	UINT32 ScenePicking::allocatePickIndex()
+	{
+		if (!mFreeIndices.empty())
+		{
+			UINT32 index = mFreeIndices.back();
+			mFreeIndices.pop_back();
+
+			return index;
+		}
+
+		mIndexObjects.push_back(HSceneObject());
+		return (UINT32)mIndexObjects.size() - 1;
+	}
+
+	Vector<UINT32> ScenePicking::getIgnoredIndices(const Vector<HSceneObject>& ignoreRenderables) const
+	{
+		Vector<UINT32> indices;
+		for (auto& so : ignoreRenderables)
+		{
+			if (so.isDestroyed())
+				continue;
+
+			for (auto& component : so->getComponents())
+			{
+				auto iterFind = mPickEntries.find(component.getInstanceId());
+				if (iterFind == mPickEntries.end())
+					continue;
+
+				const PickEntry& entry = iterFind->second;
+				indices.insert(indices.end(), entry.indices.begin(), entry.indices.end());
+			}
+		}
+
+		std::sort(indices.begin(), indices.end());
+		return indices;
+	}
+
 	Color ScenePicking::encodeIndex(UINT32 index)
 	{
 		Color encoded;
@@ -245,8 +891,57 @@ namespace bs
 		bs_delete(this);
 	}
 
+	void ScenePicking::updateDrawList(const Vector<bs::ScenePicking::RenderablePickData>& updated, 
+		const Vector<UINT32>& removed)
+	{
+		for (auto& index : removed)
+			removeFromDrawList(index);
+
+		for (auto& renderable : updated)
+		{
+			UINT32 typeIdx = (renderable.alpha ? 3 : 0) + (UINT32)renderable.cullMode;
+
+			auto iterFind = mDrawListLookup.find(renderable.index);
+			if (iterFind != mDrawListLookup.end())
+			{
+				if (iterFind->second.first == typeIdx)
+				{
+					mDrawList[typeIdx][iterFind->second.second] = renderable;
+					continue;
+				}
+
+				removeFromDrawList(renderable.index);
+			}
+
+			mDrawListLookup[renderable.index] = std::make_pair(typeIdx, (UINT32)mDrawList[typeIdx].size());
+			mDrawList[typeIdx].push_back(renderable);
+		}
+	}
+
+	void ScenePicking::removeFromDrawList(UINT32 index)
+	{
+		auto iterFind = mDrawListLookup.find(index);
+		if (iterFind == mDrawListLookup.end())
+			return;
+
+		UINT32 typeIdx = iterFind->second.first;
+		UINT32 position = iterFind->second.second;
+		mDrawListLookup.erase(iterFind);
+
+		// Swap with the last entry to avoid moving the rest of the list
+		Vector<bs::ScenePicking::RenderablePickData>& drawList = mDrawList[typeIdx];
+		if (position != (UINT32)drawList.size() - 1)
+		{
+			drawList[position] = drawList.back();
+			mDrawListLookup[drawList[position].index].second = position;
+		}
+
+		drawList.pop_back();
+	}
+
 	void ScenePicking::corePickingBegin(const SPtr<RenderTarget>& target, const Rect2& viewportArea,
-		const bs::ScenePicking::RenderableSet& renderables, const Vector2I& position, const Vector2I& area)
+		const Matrix4& viewProj, const ConvexVolume& frustum, const Vector<UINT32>& ignored, const Vector2I& position, 
+		const Vector2I& area)
 	{
 		RenderAPI& rs = RenderAPI::instance();
 
@@ -276,93 +971,156 @@ namespace bs
 		
 		mPickingTexture = RenderTexture::create(pickingMRT);
 
-		rs.setRenderTarget(mPickingTexture);
+		renderPickingData(mPickingTexture, viewportArea, viewProj, frustum, ignored, position, area);
+	}
+
+	void ScenePicking::corePickingBeginAsync(UINT32 bufferIdx, const SPtr<RenderTarget>& target,
+		const Rect2& viewportArea, const Matrix4& viewProj, const ConvexVolume& frustum, const Vector<UINT32>& ignored, 
+		const Vector2I& position, const Vector2I& area)
+	{
+		const RenderTargetProperties& rtProps = target->getProperties();
+
+		// Async picks render into their own buffers, so the results stay intact while waiting to be read, even if the
+		// camera's target gets rendered to in the meantime
+		SPtr<RenderTexture>& pickingTexture = mAsyncBuffers[bufferIdx];
+		if (pickingTexture != nullptr)
+		{
+			const RenderTargetProperties& pickingProps = pickingTexture->getProperties();
+			if (pickingProps.width != rtProps.width || pickingProps.height != rtProps.height)
+				pickingTexture = nullptr;
+		}
+
+		if (pickingTexture == nullptr)
+		{
+			TEXTURE_DESC colorTexDesc;
+			colorTexDesc.type = TEX_TYPE_2D;
+			colorTexDesc.width = rtProps.width;
+			colorTexDesc.height = rtProps.height;
+			colorTexDesc.format = PF_RGBA8;
+			colorTexDesc.usage = TU_RENDERTARGET;
+
+			TEXTURE_DESC normalTexDesc = colorTexDesc;
+			normalTexDesc.format = PF_RG11B10F;
+
+			TEXTURE_DESC depthTexDesc = colorTexDesc;
+			depthTexDesc.format = PF_D24S8;
+			depthTexDesc.usage = TU_DEPTHSTENCIL;
+
+			RENDER_TEXTURE_DESC pickingMRT;
+			pickingMRT.colorSurfaces[0].face = 0;
+			pickingMRT.colorSurfaces[0].texture = Texture::create(colorTexDesc);
+			pickingMRT.colorSurfaces[1].face = 0;
+			pickingMRT.colorSurfaces[1].texture = Texture::create(normalTexDesc);
+
+			pickingMRT.depthStencilSurface.face = 0;
+			pickingMRT.depthStencilSurface.texture = Texture::create(depthTexDesc);
+
+			pickingTexture = RenderTexture::create(pickingMRT);
+		}
+
+		renderPickingData(pickingTexture, viewportArea, viewProj, frustum, ignored, position, area);
+	}
+
+	void ScenePicking::corePickingEndAsync()
+	{
+		RenderAPI& rs = RenderAPI::instance();
+
+		rs.setRenderTarget(nullptr);
+		rs.submitCommandBuffer(nullptr);
+	}
+
+	void ScenePicking::coreReadPickingResults(UINT32 bufferIdx, const Vector2I& position, const Vector2I& area,
+		bool gatherSnapData, AsyncOp& asyncOp)
+	{
+		asyncOp._completeOperation(readPickingResults(mAsyncBuffers[bufferIdx], position, area, gatherSnapData));
+	}
+
+	void ScenePicking::renderPickingData(const SPtr<RenderTexture>& pickingTexture, const Rect2& viewportArea,
+		const Matrix4& viewProj, const ConvexVolume& frustum, const Vector<UINT32>& ignored, const Vector2I& position, 
+		const Vector2I& area)
+	{
+		RenderAPI& rs = RenderAPI::instance();
+
+		rs.setRenderTarget(pickingTexture);
 		rs.setViewport(viewportArea);
 		rs.clearRenderTarget(FBT_COLOR | FBT_DEPTH | FBT_STENCIL, Color::White);
 		rs.setScissorRect(position.x, position.y, position.x + area.x, position.y + area.y);
 
 		gRendererUtility().setPass(mMaterials[0]);
 
-		UINT32 numEntries = (UINT32)renderables.size();
-		UINT32* renderableIndices = bs_stack_alloc<UINT32>(numEntries);
+		// Find visible entries and assign their parameters first, entries are then drawn grouped by material
+		struct VisibleEntry
+		{
+			const bs::ScenePicking::RenderablePickData* renderable;
+			UINT32 typeIdx;
+			UINT32 renderableIdx;
+		};
 
-		UINT32 typeCounters[6];
-		bs_zero_out(typeCounters);
+		Vector<VisibleEntry> visibleEntries;
 
 		UINT32 idx = 0;
-		for (auto& renderable : renderables)
+		for (UINT32 typeIdx = 0; typeIdx < NUM_MATERIALS; typeIdx++)
 		{
-			UINT32 typeIdx;
-			if (!renderable.alpha)
-				typeIdx = 0;
-			else
-				typeIdx = 3;
+			UINT32 renderableIdx = 0;
+			for (auto& renderable : mDrawList[typeIdx])
+			{
+				if (std::binary_search(ignored.begin(), ignored.end(), renderable.index))
+					continue;
 
-			typeIdx += (UINT32)renderable.cullMode;
+				if (!frustum.intersects(renderable.worldBounds.getSphere()))
+					continue;
 
-			UINT32 renderableIdx = typeCounters[typeIdx];
-			renderableIndices[idx] = renderableIdx;
+				// More precise with the box
+				if (!frustum.intersects(renderable.worldBounds.getBox()))
+					continue;
 
-			SPtr<GpuParamsSet> paramsSet;
-			if (renderableIdx >= mParamSets[typeIdx].size())
-			{
-				paramsSet = mMaterials[typeIdx]->createParamsSet();
-				mParamSets[typeIdx].push_back(paramsSet);
-			}
-			else
-				paramsSet = mParamSets[typeIdx][renderableIdx];
+				SPtr<GpuParamsSet> paramsSet;
+				if (renderableIdx >= mParamSets[typeIdx].size())
+				{
+					paramsSet = mMaterials[typeIdx]->createParamsSet();
+					mParamSets[typeIdx].push_back(paramsSet);
+				}
+				else
+					paramsSet = mParamSets[typeIdx][renderableIdx];
 
-			SPtr<GpuParamBlockBuffer> paramBuffer;
-			if (idx >= mParamBuffers.size())
-			{
-				paramBuffer = gPickingParamBlockDef.createBuffer();
-				mParamBuffers.push_back(paramBuffer);
-			}
-			else
-				paramBuffer = mParamBuffers[idx];
+				SPtr<GpuParamBlockBuffer> paramBuffer;
+				if (idx >= mParamBuffers.size())
+				{
+					paramBuffer = gPickingParamBlockDef.createBuffer();
+					mParamBuffers.push_back(paramBuffer);
+				}
+				else
+					paramBuffer = mParamBuffers[idx];
+
+				paramsSet->setParamBlockBuffer("Uniforms", paramBuffer, true);
 
-			paramsSet->setParamBlockBuffer("Uniforms", paramBuffer, true);
+				Color color = bs::ScenePicking::encodeIndex(renderable.index);
 
-			Color color = bs::ScenePicking::encodeIndex(renderable.index);
+				gPickingParamBlockDef.gMatViewProj.set(paramBuffer, viewProj * renderable.worldTransform);
+				gPickingParamBlockDef.gAlphaCutoff.set(paramBuffer, ALPHA_CUTOFF);
+				gPickingParamBlockDef.gColorIndex.set(paramBuffer, color);
 
-			gPickingParamBlockDef.gMatViewProj.set(paramBuffer, renderable.wvpTransform);
-			gPickingParamBlockDef.gAlphaCutoff.set(paramBuffer, ALPHA_CUTOFF);
-			gPickingParamBlockDef.gColorIndex.set(paramBuffer, color);
+				visibleEntries.push_back({ &renderable, typeIdx, renderableIdx });
 
-			typeCounters[typeIdx]++;
-			idx++;
+				renderableIdx++;
+				idx++;
+			}
 		}
 
 		UINT32 activeMaterialIdx = 0;
-		idx = 0;
-		for (auto& renderable : renderables)
+		for (auto& entry : visibleEntries)
 		{
-			UINT32 typeIdx;
-			if (!renderable.alpha)
-				typeIdx = 0;
-			else
-				typeIdx = 3;
-
-			typeIdx += (UINT32)renderable.cullMode;
-
-			if (activeMaterialIdx != typeIdx)
+			if (activeMaterialIdx != entry.typeIdx)
 			{
-				gRendererUtility().setPass(mMaterials[typeIdx]);
-				activeMaterialIdx = typeIdx;
+				gRendererUtility().setPass(mMaterials[entry.typeIdx]);
+				activeMaterialIdx = entry.typeIdx;
 			}
 
-			UINT32 renderableIdx = renderableIndices[idx];
-			gRendererUtility().setPassParams(mParamSets[typeIdx][renderableIdx]);
-
-			UINT32 numSubmeshes = renderable.mesh->getProperties().getNumSubMeshes();
+			gRendererUtility().setPassParams(mParamSets[entry.typeIdx][entry.renderableIdx]);
 
-			for (UINT32 i = 0; i < numSubmeshes; i++)
-				gRendererUtility().draw(renderable.mesh, renderable.mesh->getProperties().getSubMesh(i));
-
-			idx++;
+			const SPtr<Mesh>& mesh = entry.renderable->mesh;
+			gRendererUtility().draw(mesh, mesh->getProperties().getSubMesh(entry.renderable->subMesh));
 		}
-
-		bs_stack_free(renderableIndices);
 	}
 
 	void ScenePicking::corePickingEnd(const SPtr<RenderTarget>& target, const Rect2& viewportArea, 
@@ -379,17 +1137,27 @@ namespace bs
 			BS_EXCEPT(NotImplementedException, "Picking is not supported on render windows as framebuffer readback methods aren't implemented");
 		}
 
-		SPtr<Texture> outputTexture = mPickingTexture->getColorTexture(0);
-		SPtr<Texture> normalsTexture = mPickingTexture->getColorTexture(1);
-		SPtr<Texture> depthTexture = mPickingTexture->getDepthStencilTexture();
+		asyncOp._completeOperation(readPickingResults(mPickingTexture, position, area, gatherSnapData));
+		mPickingTexture = nullptr;
+	}
+
+	PickResults ScenePicking::readPickingResults(const SPtr<RenderTexture>& pickingTexture, const Vector2I& position,
+		const Vector2I& area, bool gatherSnapData)
+	{
+		const RenderTargetProperties& rtProps = pickingTexture->getProperties();
+		RenderAPI& rs = RenderAPI::instance();
+
+		SPtr<Texture> outputTexture = pickingTexture->getColorTexture(0);
+		SPtr<Texture> normalsTexture = pickingTexture->getColorTexture(1);
+		SPtr<Texture> depthTexture = pickingTexture->getDepthStencilTexture();
 
 		if (position.x < 0 || position.x >= (INT32)outputTexture->getProperties().getWidth() ||
 			position.y < 0 || position.y >= (INT32)outputTexture->getProperties().getHeight())
 		{
-			mPickingTexture = nullptr;
+			PickResults result;
+			result.depth = 0;
 
-			asyncOp._completeOperation(Vector<UINT32>());
-			return;
+			return result;
 		}
 
 		SPtr<PixelData> outputPixelData = outputTexture->getProperties().allocBuffer(0, 0);
@@ -403,7 +1171,6 @@ namespace bs
 
 		outputTexture->readData(*outputPixelData);
 
-
 		Vector2I pickPosition = position;
 		if(rtProps.requiresTextureFlipping)
 			pickPosition.y = rtProps.height - (position.y + area.y);
@@ -474,10 +1241,8 @@ namespace bs
 		else
 			result.depth = 0;
 
-		mPickingTexture = nullptr;
-		
 		result.objects = objects;
-		asyncOp._completeOperation(result);
+		return result;
 	}
 	}
 }
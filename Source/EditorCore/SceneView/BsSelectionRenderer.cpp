@@ -42,17 +42,19 @@ namespace bs
 	{
 		Vector<SPtr<ct::Renderable>> objects;
 
+		// Look up the renderables directly on the selected objects, instead of going through all scene renderables
 		const Vector<HSceneObject>& sceneObjects = Selection::instance().getSceneObjects();
-		Vector<HRenderable> renderables = gSceneManager().findComponents<CRenderable>(true);
-
-		for (auto& renderable : renderables)
+		for (auto& so : sceneObjects)
 		{
-			HSceneObject renderableSO = renderable->SO();
-			for (auto& so : sceneObjects)
+			if (so.isDestroyed() || !so->getActive())
+				continue;
+
+			for (auto& component : so->getComponents())
 			{
-				if (renderableSO != so)
+				if (!rtti_is_of_type<CRenderable>(component.get()))
 					continue;
 
+				HRenderable renderable = static_object_cast<CRenderable>(component);
 				if (renderable->getMesh().isLoaded())
 					objects.push_back(renderable->_getRenderable()->getCore());
 			}
@@ -61,6 +61,12 @@ namespace bs
 		/**	Retrieves a list of most recently loaded project paths and their last access times. */
 		const Vector<RecentProject>& getRecentProjects() const { return mRecentProjects; }
 
+		/** 
+		 * Retrieves the path to a folder used for caching imported resources between projects. Empty if the import
+		 * cache is disabled.
+		 */
+		Path getImportCacheFolder() const { return mImportCacheFolder; }
+
 		/** Retrieves the maximum number of frames per second the editor is allowed to execute. Zero means infinite. */
 		UINT32 getFPSLimit() const { return mFPSLimit; }
 
@@ -109,6 +115,12 @@ namespace bs
 		/**	Sets a list of most recently loaded project paths and their last access times. */
 		void setRecentProjects(const Vector<RecentProject>& value) { mRecentProjects = value; markAsDirty(); }
 
+		/** 
+		 * Sets the path to a folder used for caching imported resources between projects. Set to an empty path to
+		 * disable the import cache.
+		 */
+		void setImportCacheFolder(const Path& value) { mImportCacheFolder = value; markAsDirty(); }
+
 		/** Sets the maximum number of frames per second the editor is allowed to execute. Zero means infinite. */
 		void setFPSLimit(UINT32 limit) { mFPSLimit = limit; markAsDirty(); }
 
@@ -139,6 +151,7 @@ namespace bs
 		Path mLastOpenProject;
 		bool mAutoLoadLastProject;
 		Vector<RecentProject> mRecentProjects;
+		Path mImportCacheFolder;
 
 		/************************************************************************/
 		/* 								RTTI		                     		*/
@@ -15,6 +15,20 @@
 #include "Scene/BsPrefabDiff.h"
 #include "FileSystem/BsFileSystem.h"
 #include "Scene/BsSceneManager.h"
+#include "Library/BsProjectLibrarySearch.h"
+#include "Build/BsResourceArchive.h"
+#include "FileSystem/BsDataStream.h"
+#include "Utility/BsCompression.h"
+#include "Scene/BsPickingBVH.h"
+#include "Mesh/BsMeshData.h"
+#include "RenderAPI/BsSubMesh.h"
+#include "RenderAPI/BsVertexDataDesc.h"
+#include "Scene/BsScenePicking.h"
+#include "Components/BsCRenderable.h"
+#include "Renderer/BsCamera.h"
+#include "RenderAPI/BsViewport.h"
+#include "Mesh/BsMesh.h"
+#include "BsCoreApplication.h"
 
 namespace bs
 {
@@ -413,6 +427,11 @@ namespace bs
 		BS_ADD_TEST(EditorTestSuite::TestPrefabComplex);
 		BS_ADD_TEST(EditorTestSuite::TestPrefabDiff);
 		BS_ADD_TEST(EditorTestSuite::TestFrameAlloc);
+		BS_ADD_TEST(EditorTestSuite::TestProjectLibrarySearchIndex);
+		BS_ADD_TEST(EditorTestSuite::TestResourceArchive);
+		BS_ADD_TEST(EditorTestSuite::TestMeshBVH);
+		BS_ADD_TEST(EditorTestSuite::TestDynamicAABBTree);
+		BS_ADD_TEST(EditorTestSuite::TestScenePickingArea);
 	}
 
 	void EditorTestSuite::SceneObjectRecord_UndoRedo()
@@ -807,4 +826,832 @@ namespace bs
 		alloc.free(a13);
 		alloc.clear();
 	}
-}
\ No newline at end of file
+
+	void EditorTestSuite::TestProjectLibrarySearchIndex()
+	{
+		typedef ProjectLibrary::LibraryEntry LibraryEntry;
+		typedef ProjectLibrary::FileEntry FileEntry;
+		typedef ProjectLibrary::DirectoryEntry DirectoryEntry;
+
+		Path root = "/Project/Resources/";
+		DirectoryEntry* rootEntry = bs_new<DirectoryEntry>(root, "Resources", nullptr);
+
+		Vector<LibraryEntry*> entries;
+		auto createFile = [&](const String& name, const Vector<UINT32>& typeIds, bool includeInBuild)
+		{
+			Path path = root;
+			path.append(name);
+
+			FileEntry* entry = bs_new<FileEntry>(path, name, rootEntry);
+			entry->hasMeta = !typeIds.empty();
+			entry->includeInBuild = includeInBuild;
+
+			for (auto& typeId : typeIds)
+				entry->resources.push_back({ UUIDGenerator::generateRandom(), typeId, name });
+
+			entries.push_back(entry);
+			return entry;
+		};
+
+		FileEntry* texture = createFile("Texture0.png", { 1 }, false);
+		FileEntry* model = createFile("Model.fbx", { 2, 1, 1 }, true);
+		FileEntry* bigTexture = createFile("texture_big.png", { 1 }, true);
+		FileEntry* shader = createFile("Shader.bsl", { 3 }, false);
+		createFile("notes.txt", {}, false);
+
+		Path folderPath = root;
+		folderPath.append("Textures/");
+		DirectoryEntry* folder = bs_new<DirectoryEntry>(folderPath, "Textures", rootEntry);
+		entries.push_back(folder);
+
+		ProjectLibrarySearchIndex index;
+		for (auto& entry : entries)
+			index.add(entry);
+
+		auto contains = [](const Vector<UINT32>& typeIds, UINT32 typeId)
+		{
+			return std::find(typeIds.begin(), typeIds.end(), typeId) != typeIds.end();
+		};
+
+		auto hasAnyType = [&](LibraryEntry* entry, const Vector<UINT32>& typeIds)
+		{
+			if (entry->type != ProjectLibrary::LibraryEntryType::File)
+				return false;
+
+			FileEntry* fileEntry = static_cast<FileEntry*>(entry);
+			if (!fileEntry->hasMeta)
+				return false;
+
+			for (auto& resource : fileEntry->resources)
+			{
+				if (contains(typeIds, resource.typeId))
+					return true;
+			}
+
+			return false;
+		};
+
+		// Entries in the index, in the order the brute-force results are expected in
+		Vector<LibraryEntry*> indexed = entries;
+
+		// Compares a search for "*<substring>*" against a brute-force scan of the indexed entries
+		auto checkFind = [&](const String& substring, const Vector<UINT32>& typeIds)
+		{
+			Vector<LibraryEntry*> found = index.find("*" + substring + "*", typeIds);
+
+			UnorderedSet<LibraryEntry*> expected;
+			for (auto& entry : indexed)
+			{
+				String name = entry->elementName;
+				StringUtil::toLowerCase(name);
+
+				if (name.find(substring) == String::npos)
+					continue;
+
+				if (!typeIds.empty() && !hasAnyType(entry, typeIds))
+					continue;
+
+				expected.insert(entry);
+			}
+
+			BS_TEST_ASSERT(found.size() == expected.size());
+			for (auto& entry : found)
+				BS_TEST_ASSERT(expected.find(entry) != expected.end());
+		};
+
+		// Compares a type query against a brute-force scan, including the order
+		auto checkFindByType = [&](const Vector<UINT32>& typeIds)
+		{
+			Vector<FileEntry*> found = index.findByType(typeIds);
+
+			Vector<FileEntry*> expected;
+			for (auto& entry : indexed)
+			{
+				if (hasAnyType(entry, typeIds))
+					expected.push_back(static_cast<FileEntry*>(entry));
+			}
+
+			BS_TEST_ASSERT(found == expected);
+		};
+
+		auto checkBuildEntries = [&]()
+		{
+			Vector<FileEntry*> found = index.getBuildEntries();
+
+			Vector<FileEntry*> expected;
+			for (auto& entry : indexed)
+			{
+				if (entry->type != ProjectLibrary::LibraryEntryType::File)
+					continue;
+
+				FileEntry* fileEntry = static_cast<FileEntry*>(entry);
+				if (fileEntry->hasMeta && fileEntry->includeInBuild)
+					expected.push_back(fileEntry);
+			}
+
+			BS_TEST_ASSERT(found == expected);
+		};
+
+		auto checkAll = [&]()
+		{
+			checkFind("tex", {});
+			checkFind("tex", { 1 });
+			checkFind("tex", { 2, 3 });
+			checkFind("e", { 1, 2 });
+			checkFind(".png", {});
+			checkFind("missing", {});
+
+			checkFindByType({ 1 });
+			checkFindByType({ 2, 1 });
+			checkFindByType({ 3, 1, 2 });
+			checkFindByType({ 4 });
+
+			checkBuildEntries();
+		};
+
+		checkAll();
+
+		// Exact matches rank first, followed by prefix matches
+		Vector<LibraryEntry*> ranked = index.find("texture*", {});
+		BS_TEST_ASSERT(ranked.size() == 3);
+		BS_TEST_ASSERT(ranked[0] == folder);
+		BS_TEST_ASSERT(ranked[1] == texture);
+		BS_TEST_ASSERT(ranked[2] == bigTexture);
+
+		BS_TEST_ASSERT(index.find("*", {}, 1, 2).size() == 2);
+
+		// Updated entries move to the end of the index order
+		auto updateEntry = [&](FileEntry* entry)
+		{
+			index.update(entry);
+
+			indexed.erase(std::find(indexed.begin(), indexed.end(), entry));
+			indexed.push_back(entry);
+		};
+
+		shader->resources.push_back({ UUIDGenerator::generateRandom(), 1, "Shader.bsl" });
+		shader->includeInBuild = true;
+		updateEntry(shader);
+		checkAll();
+
+		model->resources.clear();
+		model->resources.push_back({ UUIDGenerator::generateRandom(), 3, "Model.fbx" });
+		model->includeInBuild = false;
+		updateEntry(model);
+		checkAll();
+
+		index.remove(texture);
+		indexed.erase(std::find(indexed.begin(), indexed.end(), texture));
+		checkAll();
+
+		// Enough updates to trigger compaction of the removed slots
+		for (UINT32 i = 0; i < 3000; i++)
+		{
+			FileEntry* entry = (i % 2) == 0 ? bigTexture : shader;
+			entry->includeInBuild = (i % 3) == 0;
+			updateEntry(entry);
+		}
+
+		checkAll();
+
+		index.clear();
+		BS_TEST_ASSERT(index.find("*", {}).empty());
+		BS_TEST_ASSERT(index.findByType({ 1 }).empty());
+		BS_TEST_ASSERT(index.getBuildEntries().empty());
+
+		for (auto& entry : entries)
+		{
+			if (entry->type == ProjectLibrary::LibraryEntryType::File)
+				bs_delete(static_cast<FileEntry*>(entry));
+			else
+				bs_delete(static_cast<DirectoryEntry*>(entry));
+		}
+
+		bs_delete(rootEntry);
+	}
+
+	void EditorTestSuite::TestResourceArchive()
+	{
+		Path folder = FileSystem::getTempDirectoryPath();
+		folder.append("ResourceArchiveTest/");
+
+		if (FileSystem::exists(folder))
+			FileSystem::remove(folder);
+
+		FileSystem::createDir(folder);
+
+		struct SourceFile
+		{
+			UUID uuid;
+			Path path;
+			Vector<UINT8> data;
+			ArchiveCompression compression;
+		};
+
+		Vector<SourceFile> sources;
+		auto createSource = [&](const String& name, Vector<UINT8> data, ArchiveCompression compression)
+		{
+			Path path = folder;
+			path.append(name);
+
+			SPtr<DataStream> stream = FileSystem::createAndOpenFile(path);
+			stream->write(data.data(), data.size());
+			stream->close();
+
+			sources.push_back({ UUIDGenerator::generateRandom(), path, std::move(data), compression });
+		};
+
+		// Repetitive data compresses well, while pseudo-random data doesn't and must be stored as is
+		Vector<UINT8> repetitive(64 * 1024);
+		for (UINT32 i = 0; i < (UINT32)repetitive.size(); i++)
+			repetitive[i] = (UINT8)(i % 7);
+
+		Vector<UINT8> noise(4 * 1024 + 3);
+		UINT32 seed = 12345;
+		for (auto& entry : noise)
+		{
+			seed = seed * 1664525 + 1013904223;
+			entry = (UINT8)(seed >> 24);
+		}
+
+		createSource("Repetitive.asset", repetitive, ArchiveCompression::Snappy);
+		createSource("Noise.asset", noise, ArchiveCompression::Snappy);
+		createSource("Plain.asset", repetitive, ArchiveCompression::None);
+		createSource("Small.asset", { 1, 2, 3 }, ArchiveCompression::None);
+
+		ResourceArchiveWriter writer;
+		for (auto& source : sources)
+			writer.addEntry(source.uuid, source.path, source.compression);
+
+		// Resources whose files are missing are left out, without making the archive out of date
+		Path missingPath = folder;
+		missingPath.append("Missing.asset");
+		writer.addEntry(UUIDGenerator::generateRandom(), missingPath);
+
+		// Last two sources were loaded first, and the first of them on startup
+		writer.setLoadOrder({ sources[3].uuid, sources[2].uuid }, 1);
+
+		Path archivePath = folder;
+		archivePath.append(ResourceArchiveWriter::ARCHIVE_NAME);
+
+		BS_TEST_ASSERT(!writer.isUpToDate(archivePath));
+		BS_TEST_ASSERT(writer.write(archivePath));
+		BS_TEST_ASSERT(writer.isUpToDate(archivePath));
+		BS_TEST_ASSERT(writer.getSummary().numEntries == (UINT32)sources.size());
+		BS_TEST_ASSERT(writer.getSummary().numCompressed == 1);
+
+		// Read the archive back the same way the game does
+		SPtr<DataStream> stream = FileSystem::openFile(archivePath, true);
+		UINT64 size = stream->size();
+
+		ArchiveHeader header;
+		stream->read(&header, sizeof(header));
+		BS_TEST_ASSERT(header.magic == ARCHIVE_MAGIC && header.version == ARCHIVE_VERSION);
+
+		ArchiveFooter footer;
+		stream->seek((size_t)(size - sizeof(footer)));
+		stream->read(&footer, sizeof(footer));
+		BS_TEST_ASSERT(footer.magic == ARCHIVE_MAGIC && footer.numEntries == (UINT32)sources.size());
+		BS_TEST_ASSERT(footer.indexOffset + footer.numEntries * sizeof(ArchiveIndexEntry) + sizeof(footer) == size);
+
+		Vector<ArchiveIndexEntry> index(footer.numEntries);
+		stream->seek((size_t)footer.indexOffset);
+		stream->read(index.data(), index.size() * sizeof(ArchiveIndexEntry));
+		BS_TEST_ASSERT(std::is_sorted(index.begin(), index.end(), &compareArchiveEntries));
+
+		for (auto& source : sources)
+		{
+			auto iterFind = std::lower_bound(index.begin(), index.end(), source.uuid, &compareArchiveEntryUUID);
+			BS_TEST_ASSERT(iterFind != index.end() && iterFind->uuid == source.uuid);
+			if (iterFind == index.end() || iterFind->uuid != source.uuid)
+				continue;
+
+			const ArchiveIndexEntry& entry = *iterFind;
+			BS_TEST_ASSERT(entry.offset % ARCHIVE_ALIGNMENT == 0);
+			BS_TEST_ASSERT(entry.requestedCompression == (UINT32)source.compression);
+			BS_TEST_ASSERT(entry.uncompressedSize == source.data.size());
+
+			Vector<UINT8> data((size_t)entry.size);
+			stream->seek((size_t)entry.offset);
+			stream->read(data.data(), data.size());
+
+			if (entry.compression == (UINT32)ArchiveCompression::Snappy)
+			{
+				BS_TEST_ASSERT(entry.size < entry.uncompressedSize);
+
+				SPtr<DataStream> compressed = bs_shared_ptr_new<MemoryDataStream>(data.data(), data.size(), false);
+				SPtr<MemoryDataStream> decompressed = Compression::decompress(compressed);
+				data.assign(decompressed->getPtr(), decompressed->getPtr() + decompressed->size());
+			}
+			else
+				BS_TEST_ASSERT(entry.size == entry.uncompressedSize);
+
+			BS_TEST_ASSERT(data == source.data);
+		}
+
+		stream->close();
+
+		// Loaded resources are laid out first, in the order they were loaded in
+		Vector<ArchiveIndexEntry> entriesByOffset = index;
+		std::sort(entriesByOffset.begin(), entriesByOffset.end(),
+			[](const ArchiveIndexEntry& a, const ArchiveIndexEntry& b) { return a.offset < b.offset; });
+
+		BS_TEST_ASSERT(entriesByOffset[0].uuid == sources[3].uuid);
+		BS_TEST_ASSERT(entriesByOffset[1].uuid == sources[2].uuid);
+
+		// Only resources loaded on startup are prefetched
+		Path prefetchListPath = folder;
+		prefetchListPath.append(ResourceArchiveWriter::PREFETCH_LIST_NAME);
+		BS_TEST_ASSERT(writer.writePrefetchList(prefetchListPath));
+
+		stream = FileSystem::openFile(prefetchListPath, true);
+
+		PrefetchListHeader prefetchHeader;
+		stream->read(&prefetchHeader, sizeof(prefetchHeader));
+		BS_TEST_ASSERT(prefetchHeader.magic == PREFETCH_LIST_MAGIC && prefetchHeader.numEntries == 1);
+
+		UUID prefetched;
+		stream->read(&prefetched, sizeof(prefetched));
+		BS_TEST_ASSERT(prefetched == sources[3].uuid);
+		stream->close();
+
+		// Load trace recorded by the game is read back in the same order
+		Path loadTracePath = folder;
+		loadTracePath.append(ResourceArchiveWriter::LOAD_TRACE_NAME);
+
+		LoadTraceHeader traceHeader;
+		traceHeader.magic = LOAD_TRACE_MAGIC;
+		traceHeader.version = LOAD_TRACE_VERSION;
+		traceHeader.numRecords = 3;
+		traceHeader.numStartupRecords = 2;
+
+		LoadTraceRecord records[3] =
+		{
+			{ sources[1].uuid, 0, 10 },
+			{ sources[0].uuid, 5, 2 },
+			{ sources[2].uuid, 20, 1 }
+		};
+
+		stream = FileSystem::createAndOpenFile(loadTracePath);
+		stream->write(&traceHeader, sizeof(traceHeader));
+		stream->write(records, sizeof(records));
+		stream->close();
+
+		Vector<UUID> order;
+		UINT32 numStartup = 0;
+		BS_TEST_ASSERT(ResourceArchiveWriter::readLoadTrace(loadTracePath, order, numStartup));
+		BS_TEST_ASSERT(numStartup == 2 && order.size() == 3);
+		BS_TEST_ASSERT(order[0] == sources[1].uuid && order[1] == sources[0].uuid && order[2] == sources[2].uuid);
+
+		// A different layout or an additional entry requires the archive to be written again
+		writer.setLoadOrder(order, numStartup);
+		BS_TEST_ASSERT(!writer.isUpToDate(archivePath));
+
+		writer.setLoadOrder({ sources[3].uuid, sources[2].uuid }, 1);
+		BS_TEST_ASSERT(writer.isUpToDate(archivePath));
+
+		createSource("Added.asset", { 4, 5, 6 }, ArchiveCompression::None);
+		writer.addEntry(sources.back().uuid, sources.back().path, sources.back().compression);
+		BS_TEST_ASSERT(!writer.isUpToDate(archivePath));
+
+		FileSystem::remove(folder);
+	}
+
+	void EditorTestSuite::TestMeshBVH()
+	{
+		UINT32 seed = 4321;
+		auto random = [&seed]()
+		{
+			seed = seed * 1664525 + 1013904223;
+			return (seed >> 8) / (float)(1 << 24);
+		};
+
+		auto randomPoint = [&random](float extent)
+		{
+			return Vector3((random() * 2.0f - 1.0f) * extent, (random() * 2.0f - 1.0f) * extent,
+				(random() * 2.0f - 1.0f) * extent);
+		};
+
+		// Two sub-meshes of small triangles scattered through a cube, the second one culling back faces
+		static constexpr UINT32 NUM_TRIANGLES = 300;
+		static constexpr UINT32 NUM_SUB_MESH_TRIANGLES = NUM_TRIANGLES / 2;
+
+		SPtr<VertexDataDesc> vertexDesc = bs_shared_ptr_new<VertexDataDesc>();
+		vertexDesc->addVertElem(VET_FLOAT3, VES_POSITION);
+
+		SPtr<MeshData> meshData = bs_shared_ptr_new<MeshData>(NUM_TRIANGLES * 3, NUM_TRIANGLES * 3, vertexDesc);
+		auto positionIter = meshData->getVec3DataIter(VES_POSITION);
+		UINT32* indices = meshData->getIndices32();
+
+		struct Triangle
+		{
+			Vector3 vertices[3];
+		};
+
+		Vector<Triangle> triangles(NUM_TRIANGLES);
+		for (UINT32 i = 0; i < NUM_TRIANGLES; i++)
+		{
+			Vector3 center = randomPoint(10.0f);
+			for (UINT32 j = 0; j < 3; j++)
+			{
+				triangles[i].vertices[j] = center + randomPoint(1.5f);
+				positionIter.addValue(triangles[i].vertices[j]);
+				indices[i * 3 + j] = i * 3 + j;
+			}
+		}
+
+		Vector<SubMesh> subMeshes;
+		subMeshes.push_back(SubMesh(0, NUM_SUB_MESH_TRIANGLES * 3, DOT_TRIANGLE_LIST));
+		subMeshes.push_back(SubMesh(NUM_SUB_MESH_TRIANGLES * 3, NUM_SUB_MESH_TRIANGLES * 3, DOT_TRIANGLE_LIST));
+
+		Vector<CullingMode> cullModes = { CULL_NONE, CULL_CLOCKWISE };
+
+		SPtr<MeshBVH> bvh = MeshBVH::create(meshData, subMeshes);
+		BS_TEST_ASSERT(bvh != nullptr && bvh->getNumSubMeshes() == 2);
+
+		// Scalar Moller-Trumbore, with the same culling rules as the BVH
+		auto intersectTriangle = [&](UINT32 idx, const Vector3& origin, const Vector3& direction, float& distance)
+		{
+			const Vector3 (&vertices)[3] = triangles[idx].vertices;
+			Vector3 edge1 = vertices[1] - vertices[0];
+			Vector3 edge2 = vertices[2] - vertices[0];
+
+			Vector3 p = direction.cross(edge2);
+			float det = edge1.dot(p);
+			if (std::abs(det) < 1e-8f)
+				return false;
+
+			if (cullModes[idx / NUM_SUB_MESH_TRIANGLES] == CULL_CLOCKWISE && det < 0.0f)
+				return false;
+
+			Vector3 t = origin - vertices[0];
+			float u = t.dot(p) / det;
+			if (u < 0.0f || u > 1.0f)
+				return false;
+
+			Vector3 q = t.cross(edge1);
+			float v = direction.dot(q) / det;
+			if (v < 0.0f || u + v > 1.0f)
+				return false;
+
+			distance = edge2.dot(q) / det;
+			return distance > 0.0f;
+		};
+
+		UINT32 numHits = 0;
+		for (UINT32 i = 0; i < 500; i++)
+		{
+			// Rays from outside the cube towards a random point inside it, limited to a random distance
+			Vector3 origin = Vector3::normalize(randomPoint(1.0f)) * 30.0f;
+			Vector3 direction = Vector3::normalize(randomPoint(8.0f) - origin);
+			float maxDistance = 20.0f + random() * 30.0f;
+
+			float closest = maxDistance;
+			bool expectedHit = false;
+			for (UINT32 j = 0; j < NUM_TRIANGLES; j++)
+			{
+				float distance;
+				if (intersectTriangle(j, origin, direction, distance) && distance < closest)
+				{
+					closest = distance;
+					expectedHit = true;
+				}
+			}
+
+			MeshBVH::Hit hit;
+			bool hitFound = bvh->intersect(origin, direction, cullModes, maxDistance, hit);
+			BS_TEST_ASSERT(hitFound == expectedHit);
+
+			if (!hitFound || !expectedHit)
+				continue;
+
+			numHits++;
+			BS_TEST_ASSERT(std::abs(hit.distance - closest) < 1e-3f);
+
+			// Reported triangle must be the one at the reported distance (ties can be reported as either triangle)
+			UINT32 triangleIdx = hit.subMesh * NUM_SUB_MESH_TRIANGLES + hit.triangle;
+			float distance = 0.0f;
+			BS_TEST_ASSERT(hit.subMesh < 2 && hit.triangle < NUM_SUB_MESH_TRIANGLES);
+			BS_TEST_ASSERT(intersectTriangle(triangleIdx, origin, direction, distance));
+			BS_TEST_ASSERT(std::abs(distance - hit.distance) < 1e-3f);
+			BS_TEST_ASSERT(hit.normal.dot(direction) <= 0.0f);
+		}
+
+		// Make sure the rays actually exercised the hierarchy
+		BS_TEST_ASSERT(numHits > 50);
+
+		// Hierarchy can't be built without vertex positions
+		SPtr<VertexDataDesc> normalDesc = bs_shared_ptr_new<VertexDataDesc>();
+		normalDesc->addVertElem(VET_FLOAT3, VES_NORMAL);
+
+		BS_TEST_ASSERT(MeshBVH::create(bs_shared_ptr_new<MeshData>(3, 3, normalDesc), subMeshes) == nullptr);
+	}
+
+	void EditorTestSuite::TestDynamicAABBTree()
+	{
+		UINT32 seed = 8765;
+		auto random = [&seed]()
+		{
+			seed = seed * 1664525 + 1013904223;
+			return (seed >> 8) / (float)(1 << 24);
+		};
+
+		auto randomPoint = [&random](float extent)
+		{
+			return Vector3((random() * 2.0f - 1.0f) * extent, (random() * 2.0f - 1.0f) * extent,
+				(random() * 2.0f - 1.0f) * extent);
+		};
+
+		// Every tenth box is flat, so it only gets the minimum margin along one of the axes
+		auto randomBox = [&](UINT32 idx)
+		{
+			Vector3 center = randomPoint(50.0f);
+			Vector3 halfSize(random() * 2.0f + 0.1f, random() * 2.0f + 0.1f, random() * 2.0f + 0.1f);
+			if (idx % 10 == 0)
+				halfSize.y = 0.0f;
+
+			return AABox(center - halfSize, center + halfSize);
+		};
+
+		// Boxes inserted in order along a line would degenerate into a list without rotations
+		{
+			static constexpr UINT32 NUM_LINE_BOXES = 256;
+
+			DynamicAABBTree tree;
+			for (UINT32 i = 0; i < NUM_LINE_BOXES; i++)
+				tree.createProxy(AABox(Vector3(i * 2.0f, 0.0f, 0.0f), Vector3(i * 2.0f + 1.0f, 1.0f, 1.0f)), nullptr);
+
+			BS_TEST_ASSERT(tree.getHeight() <= 16);
+		}
+
+		static constexpr UINT32 NUM_BOXES = 500;
+
+		DynamicAABBTree tree;
+		BS_TEST_ASSERT(tree.getHeight() == 0);
+
+		Vector<AABox> boxes(NUM_BOXES);
+		Vector<UINT32> proxies(NUM_BOXES);
+		Vector<bool> alive(NUM_BOXES, true);
+		for (UINT32 i = 0; i < NUM_BOXES; i++)
+		{
+			boxes[i] = randomBox(i);
+			proxies[i] = tree.createProxy(boxes[i], (void*)(UINT64)i);
+		}
+
+		// Remove every third box, and move the rest either slightly or far enough to be reinserted
+		UINT32 numReinserted = 0;
+		for (UINT32 i = 0; i < NUM_BOXES; i++)
+		{
+			if (i % 3 == 0)
+			{
+				tree.destroyProxy(proxies[i]);
+				alive[i] = false;
+			}
+			else if (i % 3 == 1)
+			{
+				AABox oldFatBounds = tree.getFatBounds(proxies[i]);
+
+				Vector3 offset(0.0f, DynamicAABBTree::MIN_BOUNDS_MARGIN * 0.5f, 0.0f);
+				boxes[i] = AABox(boxes[i].getMin() + offset, boxes[i].getMax() + offset);
+
+				BS_TEST_ASSERT(!tree.moveProxy(proxies[i], boxes[i]));
+				BS_TEST_ASSERT(tree.getFatBounds(proxies[i]).getMin() == oldFatBounds.getMin());
+				BS_TEST_ASSERT(tree.getFatBounds(proxies[i]).getMax() == oldFatBounds.getMax());
+			}
+			else
+			{
+				boxes[i] = randomBox(i);
+				if (tree.moveProxy(proxies[i], boxes[i]))
+					numReinserted++;
+			}
+		}
+
+		BS_TEST_ASSERT(numReinserted > NUM_BOXES / 4);
+		BS_TEST_ASSERT(tree.getHeight() <= 20);
+
+		for (UINT32 i = 0; i < NUM_BOXES; i++)
+		{
+			if (!alive[i])
+				continue;
+
+			const AABox& fatBounds = tree.getFatBounds(proxies[i]);
+			BS_TEST_ASSERT(fatBounds.contains(boxes[i].getMin()) && fatBounds.contains(boxes[i].getMax()));
+			BS_TEST_ASSERT(tree.getUserData(proxies[i]) == (void*)(UINT64)i);
+		}
+
+		auto getIndex = [&tree](UINT32 proxy) { return (UINT32)(UINT64)tree.getUserData(proxy); };
+
+		// Box queries must report exactly the boxes whose enlarged bounds overlap, which includes all exact overlaps
+		for (UINT32 i = 0; i < 50; i++)
+		{
+			Vector3 center = randomPoint(50.0f);
+			Vector3 halfSize = Vector3::ONE * (random() * 15.0f + 1.0f);
+			AABox queryBounds(center - halfSize, center + halfSize);
+
+			Vector<bool> found(NUM_BOXES, false);
+			tree.query(queryBounds, [&](UINT32 proxy)
+			{
+				UINT32 idx = getIndex(proxy);
+				BS_TEST_ASSERT(alive[idx] && !found[idx]);
+				found[idx] = true;
+			});
+
+			for (UINT32 j = 0; j < NUM_BOXES; j++)
+			{
+				bool expected = alive[j] && tree.getFatBounds(proxies[j]).intersects(queryBounds);
+				BS_TEST_ASSERT(found[j] == expected);
+				BS_TEST_ASSERT(!alive[j] || !boxes[j].intersects(queryBounds) || found[j]);
+			}
+		}
+
+		// Frustum queries, using pyramids looking down the negative Z axis with the planes facing inwards
+		for (UINT32 i = 0; i < 20; i++)
+		{
+			Vector3 apex = randomPoint(40.0f);
+
+			Vector<Plane> planes;
+			planes.push_back(Plane(Vector3::normalize(Vector3(1.0f, 0.0f, -1.0f)), apex));
+			planes.push_back(Plane(Vector3::normalize(Vector3(-1.0f, 0.0f, -1.0f)), apex));
+			planes.push_back(Plane(Vector3::normalize(Vector3(0.0f, 1.0f, -1.0f)), apex));
+			planes.push_back(Plane(Vector3::normalize(Vector3(0.0f, -1.0f, -1.0f)), apex));
+			planes.push_back(Plane(Vector3(0.0f, 0.0f, -1.0f), apex - Vector3(0.0f, 0.0f, 1.0f)));
+			planes.push_back(Plane(Vector3(0.0f, 0.0f, 1.0f), apex - Vector3(0.0f, 0.0f, 60.0f)));
+
+			ConvexVolume volume(planes);
+
+			Vector<bool> found(NUM_BOXES, false);
+			tree.query(volume, [&](UINT32 proxy)
+			{
+				UINT32 idx = getIndex(proxy);
+				BS_TEST_ASSERT(alive[idx] && !found[idx]);
+				found[idx] = true;
+			});
+
+			for (UINT32 j = 0; j < NUM_BOXES; j++)
+			{
+				bool expected = alive[j] && volume.intersects(tree.getFatBounds(proxies[j]));
+				BS_TEST_ASSERT(found[j] == expected);
+				BS_TEST_ASSERT(!alive[j] || !volume.intersects(boxes[j]) || found[j]);
+			}
+		}
+
+		// Ray casts, first reporting every intersected box and then only the closest one
+		static constexpr float MAX_RAY_DISTANCE = 200.0f;
+
+		UINT32 numHits = 0;
+		for (UINT32 i = 0; i < 50; i++)
+		{
+			Vector3 origin = randomPoint(60.0f);
+			Vector3 direction = randomPoint(1.0f);
+			if (direction.length() < 0.01f)
+				continue;
+
+			direction.normalize();
+			Vector3 invDirection(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+
+			Vector<bool> expected(NUM_BOXES, false);
+			Vector<float> expectedDistances(NUM_BOXES, 0.0f);
+			float closest = MAX_RAY_DISTANCE;
+			bool anyHit = false;
+			for (UINT32 j = 0; j < NUM_BOXES; j++)
+			{
+				if (!alive[j])
+					continue;
+
+				const AABox& fatBounds = tree.getFatBounds(proxies[j]);
+				expected[j] = DynamicAABBTree::intersectBox(fatBounds.getMin(), fatBounds.getMax(), origin,
+					invDirection, MAX_RAY_DISTANCE, expectedDistances[j]);
+
+				if (expected[j])
+				{
+					closest = std::min(closest, expectedDistances[j]);
+					anyHit = true;
+				}
+			}
+
+			Vector<bool> found(NUM_BOXES, false);
+			tree.rayCast(origin, direction, MAX_RAY_DISTANCE, [&](UINT32 proxy, float distance)
+			{
+				UINT32 idx = getIndex(proxy);
+				BS_TEST_ASSERT(alive[idx] && !found[idx]);
+				BS_TEST_ASSERT(std::abs(distance - expectedDistances[idx]) < 1e-3f);
+				found[idx] = true;
+
+				return MAX_RAY_DISTANCE;
+			});
+
+			for (UINT32 j = 0; j < NUM_BOXES; j++)
+				BS_TEST_ASSERT(found[j] == expected[j]);
+
+			float nearest = MAX_RAY_DISTANCE;
+			bool hitFound = false;
+			tree.rayCast(origin, direction, MAX_RAY_DISTANCE, [&](UINT32 proxy, float distance)
+			{
+				nearest = std::min(nearest, distance);
+				hitFound = true;
+
+				return nearest;
+			});
+
+			BS_TEST_ASSERT(hitFound == anyHit);
+			if (anyHit)
+			{
+				BS_TEST_ASSERT(std::abs(nearest - closest) < 1e-3f);
+				numHits++;
+			}
+		}
+
+		// Make sure the rays actually exercised the hierarchy
+		BS_TEST_ASSERT(numHits > 10);
+
+		// Removing all the boxes leaves an empty tree
+		for (UINT32 i = 0; i < NUM_BOXES; i++)
+		{
+			if (alive[i])
+				tree.destroyProxy(proxies[i]);
+		}
+
+		BS_TEST_ASSERT(tree.getHeight() == 0);
+	}
+
+	void EditorTestSuite::TestScenePickingArea()
+	{
+		// Camera at the origin looking down the negative Z axis, seeing as far to the sides as it sees ahead
+		SPtr<Camera> camera = Camera::create();
+		camera->getViewport()->setTarget(gCoreApplication().getPrimaryWindow());
+
+		Rect2I viewArea = camera->getViewport()->getPixelArea();
+		if (viewArea.width < 2 || viewArea.height < 2)
+		{
+			camera->destroy();
+			return;
+		}
+
+		float aspect = viewArea.width / (float)viewArea.height;
+		camera->setHorzFOV(Degree(90.0f));
+		camera->setAspectRatio(aspect);
+		camera->setNearClipDistance(0.5f);
+		camera->setFarClipDistance(100.0f);
+
+		// Mesh whose bounds are a unit cube
+		SPtr<VertexDataDesc> vertexDesc = bs_shared_ptr_new<VertexDataDesc>();
+		vertexDesc->addVertElem(VET_FLOAT3, VES_POSITION);
+
+		SPtr<MeshData> meshData = bs_shared_ptr_new<MeshData>(3, 3, vertexDesc);
+		auto positionIter = meshData->getVec3DataIter(VES_POSITION);
+		positionIter.addValue(Vector3(-0.5f, -0.5f, -0.5f));
+		positionIter.addValue(Vector3(0.5f, 0.5f, 0.5f));
+		positionIter.addValue(Vector3(0.5f, -0.5f, 0.5f));
+
+		UINT32* indices = meshData->getIndices32();
+		for (UINT32 i = 0; i < 3; i++)
+			indices[i] = i;
+
+		HMesh mesh = Mesh::create(meshData);
+
+		auto createObject = [&mesh](const String& name, const Vector3& position)
+		{
+			HSceneObject so = SceneObject::create(name);
+			so->setPosition(position);
+
+			HRenderable renderable = so->addComponent<CRenderable>();
+			renderable->setMesh(mesh);
+
+			return so;
+		};
+
+		// Only the object in the middle of the top left quarter of the view is within the area covering that quarter.
+		// The area doesn't contain the view center, so the volume is built from a point inside the area itself.
+		float depth = 20.0f;
+		HSceneObject inArea = createObject("InArea", Vector3(-depth * 0.5f, depth * 0.5f / aspect, -depth));
+		HSceneObject outOfArea = createObject("OutOfArea", Vector3(depth * 0.5f, -depth * 0.5f / aspect, -depth));
+		HSceneObject behind = createObject("Behind", Vector3(-depth * 0.5f, depth * 0.5f / aspect, depth));
+		HSceneObject pastFar = createObject("PastFar", Vector3(-depth * 5.0f, depth * 5.0f / aspect, -depth * 10.0f));
+
+		Vector<HSceneObject> found = ScenePicking::instance().queryArea(camera, Vector2I(0, 0),
+			Vector2I(viewArea.width / 2, viewArea.height / 2));
+
+		auto isFound = [&found](const HSceneObject& so)
+		{
+			return std::find(found.begin(), found.end(), so) != found.end();
+		};
+
+		BS_TEST_ASSERT(isFound(inArea));
+		BS_TEST_ASSERT(!isFound(outOfArea));
+		BS_TEST_ASSERT(!isFound(behind));
+		BS_TEST_ASSERT(!isFound(pastFar));
+
+		// Area around the view center finds neither of the objects in the corners
+		found = ScenePicking::instance().queryArea(camera, Vector2I(viewArea.width / 2 - 2, viewArea.height / 2 - 2),
+			Vector2I(4, 4));
+
+		BS_TEST_ASSERT(!isFound(inArea));
+		BS_TEST_ASSERT(!isFound(outOfArea));
+
+		inArea->destroy();
+		outOfArea->destroy();
+		behind->destroy();
+		pastFar->destroy();
+		camera->destroy();
+	}
+}
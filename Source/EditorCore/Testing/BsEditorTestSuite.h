@@ -93,6 +93,21 @@ namespace bs
 
 		/**	Tests the frame allocator. */
 		void TestFrameAlloc();
+
+		/** Tests project library search index queries against a brute-force scan of the indexed entries. */
+		void TestProjectLibrarySearchIndex();
+
+		/** Tests writing a resource archive and reading its entries back through the archive format definition. */
+		void TestResourceArchive();
+
+		/** Tests mesh BVH ray casts against a brute-force test of every triangle. */
+		void TestMeshBVH();
+
+		/** Tests dynamic AABB tree updates, box, frustum and ray queries against a brute-force scan of the boxes. */
+		void TestDynamicAABBTree();
+
+		/** Tests scene picking area queries against objects placed inside and outside of the area. */
+		void TestScenePickingArea();
 	};
 
 	/** @} */
@@ -0,0 +1,214 @@
+//********************************** Banshee Engine (www.banshee3d.com) **************************************************//
+//**************** Copyright (c) 2016 Marko Pintera (marko.pintera@gmail.com). All rights reserved. **********************//
+#include "Utility/BsContentHash.h"
+#include "FileSystem/BsFileSystem.h"
+#include "FileSystem/BsDataStream.h"
+#include "Serialization/BsMemorySerializer.h"
+
+namespace bs
+{
+	static constexpr UINT64 PRIME64_1 = 11400714785074694791ULL;
+	static constexpr UINT64 PRIME64_2 = 14029467366897019727ULL;
+	static constexpr UINT64 PRIME64_3 = 1609587929392839161ULL;
+	static constexpr UINT64 PRIME64_4 = 9650029242287828579ULL;
+	static constexpr UINT64 PRIME64_5 = 2870177450012600261ULL;
+
+	/** Size of the chunks used when streaming file contents. */
+	static constexpr UINT32 FILE_CHUNK_SIZE = 64 * 1024;
+
+	static UINT64 rotl64(UINT64 value, UINT32 amount)
+	{
+		return (value << amount) | (value >> (64 - amount));
+	}
+
+	static UINT64 read64(const UINT8* data)
+	{
+		UINT64 value;
+		memcpy(&value, data, sizeof(value));
+
+		return value;
+	}
+
+	static UINT32 read32(const UINT8* data)
+	{
+		UINT32 value;
+		memcpy(&value, data, sizeof(value));
+
+		return value;
+	}
+
+	static UINT64 round64(UINT64 acc, UINT64 input)
+	{
+		acc += input * PRIME64_2;
+		acc = rotl64(acc, 31);
+		acc *= PRIME64_1;
+
+		return acc;
+	}
+
+	static UINT64 mergeRound64(UINT64 acc, UINT64 value)
+	{
+		value = round64(0, value);
+		acc ^= value;
+		acc = acc * PRIME64_1 + PRIME64_4;
+
+		return acc;
+	}
+
+	ContentHash::ContentHash(UINT64 seed)
+		:mBufferSize(0), mTotalSize(0), mSeed(seed)
+	{
+		mAcc[0] = seed + PRIME64_1 + PRIME64_2;
+		mAcc[1] = seed + PRIME64_2;
+		mAcc[2] = seed;
+		mAcc[3] = seed - PRIME64_1;
+	}
+
+	void ContentHash::update(const void* data, UINT64 size)
+	{
+		if (data == nullptr || size == 0)
+			return;
+
+		const UINT8* input = (const UINT8*)data;
+		const UINT8* end = input + size;
+
+		mTotalSize += size;
+
+		// Not enough data for a full stripe, just buffer it
+		if(mBufferSize + size < 32)
+		{
+			memcpy(mBuffer + mBufferSize, input, (size_t)size);
+			mBufferSize += (UINT32)size;
+			return;
+		}
+
+		// Complete the buffered stripe
+		if(mBufferSize > 0)
+		{
+			UINT32 toCopy = 32 - mBufferSize;
+			memcpy(mBuffer + mBufferSize, input, toCopy);
+
+			mAcc[0] = round64(mAcc[0], read64(mBuffer + 0));
+			mAcc[1] = round64(mAcc[1], read64(mBuffer + 8));
+			mAcc[2] = round64(mAcc[2], read64(mBuffer + 16));
+			mAcc[3] = round64(mAcc[3], read64(mBuffer + 24));
+
+			input += toCopy;
+			mBufferSize = 0;
+		}
+
+		// Process full stripes directly from the input
+		while(input + 32 <= end)
+		{
+			mAcc[0] = round64(mAcc[0], read64(input + 0));
+			mAcc[1] = round64(mAcc[1], read64(input + 8));
+			mAcc[2] = round64(mAcc[2], read64(input + 16));
+			mAcc[3] = round64(mAcc[3], read64(input + 24));
+
+			input += 32;
+		}
+
+		// Buffer the remainder
+		if(input < end)
+		{
+			mBufferSize = (UINT32)(end - input);
+			memcpy(mBuffer, input, mBufferSize);
+		}
+	}
+
+	UINT64 ContentHash::getHash() const
+	{
+		UINT64 hash;
+		if(mTotalSize >= 32)
+		{
+			hash = rotl64(mAcc[0], 1) + rotl64(mAcc[1], 7) + rotl64(mAcc[2], 12) + rotl64(mAcc[3], 18);
+			hash = mergeRound64(hash, mAcc[0]);
+			hash = mergeRound64(hash, mAcc[1]);
+			hash = mergeRound64(hash, mAcc[2]);
+			hash = mergeRound64(hash, mAcc[3]);
+		}
+		else
+			hash = mSeed + PRIME64_5;
+
+		hash += mTotalSize;
+
+		const UINT8* input = mBuffer;
+		const UINT8* end = mBuffer + mBufferSize;
+
+		while(input + 8 <= end)
+		{
+			hash ^= round64(0, read64(input));
+			hash = rotl64(hash, 27) * PRIME64_1 + PRIME64_4;
+			input += 8;
+		}
+
+		if(input + 4 <= end)
+		{
+			hash ^= (UINT64)read32(input) * PRIME64_1;
+			hash = rotl64(hash, 23) * PRIME64_2 + PRIME64_3;
+			input += 4;
+		}
+
+		while(input < end)
+		{
+			hash ^= (*input) * PRIME64_5;
+			hash = rotl64(hash, 11) * PRIME64_1;
+			input++;
+		}
+
+		hash ^= hash >> 33;
+		hash *= PRIME64_2;
+		hash ^= hash >> 29;
+		hash *= PRIME64_3;
+		hash ^= hash >> 32;
+
+		return hash;
+	}
+
+	UINT64 ContentHash::compute(const void* data, UINT64 size, UINT64 seed)
+	{
+		ContentHash hash(seed);
+		hash.update(data, size);
+
+		return hash.getHash();
+	}
+
+	UINT64 ContentHash::computeFile(const Path& path, UINT64 seed)
+	{
+		SPtr<DataStream> stream = FileSystem::openFile(path, true);
+		if (stream == nullptr)
+			return 0;
+
+		ContentHash hash(seed);
+
+		UINT8* buffer = (UINT8*)bs_alloc(FILE_CHUNK_SIZE);
+		while(!stream->eof())
+		{
+			size_t numRead = stream->read(buffer, FILE_CHUNK_SIZE);
+			if (numRead == 0)
+				break;
+
+			hash.update(buffer, numRead);
+		}
+
+		bs_free(buffer);
+		stream->close();
+
+		return hash.getHash();
+	}
+
+	UINT64 ContentHash::computeObject(IReflectable* object, UINT64 seed)
+	{
+		if (object == nullptr)
+			return 0;
+
+		UINT32 size = 0;
+		MemorySerializer serializer;
+		UINT8* data = serializer.encode(object, size);
+
+		UINT64 hash = compute(data, size, seed);
+		bs_free(data);
+
+		return hash;
+	}
+}
@@ -0,0 +1,55 @@
+//********************************** Banshee Engine (www.banshee3d.com) **************************************************//
+//**************** Copyright (c) 2016 Marko Pintera (marko.pintera@gmail.com). All rights reserved. **********************//
+#pragma once
+
+#include "BsEditorPrerequisites.h"
+
+namespace bs
+{
+	/** @addtogroup Utility-Editor
+	 *  @{
+	 */
+
+	/**
+	 * Calculates a fast, non-cryptographic 64-bit hash of arbitrary data (XXH64 algorithm). Data can be provided
+	 * incrementally, allowing large files to be hashed without loading them into memory at once.
+	 */
+	class BS_ED_EXPORT ContentHash
+	{
+	public:
+		/** Starts a new hash calculation, using the provided seed. */
+		ContentHash(UINT64 seed = 0);
+
+		/** Appends the provided data to the hash. */
+		void update(const void* data, UINT64 size);
+
+		/**
+		 * Returns the hash of all the data provided so far. Doesn't reset the state, more data can be appended later.
+		 */
+		UINT64 getHash() const;
+
+		/** Calculates the hash of the provided block of data. */
+		static UINT64 compute(const void* data, UINT64 size, UINT64 seed = 0);
+
+		/**
+		 * Calculates the hash of the contents of the file at the specified path. File contents are streamed in chunks.
+		 * Returns 0 if the file cannot be opened.
+		 */
+		static UINT64 computeFile(const Path& path, UINT64 seed = 0);
+
+		/**
+		 * Calculates the hash of a reflectable object by hashing its serialized representation. Returns 0 if the object
+		 * is null.
+		 */
+		static UINT64 computeObject(IReflectable* object, UINT64 seed = 0);
+
+	private:
+		UINT64 mAcc[4];
+		UINT8 mBuffer[32];
+		UINT32 mBufferSize;
+		UINT64 mTotalSize;
+		UINT64 mSeed;
+	};
+
+	/** @} */
+}
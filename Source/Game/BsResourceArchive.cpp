@@ -0,0 +1,419 @@
+//********************************** Banshee Engine (www.banshee3d.com) **************************************************//
+//**************** Copyright (c) 2016 Marko Pintera (marko.pintera@gmail.com). All rights reserved. **********************//
+#include "BsResourceArchive.h"
+#include "FileSystem/BsFileSystem.h"
+#include "FileSystem/BsDataStream.h"
+#include "Resources/BsResources.h"
+#include "Resources/BsResource.h"
+#include "Resources/BsResourceManifest.h"
+#include "Resources/BsSavedResourceData.h"
+#include "Serialization/BsMemorySerializer.h"
+#include "Utility/BsCompression.h"
+#include "Debug/BsDebug.h"
+
+namespace bs
+{
+	const char* ResourceArchive::ARCHIVE_NAME = ARCHIVE_FILE_NAME;
+	const char* ResourceArchive::LOAD_TRACE_NAME = LOAD_TRACE_FILE_NAME;
+	const char* ResourceArchive::PREFETCH_LIST_NAME = PREFETCH_LIST_FILE_NAME;
+
+	/**
+	 * Decodes the next object of a resource file. Resource files consist of objects encoded one after another, each
+	 * prefixed by its size.
+	 */
+	static SPtr<IReflectable> decodeResourceObject(Vector<UINT8>& data, UINT64& offset)
+	{
+		UINT32 size;
+		if (data.size() - offset < sizeof(size))
+			return nullptr;
+
+		memcpy(&size, data.data() + offset, sizeof(size));
+		offset += sizeof(size);
+
+		if (data.size() - offset < size)
+			return nullptr;
+
+		MemorySerializer serializer;
+		SPtr<IReflectable> object = serializer.decode(data.data() + offset, size);
+		offset += size;
+
+		return object;
+	}
+
+	ResourceArchive::ResourceArchive(const Path& path, const SPtr<DataStream>& stream, Vector<ArchiveIndexEntry> index)
+		:mPath(path), mStream(stream), mIndex(std::move(index)), mCancelPrefetch(false)
+	{ }
+
+	ResourceArchive::~ResourceArchive()
+	{
+		stopPrefetch();
+		mStream->close();
+	}
+
+	SPtr<ResourceArchive> ResourceArchive::open(const Path& path)
+	{
+		if (!FileSystem::isFile(path))
+			return nullptr;
+
+		SPtr<DataStream> stream = FileSystem::openFile(path, true);
+		if (stream == nullptr)
+			return nullptr;
+
+		ArchiveHeader header;
+		ArchiveFooter footer;
+		UINT64 size = stream->size();
+
+		bool valid = size >= sizeof(header) + sizeof(footer) &&
+			stream->read(&header, sizeof(header)) == sizeof(header) && header.magic == ARCHIVE_MAGIC &&
+			header.version == ARCHIVE_VERSION;
+
+		if (valid)
+		{
+			stream->seek((size_t)(size - sizeof(footer)));
+			valid = stream->read(&footer, sizeof(footer)) == sizeof(footer) && footer.magic == ARCHIVE_MAGIC &&
+				footer.indexOffset + (UINT64)footer.numEntries * sizeof(ArchiveIndexEntry) + sizeof(footer) == size;
+		}
+
+		Vector<ArchiveIndexEntry> index;
+		if (valid)
+		{
+			size_t indexSize = footer.numEntries * sizeof(ArchiveIndexEntry);
+			index.resize(footer.numEntries);
+
+			stream->seek((size_t)footer.indexOffset);
+			valid = stream->read(index.data(), indexSize) == indexSize;
+		}
+
+		if (!valid)
+		{
+			LOGERR("Unable to open resource archive, the file is corrupt or of an unsupported version: " +
+				path.toString());
+
+			stream->close();
+			return nullptr;
+		}
+
+		return bs_shared_ptr_new<ResourceArchive>(path, stream, std::move(index));
+	}
+
+	HResource ResourceArchive::load(const UUID& uuid, bool keepLoaded)
+	{
+		HResource handle = gResources()._getResourceHandle(uuid);
+		if (handle != nullptr && handle.isLoaded(false))
+			return handle;
+
+		const ArchiveIndexEntry* entry = findEntry(uuid);
+		if (entry == nullptr)
+		{
+			ResourceLoadFlags loadFlags = ResourceLoadFlag::LoadDependencies;
+			if (keepLoaded)
+				loadFlags |= ResourceLoadFlag::KeepInternalRef;
+
+			return gResources().loadFromUUID(uuid, false, loadFlags);
+		}
+
+		// Circular dependency, the resource will be assigned to the handle once its load finishes
+		if (!mLoading.insert(uuid).second)
+			return handle;
+
+		UINT32 recordIdx = (UINT32)mLoadTrace.size();
+		UINT64 startTime = 0;
+		if (mRecording)
+		{
+			startTime = mRecordingTimer.getMicroseconds();
+			mLoadTrace.push_back({ uuid, startTime, 0 });
+		}
+
+		SPtr<Resource> resource;
+
+		Vector<UINT8> data;
+		if (readEntry(*entry, data))
+		{
+			UINT64 offset = 0;
+			SPtr<IReflectable> savedData = decodeResourceObject(data, offset);
+			if (savedData != nullptr && savedData->isDerivedFrom(SavedResourceData::getRTTIStatic()))
+			{
+				// Dependencies must be loaded first, so the resource's handles reference loaded resources when decoded
+				for (auto& dependency : std::static_pointer_cast<SavedResourceData>(savedData)->getDependencies())
+					load(dependency, false);
+
+				SPtr<IReflectable> object = decodeResourceObject(data, offset);
+				if (object != nullptr && object->isDerivedFrom(Resource::getRTTIStatic()))
+					resource = std::static_pointer_cast<Resource>(object);
+			}
+		}
+
+		mLoading.erase(uuid);
+
+		if (mRecording)
+			mLoadTrace[recordIdx].duration = mRecordingTimer.getMicroseconds() - startTime;
+
+		if (resource == nullptr)
+		{
+			LOGERR("Unable to load resource from the archive, the entry is corrupt: " + uuid.toString());
+			return HResource();
+		}
+
+		if (handle != nullptr)
+			gResources().update(handle, resource);
+		else
+			handle = gResources()._createResourceHandle(resource, uuid);
+
+		// Resource is already loaded, so this only registers the internal reference
+		if (keepLoaded)
+			gResources().loadFromUUID(uuid, false, ResourceLoadFlag::KeepInternalRef);
+
+		return handle;
+	}
+
+	const ArchiveIndexEntry* ResourceArchive::findEntry(const UUID& uuid) const
+	{
+		auto iterFind = std::lower_bound(mIndex.begin(), mIndex.end(), uuid, &compareArchiveEntryUUID);
+		if (iterFind == mIndex.end() || iterFind->uuid != uuid)
+			return nullptr;
+
+		return &*iterFind;
+	}
+
+	bool ResourceArchive::readEntry(const ArchiveIndexEntry& entry, Vector<UINT8>& output)
+	{
+		{
+			Lock lock(mPrefetchMutex);
+
+			// Prefetch reads entries in the order they're expected to be loaded in, so it should reach this one soon
+			if (mPrefetchPending.find(entry.uuid) != mPrefetchPending.end())
+			{
+				Timer waitTimer;
+				while (mPrefetchPending.find(entry.uuid) != mPrefetchPending.end())
+					mPrefetchSignal.wait(lock);
+
+				mStatistics.prefetchWaitTime += waitTimer.getMicroseconds();
+			}
+
+			auto iterFind = mPrefetched.find(entry.uuid);
+			if (iterFind != mPrefetched.end())
+			{
+				output = std::move(iterFind->second);
+				mPrefetched.erase(iterFind);
+
+				mStatistics.numLoaded++;
+				mStatistics.numPrefetched++;
+				return true;
+			}
+		}
+
+		Timer readTimer;
+		if (!readEntryData(*mStream, entry, output))
+			return false;
+
+		mStatistics.numLoaded++;
+		mStatistics.bytesRead += entry.size;
+		mStatistics.readTime += readTimer.getMicroseconds();
+
+		if (entry.compression == (UINT32)ArchiveCompression::None)
+			return true;
+
+		Timer decompressionTimer;
+		if (!decompressEntryData(entry, output))
+			return false;
+
+		mStatistics.bytesDecompressed += entry.uncompressedSize;
+		mStatistics.decompressionTime += decompressionTimer.getMicroseconds();
+		return true;
+	}
+
+	bool ResourceArchive::readEntryData(DataStream& stream, const ArchiveIndexEntry& entry, Vector<UINT8>& output)
+	{
+		output.resize((size_t)entry.size);
+
+		stream.seek((size_t)entry.offset);
+		return stream.read(output.data(), output.size()) == output.size();
+	}
+
+	bool ResourceArchive::decompressEntryData(const ArchiveIndexEntry& entry, Vector<UINT8>& data)
+	{
+		switch ((ArchiveCompression)entry.compression)
+		{
+		case ArchiveCompression::None:
+			return true;
+		case ArchiveCompression::Snappy:
+		{
+			// Decompress directly from the read buffer, without an intermediate copy
+			SPtr<DataStream> compressed = bs_shared_ptr_new<MemoryDataStream>(data.data(), data.size(), false);
+			SPtr<MemoryDataStream> decompressed = Compression::decompress(compressed);
+			if (decompressed == nullptr || decompressed->size() != entry.uncompressedSize)
+				return false;
+
+			data.assign(decompressed->getPtr(), decompressed->getPtr() + decompressed->size());
+			return true;
+		}
+		default:
+			return false;
+		}
+	}
+
+	void ResourceArchive::prefetch(const Vector<UUID>& uuids)
+	{
+		// Only a single prefetch at a time is supported
+		if (mPrefetchTask != nullptr)
+			return;
+
+		Vector<UUID> prefetched;
+		{
+			Lock lock(mPrefetchMutex);
+			for (auto& uuid : uuids)
+			{
+				if (contains(uuid) && mPrefetchPending.insert(uuid).second)
+					prefetched.push_back(uuid);
+			}
+		}
+
+		if (prefetched.empty())
+			return;
+
+		mCancelPrefetch = false;
+		mPrefetchTask = Task::create("ResourceArchivePrefetch", std::bind(&ResourceArchive::prefetchWorker, this,
+			prefetched));
+		TaskScheduler::instance().addTask(mPrefetchTask);
+	}
+
+	void ResourceArchive::stopPrefetch()
+	{
+		if (mPrefetchTask == nullptr)
+			return;
+
+		mCancelPrefetch = true;
+		mPrefetchTask->wait();
+		mPrefetchTask = nullptr;
+
+		Lock lock(mPrefetchMutex);
+		mPrefetched.clear();
+	}
+
+	void ResourceArchive::prefetchWorker(const Vector<UUID>& uuids)
+	{
+		// Separate stream so the prefetch doesn't interfere with reads on the main thread
+		SPtr<DataStream> stream = FileSystem::openFile(mPath, true);
+
+		for (auto& uuid : uuids)
+		{
+			const ArchiveIndexEntry* entry = findEntry(uuid);
+
+			Vector<UINT8> data;
+			bool read = !mCancelPrefetch && stream != nullptr && readEntryData(*stream, *entry, data) &&
+				decompressEntryData(*entry, data);
+
+			{
+				Lock lock(mPrefetchMutex);
+				mPrefetchPending.erase(uuid);
+
+				// If the read failed, the entry is read again on load
+				if (read)
+					mPrefetched[uuid] = std::move(data);
+			}
+
+			mPrefetchSignal.notify_all();
+		}
+
+		if (stream != nullptr)
+			stream->close();
+	}
+
+	void ResourceArchive::startRecording()
+	{
+		mRecording = true;
+		mRecordingTimer.reset();
+		mLoadTrace.clear();
+		mNumStartupRecords = 0;
+	}
+
+	void ResourceArchive::markStartupFinished()
+	{
+		mNumStartupRecords = (UINT32)mLoadTrace.size();
+	}
+
+	bool ResourceArchive::saveLoadTrace(const Path& path) const
+	{
+		LoadTraceHeader header;
+		header.magic = LOAD_TRACE_MAGIC;
+		header.version = LOAD_TRACE_VERSION;
+		header.numRecords = (UINT32)mLoadTrace.size();
+
+		// If startup was never marked, consider all the recorded loads as part of the startup
+		header.numStartupRecords = mNumStartupRecords > 0 ? mNumStartupRecords : header.numRecords;
+
+		SPtr<DataStream> stream = FileSystem::createAndOpenFile(path);
+		if (stream == nullptr)
+			return false;
+
+		size_t recordsSize = mLoadTrace.size() * sizeof(LoadTraceRecord);
+		bool written = stream->write(&header, sizeof(header)) == sizeof(header) &&
+			stream->write(mLoadTrace.data(), recordsSize) == recordsSize;
+		stream->close();
+
+		return written;
+	}
+
+	bool ResourceArchive::loadPrefetchList(const Path& path, Vector<UUID>& uuids)
+	{
+		if (!FileSystem::isFile(path))
+			return false;
+
+		SPtr<DataStream> stream = FileSystem::openFile(path, true);
+		if (stream == nullptr)
+			return false;
+
+		PrefetchListHeader header;
+		bool valid = stream->read(&header, sizeof(header)) == sizeof(header) && header.magic == PREFETCH_LIST_MAGIC &&
+			header.version == PREFETCH_LIST_VERSION &&
+			(UINT64)stream->size() == sizeof(header) + (UINT64)header.numEntries * sizeof(UUID);
+
+		if (valid)
+		{
+			uuids.resize(header.numEntries);
+
+			size_t uuidsSize = uuids.size() * sizeof(UUID);
+			valid = stream->read(uuids.data(), uuidsSize) == uuidsSize;
+		}
+
+		stream->close();
+		return valid;
+	}
+
+	ArchiveResourceLoader::ArchiveResourceLoader(const SPtr<ResourceArchive>& archive,
+		const SPtr<ResourceMapping>& mapping, const SPtr<ResourceManifest>& manifest)
+		:mArchive(archive), mManifest(manifest)
+	{
+		if (mapping == nullptr || manifest == nullptr)
+			return;
+
+		// Packaged resource paths in the mapping are relative to the folder containing the resources folder, while the
+		// manifest stores absolute paths
+		Path resourceRoot = Paths::getGameResourcesPath();
+		resourceRoot.makeParent();
+
+		for (auto& entry : mapping->getMap())
+		{
+			UUID uuid;
+			if (manifest->filePathToUUID(resourceRoot + entry.second, uuid))
+				mPathToUUID[entry.first] = uuid;
+		}
+	}
+
+	HResource ArchiveResourceLoader::load(const Path& path, bool keepLoaded) const
+	{
+		auto iterFind = mPathToUUID.find(path);
+		if (iterFind != mPathToUUID.end())
+			return mArchive->load(iterFind->second, keepLoaded);
+
+		// Packaged resource referenced by its handle, see ScriptResourceManager::loadResource
+		UUID uuid;
+		if (mManifest != nullptr && path.isAbsolute() && mManifest->filePathToUUID(path, uuid) &&
+			mArchive->contains(uuid))
+		{
+			return mArchive->load(uuid, keepLoaded);
+		}
+
+		return HResource();
+	}
+}
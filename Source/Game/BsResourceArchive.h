@@ -0,0 +1,183 @@
+//********************************** Banshee Engine (www.banshee3d.com) **************************************************//
+//**************** Copyright (c) 2016 Marko Pintera (marko.pintera@gmail.com). All rights reserved. **********************//
+#pragma once
+
+#include "BsCorePrerequisites.h"
+#include "Resources/BsGameResourceManager.h"
+#include "Utility/BsTimer.h"
+#include "Threading/BsTaskScheduler.h"
+#include "Build/BsResourceArchiveFormat.h"
+#include <atomic>
+
+namespace bs
+{
+	/**
+	 * Provides access to resources packed into a single archive by the editor build (see ResourceArchiveWriter in
+	 * EditorCore, and BsResourceArchiveFormat.h for the format). The archive index is read once when the archive is
+	 * opened and the archive file is kept open, so loading a resource requires a single seek and read, with no file
+	 * system lookups.
+	 *
+	 * Resources expected to be needed soon can be prefetched, in which case they are read on a worker thread and
+	 * loading them doesn't need to access the archive file at all. The archive can also record the order in which
+	 * resources are loaded, which the editor uses to lay out the archive and to decide which resources to prefetch on
+	 * startup.
+	 */
+	class ResourceArchive
+	{
+	public:
+		/** Constructs an archive from an already opened archive file and its index. Use open() instead. */
+		ResourceArchive(const Path& path, const SPtr<DataStream>& stream, Vector<ArchiveIndexEntry> index);
+		~ResourceArchive();
+
+		/** Statistics about the resources loaded from the archive so far. */
+		struct Statistics
+		{
+			UINT32 numLoaded = 0; /**< Number of resources loaded from the archive. */
+			UINT32 numPrefetched = 0; /**< Number of loaded resources that were already prefetched. */
+			UINT64 bytesRead = 0; /**< Total size of the entries read on load, as stored in the archive. */
+			UINT64 bytesDecompressed = 0; /**< Total size of the compressed entries read on load, once decompressed. */
+			UINT64 readTime = 0; /**< Time spent reading entries on load, in microseconds. */
+			UINT64 decompressionTime = 0; /**< Time spent decompressing entries on load, in microseconds. */
+			UINT64 prefetchWaitTime = 0; /**< Time spent waiting on the prefetch to read an entry, in microseconds. */
+		};
+
+		/**
+		 * Opens the archive at the specified path.
+		 *
+		 * @param[in]	path	Absolute path to the archive file.
+		 * @return				Opened archive, or null if the archive is missing, of a different version, or corrupt.
+		 */
+		static SPtr<ResourceArchive> open(const Path& path);
+
+		/** Checks does the archive contain the resource with the specified UUID. */
+		bool contains(const UUID& uuid) const { return findEntry(uuid) != nullptr; }
+
+		/**
+		 * Loads the resource with the specified UUID, along with all the resources it depends on. Resources that aren't
+		 * part of the archive (for example built-in resources) are loaded through Resources instead. Resources that are
+		 * already loaded are not loaded again.
+		 *
+		 * @param[in]	uuid		UUID of the resource to load.
+		 * @param[in]	keepLoaded	If true the resource will be kept loaded even after all of its handles are released.
+		 * @return					Handle to the loaded resource, or an empty handle if the resource failed to load.
+		 */
+		HResource load(const UUID& uuid, bool keepLoaded);
+
+		/**
+		 * Starts reading the specified resources on a worker thread, in the provided order. Any load() of a resource
+		 * waiting to be prefetched waits for the prefetch to reach it, instead of reading it separately.
+		 *
+		 * @param[in]	uuids	UUIDs of the resources to prefetch. Resources that aren't part of the archive are
+		 *						ignored.
+		 */
+		void prefetch(const Vector<UUID>& uuids);
+
+		/**
+		 * Stops the prefetch started by prefetch(), if any, and waits for its worker to finish. Releases the data of
+		 * any prefetched resources that weren't loaded yet. Must be called before the task scheduler shuts down.
+		 */
+		void stopPrefetch();
+
+		/** Starts recording the order and timing of all resources loaded from the archive. */
+		void startRecording();
+
+		/**
+		 * Marks the end of application startup in the recorded load trace. Resources loaded up to this point are
+		 * prefetched on startup in future builds.
+		 */
+		void markStartupFinished();
+
+		/**
+		 * Writes the load order and timing recorded since startRecording() was called to the specified file.
+		 *
+		 * @param[in]	path	Absolute path to the load trace file.
+		 * @return				True if the file was successfully written.
+		 */
+		bool saveLoadTrace(const Path& path) const;
+
+		/**
+		 * Reads a list of resources to prefetch, as written by the editor build.
+		 *
+		 * @param[in]	path	Absolute path to the prefetch list.
+		 * @param[out]	uuids	UUIDs of the resources to prefetch, in the order they should be read in.
+		 * @return				True if the list was read, false if the file is missing or invalid.
+		 */
+		static bool loadPrefetchList(const Path& path, Vector<UUID>& uuids);
+
+		/** Returns statistics about the resources loaded from the archive so far. */
+		const Statistics& getStatistics() const { return mStatistics; }
+
+		/** Name of the archive file in the game resources folder. */
+		static const char* ARCHIVE_NAME;
+
+		/** Name of the load trace file in the game resources folder. */
+		static const char* LOAD_TRACE_NAME;
+
+		/** Name of the prefetch list in the game resources folder. */
+		static const char* PREFETCH_LIST_NAME;
+
+	private:
+		/** Returns the index record of the resource with the specified UUID, or null if not in the archive. */
+		const ArchiveIndexEntry* findEntry(const UUID& uuid) const;
+
+		/**
+		 * Returns the data of the provided entry, decompressed if required. Uses the prefetched data if the entry was
+		 * prefetched, or reads it from the archive otherwise. Returns false on failure.
+		 */
+		bool readEntry(const ArchiveIndexEntry& entry, Vector<UINT8>& output);
+
+		/** Reads the data of the provided entry from the stream, without decompressing it. */
+		static bool readEntryData(DataStream& stream, const ArchiveIndexEntry& entry, Vector<UINT8>& output);
+
+		/** Decompresses the data of the provided entry in place. Does nothing if the entry isn't compressed. */
+		static bool decompressEntryData(const ArchiveIndexEntry& entry, Vector<UINT8>& data);
+
+		/** Reads the provided resources into the prefetched data. Called on the prefetch worker thread. */
+		void prefetchWorker(const Vector<UUID>& uuids);
+
+		Path mPath;
+		SPtr<DataStream> mStream;
+		Vector<ArchiveIndexEntry> mIndex;
+		UnorderedSet<UUID> mLoading;
+		Statistics mStatistics;
+
+		SPtr<Task> mPrefetchTask;
+		std::atomic<bool> mCancelPrefetch;
+		Mutex mPrefetchMutex;
+		Signal mPrefetchSignal;
+		UnorderedSet<UUID> mPrefetchPending;
+		UnorderedMap<UUID, Vector<UINT8>> mPrefetched;
+
+		bool mRecording = false;
+		Timer mRecordingTimer;
+		Vector<LoadTraceRecord> mLoadTrace;
+		UINT32 mNumStartupRecords = 0;
+	};
+
+	/**
+	 * Handles loading of game resources by path, from a resource archive. Accepts both the paths used by the game, and
+	 * the paths of the packaged resource files as listed in the manifest, which no longer exist on disk once packed.
+	 */
+	class ArchiveResourceLoader : public IGameResourceLoader
+	{
+	public:
+		/**
+		 * Creates a loader for the provided archive.
+		 *
+		 * @param[in]	archive		Archive to load the resources from.
+		 * @param[in]	mapping		Mapping of resource paths used by the game to the paths of the packaged resources.
+		 * @param[in]	manifest	Manifest of the packaged resources, used for finding the UUIDs of the packaged
+		 *							resources.
+		 */
+		ArchiveResourceLoader(const SPtr<ResourceArchive>& archive, const SPtr<ResourceMapping>& mapping,
+			const SPtr<ResourceManifest>& manifest);
+
+		/** @copydoc IGameResourceLoader::load */
+		HResource load(const Path& path, bool keepLoaded) const override;
+
+	private:
+		SPtr<ResourceArchive> mArchive;
+		SPtr<ResourceManifest> mManifest;
+		UnorderedMap<Path, UUID> mPathToUUID;
+	};
+}
@@ -1,9 +1,11 @@
 set(BS_GAME_INC_NOFILTER
 	"resource.h"
+	"BsResourceArchive.h"
 )
 
 set(BS_GAME_SRC_NOFILTER
 	"Main.cpp"
+	"BsResourceArchive.cpp"
 )
 
 source_group("Header Files" FILES ${BS_GAME_INC_NOFILTER})
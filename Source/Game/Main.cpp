@@ -14,8 +14,14 @@
 #include "RenderAPI/BsRenderAPI.h"
 #include "Resources/BsGameResourceManager.h"
 #include "BsEngineConfig.h"
+#include "Utility/BsTimer.h"
+#include "Debug/BsDebug.h"
+#include "BsResourceArchive.h"
 
-void runApplication();
+void runApplication(bool recordLoadOrder);
+
+/** Command line option that makes the game record the order resources are loaded in, for use by the next build. */
+static const char* RECORD_LOAD_ORDER_OPTION = "--record-load-order";
 
 #if BS_PLATFORM == BS_PLATFORM_WIN32
 #include <windows.h>
@@ -33,7 +39,7 @@ int CALLBACK WinMain(
 
 	__try
 	{
-		runApplication();
+		runApplication(strstr(lpCmdLine, RECORD_LOAD_ORDER_OPTION) != nullptr);
 	}
 	__except (gCrashHandler().reportCrash(GetExceptionInformation()))
 	{
@@ -45,16 +51,23 @@ int CALLBACK WinMain(
 	return 0;
 }
 #else
-int main()
+int main(int argc, char* argv[])
 {
-	runApplication();
+	bool recordLoadOrder = false;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], RECORD_LOAD_ORDER_OPTION) == 0)
+			recordLoadOrder = true;
+	}
+
+	runApplication(recordLoadOrder);
 	return 0;
 }
 #endif // End BS_PLATFORM
 
 using namespace bs;
 
-void runApplication()
+void runApplication(bool recordLoadOrder)
 {
 	Path gameSettingsPath = Paths::getGameSettingsPath();
 
@@ -97,6 +110,21 @@ void runApplication()
 
 	GameResourceManager::instance().setMapping(resMapping);
 
+	// If the resources were packed into an archive, load them from it instead of from the individual resource files.
+	// Open it as early as possible so the resources needed on startup can be prefetched while the rest is set up.
+	Path resourceArchivePath = resourcesPath + ResourceArchive::ARCHIVE_NAME;
+	SPtr<ResourceArchive> resourceArchive = ResourceArchive::open(resourceArchivePath);
+
+	if (resourceArchive != nullptr)
+	{
+		// Prefetching would affect the recorded timings, so it's skipped when recording
+		Vector<UUID> prefetchList;
+		if (recordLoadOrder)
+			resourceArchive->startRecording();
+		else if (ResourceArchive::loadPrefetchList(resourcesPath + ResourceArchive::PREFETCH_LIST_NAME, prefetchList))
+			resourceArchive->prefetch(prefetchList);
+	}
+
 	if (gameSettings->fullscreen)
 	{
 		if (gameSettings->useDesktopResolution)
@@ -146,9 +174,40 @@ void runApplication()
 		gResources().registerResourceManifest(manifest);
 	}
 
+	if (resourceArchive != nullptr)
+	{
+		SPtr<ArchiveResourceLoader> resourceLoader =
+			bs_shared_ptr_new<ArchiveResourceLoader>(resourceArchive, resMapping, manifest);
+
+		GameResourceManager::instance().setLoader(resourceLoader);
+	}
+
 	{
-		HPrefab mainScene = static_resource_cast<Prefab>(gResources().loadFromUUID(gameSettings->mainSceneUUID, 
-			false, ResourceLoadFlag::LoadDependencies));
+		HPrefab mainScene;
+		if (resourceArchive != nullptr)
+		{
+			Timer loadTimer;
+			mainScene = static_resource_cast<Prefab>(resourceArchive->load(gameSettings->mainSceneUUID, false));
+
+			const ResourceArchive::Statistics& stats = resourceArchive->getStatistics();
+			LOGDBG("Loaded the main scene with " + toString(stats.numLoaded) + " resources from the archive in " +
+				toString(loadTimer.getMilliseconds()) + " ms. Read " + toString(stats.bytesRead / 1024) + " KB in " +
+				toString(stats.readTime / 1000) + " ms, decompressed " + toString(stats.bytesDecompressed / 1024) +
+				" KB in " + toString(stats.decompressionTime / 1000) + " ms. Prefetched " +
+				toString(stats.numPrefetched) + " resources, waited " + toString(stats.prefetchWaitTime / 1000) +
+				" ms on the prefetch.");
+
+			resourceArchive->markStartupFinished();
+
+			// Anything prefetched but not loaded by now isn't needed on startup, so don't keep it in memory
+			resourceArchive->stopPrefetch();
+		}
+		else
+		{
+			mainScene = static_resource_cast<Prefab>(gResources().loadFromUUID(gameSettings->mainSceneUUID,
+				false, ResourceLoadFlag::LoadDependencies));
+		}
+
 		if (mainScene.isLoaded(false))
 		{
 			HSceneObject root = mainScene->instantiate();
@@ -160,5 +219,19 @@ void runApplication()
 	}
 
 	Application::instance().runMainLoop();
+
+	if (resourceArchive != nullptr && recordLoadOrder)
+	{
+		Path loadTracePath = resourcesPath + ResourceArchive::LOAD_TRACE_NAME;
+		if (!resourceArchive->saveLoadTrace(loadTracePath))
+			LOGERR("Unable to save the resource load trace to: " + loadTracePath.toString());
+	}
+
+	// The game resource loader keeps a reference to the archive until the scripting shuts down, so any prefetch must be
+	// stopped here, while the task scheduler is still running
+	if (resourceArchive != nullptr)
+		resourceArchive->stopPrefetch();
+
+	resourceArchive = nullptr;
 	Application::shutDown();
 }
\ No newline at end of file
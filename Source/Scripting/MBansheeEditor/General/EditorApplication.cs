@@ -247,7 +247,6 @@ namespace BansheeEditor
         internal static VirtualButton DuplicateKey = new VirtualButton(DuplicateBinding);
         internal static VirtualButton DeleteKey = new VirtualButton(DeleteBinding);
 
-        private static FolderMonitor monitor;
         private static ScriptCodeManager codeManager;
         private static bool sceneDirty;
         private static bool unitTestsExecuted;
@@ -308,23 +307,6 @@ namespace BansheeEditor
             inputConfig.RegisterButton(DuplicateBinding, ButtonCode.D, ButtonModifier.Ctrl);
             inputConfig.RegisterButton(DeleteBinding, ButtonCode.Delete);
             inputConfig.RegisterButton(RenameBinding, ButtonCode.F2);
-
-            if (IsProjectLoaded)
-            {
-                monitor = new FolderMonitor(ProjectLibrary.ResourceFolder);
-                monitor.OnAdded += OnAssetModified;
-                monitor.OnRemoved += OnAssetModified;
-                monitor.OnModified += OnAssetModified;
-            }
-        }
-
-        /// <summary>
-        /// Triggered when the folder monitor detects an asset in the monitored folder was modified.
-        /// </summary>
-        /// <param name="path">Path to the modified file or folder.</param>
-        private static void OnAssetModified(string path)
-        {
-            ProjectLibrary.Refresh(path);
         }
 
         /// <summary>
@@ -795,12 +777,6 @@ namespace BansheeEditor
                 {
                     Scene.Clear();
 
-                    if (monitor != null)
-                    {
-                        monitor.Destroy();
-                        monitor = null;
-                    }
-
                     LibraryWindow window = EditorWindow.GetWindow<LibraryWindow>();
                     if(window != null)
                         window.Reset();
@@ -958,16 +934,11 @@ namespace BansheeEditor
 
             ProjectLibrary.Refresh();
 
-            if(monitor != null)
-            {
-                monitor.Destroy();
-                monitor = null;
-            }
-
-            monitor = new FolderMonitor(ProjectLibrary.ResourceFolder);
-            monitor.OnAdded += OnAssetModified;
-            monitor.OnRemoved += OnAssetModified;
-            monitor.OnModified += OnAssetModified;
+            // Resources are imported in the background, start with the ones the user is looking at. Resources needed by
+            // the scene are imported when it is loaded.
+            LibraryWindow libraryWindow = EditorWindow.GetWindow<LibraryWindow>();
+            if (libraryWindow != null)
+                ProjectLibrary.PrioritizeImport(libraryWindow.CurrentFolder);
 
             if (!string.IsNullOrWhiteSpace(ProjectSettings.LastOpenScene))
             {
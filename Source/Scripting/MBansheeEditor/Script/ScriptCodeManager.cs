@@ -27,6 +27,7 @@ namespace BansheeEditor
             ProjectLibrary.OnEntryAdded += OnEntryAdded;
             ProjectLibrary.OnEntryRemoved += OnEntryRemoved;
             ProjectLibrary.OnEntryImported += OnEntryImported;
+            ProjectLibrary.OnEntriesChanged += OnEntriesChanged;
         }
 
         /// <summary>
@@ -113,6 +114,34 @@ namespace BansheeEditor
                 CodeEditor.MarkSolutionDirty();
         }
 
+        /// <summary>
+        /// Triggered when a batch of operations on the project library ends.
+        /// </summary>
+        /// <param name="removed">Paths of the removed entries, relative to the project's resource folder.</param>
+        /// <param name="added">Paths of the added entries, relative to the project's resource folder.</param>
+        private void OnEntriesChanged(string[] removed, string[] added)
+        {
+            // Removed entries can no longer be inspected, and added folders might contain code files
+            if (removed.Length > 0)
+            {
+                CodeEditor.MarkSolutionDirty();
+                return;
+            }
+
+            foreach (var path in added)
+            {
+                LibraryEntry entry = ProjectLibrary.GetEntry(path);
+                if (entry == null)
+                    continue;
+
+                if (entry.Type == LibraryEntryType.Directory || IsCodeEditorFile(path))
+                {
+                    CodeEditor.MarkSolutionDirty();
+                    return;
+                }
+            }
+        }
+
         /// <summary>
         /// Triggered when a resource is (re)imported in the project library.
         /// </summary>
@@ -2,6 +2,7 @@
 //**************** Copyright (c) 2016 Marko Pintera (marko.pintera@gmail.com). All rights reserved. **********************//
 using System;
 using System.Collections.Generic;
+using System.IO;
 using System.Runtime.CompilerServices;
 using System.Text;
 using BansheeEngine;
@@ -776,6 +777,48 @@ namespace BansheeEditor
             */
         }
 
+        /// <summary>
+        /// Tests that resources waiting in the background import queue are still imported after being moved, either
+        /// directly or as part of a moved folder.
+        /// </summary>
+        static void UnitTest5_ImportQueueMove()
+        {
+            if (!EditorApplication.IsProjectLoaded)
+            {
+                Debug.LogWarning("Skipping unit test as no project is loaded.");
+                return;
+            }
+
+            const string folder = "unitTest5";
+            string absoluteFolder = Path.Combine(ProjectLibrary.ResourceFolder, folder);
+
+            if (ProjectLibrary.Exists(folder))
+                ProjectLibrary.Delete(folder);
+
+            try
+            {
+                Directory.CreateDirectory(Path.Combine(absoluteFolder, "a"));
+                File.WriteAllText(Path.Combine(absoluteFolder, "file.txt"), "unitTest5 file");
+                File.WriteAllText(Path.Combine(absoluteFolder, "a", "child.txt"), "unitTest5 child");
+
+                // Queues the new files for import without importing them
+                ProjectLibrary.Refresh(folder);
+                Assert(ProjectLibrary.GetEntry(folder + "/file.txt") != null);
+                Assert(ProjectLibrary.GetEntry(folder + "/a/child.txt") != null);
+
+                ProjectLibrary.Move(folder + "/file.txt", folder + "/moved.txt");
+                ProjectLibrary.Move(folder + "/a", folder + "/b");
+
+                // Loading imports the queued resource, which is only possible if it was found under its new path
+                Assert(ProjectLibrary.Load<PlainText>(folder + "/moved.txt") != null);
+                Assert(ProjectLibrary.Load<PlainText>(folder + "/b/child.txt") != null);
+            }
+            finally
+            {
+                ProjectLibrary.Delete(folder);
+            }
+        }
+
         /// <summary>
         /// Runs all tests.
         /// </summary>
@@ -785,6 +828,7 @@ namespace BansheeEditor
             UnitTest2_SerializableProperties();
             UnitTest3_ManagedDiff();
             UnitTest4_Prefabs();
+            UnitTest5_ImportQueueMove();
         }
 
         [MethodImpl(MethodImplOptions.InternalCall)]
@@ -21,6 +21,17 @@ namespace BansheeEditor
         Count // Keep at end
     }
 
+    /// <summary>
+    /// Methods that can be used for compressing resources packed into an archive.
+    /// </summary>
+    public enum ResourceCompression // Note: Must match C++ enum ArchiveCompression
+    {
+        /// <summary>Resources are stored as is.</summary>
+        None,
+        /// <summary>Resources are compressed with a fast compression method, with low decompression overhead.</summary>
+        Snappy
+    }
+
     /// <summary>
     /// Contains build data for a specific platform.
     /// </summary>
@@ -108,6 +119,47 @@ namespace BansheeEditor
             set { Internal_SetDebug(mCachedPtr, value); }
         }
 
+        /// <summary>
+        /// Determines should all the resources be packed into a single archive, instead of being stored as one file per
+        /// resource. A single archive is faster to load from, but every build needs to write it in full.
+        /// </summary>
+        public bool PackResources
+        {
+            get { return Internal_GetPackResources(mCachedPtr); }
+            set { Internal_SetPackResources(mCachedPtr, value); }
+        }
+
+        /// <summary>
+        /// Compression used for resources packed into an archive, unless overriden for their type by
+        /// <see cref="SetCompression"/>. Only relevant if <see cref="PackResources"/> is on.
+        /// </summary>
+        public ResourceCompression DefaultCompression
+        {
+            get { return Internal_GetDefaultCompression(mCachedPtr); }
+            set { Internal_SetDefaultCompression(mCachedPtr, value); }
+        }
+
+        /// <summary>
+        /// Returns the compression used for resources of the specified type, when packed into an archive.
+        /// </summary>
+        /// <param name="type">Type of the resources.</param>
+        /// <returns>Compression used for the resources of the type.</returns>
+        public ResourceCompression GetCompression(ResourceType type)
+        {
+            return Internal_GetCompression(mCachedPtr, type);
+        }
+
+        /// <summary>
+        /// Sets the compression used for resources of the specified type, when packed into an archive. Overrides
+        /// <see cref="DefaultCompression"/> for the type.
+        /// </summary>
+        /// <param name="type">Type of the resources.</param>
+        /// <param name="compression">Compression to use for the resources of the type.</param>
+        public void SetCompression(ResourceType type, ResourceCompression compression)
+        {
+            Internal_SetCompression(mCachedPtr, type, compression);
+        }
+
         /// <summary>
         /// A set of semicolon separated defines to use when compiling scripts for this platform.
         /// </summary>
@@ -149,6 +201,24 @@ namespace BansheeEditor
 
         [MethodImpl(MethodImplOptions.InternalCall)]
         static extern void Internal_SetDebug(IntPtr thisPtr, bool fullscreen);
+
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        static extern bool Internal_GetPackResources(IntPtr thisPtr);
+
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        static extern void Internal_SetPackResources(IntPtr thisPtr, bool packResources);
+
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        static extern ResourceCompression Internal_GetDefaultCompression(IntPtr thisPtr);
+
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        static extern void Internal_SetDefaultCompression(IntPtr thisPtr, ResourceCompression value);
+
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        static extern ResourceCompression Internal_GetCompression(IntPtr thisPtr, ResourceType type);
+
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        static extern void Internal_SetCompression(IntPtr thisPtr, ResourceType type, ResourceCompression value);
     }
 
     /// <summary>
@@ -282,11 +352,13 @@ namespace BansheeEditor
             string srcRoot = GetBuildFolder(BuildFolder.SourceRoot, activePlatform);
             string destRoot = GetBuildFolder(BuildFolder.DestinationRoot, activePlatform);
 
-            // Prepare clean destination folder
-            if(Directory.Exists(destRoot))
-                Directory.Delete(destRoot, true);
-
-            Directory.CreateDirectory(destRoot);
+            // Prepare clean destination folder. Packaged resources of the previous build are kept, so resources that
+            // didn't change don't need to be packaged again.
+            string packagedResources = Path.Combine(destRoot, Internal_GetPackagedResourcesFolder());
+            if (Directory.Exists(destRoot))
+                CleanBuildFolder(destRoot, packagedResources.TrimEnd('/', '\\'));
+            else
+                Directory.CreateDirectory(destRoot);
 
             // Compile game assembly
             string bansheeAssemblyFolder;
@@ -369,6 +441,28 @@ namespace BansheeEditor
             ci.Dispose();
         }
 
+        /// <summary>
+        /// Deletes all files and folders within the provided folder, except for the specified folder and its contents.
+        /// </summary>
+        /// <param name="folder">Absolute path to the folder to clean.</param>
+        /// <param name="keep">Absolute path to the folder to keep. Must be within <paramref name="folder"/>.</param>
+        private static void CleanBuildFolder(string folder, string keep)
+        {
+            foreach (var dir in Directory.GetDirectories(folder))
+            {
+                if (PathEx.Compare(dir, keep))
+                    continue;
+
+                if (PathEx.IsPartOf(keep, dir + Path.DirectorySeparatorChar))
+                    CleanBuildFolder(dir, keep);
+                else
+                    Directory.Delete(dir, true);
+            }
+
+            foreach (var file in Directory.GetFiles(folder))
+                File.Delete(file);
+        }
+
         /// <summary>
         /// Injects icons specified in <see cref="PlatformInfo"/> into an executable at the specified path.
         /// </summary>
@@ -513,6 +607,9 @@ namespace BansheeEditor
         [MethodImpl(MethodImplOptions.InternalCall)]
         private static extern void Internal_PackageResources(string buildFolder, IntPtr info);
 
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        private static extern string Internal_GetPackagedResourcesFolder();
+
         [MethodImpl(MethodImplOptions.InternalCall)]
         private static extern void Internal_CreateStartupSettings(string buildFolder, IntPtr info);
     }
@@ -165,6 +165,7 @@ namespace BansheeEditor
 
             GUIResourceField sceneField = new GUIResourceField(typeof(Prefab), new LocEdString("Startup scene"));
             GUIToggleField debugToggle = new GUIToggleField(new LocEdString("Debug"));
+            GUIToggleField packResourcesToggle = new GUIToggleField(new LocEdString("Pack resources"));
             
             GUIToggleField fullscreenField = new GUIToggleField(new LocEdString("Fullscreen"));
             GUIIntField widthField = new GUIIntField(new LocEdString("Window width"));
@@ -172,20 +173,51 @@ namespace BansheeEditor
 
             GUITextField definesField = new GUITextField(new LocEdString("Defines"));
 
+            GUIEnumField defaultCompressionField = new GUIEnumField(typeof(ResourceCompression),
+                new LocEdString("Default compression"));
+
             layout.AddSpace(5);
             layout.AddElement(options);
             layout.AddSpace(5);
             layout.AddElement(sceneField);
             layout.AddElement(debugToggle);
+            layout.AddElement(packResourcesToggle);
             layout.AddElement(fullscreenField);
             layout.AddElement(widthField);
             layout.AddElement(heightField);
             layout.AddSpace(5);
             layout.AddElement(definesField);
+            layout.AddSpace(5);
+            layout.AddElement(defaultCompressionField);
+
+            // Compression can be tweaked for the resource types that make up most of the build size
+            ResourceType[] compressedTypes =
+            {
+                ResourceType.Texture, ResourceType.Mesh, ResourceType.AudioClip, ResourceType.AnimationClip,
+                ResourceType.Prefab, ResourceType.PlainText
+            };
+
+            GUIEnumField[] compressionFields = new GUIEnumField[compressedTypes.Length];
+            for (int i = 0; i < compressedTypes.Length; i++)
+            {
+                ResourceType type = compressedTypes[i];
+
+                compressionFields[i] = new GUIEnumField(typeof(ResourceCompression),
+                    new LocEdString(type + " compression"));
+                compressionFields[i].Value = (ulong)platformInfo.GetCompression(type);
+                compressionFields[i].Active = platformInfo.PackResources;
+                compressionFields[i].OnSelectionChanged += x => platformInfo.SetCompression(type, (ResourceCompression)x);
+
+                layout.AddElement(compressionFields[i]);
+            }
+
             layout.AddSpace(5);
 
             sceneField.ValueRef = platformInfo.MainScene;
             debugToggle.Value = platformInfo.Debug;
+            packResourcesToggle.Value = platformInfo.PackResources;
+            defaultCompressionField.Value = (ulong)platformInfo.DefaultCompression;
+            defaultCompressionField.Active = platformInfo.PackResources;
             definesField.Value = platformInfo.Defines;
             fullscreenField.Value = platformInfo.Fullscreen;
             widthField.Value = platformInfo.WindowedWidth;
@@ -199,6 +231,15 @@ namespace BansheeEditor
 
             sceneField.OnChanged += x => platformInfo.MainScene = x;
             debugToggle.OnChanged += x => platformInfo.Debug = x;
+            packResourcesToggle.OnChanged += x =>
+            {
+                defaultCompressionField.Active = x;
+                foreach (var field in compressionFields)
+                    field.Active = x;
+
+                platformInfo.PackResources = x;
+            };
+            defaultCompressionField.OnSelectionChanged += x => platformInfo.DefaultCompression = (ResourceCompression)x;
             definesField.OnChanged += x => platformInfo.Defines = x;
             fullscreenField.OnChanged += x =>
             {
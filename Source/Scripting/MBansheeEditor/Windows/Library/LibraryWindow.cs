@@ -131,12 +131,17 @@ namespace BansheeEditor
 
         /// <summary>
         /// Returns the path to the folder currently displayed in the library window. Returned path is relative to project 
-        /// library resources folder.
+        /// library resources folder. Resources in the displayed folder are imported before any other resources waiting
+        /// for a background import.
         /// </summary>
         public string CurrentFolder
         {
             get { return ProjectSettings.GetString(CURRENT_LIBRARY_DIRECTORY_KEY); }
-            set { ProjectSettings.SetString(CURRENT_LIBRARY_DIRECTORY_KEY, value); }
+            set
+            {
+                ProjectSettings.SetString(CURRENT_LIBRARY_DIRECTORY_KEY, value);
+                ProjectLibrary.PrioritizeImport(value);
+            }
         }
 
         /// <summary>
@@ -161,6 +166,7 @@ namespace BansheeEditor
             ProjectLibrary.OnEntryAdded += OnEntryChanged;
             ProjectLibrary.OnEntryImported += OnEntryChanged;
             ProjectLibrary.OnEntryRemoved += OnEntryChanged;
+            ProjectLibrary.OnEntriesChanged += OnEntriesChanged;
 
             GUILayoutY contentLayout = GUI.AddLayoutY();
 
@@ -708,11 +714,10 @@ namespace BansheeEditor
         {
             string[] filePaths = GetFiles(sourcePaths);
 
+            ProjectLibrary.BeginBatch();
             foreach (var source in filePaths)
-            {
                 ProjectLibrary.Copy(source, LibraryUtility.GetUniquePath(source));
-                ProjectLibrary.Refresh();
-            }
+            ProjectLibrary.EndBatch();
         }
 
         /// <summary>
@@ -728,24 +733,25 @@ namespace BansheeEditor
 
             if (copyPaths.Count > 0)
             {
+                ProjectLibrary.BeginBatch();
                 for (int i = 0; i < copyPaths.Count; i++)
                 {
                     string destination = Path.Combine(rootedDestinationFolder, PathEx.GetTail(copyPaths[i]));
                     ProjectLibrary.Copy(copyPaths[i], LibraryUtility.GetUniquePath(destination));
                 }
-
-                ProjectLibrary.Refresh();
+                ProjectLibrary.EndBatch();
             }
             else if (cutPaths.Count > 0)
             {
+                ProjectLibrary.BeginBatch();
                 for (int i = 0; i < cutPaths.Count; i++)
                 {
                     string destination = Path.Combine(rootedDestinationFolder, PathEx.GetTail(cutPaths[i]));
                     ProjectLibrary.Move(cutPaths[i], LibraryUtility.GetUniquePath(destination));
                 }
+                ProjectLibrary.EndBatch();
 
                 cutPaths.Clear();
-                ProjectLibrary.Refresh();
             }
         }
 
@@ -1139,8 +1145,10 @@ namespace BansheeEditor
                 {
                     if (type == DialogBox.ResultType.Yes)
                     {
+                        ProjectLibrary.BeginBatch();
                         foreach (var path in filePaths)
                             ProjectLibrary.Delete(path);
+                        ProjectLibrary.EndBatch();
 
                         DeselectAll();
                         Refresh();
@@ -1248,6 +1256,16 @@ namespace BansheeEditor
             requiresRefresh = true;
         }
 
+        /// <summary>
+        /// Triggered when a batch of project library operations ends.
+        /// </summary>
+        /// <param name="removed">Project library paths of the removed entries.</param>
+        /// <param name="added">Project library paths of the added entries.</param>
+        private void OnEntriesChanged(string[] removed, string[] added)
+        {
+            requiresRefresh = true;
+        }
+
         /// <summary>
         /// Triggered when the drag and drop operation is starting while over the content area. If drag operation is over
         /// an element, element will be dragged.
@@ -1371,6 +1389,8 @@ namespace BansheeEditor
             if (paths != null)
             {
                 List<string> addedResources = new List<string>();
+
+                ProjectLibrary.BeginBatch();
                 foreach (var path in paths)
                 {
                     string absolutePath = path;
@@ -1400,22 +1420,28 @@ namespace BansheeEditor
                     if (Directory.Exists(path))
                     {
                         if (newFile)
+                        {
                             DirectoryEx.Copy(absolutePath, uniqueDestination);
+                            ProjectLibrary.Refresh(uniqueDestination);
+                        }
                         else
                             ProjectLibrary.Move(absolutePath, uniqueDestination);
                     }
                     else if (File.Exists(path))
                     {
                         if (newFile)
+                        {
                             FileEx.Copy(absolutePath, uniqueDestination);
+                            ProjectLibrary.Refresh(uniqueDestination);
+                        }
                         else
                             ProjectLibrary.Move(absolutePath, uniqueDestination);
                     }
 
                     string relativeDestination = uniqueDestination.Substring(resourceDir.Length, uniqueDestination.Length - resourceDir.Length);
                     addedResources.Add(relativeDestination);
-                    ProjectLibrary.Refresh();
                 }
+                ProjectLibrary.EndBatch();
 
                 SetSelection(addedResources);
             }
@@ -4,6 +4,7 @@ using System;
 using System.Collections.Generic;
 using System.IO;
 using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
 using BansheeEngine;
 
 namespace BansheeEditor
@@ -28,6 +29,20 @@ namespace BansheeEditor
         /// </summary>
         public static string ResourceFolder { get { return Internal_GetResourceFolder(); } }
 
+        /// <summary>
+        /// Returns hit and miss statistics of the import cache. See <see cref="EditorSettings.ImportCacheFolder"/>.
+        /// </summary>
+        public static ImportCacheStatistics ImportCacheStatistics
+        {
+            get
+            {
+                ImportCacheStatistics output;
+                Internal_GetImportCacheStatistics(out output);
+
+                return output;
+            }
+        }
+
         /// <summary>
         /// Triggered when a new entry is added to the project library. Provided path relative to the project library 
         /// resources folder.
@@ -47,58 +62,80 @@ namespace BansheeEditor
         public static event Action<string> OnEntryImported;
 
         /// <summary>
-        /// Checks wheher an asset import is currently in progress.
+        /// Triggered once a batch of operations started with <see cref="BeginBatch"/> ends, instead of triggering
+        /// <see cref="OnEntryRemoved"/> and <see cref="OnEntryAdded"/> for each changed entry. Provides paths of the 
+        /// removed entries, followed by paths of the added entries, all relative to the project library resources
+        /// folder. Descendants of a reported entry are not reported separately.
+        /// </summary>
+        public static event Action<string[], string[]> OnEntriesChanged;
+
+        /// <summary>
+        /// Number of resources waiting to be imported in the background, including the ones currently being imported.
+        /// </summary>
+        public static int ImportQueueLength { get { return (int)Internal_GetImportQueueLength(); } }
+
+        /// <summary>
+        /// Path of a resource currently being imported in the background, relative to the project library resources 
+        /// folder. Null if no resource is being imported.
         /// </summary>
-        internal static bool ImportInProgress { get { return importInProgress; } }
+        public static string CurrentImport { get { return Internal_GetCurrentImport(); } }
 
-        private static HashSet<string> queuedForImport = new HashSet<string>();
-        private static int numImportedFiles;
-        private static int totalFilesToImport;
-        private static bool importInProgress;
+        /// <summary>
+        /// Estimated time until all the resources queued for a background import are imported, in seconds. Zero until 
+        /// the first background import finishes.
+        /// </summary>
+        public static float ImportETA { get { return Internal_GetImportETA(); } }
 
-        private const float TIME_SLICE_SECONDS = 0.030f;
+        /// <summary>
+        /// Checks wheher an asset import is currently in progress.
+        /// </summary>
+        internal static bool ImportInProgress { get { return Internal_GetImportQueueLength() > 0; } }
 
         /// <summary>
         /// Checks the project library folder for any modifications and reimports the required resources.
         /// </summary>
         /// <param name="synchronous">If true this method will block until the project library has done refreshing, 
-        ///                           otherwise the refresh will happen over the course of this and next frames.</param>
+        ///                           otherwise the modified resources are queued for importing in the background.
+        ///                           </param>
         public static void Refresh(bool synchronous = false)
         {
-            string[] modifiedPaths = Internal_Refresh(ResourceFolder, synchronous);
+            Internal_Refresh(ResourceFolder, synchronous);
 
-            if (!synchronous)
-            {
-                foreach (var modifiedPath in modifiedPaths)
-                {
-                    if (queuedForImport.Add(modifiedPath))
-                        totalFilesToImport++;
-                }
-            }
-            else
-            {
-                foreach (var path in queuedForImport)
-                    Internal_Refresh(path, true);
-
-                queuedForImport.Clear();
-                numImportedFiles = 0;
-                totalFilesToImport = 0;
-            }
+            if (synchronous)
+                Internal_ImportQueued();
         }
 
         /// <summary>
-        /// Checks the specified folder for any modifications and reimports the required resources.
+        /// Checks the specified folder for any modifications and queues the required resources for importing in the
+        /// background.
         /// </summary>
         /// <param name="path">Path to a file or folder to refresh. Relative to the project library resources folder or 
         ///                    absolute.</param>
         public static void Refresh(string path)
         {
-            string[] modifiedPaths = Internal_Refresh(path, false);
-            foreach (var modifiedPath in modifiedPaths)
-            {
-                if (queuedForImport.Add(modifiedPath))
-                    totalFilesToImport++;
-            }
+            Internal_Refresh(path, false);
+        }
+
+        /// <summary>
+        /// Checks the files and folders that were changed on disk since the last refresh, as reported by the file
+        /// system, and queues the required resources for importing in the background. If too many changes were reported
+        /// the entire project library folder is checked instead.
+        /// </summary>
+        public static void RefreshQueued()
+        {
+            Internal_RefreshQueued(false);
+        }
+
+        /// <summary>
+        /// Moves the resource at the specified path to the front of the background import queue. If the path is a
+        /// folder all the queued resources within it are moved to the front instead. Does nothing for resources that
+        /// aren't waiting to be imported.
+        /// </summary>
+        /// <param name="path">Path to a file or folder. Relative to the project library resources folder or absolute.
+        ///                    </param>
+        public static void PrioritizeImport(string path)
+        {
+            Internal_PrioritizeImport(path);
         }
 
         /// <summary>
@@ -203,6 +240,22 @@ namespace BansheeEditor
             return Internal_Search(pattern, types);
         }
 
+        /// <summary>
+        /// Finds all entries containing resources that reference the resource at the specified path (for example all
+        /// materials using a texture). Uses references recorded when resources are imported, so no resources are
+        /// loaded.
+        /// </summary>
+        /// <param name="path">Path to the resource, absolute or relative to the project library resources folder. If
+        ///                    the path points to a file with multiple resources, references to any of them are found.
+        ///                    </param>
+        /// <param name="recursive">If true, entries referencing the resource indirectly are returned as well.</param>
+        /// <returns>A set of entries referencing the resource. These objects can become invalid on the next library 
+        ///          refresh and you are not meant to hold a permanent reference to them.</returns>
+        public static FileEntry[] FindReferences(string path, bool recursive = false)
+        {
+            return Internal_FindReferences(path, recursive);
+        }
+
         /// <summary>
         /// Returns a path to a resource stored in the project library.
         /// </summary>
@@ -279,6 +332,25 @@ namespace BansheeEditor
             Internal_Copy(source, destination, overwrite);
         }
 
+        /// <summary>
+        /// Starts a batch of library operations. Until the matching <see cref="EndBatch"/> call, operations like 
+        /// <see cref="Move"/>, <see cref="Copy"/> and <see cref="Delete"/> only update the library hierarchy, while 
+        /// importing, change notifications and saving are performed once for the entire batch. Batches can be nested.
+        /// </summary>
+        public static void BeginBatch()
+        {
+            Internal_BeginBatch();
+        }
+
+        /// <summary>
+        /// Ends a batch of library operations started with <see cref="BeginBatch"/>. If this is the outermost batch,
+        /// all the affected resources are imported and <see cref="OnEntriesChanged"/> is triggered.
+        /// </summary>
+        public static void EndBatch()
+        {
+            Internal_EndBatch();
+        }
+
         /// <summary>
         /// Controls should a resource be included an a build. All dependant resources will also be included.
         /// </summary>
@@ -301,63 +373,12 @@ namespace BansheeEditor
         }
 
         /// <summary>
-        /// Triggers reimport for queued resource. Should be called once per frame.
+        /// Queues resources changed on disk for importing. Should be called once per frame. Queued resources are
+        /// imported in the background, with progress displayed on the status bar.
         /// </summary>
         internal static void Update()
         {
-            if (queuedForImport.Count > 0)
-            {
-                // Skip first frame to get the progress bar a chance to show up
-                if (importInProgress)
-                {
-                    UInt64 start = Time.Precise;
-                    List<string> toRemove = new List<string>();
-
-                    foreach (var entry in queuedForImport)
-                    {
-                        Internal_Refresh(entry, true);
-                        toRemove.Add(entry);
-                        numImportedFiles++;
-
-                        UInt64 end = Time.Precise;
-                        UInt64 elapsed = end - start;
-
-                        float elapsedSeconds = elapsed * Time.MicroToSecond;
-                        if (elapsedSeconds > TIME_SLICE_SECONDS)
-                            break;
-                    }
-
-                    foreach (var entry in toRemove)
-                        queuedForImport.Remove(entry);
-                }
-
-                if (queuedForImport.Count == 0)
-                {
-                    numImportedFiles = 0;
-                    totalFilesToImport = 0;
-
-                    ProgressBar.Hide();
-                }
-                else
-                {
-                    IEnumerator<string> enumerator = queuedForImport.GetEnumerator();
-                    enumerator.MoveNext();
-
-                    string displayName = enumerator.Current;
-                    if (displayName.Length > 60)
-                    {
-                        displayName = displayName.Remove(0, displayName.Length - 60);
-                        displayName = "..." + displayName;
-                    }
-
-                    float pct = numImportedFiles / (float)totalFilesToImport;
-                    ProgressBar.Show("Importing (" + numImportedFiles + "/" + totalFilesToImport + ")", displayName, pct);
-                }
-
-                importInProgress = true;
-            }
-            else
-                importInProgress = false;
+            RefreshQueued();
         }
 
         /// <summary>
@@ -390,9 +411,30 @@ namespace BansheeEditor
                 OnEntryImported(path);
         }
 
+        /// <summary>
+        /// Triggered internally by the runtime when a batch of operations on the project library ends.
+        /// </summary>
+        /// <param name="removed">Paths of the removed entries, relative to the project library resources folder.
+        ///                       </param>
+        /// <param name="added">Paths of the added entries, relative to the project library resources folder.</param>
+        private static void Internal_DoOnEntriesChanged(string[] removed, string[] added)
+        {
+            if (OnEntriesChanged != null)
+                OnEntriesChanged(removed, added);
+        }
+
         [MethodImpl(MethodImplOptions.InternalCall)]
         private static extern string[] Internal_Refresh(string path, bool import);
 
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        private static extern string[] Internal_RefreshQueued(bool import);
+
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        private static extern void Internal_BeginBatch();
+
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        private static extern void Internal_EndBatch();
+
         [MethodImpl(MethodImplOptions.InternalCall)]
         private static extern void Internal_Create(Resource resource, string path);
 
@@ -420,6 +462,9 @@ namespace BansheeEditor
         [MethodImpl(MethodImplOptions.InternalCall)]
         private static extern LibraryEntry[] Internal_Search(string path, ResourceType[] types);
 
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        private static extern FileEntry[] Internal_FindReferences(string path, bool recursive);
+
         [MethodImpl(MethodImplOptions.InternalCall)]
         private static extern string Internal_GetPath(Resource resource);
 
@@ -449,6 +494,46 @@ namespace BansheeEditor
 
         [MethodImpl(MethodImplOptions.InternalCall)]
         private static extern void Internal_SetEditorData(string path, object userData);
+
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        private static extern void Internal_GetImportCacheStatistics(out ImportCacheStatistics output);
+
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        private static extern void Internal_PrioritizeImport(string path);
+
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        private static extern void Internal_ImportQueued();
+
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        private static extern uint Internal_GetImportQueueLength();
+
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        private static extern string Internal_GetCurrentImport();
+
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        private static extern float Internal_GetImportETA();
+    }
+
+    /// <summary>
+    /// Contains statistics about the import cache usage.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct ImportCacheStatistics // Note: Must match the C++ struct ImportCacheStatistics
+    {
+        /// <summary>
+        /// Number of imports that were restored from the cache.
+        /// </summary>
+        public uint Hits;
+
+        /// <summary>
+        /// Number of imports that weren't found in the cache.
+        /// </summary>
+        public uint Misses;
+
+        /// <summary>
+        /// Number of imports that were written to the cache.
+        /// </summary>
+        public uint Writes;
     }
 
     /// <summary>
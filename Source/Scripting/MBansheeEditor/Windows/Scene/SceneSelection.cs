@@ -88,6 +88,64 @@ namespace BansheeEditor
             return Internal_Snap(mCachedPtr, ref pointerPos, out data, ignoreSceneObjects);
         }
 
+        /// <summary>
+        /// Starts a search for a scene object under the provided position, without waiting for the results. Use 
+        /// <see cref="TryGetSnapResult"/> to retrieve the results once available. Unlike <see cref="Snap"/> this
+        /// doesn't stall until the GPU finishes rendering, making it suitable for snapping performed every frame. Does
+        /// nothing if a previously started search hasn't completed yet.
+        /// </summary>
+        /// <param name="pointerPos">Position of the pointer relative to the scene camera viewport.</param>
+        /// <param name="ignoreSceneObjects">Optional set of objects to ignore during scene picking.</param>
+        internal void SnapAsync(Vector2I pointerPos, SceneObject[] ignoreSceneObjects = null)
+        {
+            Internal_SnapAsync(mCachedPtr, ref pointerPos, ignoreSceneObjects);
+        }
+
+        /// <summary>
+        /// Retrieves the results of a search started with <see cref="SnapAsync"/>, if it has completed.
+        /// </summary>
+        /// <param name="sceneObject">The object the pointer is snapping to, or null if there is none.</param>
+        /// <param name="data">Position and normal on the object surface at the point that was hit.</param>
+        /// <returns>True if the search completed and the results were retrieved, false otherwise.</returns>
+        internal bool TryGetSnapResult(out SceneObject sceneObject, out SnapData data)
+        {
+            return Internal_TryGetSnapResult(mCachedPtr, out sceneObject, out data);
+        }
+
+        /// <summary>
+        /// Finds all scene objects whose bounds are intersected by the ray. Unlike picking this only tests the bounds
+        /// of the objects and doesn't require rendering, making it cheap enough to perform every frame.
+        /// </summary>
+        /// <param name="ray">Ray to test, in world space.</param>
+        /// <param name="maxDistance">Maximum distance along the ray to search up to.</param>
+        /// <returns>Objects intersected by the ray, ordered from the closest.</returns>
+        internal SceneObject[] QueryRay(Ray ray, float maxDistance = float.PositiveInfinity)
+        {
+            return Internal_QueryRay(mCachedPtr, ref ray, maxDistance);
+        }
+
+        /// <summary>
+        /// Finds all scene objects whose bounds overlap the provided box.
+        /// </summary>
+        /// <param name="bounds">Box to test, in world space.</param>
+        /// <returns>Objects overlapping the box.</returns>
+        internal SceneObject[] QueryBox(AABox bounds)
+        {
+            return Internal_QueryBox(mCachedPtr, ref bounds);
+        }
+
+        /// <summary>
+        /// Finds all scene objects whose bounds are at least partially visible in the specified area of the scene
+        /// camera viewport. Objects hidden behind other objects are included as well.
+        /// </summary>
+        /// <param name="pointerPos">Position of the area relative to the scene camera viewport.</param>
+        /// <param name="area">Size of the area, in pixels and relative to <paramref name="pointerPos"/>.</param>
+        /// <returns>Objects within the area.</returns>
+        internal SceneObject[] QueryArea(Vector2I pointerPos, Vector2I area)
+        {
+            return Internal_QueryArea(mCachedPtr, ref pointerPos, ref area);
+        }
+
         [MethodImpl(MethodImplOptions.InternalCall)]
         private static extern void Internal_Create(SceneSelection managedInstance, IntPtr camera);
 
@@ -102,6 +160,21 @@ namespace BansheeEditor
 
         [MethodImpl(MethodImplOptions.InternalCall)]
         private static extern SceneObject Internal_Snap(IntPtr thisPtr, ref Vector2I pointerPos, out SnapData data, SceneObject[] ignoreRenderables);
+
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        private static extern void Internal_SnapAsync(IntPtr thisPtr, ref Vector2I pointerPos, SceneObject[] ignoreRenderables);
+
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        private static extern bool Internal_TryGetSnapResult(IntPtr thisPtr, out SceneObject sceneObject, out SnapData data);
+
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        private static extern SceneObject[] Internal_QueryRay(IntPtr thisPtr, ref Ray ray, float maxDistance);
+
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        private static extern SceneObject[] Internal_QueryBox(IntPtr thisPtr, ref AABox bounds);
+
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        private static extern SceneObject[] Internal_QueryArea(IntPtr thisPtr, ref Vector2I pointerPos, ref Vector2I area);
     }
 
     /** @} */
@@ -589,12 +589,18 @@ namespace BansheeEditor
                     {
                         if (Input.IsButtonHeld(ButtonCode.Space))
                         {
+                            // Snapping is performed every frame, so use the non-blocking version and apply the results
+                            // once they arrive
+                            SceneObject snapSO;
                             SnapData snapData;
-                            sceneSelection.Snap(scenePos, out snapData, new SceneObject[] {draggedSO});
+                            if (sceneSelection.TryGetSnapResult(out snapSO, out snapData) && snapSO != null)
+                            {
+                                Quaternion q = Quaternion.FromToRotation(Vector3.YAxis, snapData.normal);
+                                draggedSO.Position = snapData.position;
+                                draggedSO.Rotation = q;
+                            }
 
-                            Quaternion q = Quaternion.FromToRotation(Vector3.YAxis, snapData.normal);
-                            draggedSO.Position = snapData.position;
-                            draggedSO.Rotation = q;
+                            sceneSelection.SnapAsync(scenePos, new SceneObject[] {draggedSO});
                         }
                         else
                         {
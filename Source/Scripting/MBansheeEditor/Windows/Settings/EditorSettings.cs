@@ -129,6 +129,17 @@ namespace BansheeEditor
             set { Internal_SetAutoLoadLastProject(value); }
         }
 
+        /// <summary>
+        /// Absolute path to a folder in which imported resources are cached. The folder can be shared between all
+        /// projects on this machine, so identical source files with identical import options only need to be imported
+        /// once. Set to an empty string to disable the cache.
+        /// </summary>
+        public static string ImportCacheFolder
+        {
+            get { return Internal_GetImportCacheFolder(); }
+            set { Internal_SetImportCacheFolder(value); }
+        }
+
         /// <summary>
         /// Contains a list of most recently loaded projects.
         /// </summary>
@@ -355,6 +366,11 @@ namespace BansheeEditor
         [MethodImpl(MethodImplOptions.InternalCall)]
         private static extern void Internal_SetAutoLoadLastProject(bool value);
 
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        private static extern string Internal_GetImportCacheFolder();
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        private static extern void Internal_SetImportCacheFolder(string value);
+
         [MethodImpl(MethodImplOptions.InternalCall)]
         private static extern void Internal_GetRecentProjects(out string[] paths, out UInt64[] timestamps);
         [MethodImpl(MethodImplOptions.InternalCall)]
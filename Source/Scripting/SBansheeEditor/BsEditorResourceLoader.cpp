@@ -10,13 +10,16 @@ namespace bs
 {
 	HResource EditorResourceLoader::load(const Path& path, bool keepLoaded) const
 	{
+		// Scenes and other resources loaded by the game might still be waiting to be imported
+		gProjectLibrary().importRequiredResources(path);
+
 		ProjectLibrary::LibraryEntry* entry = gProjectLibrary().findEntry(path);
 
 		if (entry == nullptr || entry->type == ProjectLibrary::LibraryEntryType::Directory)
 			return HResource();
 
 		ProjectLibrary::FileEntry* resEntry = static_cast<ProjectLibrary::FileEntry*>(entry);
-		if (resEntry->meta == nullptr)
+		if (!resEntry->hasMeta)
 		{
 			LOGWRN("Missing .meta file for resource at path: \"" + path.toString() + "\".");
 			return HResource();
@@ -30,7 +33,7 @@ namespace bs
 
 		UUID resUUID = meta->getUUID();
 
-		if (resEntry->meta->getIncludeInBuild())
+		if (resEntry->includeInBuild)
 		{
 			LOGWRN("Dynamically loading a resource at path: \"" + path.toString() + "\" but the resource \
 					isn't flagged to be included in the build. It may not be available outside of the editor.");
@@ -21,6 +21,9 @@
 #include "Scene/BsSceneObject.h"
 #include "Debug/BsDebug.h"
 #include "Resources/BsGameResourceManager.h"
+#include "Build/BsResourcePackager.h"
+#include "Build/BsResourceArchive.h"
+#include "Build/BsBuildReport.h"
 
 namespace bs
 {
@@ -42,6 +45,7 @@ namespace bs
 		metaData.scriptClass->addInternalCall("Internal_GetBuildFolder", (void*)&ScriptBuildManager::internal_GetBuildFolder);
 		metaData.scriptClass->addInternalCall("Internal_InjectIcons", (void*)&ScriptBuildManager::internal_InjectIcons);
 		metaData.scriptClass->addInternalCall("Internal_PackageResources", (void*)&ScriptBuildManager::internal_PackageResources);
+		metaData.scriptClass->addInternalCall("Internal_GetPackagedResourcesFolder", (void*)&ScriptBuildManager::internal_GetPackagedResourcesFolder);
 		metaData.scriptClass->addInternalCall("Internal_CreateStartupSettings", (void*)&ScriptBuildManager::internal_CreateStartupSettings);
 	}
 
@@ -225,25 +229,28 @@ namespace bs
 
 	void ScriptBuildManager::internal_PackageResources(MonoString* buildFolder, ScriptPlatformInfo* info)
 	{
-		UnorderedSet<Path> usedResources;
+		Vector<UUID> includedResources;
 		SPtr<ResourceMapping> resourceMap = ResourceMapping::create();
+		BuildReport report;
 
 		// Get all resources manually included in build
 		Vector<ProjectLibrary::FileEntry*> buildResources = gProjectLibrary().getResourcesForBuild();
 		for (auto& entry : buildResources)
 		{
-			if (entry->meta == nullptr)
+			if (!entry->hasMeta)
 			{
 				LOGWRN("Cannot include resource in build, missing meta file for: " + entry->path.toString());
 				continue;
 			}
 
-			auto& resourceMetas = entry->meta->getResourceMetaData();
-			for(auto& resMeta : resourceMetas)
+			for(auto& resHeader : entry->resources)
 			{
 				Path resourcePath;
-				if (gResources().getFilePathFromUUID(resMeta->getUUID(), resourcePath))
-					usedResources.insert(resourcePath);
+				if (gResources().getFilePathFromUUID(resHeader.uuid, resourcePath))
+				{
+					includedResources.push_back(resHeader.uuid);
+					report.addRoot(resHeader.uuid, "Included in build");
+				}
 				else
 					LOGWRN("Cannot include resource in build, missing imported asset for: " + entry->path.toString());
 			}
@@ -259,46 +266,46 @@ namespace bs
 		{
 			Path resourcePath;
 			if (gResources().getFilePathFromUUID(platformInfo->mainScene.getUUID(), resourcePath))
-				usedResources.insert(resourcePath);
+			{
+				includedResources.push_back(platformInfo->mainScene.getUUID());
+				report.addRoot(platformInfo->mainScene.getUUID(), "Main scene");
+			}
 			else
 				LOGWRN("Cannot include main scene in build, missing imported asset.");
 		}
 
-		// Find dependencies of all resources
-		Vector<Path> newResources;
-		for (auto& entry : usedResources)
-			newResources.push_back(entry);
+		// Find dependencies of all resources, as recorded by the project library when the resources were imported
+		UnorderedMap<UUID, UUID> referencedFrom;
+		Vector<UUID> allResources = gProjectLibrary().findReferencedResources(includedResources, &referencedFrom);
+		report.setReferences(std::move(referencedFrom));
 
-		while (!newResources.empty())
+		UnorderedSet<Path> usedResources;
+		for (auto& uuid : allResources)
 		{
-			Vector<Path> allDependencies;
-			for (auto& entry : newResources)
-			{
-				Vector<UUID> curDependencies = gResources().getDependencies(entry);
-				for (auto& entry : curDependencies)
-				{
-					Path resourcePath;
-					if (gResources().getFilePathFromUUID(entry, resourcePath))
-					{
-						if (usedResources.find(resourcePath) == usedResources.end())
-						{
-							allDependencies.push_back(resourcePath);
-							usedResources.insert(resourcePath);
-						}
-					}
-				}
-			}
-
-			newResources = allDependencies;
-		} 
+			Path resourcePath;
+			if (gResources().getFilePathFromUUID(uuid, resourcePath))
+				usedResources.insert(resourcePath);
+		}
 
-		// Copy resources
+		// Package resources
 		Path buildPath = MonoUtil::monoToString(buildFolder);
 
 		Path outputPath = buildPath;
 		outputPath.append(GAME_RESOURCES_FOLDER_NAME);
 
-		FileSystem::createDir(outputPath);
+		// When packing resources into an archive the individual files are packaged into the project instead, so the
+		// ones that didn't change don't need to be processed again on the next build
+		bool packResources = platformInfo != nullptr && platformInfo->packResources;
+
+		Path packagePath = outputPath;
+		if (packResources)
+		{
+			packagePath = gEditorApplication().getProjectPath();
+			packagePath.append(INTERNAL_PACKAGE_CACHE_PATH);
+		}
+
+		ResourcePackager packager(packagePath);
+		ResourceArchiveWriter archive;
 
 		Path libraryDir = gProjectLibrary().getResourcesFolder();
 		for (auto& entry : usedResources)
@@ -313,9 +320,6 @@ namespace bs
 			SPtr<ProjectResourceMeta> resMeta = gProjectLibrary().findResourceMeta(sourcePath);
 			assert(resMeta != nullptr);
 
-			Path destPath = outputPath;
-			destPath.setFilename(entry.getFilename());
-
 			// Create library -> packaged resource mapping
 			Path relSourcePath = sourcePath;
 			if (sourcePath.isAbsolute())
@@ -326,46 +330,186 @@ namespace bs
 
 			resourceMap->add(relSourcePath, relDestPath);
 
+			Path packagedPath = packagePath;
+			packagedPath.append(entry.getFilename());
+
+			report.addEntry(uuid, relSourcePath, resMeta->getTypeID(), packagedPath);
+
+			if (packResources)
+			{
+				archive.addEntry(uuid, packagedPath, platformInfo->getCompression(resMeta->getTypeID()));
+			}
+
 			// If resource is prefab make sure to update it in case any of the prefabs it is referencing changed
 			if (resMeta->getTypeID() == TID_Prefab)
 			{
-				bool reload = gResources().isLoaded(uuid);
+				// Contents of the updated prefab depend on the prefabs it references, so it is written again if any of
+				// its references change
+				Vector<Path> sources;
+				for (auto& reference : gProjectLibrary().findReferencedResources({ uuid }))
+				{
+					Path referencePath;
+					if (gResources().getFilePathFromUUID(reference, referencePath))
+						sources.push_back(referencePath);
+				}
 
-				HPrefab prefab = static_resource_cast<Prefab>(gProjectLibrary().load(sourcePath));
-				prefab->_updateChildInstances();
+				// Prefabs must be loaded and saved on the main thread
+				packager.addGeneratedFile(entry.getFilename(), sources, [uuid, sourcePath](const Path& destPath)
+				{
+					bool reload = gResources().isLoaded(uuid);
 
-				// Clear prefab diffs as they're not used in standalone
-				Stack<HSceneObject> todo;
-				todo.push(prefab->_getRoot());
+					HPrefab prefab = static_resource_cast<Prefab>(gProjectLibrary().load(sourcePath));
+					if (prefab == nullptr)
+						return false;
 
-				while (!todo.empty())
-				{
-					HSceneObject current = todo.top();
-					todo.pop();
+					prefab->_updateChildInstances();
 
-					current->_clearPrefabDiff();
+					// Clear prefab diffs as they're not used in standalone
+					Stack<HSceneObject> todo;
+					todo.push(prefab->_getRoot());
 
-					UINT32 numChildren = current->getNumChildren();
-					for (UINT32 i = 0; i < numChildren; i++)
+					while (!todo.empty())
 					{
-						HSceneObject child = current->getChild(i);
-						todo.push(child);
+						HSceneObject current = todo.top();
+						todo.pop();
+
+						current->_clearPrefabDiff();
+
+						UINT32 numChildren = current->getNumChildren();
+						for (UINT32 i = 0; i < numChildren; i++)
+						{
+							HSceneObject child = current->getChild(i);
+							todo.push(child);
+						}
 					}
-				}
 
-				gResources().save(prefab, destPath, false);
+					gResources().save(prefab, destPath, true);
+
+					// Need to unload this one as we modified it in memory, and we don't want to persist those changes
+					// past this point
+					gResources().release(prefab);
 
-				// Need to unload this one as we modified it in memory, and we don't want to persist those changes past
-				// this point
-				gResources().release(prefab);
+					if (reload)
+						gProjectLibrary().load(sourcePath);
 
-				if (reload)
-					gProjectLibrary().load(sourcePath);
+					return FileSystem::isFile(destPath);
+				});
 			}
 			else
-				FileSystem::copy(entry, destPath);
+				packager.addFile(entry, entry.getFilename());
 		}
 
+		PackagingSummary summary = packager.package();
+		LOGDBG("Packaged " + toString(summary.numFiles) + " resources in " + toString(summary.time) + " ms. Written: " +
+			toString(summary.numWritten) + " (" + toString(summary.bytesWritten / 1024) + " KB), unchanged: " + 
+			toString(summary.numSkipped) + " (" + toString(summary.bytesSkipped / 1024) + " KB), removed: " + 
+			toString(summary.numRemoved) + ", failed: " + toString(summary.numFailed) + ".");
+
+		Path archivePath = outputPath;
+		archivePath.append(ResourceArchiveWriter::ARCHIVE_NAME);
+
+		Path prefetchListPath = outputPath;
+		prefetchListPath.append(ResourceArchiveWriter::PREFETCH_LIST_NAME);
+
+		if (packResources)
+		{
+			// Remove any individual resource files left over from a previous build that didn't pack its resources,
+			// along with the package manifest that tracked them
+			ResourcePackager(outputPath).package();
+
+			Path packageManifestPath = outputPath;
+			packageManifestPath.append(ResourcePackager::MANIFEST_NAME);
+
+			if (FileSystem::isFile(packageManifestPath))
+				FileSystem::remove(packageManifestPath);
+
+			// A load trace recorded by a previous build of the game is moved into the project, so it keeps being used
+			// by all future builds until a new one is recorded
+			Path buildLoadTracePath = outputPath;
+			buildLoadTracePath.append(ResourceArchiveWriter::LOAD_TRACE_NAME);
+
+			Path loadTracePath = gEditorApplication().getProjectPath();
+			loadTracePath.append(PROJECT_INTERNAL_DIR);
+			loadTracePath.append(ResourceArchiveWriter::LOAD_TRACE_NAME);
+
+			if (FileSystem::isFile(buildLoadTracePath))
+				FileSystem::move(buildLoadTracePath, loadTracePath, true);
+
+			Vector<UUID> loadOrder;
+			UINT32 numStartupResources = 0;
+			if (ResourceArchiveWriter::readLoadTrace(loadTracePath, loadOrder, numStartupResources))
+				archive.setLoadOrder(loadOrder, numStartupResources);
+
+			if (!archive.isUpToDate(archivePath))
+			{
+				if (archive.write(archivePath))
+				{
+					const ArchiveSummary& archiveSummary = archive.getSummary();
+
+					UINT64 ratio = 100;
+					if (archiveSummary.uncompressedBytes > 0)
+						ratio = archiveSummary.storedBytes * 100 / archiveSummary.uncompressedBytes;
+
+					LOGDBG("Packed " + toString(archiveSummary.numEntries) + " resources into an archive, " +
+						"compressing " + toString(archiveSummary.numCompressed) + " of them in " +
+						toString(archiveSummary.compressionTime) + " ms. Size: " +
+						toString(archiveSummary.uncompressedBytes / 1024) + " KB -> " +
+						toString(archiveSummary.storedBytes / 1024) + " KB (" + toString(ratio) + "%). Decompression " +
+						"adds approximately " + toString(archiveSummary.decompressionTime / 1000) + " ms to " +
+						"loading all the resources.");
+				}
+				else
+					LOGERR("Failed to write the resource archive: " + archivePath.toString());
+			}
+
+			if (!loadOrder.empty())
+			{
+				if (!archive.writePrefetchList(prefetchListPath))
+					LOGERR("Failed to write the resource prefetch list: " + prefetchListPath.toString());
+			}
+			else if (FileSystem::isFile(prefetchListPath))
+				FileSystem::remove(prefetchListPath);
+		}
+		else
+		{
+			if (FileSystem::isFile(archivePath))
+				FileSystem::remove(archivePath);
+
+			if (FileSystem::isFile(prefetchListPath))
+				FileSystem::remove(prefetchListPath);
+		}
+
+		// Report what ended up in the build and why. Kept in the project rather than the build, so it doesn't ship with
+		// the game.
+		if (packResources)
+		{
+			UnorderedMap<UUID, UINT64> storedSizes;
+			if (ResourceArchiveWriter::readStoredSizes(archivePath, storedSizes))
+				report.setStoredSizes(std::move(storedSizes));
+		}
+
+		report.generate();
+
+		Path reportFolder = gEditorApplication().getProjectPath();
+		reportFolder.append(PROJECT_INTERNAL_DIR);
+
+		Path jsonReportPath = reportFolder;
+		jsonReportPath.append(BuildReport::JSON_NAME);
+
+		Path textReportPath = reportFolder;
+		textReportPath.append(BuildReport::TEXT_NAME);
+
+		if (report.writeJSON(jsonReportPath) && report.writeText(textReportPath))
+		{
+			LOGDBG("Build contains " + toString((UINT32)report.getEntries().size()) + " resources, totalling " +
+				toString(report.getTotalSize() / 1024) + " KB (" + toString(report.getTotalStoredSize() / 1024) +
+				" KB as stored). Found " + toString(report.getNumDuplicateGroups()) +
+				" groups of identical resources, wasting " + toString(report.getDuplicateSize() / 1024) + " KB. " +
+				"Full report written to: " + textReportPath.toString());
+		}
+		else
+			LOGERR("Failed to write the build report to: " + reportFolder.toString());
+
 		// Save icon
 		Path iconFolder = BuiltinResources::getIconFolder();
 
@@ -410,6 +554,11 @@ namespace bs
 		fe.encode(resourceMap.get());
 	}
 
+	MonoString* ScriptBuildManager::internal_GetPackagedResourcesFolder()
+	{
+		return MonoUtil::stringToMono(Path(GAME_RESOURCES_FOLDER_NAME).toString());
+	}
+
 	void ScriptBuildManager::internal_CreateStartupSettings(MonoString* buildFolder, ScriptPlatformInfo* info)
 	{
 		SPtr<PlatformInfo> platformInfo;
@@ -49,6 +49,7 @@ namespace bs
 		static MonoString* internal_GetBuildFolder(ScriptBuildFolder folder, PlatformType platform);
 		static void internal_InjectIcons(MonoString* filePath, ScriptPlatformInfo* info);
 		static void internal_PackageResources(MonoString* buildFolder, ScriptPlatformInfo* info);
+		static MonoString* internal_GetPackagedResourcesFolder();
 		static void internal_CreateStartupSettings(MonoString* buildFolder, ScriptPlatformInfo* info);
 	};
 
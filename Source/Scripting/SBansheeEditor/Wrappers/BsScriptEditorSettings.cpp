@@ -7,6 +7,7 @@
 #include "BsMonoUtil.h"
 #include "BsEditorApplication.h"
 #include "Settings/BsEditorSettings.h"
+#include "Library/BsProjectLibrary.h"
 
 namespace bs
 {
@@ -40,6 +41,8 @@ namespace bs
 		metaData.scriptClass->addInternalCall("Internal_SetLastOpenProject", (void*)&ScriptEditorSettings::internal_SetLastOpenProject);
 		metaData.scriptClass->addInternalCall("Internal_GetAutoLoadLastProject", (void*)&ScriptEditorSettings::internal_GetAutoLoadLastProject);
 		metaData.scriptClass->addInternalCall("Internal_SetAutoLoadLastProject", (void*)&ScriptEditorSettings::internal_SetAutoLoadLastProject);
+		metaData.scriptClass->addInternalCall("Internal_GetImportCacheFolder", (void*)&ScriptEditorSettings::internal_GetImportCacheFolder);
+		metaData.scriptClass->addInternalCall("Internal_SetImportCacheFolder", (void*)&ScriptEditorSettings::internal_SetImportCacheFolder);
 		metaData.scriptClass->addInternalCall("Internal_GetRecentProjects", (void*)&ScriptEditorSettings::internal_GetRecentProjects);
 		metaData.scriptClass->addInternalCall("Internal_SetRecentProjects", (void*)&ScriptEditorSettings::internal_SetRecentProjects);
 		metaData.scriptClass->addInternalCall("Internal_SetFloat", (void*)&ScriptEditorSettings::internal_SetFloat);
@@ -201,6 +204,22 @@ namespace bs
 		settings->setAutoLoadLastProject(value);
 	}
 
+	MonoString* ScriptEditorSettings::internal_GetImportCacheFolder()
+	{
+		SPtr<EditorSettings> settings = gEditorApplication().getEditorSettings();
+		return MonoUtil::stringToMono(settings->getImportCacheFolder().toString());
+	}
+
+	void ScriptEditorSettings::internal_SetImportCacheFolder(MonoString* value)
+	{
+		Path folder = MonoUtil::monoToString(value);
+
+		SPtr<EditorSettings> settings = gEditorApplication().getEditorSettings();
+		settings->setImportCacheFolder(folder);
+
+		gProjectLibrary().setImportCacheFolder(folder);
+	}
+
 	void ScriptEditorSettings::internal_GetRecentProjects(MonoArray** paths, MonoArray** timeStamps)
 	{
 		SPtr<EditorSettings> settings = gEditorApplication().getEditorSettings();
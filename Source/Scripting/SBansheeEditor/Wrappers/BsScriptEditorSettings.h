@@ -48,6 +48,8 @@ namespace bs
 		static void internal_SetLastOpenProject(MonoString* value);
 		static bool internal_GetAutoLoadLastProject();
 		static void internal_SetAutoLoadLastProject(bool value);
+		static MonoString* internal_GetImportCacheFolder();
+		static void internal_SetImportCacheFolder(MonoString* value);
 		static void internal_GetRecentProjects(MonoArray** paths, MonoArray** timeStamps);
 		static void internal_SetRecentProjects(MonoArray* paths, MonoArray* timeStamps);
 
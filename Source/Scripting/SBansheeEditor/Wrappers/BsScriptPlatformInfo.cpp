@@ -9,6 +9,7 @@
 #include "BsMonoUtil.h"
 #include "Wrappers/BsScriptPrefab.h"
 #include "Wrappers/BsScriptResourceRef.h"
+#include "Serialization/BsScriptAssemblyManager.h"
 
 namespace bs
 {
@@ -35,6 +36,12 @@ namespace bs
 		metaData.scriptClass->addInternalCall("Internal_SetResolution", (void*)&ScriptPlatformInfo::internal_SetResolution);
 		metaData.scriptClass->addInternalCall("Internal_GetDebug", (void*)&ScriptPlatformInfo::internal_GetDebug);
 		metaData.scriptClass->addInternalCall("Internal_SetDebug", (void*)&ScriptPlatformInfo::internal_SetDebug);
+		metaData.scriptClass->addInternalCall("Internal_GetPackResources", (void*)&ScriptPlatformInfo::internal_GetPackResources);
+		metaData.scriptClass->addInternalCall("Internal_SetPackResources", (void*)&ScriptPlatformInfo::internal_SetPackResources);
+		metaData.scriptClass->addInternalCall("Internal_GetDefaultCompression", (void*)&ScriptPlatformInfo::internal_GetDefaultCompression);
+		metaData.scriptClass->addInternalCall("Internal_SetDefaultCompression", (void*)&ScriptPlatformInfo::internal_SetDefaultCompression);
+		metaData.scriptClass->addInternalCall("Internal_GetCompression", (void*)&ScriptPlatformInfo::internal_GetCompression);
+		metaData.scriptClass->addInternalCall("Internal_SetCompression", (void*)&ScriptPlatformInfo::internal_SetCompression);
 	}
 
 	MonoObject* ScriptPlatformInfo::create(const SPtr<PlatformInfo>& platformInfo)
@@ -117,6 +124,46 @@ namespace bs
 		thisPtr->getPlatformInfo()->debug = debug;
 	}
 
+	bool ScriptPlatformInfo::internal_GetPackResources(ScriptPlatformInfoBase* thisPtr)
+	{
+		return thisPtr->getPlatformInfo()->packResources;
+	}
+
+	void ScriptPlatformInfo::internal_SetPackResources(ScriptPlatformInfoBase* thisPtr, bool packResources)
+	{
+		thisPtr->getPlatformInfo()->packResources = packResources;
+	}
+
+	ArchiveCompression ScriptPlatformInfo::internal_GetDefaultCompression(ScriptPlatformInfoBase* thisPtr)
+	{
+		return thisPtr->getPlatformInfo()->defaultCompression;
+	}
+
+	void ScriptPlatformInfo::internal_SetDefaultCompression(ScriptPlatformInfoBase* thisPtr, ArchiveCompression value)
+	{
+		thisPtr->getPlatformInfo()->defaultCompression = value;
+	}
+
+	ArchiveCompression ScriptPlatformInfo::internal_GetCompression(ScriptPlatformInfoBase* thisPtr,
+		ScriptResourceType type)
+	{
+		BuiltinResourceInfo* resInfo = ScriptAssemblyManager::instance().getBuiltinResourceInfo(type);
+		if (resInfo == nullptr)
+			return thisPtr->getPlatformInfo()->defaultCompression;
+
+		return thisPtr->getPlatformInfo()->getCompression(resInfo->typeId);
+	}
+
+	void ScriptPlatformInfo::internal_SetCompression(ScriptPlatformInfoBase* thisPtr, ScriptResourceType type,
+		ArchiveCompression value)
+	{
+		BuiltinResourceInfo* resInfo = ScriptAssemblyManager::instance().getBuiltinResourceInfo(type);
+		if (resInfo == nullptr)
+			return;
+
+		thisPtr->getPlatformInfo()->typeCompression[resInfo->typeId] = value;
+	}
+
 	ScriptWinPlatformInfo::ScriptWinPlatformInfo(MonoObject* instance)
 		:ScriptObject(instance)
 	{
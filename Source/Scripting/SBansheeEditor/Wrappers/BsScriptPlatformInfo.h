@@ -51,6 +51,13 @@ namespace bs
 		static void internal_SetResolution(ScriptPlatformInfoBase* thisPtr, UINT32 width, UINT32 height);
 		static bool internal_GetDebug(ScriptPlatformInfoBase* thisPtr);
 		static void internal_SetDebug(ScriptPlatformInfoBase* thisPtr, bool debug);
+		static bool internal_GetPackResources(ScriptPlatformInfoBase* thisPtr);
+		static void internal_SetPackResources(ScriptPlatformInfoBase* thisPtr, bool packResources);
+		static ArchiveCompression internal_GetDefaultCompression(ScriptPlatformInfoBase* thisPtr);
+		static void internal_SetDefaultCompression(ScriptPlatformInfoBase* thisPtr, ArchiveCompression value);
+		static ArchiveCompression internal_GetCompression(ScriptPlatformInfoBase* thisPtr, ScriptResourceType type);
+		static void internal_SetCompression(ScriptPlatformInfoBase* thisPtr, ScriptResourceType type,
+			ArchiveCompression value);
 	};
 
 	/**	Interop class between C++ & CLR for WinPlatformInfo. */
@@ -8,6 +8,7 @@
 #include "Wrappers/BsScriptResource.h"
 #include "Resources/BsResources.h"
 #include "Library/BsProjectResourceMeta.h"
+#include "Library/BsImportCache.h"
 #include "BsScriptResourceManager.h"
 #include "Serialization/BsScriptAssemblyManager.h"
 #include "Wrappers/BsScriptImportOptions.h"
@@ -22,10 +23,12 @@ namespace bs
 	ScriptProjectLibrary::OnEntryChangedThunkDef ScriptProjectLibrary::OnEntryAddedThunk;
 	ScriptProjectLibrary::OnEntryChangedThunkDef ScriptProjectLibrary::OnEntryRemovedThunk;
 	ScriptProjectLibrary::OnEntryChangedThunkDef ScriptProjectLibrary::OnEntryImportedThunk;
+	ScriptProjectLibrary::OnEntriesChangedThunkDef ScriptProjectLibrary::OnEntriesChangedThunk;
 
 	HEvent ScriptProjectLibrary::mOnEntryAddedConn;
 	HEvent ScriptProjectLibrary::mOnEntryRemovedConn;
 	HEvent ScriptProjectLibrary::mOnEntryImportedConn;
+	HEvent ScriptProjectLibrary::mOnEntriesChangedConn;
 
 	ScriptProjectLibrary::ScriptProjectLibrary(MonoObject* instance)
 		:ScriptObject(instance)
@@ -34,6 +37,7 @@ namespace bs
 	void ScriptProjectLibrary::initRuntimeData()
 	{
 		metaData.scriptClass->addInternalCall("Internal_Refresh", (void*)&ScriptProjectLibrary::internal_Refresh);
+		metaData.scriptClass->addInternalCall("Internal_RefreshQueued", (void*)&ScriptProjectLibrary::internal_RefreshQueued);
 		metaData.scriptClass->addInternalCall("Internal_Create", (void*)&ScriptProjectLibrary::internal_Create);
 		metaData.scriptClass->addInternalCall("Internal_Load", (void*)&ScriptProjectLibrary::internal_Load);
 		metaData.scriptClass->addInternalCall("Internal_Save", (void*)&ScriptProjectLibrary::internal_Save);
@@ -45,18 +49,29 @@ namespace bs
 		metaData.scriptClass->addInternalCall("Internal_GetPath", (void*)&ScriptProjectLibrary::internal_GetPath);
 		metaData.scriptClass->addInternalCall("Internal_GetPathFromUUID", (void*)&ScriptProjectLibrary::internal_GetPathFromUUID);
 		metaData.scriptClass->addInternalCall("Internal_Search", (void*)&ScriptProjectLibrary::internal_Search);
+		metaData.scriptClass->addInternalCall("Internal_FindReferences", (void*)&ScriptProjectLibrary::internal_FindReferences);
 		metaData.scriptClass->addInternalCall("Internal_Delete", (void*)&ScriptProjectLibrary::internal_Delete);
 		metaData.scriptClass->addInternalCall("Internal_CreateFolder", (void*)&ScriptProjectLibrary::internal_CreateFolder);
 		metaData.scriptClass->addInternalCall("Internal_Rename", (void*)&ScriptProjectLibrary::internal_Rename);
 		metaData.scriptClass->addInternalCall("Internal_Move", (void*)&ScriptProjectLibrary::internal_Move);
 		metaData.scriptClass->addInternalCall("Internal_Copy", (void*)&ScriptProjectLibrary::internal_Copy);
+		metaData.scriptClass->addInternalCall("Internal_BeginBatch", (void*)&ScriptProjectLibrary::internal_BeginBatch);
+		metaData.scriptClass->addInternalCall("Internal_EndBatch", (void*)&ScriptProjectLibrary::internal_EndBatch);
 		metaData.scriptClass->addInternalCall("Internal_GetResourceFolder", (void*)&ScriptProjectLibrary::internal_GetResourceFolder);
 		metaData.scriptClass->addInternalCall("Internal_SetIncludeInBuild", (void*)&ScriptProjectLibrary::internal_SetIncludeInBuild);
 		metaData.scriptClass->addInternalCall("Internal_SetEditorData", (void*)&ScriptProjectLibrary::internal_SetEditorData);
+		metaData.scriptClass->addInternalCall("Internal_GetImportCacheStatistics", (void*)&ScriptProjectLibrary::internal_GetImportCacheStatistics);
+		metaData.scriptClass->addInternalCall("Internal_PrioritizeImport", (void*)&ScriptProjectLibrary::internal_PrioritizeImport);
+		metaData.scriptClass->addInternalCall("Internal_ImportQueued", (void*)&ScriptProjectLibrary::internal_ImportQueued);
+		metaData.scriptClass->addInternalCall("Internal_GetImportQueueLength", (void*)&ScriptProjectLibrary::internal_GetImportQueueLength);
+		metaData.scriptClass->addInternalCall("Internal_GetCurrentImport", (void*)&ScriptProjectLibrary::internal_GetCurrentImport);
+		metaData.scriptClass->addInternalCall("Internal_GetImportETA", (void*)&ScriptProjectLibrary::internal_GetImportETA);
 
 		OnEntryAddedThunk = (OnEntryChangedThunkDef)metaData.scriptClass->getMethod("Internal_DoOnEntryAdded", 1)->getThunk();
 		OnEntryRemovedThunk = (OnEntryChangedThunkDef)metaData.scriptClass->getMethod("Internal_DoOnEntryRemoved", 1)->getThunk();
 		OnEntryImportedThunk = (OnEntryChangedThunkDef)metaData.scriptClass->getMethod("Internal_DoOnEntryImported", 1)->getThunk();
+		OnEntriesChangedThunk = (OnEntriesChangedThunkDef)metaData.scriptClass->getMethod(
+			"Internal_DoOnEntriesChanged", 2)->getThunk();
 	}
 
 	MonoArray* ScriptProjectLibrary::internal_Refresh(MonoString* path, bool import)
@@ -69,6 +84,33 @@ namespace bs
 		Vector<Path> dirtyResources;
 		gProjectLibrary().checkForModifications(nativePath, import, dirtyResources);
 
+		// Resources not imported right away are imported in the background
+		if (!import)
+		{
+			for (auto& entry : dirtyResources)
+				gProjectLibrary().queueImport(entry);
+		}
+
+		ScriptArray output = ScriptArray::create<String>((UINT32)dirtyResources.size());
+		for (UINT32 i = 0; i < (UINT32)dirtyResources.size(); i++)
+		{
+			output.set(i, dirtyResources[i].toString());
+		}
+
+		return output.getInternal();
+	}
+
+	MonoArray* ScriptProjectLibrary::internal_RefreshQueued(bool import)
+	{
+		Vector<Path> dirtyResources;
+		gProjectLibrary().checkForQueuedModifications(import, dirtyResources);
+
+		if (!import)
+		{
+			for (auto& entry : dirtyResources)
+				gProjectLibrary().queueImport(entry);
+		}
+
 		ScriptArray output = ScriptArray::create<String>((UINT32)dirtyResources.size());
 		for (UINT32 i = 0; i < (UINT32)dirtyResources.size(); i++)
 		{
@@ -217,6 +259,23 @@ namespace bs
 		return outArray.getInternal();
 	}
 
+	MonoArray* ScriptProjectLibrary::internal_FindReferences(MonoString* path, bool recursive)
+	{
+		Path nativePath = MonoUtil::monoToString(path);
+		Vector<ProjectLibrary::FileEntry*> foundEntries =
+			gProjectLibrary().findReferencingEntries(nativePath, recursive);
+
+		UINT32 idx = 0;
+		ScriptArray outArray = ScriptArray::create<ScriptFileEntry>((UINT32)foundEntries.size());
+		for (auto& entry : foundEntries)
+		{
+			outArray.set(idx, ScriptFileEntry::create(entry));
+			idx++;
+		}
+
+		return outArray.getInternal();
+	}
+
 	void ScriptProjectLibrary::internal_Delete(MonoString* path)
 	{
 		Path pathToDelete = MonoUtil::monoToString(path);
@@ -253,6 +312,16 @@ namespace bs
 		gProjectLibrary().copyEntry(oldPathNative, newPathNative, overwrite);
 	}
 
+	void ScriptProjectLibrary::internal_BeginBatch()
+	{
+		gProjectLibrary().beginBatch();
+	}
+
+	void ScriptProjectLibrary::internal_EndBatch()
+	{
+		gProjectLibrary().endBatch();
+	}
+
 	MonoString* ScriptProjectLibrary::internal_GetResourceFolder()
 	{
 		String resFolder = gProjectLibrary().getResourcesFolder().toString();
@@ -260,6 +329,43 @@ namespace bs
 		return MonoUtil::stringToMono(resFolder);
 	}
 
+	void ScriptProjectLibrary::internal_GetImportCacheStatistics(ImportCacheStatistics* output)
+	{
+		*output = gProjectLibrary().getImportCacheStatistics();
+	}
+
+	void ScriptProjectLibrary::internal_PrioritizeImport(MonoString* path)
+	{
+		Path pathNative = MonoUtil::monoToString(path);
+
+		gProjectLibrary().prioritizeImport(pathNative);
+	}
+
+	void ScriptProjectLibrary::internal_ImportQueued()
+	{
+		gProjectLibrary().importQueued();
+	}
+
+	UINT32 ScriptProjectLibrary::internal_GetImportQueueLength()
+	{
+		return gProjectLibrary().getImportQueueLength();
+	}
+
+	MonoString* ScriptProjectLibrary::internal_GetCurrentImport()
+	{
+		Path currentImport = gProjectLibrary().getCurrentImport();
+		if (currentImport.isEmpty())
+			return nullptr;
+
+		Path relativePath = currentImport.getRelative(gProjectLibrary().getResourcesFolder());
+		return MonoUtil::stringToMono(relativePath.toString());
+	}
+
+	float ScriptProjectLibrary::internal_GetImportETA()
+	{
+		return gProjectLibrary().getImportETA();
+	}
+
 	void ScriptProjectLibrary::internal_SetIncludeInBuild(MonoString* path, bool include)
 	{
 		Path pathNative = MonoUtil::monoToString(path);
@@ -288,6 +394,8 @@ namespace bs
 		mOnEntryAddedConn = gProjectLibrary().onEntryAdded.connect(std::bind(&ScriptProjectLibrary::onEntryAdded, _1));
 		mOnEntryRemovedConn = gProjectLibrary().onEntryRemoved.connect(std::bind(&ScriptProjectLibrary::onEntryRemoved, _1));
 		mOnEntryImportedConn = gProjectLibrary().onEntryImported.connect(std::bind(&ScriptProjectLibrary::onEntryImported, _1));
+		mOnEntriesChangedConn = gProjectLibrary().onEntriesChanged.connect(
+			std::bind(&ScriptProjectLibrary::onEntriesChanged, _1, _2));
 	}
 
 	void ScriptProjectLibrary::shutDown()
@@ -295,6 +403,7 @@ namespace bs
 		mOnEntryAddedConn.disconnect();
 		mOnEntryRemovedConn.disconnect();
 		mOnEntryImportedConn.disconnect();
+		mOnEntriesChangedConn.disconnect();
 	}
 
 	void ScriptProjectLibrary::onEntryAdded(const Path& path)
@@ -327,6 +436,28 @@ namespace bs
 		MonoUtil::invokeThunk(OnEntryImportedThunk, pathStr);
 	}
 
+	void ScriptProjectLibrary::onEntriesChanged(const Vector<Path>& removed, const Vector<Path>& added)
+	{
+		auto toRelativePaths = [](const Vector<Path>& paths)
+		{
+			ScriptArray output = ScriptArray::create<String>((UINT32)paths.size());
+			for (UINT32 i = 0; i < (UINT32)paths.size(); i++)
+			{
+				Path relativePath = paths[i];
+				if (relativePath.isAbsolute())
+					relativePath.makeRelative(gProjectLibrary().getResourcesFolder());
+
+				output.set(i, relativePath.toString());
+			}
+
+			return output.getInternal();
+		};
+
+		MonoArray* removedArray = toRelativePaths(removed);
+		MonoArray* addedArray = toRelativePaths(added);
+		MonoUtil::invokeThunk(OnEntriesChangedThunk, removedArray, addedArray);
+	}
+
 	ScriptLibraryEntryBase::ScriptLibraryEntryBase(MonoObject* instance)
 		:ScriptObjectBase(instance)
 	{ }
@@ -454,8 +585,9 @@ namespace bs
 
 		ProjectLibrary::FileEntry* fileEntry = static_cast<ProjectLibrary::FileEntry*>(entry);
 
-		if (fileEntry->meta != nullptr)
-			return ScriptImportOptions::create(fileEntry->meta->getImportOptions());
+		SPtr<ProjectFileMeta> fileMeta = fileEntry->getMeta();
+		if (fileMeta != nullptr)
+			return ScriptImportOptions::create(fileMeta->getImportOptions());
 		else
 			return nullptr;
 	}
@@ -467,9 +599,10 @@ namespace bs
 		{
 			ProjectLibrary::FileEntry* fileEntry = static_cast<ProjectLibrary::FileEntry*>(entry);
 
-			if (fileEntry->meta != nullptr)
+			SPtr<ProjectFileMeta> fileMeta = fileEntry->getMeta();
+			if (fileMeta != nullptr)
 			{
-				auto& resourceMetas = fileEntry->meta->getResourceMetaData();
+				auto& resourceMetas = fileMeta->getResourceMetaData();
 				UINT32 numElements = (UINT32)resourceMetas.size();
 
 				ScriptArray output = ScriptArray::create<ScriptResourceMeta>(numElements);
@@ -491,10 +624,7 @@ namespace bs
 
 		ProjectLibrary::FileEntry* fileEntry = static_cast<ProjectLibrary::FileEntry*>(entry);
 
-		if (fileEntry->meta != nullptr)
-			return fileEntry->meta->getIncludeInBuild();
-
-		return false;
+		return fileEntry->hasMeta && fileEntry->includeInBuild;
 	}
 
 	ScriptResourceMeta::ScriptResourceMeta(MonoObject* instance, const SPtr<ProjectResourceMeta>& meta)
@@ -49,20 +49,32 @@ namespace bs
 		 */
 		static void onEntryImported(const Path& path);
 
+		/**
+		 * Triggered when a batch of operations on the library ends.
+		 *
+		 * @param[in]	removed		Absolute paths to the entries removed during the batch.
+		 * @param[in]	added		Absolute paths to the entries added during the batch.
+		 */
+		static void onEntriesChanged(const Vector<Path>& removed, const Vector<Path>& added);
+
 		static HEvent mOnEntryAddedConn;
 		static HEvent mOnEntryRemovedConn;
 		static HEvent mOnEntryImportedConn;
+		static HEvent mOnEntriesChangedConn;
 
 		/************************************************************************/
 		/* 								CLR HOOKS						   		*/
 		/************************************************************************/
 		typedef void(BS_THUNKCALL *OnEntryChangedThunkDef) (MonoString*, MonoException**);
+		typedef void(BS_THUNKCALL *OnEntriesChangedThunkDef) (MonoArray*, MonoArray*, MonoException**);
 
 		static OnEntryChangedThunkDef OnEntryAddedThunk;
 		static OnEntryChangedThunkDef OnEntryRemovedThunk;
 		static OnEntryChangedThunkDef OnEntryImportedThunk;
+		static OnEntriesChangedThunkDef OnEntriesChangedThunk;
 
 		static MonoArray* internal_Refresh(MonoString* path, bool import);
+		static MonoArray* internal_RefreshQueued(bool import);
 		static void internal_Create(MonoObject* resource, MonoString* path);
 		static MonoObject* internal_Load(MonoString* path);
 		static void internal_Save(MonoObject* resource);
@@ -74,14 +86,23 @@ namespace bs
 		static MonoString* internal_GetPathFromUUID(UUID* uuid);
 		static MonoString* internal_GetPath(MonoObject* resource);
 		static MonoArray* internal_Search(MonoString* pattern, MonoArray* types);
+		static MonoArray* internal_FindReferences(MonoString* path, bool recursive);
 		static void internal_Delete(MonoString* path);
 		static void internal_CreateFolder(MonoString* path);
 		static void internal_Rename(MonoString* path, MonoString* name, bool overwrite);
 		static void internal_Move(MonoString* oldPath, MonoString* newPath, bool overwrite);
 		static void internal_Copy(MonoString* source, MonoString* destination, bool overwrite);
+		static void internal_BeginBatch();
+		static void internal_EndBatch();
 		static MonoString* internal_GetResourceFolder();
 		static void internal_SetIncludeInBuild(MonoString* path, bool include);
 		static void internal_SetEditorData(MonoString* path, MonoObject* userData);
+		static void internal_GetImportCacheStatistics(ImportCacheStatistics* output);
+		static void internal_PrioritizeImport(MonoString* path);
+		static void internal_ImportQueued();
+		static UINT32 internal_GetImportQueueLength();
+		static MonoString* internal_GetCurrentImport();
+		static float internal_GetImportETA();
 	};
 
 	/**	Base class for C++/CLR interop objects used for wrapping LibraryEntry implementations. */
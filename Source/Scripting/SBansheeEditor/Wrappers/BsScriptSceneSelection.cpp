@@ -14,6 +14,20 @@
 
 namespace bs
 {
+	/** Converts a list of scene objects into a managed array of scene objects. */
+	static MonoArray* toManagedArray(const Vector<HSceneObject>& sceneObjects)
+	{
+		ScriptArray scriptArray = ScriptArray::create<ScriptSceneObject>((UINT32)sceneObjects.size());
+		for (UINT32 i = 0; i < (UINT32)sceneObjects.size(); i++)
+		{
+			ScriptSceneObject* scriptSO =
+				ScriptGameObjectManager::instance().getOrCreateScriptSceneObject(sceneObjects[i]);
+			scriptArray.set(i, scriptSO->getManagedInstance());
+		}
+
+		return scriptArray.getInternal();
+	}
+
 	ScriptSceneSelection::ScriptSceneSelection(MonoObject* object, const SPtr<Camera>& camera)
 		:ScriptObject(object), mCamera(camera), mSelectionRenderer(nullptr)
 	{
@@ -32,6 +46,12 @@ namespace bs
 		metaData.scriptClass->addInternalCall("Internal_PickObject", (void*)&ScriptSceneSelection::internal_PickObject);
 		metaData.scriptClass->addInternalCall("Internal_PickObjects", (void*)&ScriptSceneSelection::internal_PickObjects);
 		metaData.scriptClass->addInternalCall("Internal_Snap", (void*)&ScriptSceneSelection::internal_Snap);
+		metaData.scriptClass->addInternalCall("Internal_SnapAsync", (void*)&ScriptSceneSelection::internal_SnapAsync);
+		metaData.scriptClass->addInternalCall("Internal_TryGetSnapResult", 
+			(void*)&ScriptSceneSelection::internal_TryGetSnapResult);
+		metaData.scriptClass->addInternalCall("Internal_QueryRay", (void*)&ScriptSceneSelection::internal_QueryRay);
+		metaData.scriptClass->addInternalCall("Internal_QueryBox", (void*)&ScriptSceneSelection::internal_QueryBox);
+		metaData.scriptClass->addInternalCall("Internal_QueryArea", (void*)&ScriptSceneSelection::internal_QueryArea);
 	}
 
 	void ScriptSceneSelection::internal_Create(MonoObject* managedInstance, ScriptCCamera* camera)
@@ -185,4 +205,72 @@ namespace bs
 		ScriptSceneObject* scriptSO = ScriptGameObjectManager::instance().getOrCreateScriptSceneObject(instance);
 		return scriptSO->getManagedInstance();
 	}
-}
+
+	void ScriptSceneSelection::internal_SnapAsync(ScriptSceneSelection* thisPtr, Vector2I* inputPos, 
+		MonoArray* ignoreRenderables)
+	{
+		// Only keep a single snap in flight, so results don't pile up if they arrive slower than they're requested
+		if (thisPtr->mPendingSnap != nullptr)
+			return;
+
+		Vector<HSceneObject> ignoredSceneObjects;
+
+		if (ignoreRenderables != nullptr)
+		{
+			ScriptArray scriptArray(ignoreRenderables);
+
+			UINT32 arrayLen = scriptArray.size();
+			for (UINT32 i = 0; i < arrayLen; i++)
+			{
+				MonoObject* monoSO = scriptArray.get<MonoObject*>(i);
+				ScriptSceneObject* scriptSO = ScriptSceneObject::toNative(monoSO);
+
+				if (scriptSO == nullptr)
+					continue;
+
+				HSceneObject so = static_object_cast<SceneObject>(scriptSO->getNativeHandle());
+				ignoredSceneObjects.push_back(so);
+			}
+		}
+
+		thisPtr->mPendingSnap = ScenePicking::instance().pickClosestObjectAsync(thisPtr->mCamera, *inputPos, 
+			ignoredSceneObjects, true);
+	}
+
+	bool ScriptSceneSelection::internal_TryGetSnapResult(ScriptSceneSelection* thisPtr, MonoObject** sceneObject, 
+		SnapData* data)
+	{
+		*sceneObject = nullptr;
+
+		if (thisPtr->mPendingSnap == nullptr || !thisPtr->mPendingSnap->hasCompleted())
+			return false;
+
+		HSceneObject instance = thisPtr->mPendingSnap->getClosestObject();
+		*data = thisPtr->mPendingSnap->getSnapData();
+		thisPtr->mPendingSnap = nullptr;
+
+		if (instance != nullptr)
+		{
+			ScriptSceneObject* scriptSO = ScriptGameObjectManager::instance().getOrCreateScriptSceneObject(instance);
+			*sceneObject = scriptSO->getManagedInstance();
+		}
+
+		return true;
+	}
+
+	MonoArray* ScriptSceneSelection::internal_QueryRay(ScriptSceneSelection* thisPtr, Ray* ray, float maxDistance)
+	{
+		return toManagedArray(ScenePicking::instance().queryRay(*ray, maxDistance));
+	}
+
+	MonoArray* ScriptSceneSelection::internal_QueryBox(ScriptSceneSelection* thisPtr, AABox* bounds)
+	{
+		return toManagedArray(ScenePicking::instance().queryBox(*bounds));
+	}
+
+	MonoArray* ScriptSceneSelection::internal_QueryArea(ScriptSceneSelection* thisPtr, Vector2I* inputPos, 
+		Vector2I* area)
+	{
+		return toManagedArray(ScenePicking::instance().queryArea(thisPtr->mCamera, *inputPos, *area));
+	}
+}
\ No newline at end of file
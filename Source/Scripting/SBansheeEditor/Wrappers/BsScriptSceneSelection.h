@@ -26,6 +26,7 @@ namespace bs
 
 		SPtr<Camera> mCamera;
 		SelectionRenderer* mSelectionRenderer;
+		SPtr<ScenePickingOp> mPendingSnap;
 
 		/************************************************************************/
 		/* 								CLR HOOKS						   		*/
@@ -35,6 +36,11 @@ namespace bs
 		static void internal_PickObject(ScriptSceneSelection* thisPtr, Vector2I* inputPos, bool additive, MonoArray* ignoreRenderables);
 		static void internal_PickObjects(ScriptSceneSelection* thisPtr, Vector2I* inputPos, Vector2I* area, bool additive, MonoArray* ignoreRenderables);
 		static MonoObject* internal_Snap(ScriptSceneSelection* thisPtr, Vector2I* inputPos, SnapData* data, MonoArray* ignoreRenderables);
+		static void internal_SnapAsync(ScriptSceneSelection* thisPtr, Vector2I* inputPos, MonoArray* ignoreRenderables);
+		static bool internal_TryGetSnapResult(ScriptSceneSelection* thisPtr, MonoObject** sceneObject, SnapData* data);
+		static MonoArray* internal_QueryRay(ScriptSceneSelection* thisPtr, Ray* ray, float maxDistance);
+		static MonoArray* internal_QueryBox(ScriptSceneSelection* thisPtr, AABox* bounds);
+		static MonoArray* internal_QueryArea(ScriptSceneSelection* thisPtr, Vector2I* inputPos, Vector2I* area);
 	};
 
 	/** @} */
@@ -5,6 +5,9 @@
 #include "BsMonoAssembly.h"
 #include "BsMonoClass.h"
 #include "Resources/BsResources.h"
+#include "Resources/BsGameResourceManager.h"
+#include "FileSystem/BsFileSystem.h"
+#include "BsApplication.h"
 #include "Reflection/BsRTTIType.h"
 #include "Resources/BsResource.h"
 #include "Wrappers/BsScriptManagedResource.h"
@@ -86,6 +89,27 @@ namespace bs
 		return nullptr;
 	}
 
+	HResource ScriptResourceManager::loadResource(const WeakResourceHandle<Resource>& handle,
+		ResourceLoadFlags loadFlags)
+	{
+		// Resources can only be loaded by UUID from their own files, so the ones packed into an archive are loaded by
+		// the game resource loader instead, which resolves their packaged paths to the archive
+		if (!gApplication().isEditor() && !handle.isLoaded(false))
+		{
+			Path filePath;
+			if (gResources().getFilePathFromUUID(handle.getUUID(), filePath) && !FileSystem::isFile(filePath))
+			{
+				bool keepLoaded = loadFlags.isSet(ResourceLoadFlag::KeepInternalRef);
+
+				HResource resource = GameResourceManager::instance().load(filePath, keepLoaded);
+				if (resource != nullptr)
+					return resource;
+			}
+		}
+
+		return gResources().load(handle, loadFlags);
+	}
+
 	void ScriptResourceManager::destroyScriptResource(ScriptResourceBase* resource)
 	{
 		HResource resourceHandle = resource->getGenericHandle();
@@ -4,6 +4,7 @@
 
 #include "BsScriptEnginePrerequisites.h"
 #include "Utility/BsModule.h"
+#include "Resources/BsResources.h"
 
 namespace bs
 {
@@ -64,6 +65,17 @@ namespace bs
 		 */
 		ScriptResourceBase* getScriptResource(const UUID& UUID);
 
+		/**
+		 * Loads the resource referenced by the provided handle. Outside of the editor, resources without a file of
+		 * their own (for example resources the build packed into an archive) are loaded through the game resource
+		 * loader.
+		 *
+		 * @param[in]	handle		Handle of the resource to load.
+		 * @param[in]	loadFlags	Flags that control how is the resource loaded.
+		 * @return					Handle to the loaded resource, or an empty handle if the resource failed to load.
+		 */
+		HResource loadResource(const WeakResourceHandle<Resource>& handle, ResourceLoadFlags loadFlags);
+
 		/**
 		 * Deletes the provided resource interop objects. All resource interop objects should be deleted using this method.
 		 */
@@ -44,7 +44,7 @@ namespace bs
 		if (gApplication().isEditor())
 			loadFlags |= ResourceLoadFlag::KeepSourceData;
 
-		HResource resource = gResources().load(nativeInstance->mResource, loadFlags);
+		HResource resource = ScriptResourceManager::instance().loadResource(nativeInstance->mResource, loadFlags);
 		ScriptResourceBase* scriptResource = ScriptResourceManager::instance().getScriptResource(resource, true);
 
 		return scriptResource->getManagedInstance();
@@ -52,7 +52,7 @@ namespace bs
 		if (gApplication().isEditor())
 			loadFlags |= ResourceLoadFlag::KeepSourceData;
 
-		HResource resource = gResources().load(scriptRef->getHandle(), loadFlags);
+		HResource resource = ScriptResourceManager::instance().loadResource(scriptRef->getHandle(), loadFlags);
 		if (resource == nullptr)
 			return nullptr;
 